@@ -0,0 +1,100 @@
+#include "bench_common.hpp"
+#include "simd_kernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+namespace pc_monitor::bench {
+
+namespace {
+
+// What a windowed query looked like before the kernels: mean through utils::Average, extremes through
+// std::ranges::minmax and the variance through a second std::accumulate
+simd::Summary SummarizeWithRanges(std::span<const float> values) {
+    simd::Summary Result;
+    Result.count = values.size();
+    auto const Mean = utils::Average(values);
+    Result.sum = Mean * static_cast<double>(values.size());
+    auto const [Min, Max] = std::ranges::minmax(values);
+    Result.min = Min;
+    Result.max = Max;
+    Result.m2 = std::accumulate(values.begin(), values.end(), 0.0, [Mean](double total, float value) {
+        return total + ((value - Mean) * (value - Mean));
+    });
+    return Result;
+}
+
+void PrintComparison(std::string_view what, double baselineNanos, double kernelNanos) {
+    std::cout << std::format("{:<30}: {:10.0f} ns -> {:8.0f} ns ({:.2f}x)\n",
+                             what,
+                             baselineNanos,
+                             kernelNanos,
+                             baselineNanos / kernelNanos);
+    Report(std::format("{} baseline", what), baselineNanos, "ns/op");
+    Report(std::format("{} kernel", what), kernelNanos, "ns/op");
+}
+
+}  // namespace
+
+// Per-core averages as the collector computes them, and per-core statistics over an hour-long window of
+// 1-second samples, against the ranges/scalar code they replace
+void RunAggregationBench(const BenchOptions& options) {
+    constexpr std::size_t WINDOW = 3600;
+    constexpr std::size_t BUCKETS = 256;
+    auto const Budget = std::chrono::duration_cast<std::chrono::nanoseconds>(options.duration) / 8;
+    auto const Stats = MakeSyntheticStats(options.cores);
+    std::cout << "kernel                        : " << simd::ActiveKernel() << '\n';
+
+    // Average over the per-core values of one sample, as gathered contiguously by the collector
+    std::vector<double> Frequencies;
+    for (const auto& Core : Stats.cpu.cores) {
+        Frequencies.push_back(static_cast<double>(Core.frequency));
+    }
+    double Sink = 0.0;
+    auto const AverageNanos = NanosPerCall(Budget, [&]() { Sink += utils::Average(Frequencies); });
+    auto const MeanNanos = NanosPerCall(Budget, [&]() { Sink += simd::Mean(Frequencies); });
+    PrintComparison("per-core mean of one sample", AverageNanos, MeanNanos);
+
+    // One hour of usage per core, column-major like the history rings
+    std::vector<float> Window(options.cores * WINDOW);
+    for (std::size_t I = 0; I < Window.size(); ++I) {
+        Window[I] = static_cast<float>((I * 7919) % 10007) / 100.07F;
+    }
+    auto ForEachCore = [&](auto&& summarize) {
+        for (std::size_t Core = 0; Core < options.cores; ++Core) {
+            Sink += summarize(std::span<const float>(Window).subspan(Core * WINDOW, WINDOW)).StdDev();
+        }
+    };
+    auto const RangesNanos = NanosPerCall(Budget, [&]() { ForEachCore(SummarizeWithRanges); });
+    auto const ScalarNanos = NanosPerCall(Budget, [&]() {
+        ForEachCore([](std::span<const float> values) { return simd::scalar::Summarize(values); });
+    });
+    auto const KernelNanos = NanosPerCall(Budget, [&]() {
+        ForEachCore([](std::span<const float> values) { return simd::Summarize(values); });
+    });
+    PrintComparison("1h window stats (ranges)", RangesNanos, KernelNanos);
+    PrintComparison("1h window stats (scalar)", ScalarNanos, KernelNanos);
+
+    std::vector<std::uint32_t> Buckets(BUCKETS);
+    auto const ScalarHistogramNanos = NanosPerCall(Budget, [&]() {
+        simd::scalar::Histogram(std::span<const float>(Window), 0.0, 100.0, Buckets);
+    });
+    auto const KernelHistogramNanos =
+        NanosPerCall(Budget, [&]() { simd::Histogram(std::span<const float>(Window), 0.0, 100.0, Buckets); });
+    PrintComparison("1h window histogram (all cores)", ScalarHistogramNanos, KernelHistogramNanos);
+
+    // Both paths must agree before the timings mean anything
+    auto const Expected = SummarizeWithRanges(Window);
+    auto const Actual = simd::Summarize(std::span<const float>(Window));
+    bool const Equivalent = Expected.min == Actual.min && Expected.max == Actual.max &&
+                            std::abs(Expected.Mean() - Actual.Mean()) < 1e-9 * std::abs(Expected.Mean()) &&
+                            std::abs(Expected.m2 - Actual.m2) < 1e-9 * Expected.m2;
+    std::cout << std::format("results equivalent            : {} (checksum {:.0f})\n", Equivalent ? "yes" : "NO", Sink);
+}
+
+}  // namespace pc_monitor::bench
@@ -0,0 +1,119 @@
+#include "alert_rules.hpp"
+#include "bench_common.hpp"
+
+#include <array>
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace pc_monitor::bench {
+
+namespace {
+constexpr std::size_t RULES = 300;
+
+// Metrics the generated rules cycle through: per-core, per-package, per-device and host-wide
+constexpr std::array METRICS{std::string_view{"cpu.core.usage"},
+                             std::string_view{"cpu.core.frequency"},
+                             std::string_view{"cpu.core.temperature"},
+                             std::string_view{"cpu.package.temperature"},
+                             std::string_view{"cpu.overall"},
+                             std::string_view{"memory.usagePercent"},
+                             std::string_view{"pressure.io.some"},
+                             std::string_view{"disk.utilization"},
+                             std::string_view{"network.rxBytesPerSec"},
+                             std::string_view{"network.errorsPerSec"}};
+
+// RULES rules with thresholds spread so that some of them fire on the synthetic sample and most do not;
+// every seventh one waits 30 s
+std::string MakeRulesFile() {
+    std::string Config = R"({"rules":[)";
+    for (std::size_t I = 0; I < RULES; ++I) {
+        auto const Metric = METRICS[I % METRICS.size()];
+        auto const Level = Metric == "cpu.core.frequency"      ? 4000 + (I % 500)
+                           : Metric == "network.rxBytesPerSec" ? 3'000'000 + (I * 1000)
+                                                               : 50 + (I % 50);
+        Config += I == 0 ? "{" : ",{";
+        Config += std::format(
+            R"("name":"rule-{}","metric":"{}","above":{},"clear":{})", I, Metric, Level, Level - 5);
+        Config += I % 7 == 0 ? R"(,"for":"30s"})" : "}";
+    }
+    Config += "]}";
+    return Config;
+}
+}  // namespace
+
+// Cost of evaluating a few hundred rules against a sample of `options.cores` cores, once with steady values
+// and once with one core crossing its thresholds on every sample, plus the hold and hysteresis semantics on
+// a single rule
+void RunAlertBench(const BenchOptions& options) {
+    auto Rules = AlertEngine::Parse(MakeRulesFile());
+    if (!Rules) {
+        std::cout << "cannot parse the generated rules: " << Rules.error() << '\n';
+        return;
+    }
+
+    AlertEngine Engine(std::move(*Rules));
+    auto Stats = MakeSyntheticStats(options.cores);
+    std::vector<AlertEvent> Events;
+    auto const Budget = std::chrono::duration_cast<std::chrono::nanoseconds>(options.duration) / 2;
+    Engine.Evaluate(Stats, Events);
+
+    std::size_t Steady = 0;
+    auto const SteadyNanos = NanosPerCall(Budget, [&]() {
+        Stats.timestamp += std::chrono::seconds{1};
+        Events.clear();
+        Engine.Evaluate(Stats, Events);
+        Steady += Events.size();
+    });
+
+    // One core swings between idle and busy, so its usage rules fire and resolve in turn
+    std::size_t Transitions = 0;
+    std::size_t Sample = 0;
+    auto const FlappingNanos = NanosPerCall(Budget, [&]() {
+        Stats.timestamp += std::chrono::seconds{1};
+        Stats.cpu.cores.front().usage = Sample % 2 == 0 ? 100.0 : 0.0;
+        ++Sample;
+        Events.clear();
+        Engine.Evaluate(Stats, Events);
+        Transitions += Events.size();
+    });
+
+    // A 30 s rule on a 1 s sample fires on the 31st busy sample and resolves only below its clear level
+    auto Single = AlertEngine::Parse(
+        R"({"rules":[{"name":"busy","metric":"cpu.overall","above":90,"clear":80,"for":"30s"}]})");
+    AlertEngine Hold(std::move(*Single));
+    auto Host = MakeSyntheticStats(1);
+    std::size_t FiredAt = 0;
+    Host.cpu.overall = 95.0;
+    for (std::size_t I = 1; I <= 40 && FiredAt == 0; ++I) {
+        Events.clear();
+        Hold.Evaluate(Host, Events);
+        FiredAt = Events.empty() ? 0 : I;
+        Host.timestamp += std::chrono::seconds{1};
+    }
+    Host.cpu.overall = 85.0;
+    Events.clear();
+    Hold.Evaluate(Host, Events);
+    auto const HeldInBand = Events.empty();
+    Host.cpu.overall = 75.0;
+    Events.clear();
+    Hold.Evaluate(Host, Events);
+    auto const Resolved = Events.size() == 1 && Events.front().state == "resolved";
+
+    std::cout << std::format("rules / checks                : {:10} / {}\n", Engine.RuleCount(), Engine.CheckCount());
+    std::cout << std::format("firing on the steady sample   : {:10}\n", Engine.Firing().size());
+    std::cout << std::format("evaluate, steady              : {:10.0f} ns ({} transitions)\n", SteadyNanos, Steady);
+    std::cout << std::format(
+        "evaluate, one core flapping   : {:10.0f} ns ({} transitions)\n", FlappingNanos, Transitions);
+    std::cout << std::format("30s rule fired on sample      : {:10}\n", FiredAt);
+    std::cout << std::format("held in band / resolved       : {} / {}\n",
+                             HeldInBand ? "yes" : "NO",
+                             Resolved ? "yes" : "NO");
+    Report("evaluate steady", SteadyNanos, "ns/op");
+    Report("evaluate flapping", FlappingNanos, "ns/op");
+    Report("checks", static_cast<double>(Engine.CheckCount()), "count");
+}
+
+}  // namespace pc_monitor::bench
@@ -0,0 +1,149 @@
+#include "bench_common.hpp"
+#include "event_loop.hpp"
+#include "stats_sampler.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <format>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pc_monitor::bench {
+
+namespace {
+constexpr std::size_t SUBSCRIBERS = 2000;
+constexpr std::size_t ROUNDS = 200;
+
+Task CountWakeups(EventLoop& loop,
+                  AsyncNotifier& notifier,
+                  const std::atomic<std::uint64_t>& sequence,
+                  std::atomic<std::uint64_t>& delivered) {
+    std::uint64_t Seen = 0;
+    while (co_await notifier.Wait(loop, loop.StopToken(), [&]() { return sequence.load() != Seen; })) {
+        Seen = sequence.load();
+        delivered.fetch_add(1);
+    }
+}
+
+Task CountSnapshots(EventLoop& loop, StatsSampler& sampler, std::atomic<std::uint64_t>& delivered) {
+    auto Stream = sampler.Subscribe(loop, loop.StopToken());
+    while (co_await Stream.Next()) {
+        delivered.fetch_add(1);
+    }
+}
+
+// Bumps the sequence and waits until every subscriber saw it; returns mean microseconds per round
+template <typename Notify>
+double FanOut(std::atomic<std::uint64_t>& sequence, const std::atomic<std::uint64_t>& delivered, Notify&& notify) {
+    auto const Started = std::chrono::steady_clock::now();
+    for (std::size_t Round = 1; Round <= ROUNDS; ++Round) {
+        sequence.fetch_add(1);
+        notify();
+        while (delivered.load() < Round * SUBSCRIBERS) {
+            std::this_thread::yield();
+        }
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - Started).count() /
+           static_cast<double>(ROUNDS);
+}
+}  // namespace
+
+// Waking SUBSCRIBERS stream consumers per published sample: coroutines sharing one loop thread against one
+// blocked thread per consumer, which is what a per-client generator or stream provider costs
+void RunAsyncBench(const BenchOptions& options) {
+    {
+        EventLoop Loop;
+        AsyncNotifier Notifier;
+        std::atomic<std::uint64_t> Sequence{0};
+        std::atomic<std::uint64_t> Delivered{0};
+        Loop.Start();
+        for (std::size_t I = 0; I < SUBSCRIBERS; ++I) {
+            Loop.Spawn(CountWakeups(Loop, Notifier, Sequence, Delivered));
+        }
+        while (Notifier.WaiterCount() != SUBSCRIBERS) {
+            std::this_thread::yield();
+        }
+        auto const Micros = FanOut(Sequence, Delivered, [&]() { Notifier.Notify(); });
+        Loop.Stop();
+        Report("coroutines on 1 thread", Micros, "us/round");
+        std::cout << std::format("coroutines on 1 thread        : {:10.0f} us per round ({} subscribers, {} left)\n",
+                                 Micros,
+                                 SUBSCRIBERS,
+                                 Loop.ActiveTasks());
+    }
+
+    {
+        std::mutex Mutex;
+        std::condition_variable Published;
+        std::atomic<std::uint64_t> Sequence{0};
+        std::atomic<std::uint64_t> Delivered{0};
+        std::atomic<bool> Stopping{false};
+        std::vector<std::thread> Threads;
+        Threads.reserve(SUBSCRIBERS);
+        for (std::size_t I = 0; I < SUBSCRIBERS; ++I) {
+            Threads.emplace_back([&]() {
+                std::uint64_t Seen = 0;
+                std::unique_lock<std::mutex> Lock(Mutex);
+                while (true) {
+                    Published.wait(Lock, [&]() { return Sequence.load() != Seen || Stopping.load(); });
+                    if (Stopping.load()) {
+                        return;
+                    }
+                    Seen = Sequence.load();
+                    Delivered.fetch_add(1);
+                }
+            });
+        }
+        auto const Micros = FanOut(Sequence, Delivered, [&]() {
+            std::lock_guard<std::mutex> const Lock(Mutex);
+            Published.notify_all();
+        });
+        {
+            std::lock_guard<std::mutex> const Lock(Mutex);
+            Stopping.store(true);
+        }
+        Published.notify_all();
+        for (auto& Thread : Threads) {
+            Thread.join();
+        }
+        Report("thread per subscriber", Micros, "us/round");
+        std::cout << std::format("thread per subscriber         : {:10.0f} us per round ({} threads)\n",
+                                 Micros,
+                                 SUBSCRIBERS);
+    }
+
+    // End to end: live sampler snapshots delivered to every subscription on one loop thread
+    auto Monitor = std::make_shared<SystemMonitor>();
+    if (!Monitor->Initialize()) {
+        std::cout << "cannot initialize the system monitor\n";
+        return;
+    }
+    StatsSampler Sampler(Monitor, StatsSampler::Options{.cpuInterval = std::chrono::milliseconds{100}});
+    (void)Sampler.Start();
+
+    EventLoop Loop;
+    std::atomic<std::uint64_t> Delivered{0};
+    Loop.Start();
+    auto const FirstSequence = Sampler.Sequence();
+    for (std::size_t I = 0; I < SUBSCRIBERS; ++I) {
+        Loop.Spawn(CountSnapshots(Loop, Sampler, Delivered));
+    }
+    std::this_thread::sleep_for(options.duration / 5);
+    Sampler.Stop();
+
+    // Every subscription starts with the snapshot current when it subscribed; give the last one time to land
+    auto const Expected = (Sampler.Sequence() - FirstSequence + 1) * SUBSCRIBERS;
+    auto const Drained = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+    while (Delivered.load() < Expected && std::chrono::steady_clock::now() < Drained) {
+        std::this_thread::yield();
+    }
+    Loop.Stop();
+    std::cout << std::format("sampler subscriptions         : {:10} of {} snapshots delivered ({} subscribers)\n",
+                             Delivered.load(),
+                             Expected,
+                             SUBSCRIBERS);
+}
+
+}  // namespace pc_monitor::bench
@@ -0,0 +1,134 @@
+#pragma once
+
+// Standard library includes first
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Local includes last
+#include "system_monitor.hpp"
+
+namespace pc_monitor::bench {
+
+struct BenchOptions {
+    std::size_t cores = 128;       // synthetic core count
+    std::size_t clients = 8;       // concurrent load-generator connections
+    std::size_t processes = 5000;  // idle child processes for the process-table scan
+    std::size_t cgroups = 2000;    // synthetic cgroups for the cgroup collector
+    std::size_t hosts = 16;        // local upstream instances for the fleet aggregator
+    std::size_t streams = 10000;   // idle stream connections held open against the event server
+    std::chrono::seconds duration{5};
+};
+
+// Deterministic SystemStats with the given core count and a few disks and interfaces, so results do not
+// depend on the host
+inline SystemStats MakeSyntheticStats(std::size_t coreCount) {
+    SystemStats Stats;
+    Stats.timestamp = std::chrono::system_clock::time_point{std::chrono::milliseconds{1'700'000'000'000}};
+
+    Stats.cpu.cores.reserve(coreCount);
+    for (std::size_t I = 0; I < coreCount; ++I) {
+        Stats.cpu.cores.push_back(CPUCoreData{.coreId = static_cast<std::uint32_t>(I),
+                                              .usage = static_cast<double>((I * 37) % 1000) / 10.0,
+                                              .frequency = 2400 + ((I * 131) % 2200),
+                                              .temperature = 45.0 + static_cast<double>((I * 7) % 30)});
+    }
+    Stats.cpu.overall = 42.5;
+    Stats.cpu.averageFrequency = 3300;
+    Stats.cpu.temperature = 75.0;
+    Stats.cpu.packages = {CpuPackageThermal{.package = 0, .temperature = 75.0, .critical = 100.0, .throttling = false},
+                          CpuPackageThermal{.package = 1, .temperature = 74.0, .critical = 100.0, .throttling = false}};
+
+    constexpr std::uint64_t GIB = 1024ULL * 1024 * 1024;
+    Stats.memory = MemoryUsageData{.total = 64 * GIB,
+                                   .used = 23 * GIB,
+                                   .available = 41 * GIB,
+                                   .cache = 12 * GIB,
+                                   .buffers = GIB / 2,
+                                   .usagePercent = 35.9375,
+                                   .slab = GIB,
+                                   .dirty = 48 * 1024 * 1024,
+                                   .writeback = 0,
+                                   .swapTotal = 8 * GIB,
+                                   .swapUsed = GIB / 4,
+                                   .hugePagesTotal = GIB,
+                                   .hugePagesFree = GIB / 4,
+                                   .pressure = std::nullopt};
+    Stats.memory.pressure = SystemPressure{
+        .cpu = {.some = {.avg10 = 4.12, .avg60 = 3.5, .avg300 = 2.01, .total = 91'234'567}, .full = PressureStall{}},
+        .io = {.some = {.avg10 = 0.31, .avg60 = 0.2, .avg300 = 0.1, .total = 5'345'678},
+               .full = PressureStall{.avg10 = 0.12, .total = 2'001'002}},
+        .memory = {.some = {.total = 12'345}, .full = PressureStall{.total = 6'001}}};
+
+    for (std::size_t I = 0; I < 4; ++I) {
+        auto const Scale = static_cast<double>(I + 1);
+        Stats.disks.push_back(DiskDeviceData{.name = "nvme" + std::to_string(I) + "n1",
+                                             .queueDepth = 0.25 * Scale,
+                                             .readBytesPerSec = 52'428'800.0 * Scale,
+                                             .readsPerSec = 410.0 * Scale,
+                                             .utilization = 12.5 * Scale,
+                                             .writeBytesPerSec = 20'971'520.0 * Scale,
+                                             .writesPerSec = 160.0 * Scale});
+        Stats.network.push_back(NetworkInterfaceData{.name = "eth" + std::to_string(I),
+                                                     .dropsPerSec = 0.0,
+                                                     .errorsPerSec = 0.0,
+                                                     .rxBytesPerSec = 1'250'000.0 * Scale,
+                                                     .rxPacketsPerSec = 940.0 * Scale,
+                                                     .txBytesPerSec = 310'000.0 * Scale,
+                                                     .txPacketsPerSec = 610.0 * Scale});
+    }
+    return Stats;
+}
+
+// Runs body repeatedly for about `budget` and returns the mean nanoseconds per call
+template <typename Body>
+double NanosPerCall(std::chrono::nanoseconds budget, Body&& body) {
+    std::uint64_t Calls = 0;
+    auto const Started = std::chrono::steady_clock::now();
+    auto Elapsed = std::chrono::nanoseconds{0};
+    while (Elapsed < budget) {
+        for (int I = 0; I < 64; ++I) {
+            body();
+        }
+        Calls += 64;
+        Elapsed = std::chrono::steady_clock::now() - Started;
+    }
+    return static_cast<double>(Elapsed.count()) / static_cast<double>(Calls);
+}
+
+// Records one result of the running suite for the --json report; units are part of the metric's identity, so
+// keep them stable ("ns/op", "req/s", "ms", ...) for comparisons across commits
+void Report(std::string_view metric, double value, std::string_view unit);
+
+// Nearest-rank percentile (0-100) of unsorted samples; sorts them in place, 0 when empty
+inline double Percentile(std::vector<double>& samples, double percentile) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    std::ranges::sort(samples);
+    auto const Rank = static_cast<std::size_t>(percentile / 100.0 * static_cast<double>(samples.size() - 1) + 0.5);
+    return samples[std::min(Rank, samples.size() - 1)];
+}
+
+// Suites registered in bench_main.cpp
+void RunAggregationBench(const BenchOptions& options);
+void RunAlertBench(const BenchOptions& options);
+void RunAsyncBench(const BenchOptions& options);
+void RunCgroupBench(const BenchOptions& options);
+void RunCollectionBench(const BenchOptions& options);
+void RunEventServerBench(const BenchOptions& options);
+void RunFleetBench(const BenchOptions& options);
+void RunHttpBench(const BenchOptions& options);
+void RunLatencyBench(const BenchOptions& options);
+void RunPerfBench(const BenchOptions& options);
+void RunProcessBench(const BenchOptions& options);
+void RunReplayBench(const BenchOptions& options);
+void RunSchedulerBench(const BenchOptions& options);
+void RunSerializationBench(const BenchOptions& options);
+void RunStoreBench(const BenchOptions& options);
+
+}  // namespace pc_monitor::bench
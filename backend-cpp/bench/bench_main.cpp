@@ -0,0 +1,148 @@
+#include "bench_common.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace {
+
+struct Suite {
+    std::string_view name;
+    void (*run)(const pc_monitor::bench::BenchOptions&);
+};
+
+constexpr std::array SUITES = {
+    Suite{"collection", &pc_monitor::bench::RunCollectionBench},
+    Suite{"serialization", &pc_monitor::bench::RunSerializationBench},
+    Suite{"http", &pc_monitor::bench::RunHttpBench},
+    Suite{"epoll", &pc_monitor::bench::RunEventServerBench},
+    Suite{"latency", &pc_monitor::bench::RunLatencyBench},
+    Suite{"store", &pc_monitor::bench::RunStoreBench},
+    Suite{"aggregation", &pc_monitor::bench::RunAggregationBench},
+    Suite{"processes", &pc_monitor::bench::RunProcessBench},
+    Suite{"cgroups", &pc_monitor::bench::RunCgroupBench},
+    Suite{"alerts", &pc_monitor::bench::RunAlertBench},
+    Suite{"fleet", &pc_monitor::bench::RunFleetBench},
+    Suite{"scheduler", &pc_monitor::bench::RunSchedulerBench},
+    Suite{"async", &pc_monitor::bench::RunAsyncBench},
+    Suite{"replay", &pc_monitor::bench::RunReplayBench},
+    Suite{"perf", &pc_monitor::bench::RunPerfBench},
+};
+
+// Results of every suite run so far, in order, for --json
+std::string_view CurrentSuite;
+nlohmann::json Results = nlohmann::json::array();
+
+bool ParseCount(std::string_view text, std::size_t& value) {
+    auto const [Ptr, Ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return Ec == std::errc{} && Ptr == text.data() + text.size();
+}
+
+void PrintUsage() {
+    std::cerr << "usage: pc-monitor-bench [suite...] [--cores N] [--clients N] [--processes N] [--cgroups N] "
+                 "[--hosts N] [--streams N] [--seconds N] [--json PATH] [--label TEXT]\nsuites:";
+    for (const auto& Entry : SUITES) {
+        std::cerr << ' ' << Entry.name;
+    }
+    std::cerr << '\n';
+}
+
+}  // namespace
+
+namespace pc_monitor::bench {
+
+void Report(std::string_view metric, double value, std::string_view unit) {
+    Results.push_back({{"metric", metric}, {"suite", CurrentSuite}, {"unit", unit}, {"value", value}});
+}
+
+}  // namespace pc_monitor::bench
+
+int main(int argc, char** argv) {
+    pc_monitor::bench::BenchOptions Options;
+    std::vector<std::string_view> Selected;
+    std::string JsonPath;
+    std::string Label;
+
+    for (int I = 1; I < argc; ++I) {
+        std::string_view const Arg = argv[I];
+        std::size_t Value = 0;
+        bool const HasValue = I + 1 < argc && ParseCount(argv[I + 1], Value);
+
+        if (Arg == "--cores" && HasValue) {
+            Options.cores = Value;
+        } else if (Arg == "--clients" && HasValue) {
+            Options.clients = Value;
+        } else if (Arg == "--processes" && HasValue) {
+            Options.processes = Value;
+        } else if (Arg == "--cgroups" && HasValue) {
+            Options.cgroups = Value;
+        } else if (Arg == "--hosts" && HasValue) {
+            Options.hosts = Value;
+        } else if (Arg == "--streams" && HasValue) {
+            Options.streams = Value;
+        } else if (Arg == "--seconds" && HasValue) {
+            Options.duration = std::chrono::seconds{Value};
+        } else if (Arg == "--json" && I + 1 < argc) {
+            JsonPath = argv[I + 1];
+        } else if (Arg == "--label" && I + 1 < argc) {
+            Label = argv[I + 1];
+        } else if (!Arg.starts_with("--")) {
+            Selected.push_back(Arg);
+            continue;
+        } else {
+            PrintUsage();
+            return 1;
+        }
+        ++I;
+    }
+
+    for (const auto& Entry : SUITES) {
+        if (Selected.empty() || std::ranges::find(Selected, Entry.name) != Selected.end()) {
+            std::cout << std::format("== {} (cores={}, clients={}, seconds={})\n",
+                                     Entry.name,
+                                     Options.cores,
+                                     Options.clients,
+                                     Options.duration.count());
+            CurrentSuite = Entry.name;
+            Entry.run(Options);
+        }
+    }
+
+    // One document per run; compare runs by (suite, metric, unit)
+    if (!JsonPath.empty()) {
+        nlohmann::json const Document = {
+            {"hardwareThreads", std::thread::hardware_concurrency()},
+            {"label", Label},
+            {"options",
+             {{"cgroups", Options.cgroups},
+              {"clients", Options.clients},
+              {"cores", Options.cores},
+              {"hosts", Options.hosts},
+              {"processes", Options.processes},
+              {"streams", Options.streams},
+              {"seconds", Options.duration.count()}}},
+            {"results", Results},
+            {"timestamp",
+             std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch())
+                 .count()},
+        };
+        std::ofstream Out(JsonPath);
+        Out << Document.dump(2) << '\n';
+        if (!Out) {
+            std::cerr << "cannot write " << JsonPath << '\n';
+            return 1;
+        }
+        std::cout << std::format("wrote {} results to {}\n", Results.size(), JsonPath);
+    }
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include "bench_common.hpp"
+#include "cgroup_monitor.hpp"
+
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace pc_monitor::bench {
+
+namespace {
+constexpr std::size_t SLICES = 20;
+constexpr std::size_t SCANS = 2 * CgroupMonitor::REFRESH_SCANS;  // each regime includes two refresh scans
+
+// The four files the collector reads, in the kernel's format
+void WriteCgroup(const std::filesystem::path& directory, std::uint64_t usageUsec, std::uint64_t bytes) {
+    std::filesystem::create_directories(directory);
+    std::ofstream(directory / "cpu.stat") << std::format(
+        "usage_usec {}\nuser_usec {}\nsystem_usec {}\nnr_periods 0\nnr_throttled 0\nthrottled_usec 0\n",
+        usageUsec,
+        usageUsec / 2,
+        usageUsec / 2);
+    std::ofstream(directory / "memory.current") << bytes << '\n';
+    std::ofstream(directory / "memory.stat") << std::format(
+        "anon {}\nfile {}\nkernel 1048576\nkernel_stack 65536\nsock 0\nshmem 0\n", bytes / 2, bytes / 4);
+    std::ofstream(directory / "io.stat") << std::format(
+        "259:0 rbytes={} wbytes={} rios=10 wios=5 dbytes=0 dios=0\n", bytes / 8, bytes / 16);
+}
+}  // namespace
+
+// Scan cost over a synthetic tree of `options.cgroups` containers in SLICES slices, with nothing running, with
+// 1% of the containers (in one or two slices) running and with all of them running; the collector only reads
+// the files of cgroups whose CPU usage moved and the cpu.stat of their children, so the first two should stay
+// far below the last. Also checks that a container moved into place and then removed is picked up through
+// inotify without a rescan.
+void RunCgroupBench(const BenchOptions& options) {
+    auto const Root = std::filesystem::temp_directory_path() / "pc-monitor-bench-cgroups";
+    std::filesystem::remove_all(Root);
+    std::filesystem::create_directories(Root);
+
+    auto const PerSlice = std::max<std::size_t>(options.cgroups / SLICES, 1);
+    std::vector<std::filesystem::path> Slices;
+    std::vector<std::filesystem::path> Containers;
+    std::vector<std::uint64_t> SliceUsage(SLICES);
+    std::vector<std::uint64_t> ContainerUsage(SLICES * PerSlice);
+    for (std::size_t S = 0; S < SLICES; ++S) {
+        Slices.push_back(Root / std::format("pod-{:02}.slice", S));
+        WriteCgroup(Slices.back(), 0, 1ULL << 30);
+        for (std::size_t C = 0; C < PerSlice; ++C) {
+            Containers.push_back(Slices.back() / std::format("ctr-{:04}.scope", C));
+            WriteCgroup(Containers.back(), 0, 64ULL << 20);
+        }
+    }
+
+    CgroupMonitor Monitor;
+    auto const InitStarted = std::chrono::steady_clock::now();
+    if (!Monitor.Initialize(Root.string()) || !Monitor.Scan()) {
+        std::cout << "cannot read " << Root.string() << '\n';
+        std::filesystem::remove_all(Root);
+        return;
+    }
+    auto const InitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - InitStarted);
+
+    // Mean Scan() time while a moving block of `running` adjacent containers and their slices accumulate
+    // usage; rewriting the files is not timed
+    auto const ScanMicros = [&](std::size_t running) {
+        std::chrono::nanoseconds Spent{0};
+        for (std::size_t I = 0; I < SCANS; ++I) {
+            for (std::size_t R = 0; R < running; ++R) {
+                auto const Index = ((I * running) + R) % Containers.size();
+                ContainerUsage[Index] += 1000;
+                SliceUsage[Index / PerSlice] += 1000;
+                WriteCgroup(Containers[Index], ContainerUsage[Index], 64ULL << 20);
+            }
+            for (std::size_t S = 0; running != 0 && S < SLICES; ++S) {
+                WriteCgroup(Slices[S], SliceUsage[S], 1ULL << 30);
+            }
+            auto const Started = std::chrono::steady_clock::now();
+            (void)Monitor.Scan();
+            Spent += std::chrono::steady_clock::now() - Started;
+        }
+        return static_cast<double>(Spent.count()) / 1e3 / static_cast<double>(SCANS);
+    };
+    auto const IdleMicros = ScanMicros(0);
+    auto const FewMicros = ScanMicros(std::max<std::size_t>(Containers.size() / 100, 1));
+    auto const AllMicros = ScanMicros(Containers.size());
+
+    auto const Total = Monitor.Latest()->cgroups.size();
+    auto const Prefix = "/" + Slices[SLICES / 2].filename().string();
+    std::size_t Sink = 0;
+    auto const TopNanos =
+        NanosPerCall(std::chrono::duration_cast<std::chrono::nanoseconds>(options.duration) / 8, [&]() {
+            Sink += CgroupMonitor::Top(*Monitor.Latest(), 20, CgroupSortKey::CPU, Prefix).size();
+        });
+
+    // A container appears by rename, as if created with its files in place, then goes away
+    auto const Staged = Root / "staged";
+    WriteCgroup(Staged, 0, 1ULL << 20);
+    std::filesystem::rename(Staged, Slices.front() / "ctr-new.scope");
+    (void)Monitor.Scan();
+    auto const Added = Monitor.Latest()->cgroups.size() == Total + 1;
+    std::filesystem::remove_all(Slices.front() / "ctr-new.scope");
+    (void)Monitor.Scan();
+    auto const Removed = Monitor.Latest()->cgroups.size() == Total;
+
+    std::cout << std::format("cgroups in table              : {:10} ({} slices)\n", Total, SLICES);
+    std::cout << std::format("first walk and scan           : {:10.1f} ms\n", InitMs.count());
+    std::cout << std::format("scan, none running            : {:10.0f} us\n", IdleMicros);
+    std::cout << std::format("scan, 1% running              : {:10.0f} us\n", FewMicros);
+    std::cout << std::format("scan, all running             : {:10.0f} us\n", AllMicros);
+    std::cout << std::format("top 20 under one slice        : {:10.0f} ns (checksum {})\n", TopNanos, Sink % 997);
+    std::cout << std::format("inotify add / remove seen     : {} / {}\n", Added ? "yes" : "NO", Removed ? "yes" : "NO");
+    Report("first walk", InitMs.count(), "ms");
+    Report("scan none running", IdleMicros, "us");
+    Report("scan 1% running", FewMicros, "us");
+    Report("scan all running", AllMicros, "us");
+    Report("top 20 by prefix", TopNanos, "ns/op");
+
+    std::filesystem::remove_all(Root);
+}
+
+}  // namespace pc_monitor::bench
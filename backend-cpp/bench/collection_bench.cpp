@@ -0,0 +1,62 @@
+#include "bench_common.hpp"
+#include "reference_json.hpp"
+#include "web_server.hpp"
+
+#include <format>
+#include <iostream>
+#include <ranges>
+#include <string_view>
+
+namespace pc_monitor::bench {
+
+namespace {
+void PrintAndReport(std::string_view metric, double nanos) {
+    std::cout << std::format("{:<30}: {:10.0f} ns/op\n", metric, nanos);
+    Report(metric, nanos, "ns/op");
+}
+}  // namespace
+
+// Per-call cost of the hot paths behind every sample: collection on this host, the nlohmann DOM conversions
+// and the console formatting helpers
+void RunCollectionBench(const BenchOptions& options) {
+    auto const Budget = std::chrono::duration_cast<std::chrono::nanoseconds>(options.duration) / 8;
+    std::size_t Sink = 0;
+
+    SystemMonitor Monitor;
+    if (Monitor.Initialize()) {
+        PrintAndReport("GetCurrentStats", NanosPerCall(Budget, [&]() {
+                           if (auto Stats = Monitor.GetCurrentStats()) {
+                               Sink += Stats->cpu.cores.size();
+                           }
+                       }));
+        // /proc/meminfo through the learned line layout, plus the three PSI files
+        PrintAndReport("GetMemoryStats", NanosPerCall(Budget, [&]() {
+                           if (auto Memory = Monitor.GetMemoryStats()) {
+                               Sink += Memory->pressure.has_value() ? 1 : 0;
+                           }
+                       }));
+    } else {
+        std::cout << "cannot initialize the system monitor, skipping GetCurrentStats\n";
+    }
+
+    // Synthetic input so the serialization numbers depend on --cores rather than on the host
+    auto const Stats = MakeSyntheticStats(options.cores);
+    PrintAndReport("ToJson(CPUCoreData)",
+                   NanosPerCall(Budget, [&]() { Sink += reference::ToJson(Stats.cpu.cores.front()).size(); }));
+    PrintAndReport("ToJson(CPUUsageData)",
+                   NanosPerCall(Budget, [&]() { Sink += reference::ToJson(Stats.cpu).size(); }));
+    PrintAndReport("ToJson(MemoryUsageData)",
+                   NanosPerCall(Budget, [&]() { Sink += reference::ToJson(Stats.memory).size(); }));
+    PrintAndReport("ToJson(SystemStats)", NanosPerCall(Budget, [&]() { Sink += reference::ToJson(Stats).size(); }));
+
+    auto const Usage = Stats.cpu.cores | std::views::transform(&CPUCoreData::usage);
+    double Total = 0.0;
+    PrintAndReport("utils::Average", NanosPerCall(Budget, [&]() { Total += utils::Average(Usage); }));
+    PrintAndReport("utils::FormatBytes", NanosPerCall(Budget, [&]() {
+                       Sink += utils::FormatBytes(Stats.memory.used + Sink % 4096).size();
+                   }));
+
+    std::cout << std::format("checksum                      : {} {:.0f}\n", Sink % 997, Total);
+}
+
+}  // namespace pc_monitor::bench
@@ -0,0 +1,416 @@
+#include "bench_common.hpp"
+#include "event_http_server.hpp"
+#include "web_server.hpp"
+
+#include <algorithm>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+    #include <array>
+    #include <charconv>
+    #include <fstream>
+
+    #include <netinet/in.h>
+    #include <sys/epoll.h>
+    #include <sys/resource.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+namespace pc_monitor::bench {
+
+#if defined(__linux__)
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::uint16_t PORT = 3121;
+constexpr std::size_t FRAMES = 5;
+constexpr auto FRAME_INTERVAL = std::chrono::milliseconds{200};
+constexpr auto DELIVERY_TIMEOUT = std::chrono::seconds{10};
+constexpr std::size_t PIPELINE_DEPTH = 16;
+constexpr std::size_t EXHAUSTION_CLIENTS = 64;
+
+constexpr std::string_view STATS_REQUEST = "GET /api/stats HTTP/1.1\r\nHost: bench\r\n\r\n";
+constexpr std::string_view STREAM_REQUEST = "GET /ws/stats HTTP/1.1\r\nHost: bench\r\n\r\n";
+
+bool ConnectSocket(int socket) {
+    sockaddr_in Address{};
+    Address.sin_family = AF_INET;
+    Address.sin_port = htons(PORT);
+    Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return ::connect(socket, reinterpret_cast<const sockaddr*>(&Address), sizeof(Address)) == 0;
+}
+
+// Blocking connection to the bench server on the loopback interface, or -1
+int Connect() {
+    auto const Socket = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (Socket < 0 || !ConnectSocket(Socket)) {
+        if (Socket >= 0) {
+            ::close(Socket);
+        }
+        return -1;
+    }
+    return Socket;
+}
+
+bool SendAll(int socket, std::string_view data) {
+    while (!data.empty()) {
+        auto const Sent = ::send(socket, data.data(), data.size(), MSG_NOSIGNAL);
+        if (Sent <= 0) {
+            return false;
+        }
+        data.remove_prefix(static_cast<std::size_t>(Sent));
+    }
+    return true;
+}
+
+// Client and server sockets both live in this process, so every stream takes two descriptors
+std::size_t RaiseDescriptorLimit() {
+    rlimit Limit{};
+    ::getrlimit(RLIMIT_NOFILE, &Limit);
+    Limit.rlim_cur = Limit.rlim_max;
+    ::setrlimit(RLIMIT_NOFILE, &Limit);
+    ::getrlimit(RLIMIT_NOFILE, &Limit);
+    return static_cast<std::size_t>(Limit.rlim_cur);
+}
+
+std::size_t ResidentBytes() {
+    std::ifstream Status("/proc/self/status");
+    std::string Line;
+    while (std::getline(Status, Line)) {
+        if (Line.starts_with("VmRSS:")) {
+            std::string_view Value(Line);
+            Value.remove_prefix(Value.find_first_not_of(" \t", 6));
+            std::size_t Kilobytes = 0;
+            std::from_chars(Value.data(), Value.data() + Value.size(), Kilobytes);
+            return Kilobytes * 1024;
+        }
+    }
+    return 0;
+}
+
+double CpuSeconds() {
+    rusage Usage{};
+    ::getrusage(RUSAGE_SELF, &Usage);
+    return static_cast<double>(Usage.ru_utime.tv_sec + Usage.ru_stime.tv_sec) +
+           (static_cast<double>(Usage.ru_utime.tv_usec + Usage.ru_stime.tv_usec) / 1e6);
+}
+
+// Size of one /api/stats response, head included; every response of the run has the same size
+std::size_t ResponseSize() {
+    auto const Socket = Connect();
+    if (Socket < 0 || !SendAll(Socket, STATS_REQUEST)) {
+        return 0;
+    }
+    std::string Received;
+    std::array<char, 16 * 1024> Buffer;
+    std::size_t Total = 0;
+    while (Total == 0 || Received.size() < Total) {
+        auto const Count = ::recv(Socket, Buffer.data(), Buffer.size(), 0);
+        if (Count <= 0) {
+            break;
+        }
+        Received.append(Buffer.data(), static_cast<std::size_t>(Count));
+        auto const HeadEnd = Received.find("\r\n\r\n");
+        auto const Length = Received.find("Content-Length: ");
+        if (Total == 0 && HeadEnd != std::string::npos && Length != std::string::npos) {
+            std::size_t Body = 0;
+            std::from_chars(Received.data() + Length + 16, Received.data() + HeadEnd, Body);
+            Total = HeadEnd + 4 + Body;
+        }
+    }
+    ::close(Socket);
+    return Received.starts_with("HTTP/1.1 200") && Received.size() == Total ? Total : 0;
+}
+
+struct StreamClient {
+    int socket = -1;
+    std::size_t frames = 0;  // "\n\n"-terminated frames seen so far
+    char last = 0;
+};
+
+// Reads the streams until every one of them has seen `frames` frames; false on timeout
+bool AwaitFrames(int epoll, std::vector<StreamClient>& clients, std::size_t frames) {
+    std::size_t Behind = 0;
+    for (const auto& Client : clients) {
+        Behind += Client.frames < frames ? 1 : 0;
+    }
+
+    std::array<epoll_event, 512> Events{};
+    std::array<char, 4096> Buffer;
+    auto const Deadline = Clock::now() + DELIVERY_TIMEOUT;
+    while (Behind != 0 && Clock::now() < Deadline) {
+        auto const Count = ::epoll_wait(epoll, Events.data(), static_cast<int>(Events.size()), 100);
+        for (int I = 0; I < Count; ++I) {
+            auto& Client = clients[Events[static_cast<std::size_t>(I)].data.u32];
+            auto const Received = ::recv(Client.socket, Buffer.data(), Buffer.size(), MSG_DONTWAIT);
+            for (std::size_t J = 0; J < static_cast<std::size_t>(std::max<ssize_t>(Received, 0)); ++J) {
+                if (Buffer[J] == '\n' && Client.last == '\n') {
+                    Behind -= ++Client.frames == frames ? 1 : 0;
+                    Client.last = 0;
+                } else {
+                    Client.last = Buffer[J];
+                }
+            }
+        }
+    }
+    return Behind == 0;
+}
+
+// `connections` keep-alive clients with up to `depth` requests in flight each, driven from one thread;
+// returns completed responses per second
+double DriveRequests(std::size_t connections, std::size_t depth, std::size_t responseSize, Clock::duration duration) {
+    struct Client {
+        int socket = -1;
+        std::size_t sent = 0;
+        std::size_t receivedBytes = 0;
+    };
+
+    std::string Batch;
+    for (std::size_t I = 0; I < depth; ++I) {
+        Batch += STATS_REQUEST;
+    }
+
+    auto const Epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    std::vector<Client> Clients(connections);
+    for (std::size_t I = 0; I < Clients.size(); ++I) {
+        Clients[I].socket = Connect();
+        epoll_event Event{.events = EPOLLIN, .data = {.u64 = I}};
+        ::epoll_ctl(Epoll, EPOLL_CTL_ADD, Clients[I].socket, &Event);
+        Clients[I].sent = SendAll(Clients[I].socket, Batch) ? depth : 0;
+    }
+
+    std::array<epoll_event, 64> Events{};
+    std::vector<char> Buffer(256 * 1024);
+    auto const Started = Clock::now();
+    while (Clock::now() - Started < duration) {
+        auto const Count = ::epoll_wait(Epoll, Events.data(), static_cast<int>(Events.size()), 10);
+        for (int I = 0; I < Count; ++I) {
+            auto& Each = Clients[Events[static_cast<std::size_t>(I)].data.u64];
+            auto const Received = ::recv(Each.socket, Buffer.data(), Buffer.size(), MSG_DONTWAIT);
+            if (Received <= 0) {
+                continue;
+            }
+            Each.receivedBytes += static_cast<std::size_t>(Received);
+
+            // Top the pipeline up once half of it has been answered
+            auto const InFlight = Each.sent - (Each.receivedBytes / responseSize);
+            if (InFlight <= depth / 2) {
+                auto const More = depth - InFlight;
+                SendAll(Each.socket, std::string_view(Batch).substr(0, More * STATS_REQUEST.size()));
+                Each.sent += More;
+            }
+        }
+    }
+    auto const Elapsed = std::chrono::duration<double>(Clock::now() - Started).count();
+
+    std::size_t Completed = 0;
+    for (const auto& Each : Clients) {
+        Completed += Each.receivedBytes / responseSize;
+        ::close(Each.socket);
+    }
+    ::close(Epoll);
+    return static_cast<double>(Completed) / Elapsed;
+}
+
+struct Exhaustion {
+    std::size_t stalled = 0;   // streams left in the listen backlog at the descriptor limit
+    double recoveryMs = -1.0;  // from closing the accepted streams until every stalled one got its first frame
+};
+
+// Lowers the descriptor limit so that only half of EXHAUSTION_CLIENTS streams can be accepted, then closes
+// those and times how long the server takes to accept and answer the ones left in the backlog
+Exhaustion ExhaustDescriptors(const EventHttpServer& server) {
+    // The server side of the earlier connections must be gone for the limit below to mean anything
+    auto const Deadline = Clock::now() + DELIVERY_TIMEOUT;
+    while (server.ConnectionCount() != 0 && Clock::now() < Deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+
+    // Descriptors are allocated lowest first, so everything the client needs is created before the limit
+    auto const Epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    std::vector<StreamClient> Clients(EXHAUSTION_CLIENTS);
+    int Highest = Epoll;
+    for (auto& Client : Clients) {
+        Client.socket = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        Highest = std::max(Highest, Client.socket);
+    }
+
+    rlimit Saved{};
+    ::getrlimit(RLIMIT_NOFILE, &Saved);
+    auto Lowered = Saved;
+    Lowered.rlim_cur = static_cast<rlim_t>(Highest) + 1 + (EXHAUSTION_CLIENTS / 2);
+    ::setrlimit(RLIMIT_NOFILE, &Lowered);
+
+    for (auto& Client : Clients) {
+        if (!ConnectSocket(Client.socket) || !SendAll(Client.socket, STREAM_REQUEST)) {
+            Client.socket = -1;
+        }
+    }
+    std::this_thread::sleep_for(FRAME_INTERVAL);
+
+    // A stream that got its first frame was accepted; the rest wait in the backlog
+    std::vector<StreamClient> Accepted;
+    std::vector<StreamClient> Stalled;
+    for (const auto& Client : Clients) {
+        char Byte = 0;
+        if (Client.socket < 0) {
+            continue;
+        }
+        if (::recv(Client.socket, &Byte, 1, MSG_DONTWAIT | MSG_PEEK) > 0) {
+            Accepted.push_back(Client);
+        } else {
+            epoll_event Event{.events = EPOLLIN, .data = {.u32 = static_cast<std::uint32_t>(Stalled.size())}};
+            ::epoll_ctl(Epoll, EPOLL_CTL_ADD, Client.socket, &Event);
+            Stalled.push_back(Client);
+        }
+    }
+
+    Exhaustion Measured{.stalled = Stalled.size()};
+    auto const Released = Clock::now();
+    for (const auto& Client : Accepted) {
+        ::close(Client.socket);
+    }
+    if (AwaitFrames(Epoll, Stalled, 1)) {
+        Measured.recoveryMs = std::chrono::duration<double, std::milli>(Clock::now() - Released).count();
+    }
+
+    ::setrlimit(RLIMIT_NOFILE, &Saved);
+    for (const auto& Client : Stalled) {
+        ::close(Client.socket);
+    }
+    ::close(Epoll);
+    return Measured;
+}
+
+}  // namespace
+#endif
+
+// The epoll front end holding `options.streams` idle /ws/stats streams: what they cost to keep open, how long
+// one published frame takes to reach all of them, and the /api/stats request rate of `options.clients`
+// keep-alive connections (one request at a time, then pipelined) while the streams stay connected. Finally,
+// whether streams queued while the server is out of descriptors are served once descriptors free up.
+void RunEventServerBench(const BenchOptions& options) {
+#if defined(__linux__)
+    auto const Limit = RaiseDescriptorLimit();
+    auto const Reserved = 256 + options.clients;
+    auto const Streams = std::min(options.streams, Limit > Reserved ? (Limit - Reserved) / 2 : 0);
+
+    auto const Rendered = json::Render(std::make_shared<const SystemStats>(MakeSyntheticStats(options.cores)));
+    StreamHub Hub;
+    EventHttpServer Server;
+    Server.Get("/api/stats", [&Rendered](const httplib::Request&, httplib::Response& res) {
+        SetSharedContent(res, RenderedStats::Share(Rendered, &RenderedStats::statsBody), "application/json");
+    });
+    Server.Stream("/ws/stats", [&Hub](const httplib::Request&, httplib::Response& res) {
+        res.set_header("Content-Type", "text/event-stream");
+        return EventHttpServer::StreamSource{.hub = &Hub,
+                                             .initial = std::make_shared<const std::string>("data: hello\n\n"),
+                                             .heartbeat = ": heartbeat\n\n",
+                                             .onFrame = nullptr};
+    });
+    if (!Server.Start("127.0.0.1", PORT)) {
+        std::cout << std::format("cannot listen on port {}\n", PORT);
+        return;
+    }
+
+    // Open the streams and wait for each one's initial frame
+    auto const ResidentBefore = ResidentBytes();
+    auto const ConnectStarted = Clock::now();
+    auto const Epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    std::vector<StreamClient> Clients;
+    Clients.reserve(Streams);
+    for (std::size_t I = 0; I < Streams; ++I) {
+        auto const Socket = Connect();
+        if (Socket < 0 || !SendAll(Socket, STREAM_REQUEST)) {
+            break;
+        }
+        epoll_event Event{.events = EPOLLIN, .data = {.u32 = static_cast<std::uint32_t>(I)}};
+        ::epoll_ctl(Epoll, EPOLL_CTL_ADD, Socket, &Event);
+        Clients.push_back(StreamClient{.socket = Socket});
+    }
+    auto const Opened = AwaitFrames(Epoll, Clients, 1);
+    auto const ConnectSeconds = std::chrono::duration<double>(Clock::now() - ConnectStarted).count();
+    auto const PerStream = Clients.empty() ? 0.0
+                                           : static_cast<double>(ResidentBytes() - ResidentBefore) /
+                                                 static_cast<double>(Clients.size());
+
+    // Nothing to send: the idle streams should cost no CPU
+    auto const CpuBefore = CpuSeconds();
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+    auto const IdleCpu = (CpuSeconds() - CpuBefore) * 100.0;
+
+    // Each published frame is one shared buffer written to every stream
+    std::vector<double> FanOutMs;
+    for (std::size_t Frame = 1; Frame <= FRAMES && Opened; ++Frame) {
+        auto const Published = Clock::now();
+        Hub.Publish(std::make_shared<const std::string>("data: frame " + std::to_string(Frame) + "\n\n"));
+        if (!AwaitFrames(Epoll, Clients, Frame + 1)) {
+            break;
+        }
+        FanOutMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - Published).count());
+        std::this_thread::sleep_for(FRAME_INTERVAL);
+    }
+    auto const StreamsOpen = Server.StreamCount();
+
+    auto const Size = ResponseSize();
+    auto const Budget = std::chrono::duration_cast<Clock::duration>(options.duration) / 2;
+    auto const SerialRate = Size == 0 ? 0.0 : DriveRequests(options.clients, 1, Size, Budget);
+    auto const PipelinedRate = Size == 0 ? 0.0 : DriveRequests(options.clients, PIPELINE_DEPTH, Size, Budget);
+
+    for (const auto& Client : Clients) {
+        ::close(Client.socket);
+    }
+    ::close(Epoll);
+    auto const Exhausted = ExhaustDescriptors(Server);
+    Server.Stop();
+
+    auto const FanOutMax = FanOutMs.empty() ? 0.0 : std::ranges::max(FanOutMs);
+    auto const FanOutMedian = Percentile(FanOutMs, 50);
+    std::cout << std::format("I/O threads                   : {:10}\n", Server.ThreadCount());
+    std::cout << std::format("idle streams open             : {:10} of {} (descriptor limit {})\n",
+                             StreamsOpen,
+                             options.streams,
+                             Limit);
+    std::cout << std::format("connect + first frame, all    : {:10.0f} ms\n", ConnectSeconds * 1000);
+    std::cout << std::format("resident memory per stream    : {:10.0f} bytes (client and server side)\n", PerStream);
+    std::cout << std::format("CPU while the streams idle    : {:10.2f} % of one core\n", IdleCpu);
+    std::cout << std::format("frame to every stream, median : {:10.1f} ms (max {:.1f} ms over {} frames)\n",
+                             FanOutMedian,
+                             FanOutMax,
+                             FanOutMs.size());
+    std::cout << std::format("/api/stats, one in flight     : {:10.0f} req/s over {} connections\n",
+                             SerialRate,
+                             options.clients);
+    std::cout << std::format("/api/stats, pipelined         : {:10.0f} req/s ({} in flight per connection)\n",
+                             PipelinedRate,
+                             PIPELINE_DEPTH);
+    if (Exhausted.recoveryMs < 0) {
+        std::cout << std::format("backlog at descriptor limit   : {:>10} ({} streams never served)\n",
+                                 "STALLED",
+                                 Exhausted.stalled);
+    } else {
+        std::cout << std::format("backlog at descriptor limit   : {:10.1f} ms to serve {} queued streams\n",
+                                 Exhausted.recoveryMs,
+                                 Exhausted.stalled);
+    }
+    Report("idle streams", static_cast<double>(StreamsOpen), "count");
+    Report("resident memory per stream", PerStream, "bytes");
+    Report("frame fan-out median", FanOutMedian, "ms");
+    Report("/api/stats keep-alive", SerialRate, "req/s");
+    Report("/api/stats pipelined", PipelinedRate, "req/s");
+    Report("backlog recovery at descriptor limit", Exhausted.recoveryMs, "ms");
+#else
+    (void)options;
+    std::cout << "the event server benchmark needs epoll (Linux)\n";
+#endif
+}
+
+}  // namespace pc_monitor::bench
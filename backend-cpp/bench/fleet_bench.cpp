@@ -0,0 +1,103 @@
+#include "bench_common.hpp"
+#include "fleet_aggregator.hpp"
+#include "web_server.hpp"
+
+#include <algorithm>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pc_monitor::bench {
+
+namespace {
+constexpr std::uint16_t FIRST_PORT = 3201;
+constexpr auto INTERVAL = std::chrono::milliseconds{200};
+constexpr auto TIMEOUT = std::chrono::milliseconds{300};
+constexpr auto SLOW_RESPONSE = std::chrono::milliseconds{1500};
+constexpr auto SAMPLE_EVERY = std::chrono::milliseconds{50};
+}  // namespace
+
+// `options.hosts` local upstreams serving a synthetic /api/stats, one of which answers well after the fetch
+// timeout and one of which is not listening at all. Measures how stale the healthy hosts get in the fleet
+// view while those two time out and back off, and how often the view is rendered.
+void RunFleetBench(const BenchOptions& options) {
+    auto const Hosts = std::max<std::size_t>(options.hosts, 3);
+    auto const Rendered = json::Render(std::make_shared<const SystemStats>(MakeSyntheticStats(options.cores)));
+
+    // Host 0 is slow, host 1 is down, the rest answer at once
+    std::vector<std::unique_ptr<httplib::Server>> Servers;
+    std::vector<std::thread> Listeners;
+    std::vector<UpstreamConfig> Upstreams;
+    for (std::size_t I = 0; I < Hosts; ++I) {
+        auto const Port = static_cast<std::uint16_t>(FIRST_PORT + I);
+        Upstreams.push_back(UpstreamConfig{.name = std::format("host-{}", I), .host = "localhost", .port = Port});
+        if (I == 1) {
+            continue;
+        }
+        auto& Server = *Servers.emplace_back(std::make_unique<httplib::Server>());
+        Server.Get("/api/stats", [&Rendered, Slow = I == 0](const httplib::Request&, httplib::Response& res) {
+            if (Slow) {
+                std::this_thread::sleep_for(SLOW_RESPONSE);
+            }
+            SetSharedContent(res, RenderedStats::Share(Rendered, &RenderedStats::statsBody), "application/json");
+        });
+        Listeners.emplace_back([&Server, Port]() { Server.listen("localhost", Port); });
+        Server.wait_until_ready();
+    }
+
+    FleetAggregator Fleet(std::move(Upstreams), {.interval = INTERVAL, .timeout = TIMEOUT, .maxBackoff = 4 * INTERVAL});
+    Fleet.Start();
+
+    // Worst age of a healthy host's last fetch across the run, once every host has been fetched
+    std::this_thread::sleep_for(4 * INTERVAL);
+    auto const FirstSequence = Fleet.Latest()->sequence;
+    auto const Started = std::chrono::steady_clock::now();
+    std::chrono::milliseconds WorstAge{0};
+    std::size_t Missing = 0;
+    while (std::chrono::steady_clock::now() - Started < options.duration) {
+        auto const View = Fleet.Latest();
+        for (std::size_t I = 2; I < Hosts; ++I) {
+            if (!View->hosts.contains(std::format("host-{}", I))) {
+                ++Missing;
+            }
+        }
+        auto const Now = std::chrono::system_clock::now();
+        auto const Rows = nlohmann::json::parse(View->body)["hosts"];
+        for (const auto& Row : Rows) {
+            if (Row["name"] != "host-0" && Row["name"] != "host-1" && Row.contains("lastSeen")) {
+                auto const Seen = std::chrono::system_clock::time_point{
+                    std::chrono::milliseconds{Row["lastSeen"].get<std::int64_t>()}};
+                WorstAge = std::max(WorstAge, std::chrono::duration_cast<std::chrono::milliseconds>(Now - Seen));
+            }
+        }
+        std::this_thread::sleep_for(SAMPLE_EVERY);
+    }
+    auto const Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Started).count();
+    auto const Last = Fleet.Latest();
+    auto const RendersPerSecond = static_cast<double>(Last->sequence - FirstSequence) / Elapsed;
+    auto const Rollup = nlohmann::json::parse(Last->body)["rollup"];
+
+    Fleet.Stop();
+    for (auto& Server : Servers) {
+        Server->stop();
+    }
+    for (auto& Listener : Listeners) {
+        Listener.join();
+    }
+
+    std::cout << std::format("upstreams (1 slow, 1 down)    : {:10}\n", Hosts);
+    std::cout << std::format("hosts up in the rollup        : {:10}\n", Rollup["up"].get<std::size_t>());
+    std::cout << std::format("worst healthy host age        : {:10} ms (interval {} ms)\n",
+                             WorstAge.count(),
+                             INTERVAL.count());
+    std::cout << std::format("healthy hosts missing a body  : {:10}\n", Missing);
+    std::cout << std::format("views rendered                : {:10.1f} /s\n", RendersPerSecond);
+    std::cout << std::format("/api/fleet body               : {:10} bytes\n", Last->body.size());
+    Report("worst healthy host age", static_cast<double>(WorstAge.count()), "ms");
+    Report("views rendered", RendersPerSecond, "1/s");
+}
+
+}  // namespace pc_monitor::bench
@@ -0,0 +1,87 @@
+#include "bench_common.hpp"
+#include "reference_json.hpp"
+#include "web_server.hpp"
+
+#include <atomic>
+#include <format>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace pc_monitor::bench {
+
+namespace {
+
+constexpr std::uint16_t PER_REQUEST_PORT = 3101;
+constexpr std::uint16_t RENDERED_PORT = 3102;
+
+// Keep-alive clients hammering one path; returns completed requests per second
+double DriveLoad(std::uint16_t port, const BenchOptions& options) {
+    std::atomic<std::uint64_t> Completed{0};
+    std::atomic<bool> Stop{false};
+
+    std::vector<std::thread> Clients;
+    Clients.reserve(options.clients);
+    for (std::size_t I = 0; I < options.clients; ++I) {
+        Clients.emplace_back([&]() {
+            httplib::Client Client("localhost", port);
+            Client.set_keep_alive(true);
+            while (!Stop.load(std::memory_order_relaxed)) {
+                if (auto Response = Client.Get("/api/stats"); Response && Response->status == 200) {
+                    Completed.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    auto const Started = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(options.duration);
+    Stop.store(true);
+    for (auto& Client : Clients) {
+        Client.join();
+    }
+
+    auto const Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Started).count();
+    return static_cast<double>(Completed.load()) / Elapsed;
+}
+
+double MeasureServer(httplib::Server& server, std::uint16_t port, const BenchOptions& options) {
+    std::thread Listener([&]() { server.listen("localhost", port); });
+    server.wait_until_ready();
+
+    auto const Rate = DriveLoad(port, options);
+
+    server.stop();
+    Listener.join();
+    return Rate;
+}
+
+}  // namespace
+
+// /api/stats throughput with per-request serialization (the old handler) against bodies rendered once
+// per sample and shared by every response
+void RunHttpBench(const BenchOptions& options) {
+    auto const Snapshot = std::make_shared<const SystemStats>(MakeSyntheticStats(options.cores));
+
+    httplib::Server PerRequest;
+    PerRequest.Get("/api/stats", [&](const httplib::Request&, httplib::Response& res) {
+        res.set_content(reference::ToJson(*Snapshot).dump(), "application/json");
+    });
+
+    auto const Rendered = json::Render(Snapshot);
+    httplib::Server Shared;
+    Shared.Get("/api/stats", [&](const httplib::Request&, httplib::Response& res) {
+        SetSharedContent(res, RenderedStats::Share(Rendered, &RenderedStats::statsBody), "application/json");
+    });
+
+    auto const PerRequestRate = MeasureServer(PerRequest, PER_REQUEST_PORT, options);
+    auto const RenderedRate = MeasureServer(Shared, RENDERED_PORT, options);
+
+    Report("/api/stats per-request ToJson", PerRequestRate, "req/s");
+    Report("/api/stats rendered once", RenderedRate, "req/s");
+    std::cout << std::format("/api/stats per-request ToJson : {:10.0f} req/s\n", PerRequestRate);
+    std::cout << std::format("/api/stats rendered once      : {:10.0f} req/s\n", RenderedRate);
+    std::cout << std::format("speedup                       : {:10.2f}x\n", RenderedRate / PerRequestRate);
+}
+
+}  // namespace pc_monitor::bench
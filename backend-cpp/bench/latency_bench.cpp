@@ -0,0 +1,142 @@
+#include "bench_common.hpp"
+#include "web_server.hpp"
+
+#include <atomic>
+#include <charconv>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace pc_monitor::bench {
+
+namespace {
+
+constexpr std::uint16_t HTTP_PORT = 3111;
+constexpr std::uint16_t WS_PORT = 3113;
+constexpr auto SAMPLE_INTERVAL = std::chrono::milliseconds{100};
+
+struct LoadResult {
+    std::vector<double> latencies;  // per request or per frame
+    double seconds = 0.0;
+};
+
+// Runs `clients` copies of `client` until the duration elapses; each appends to its own latency vector
+template <typename Client>
+LoadResult DriveClients(const BenchOptions& options, Client&& client) {
+    std::atomic<bool> Stop{false};
+    std::vector<std::vector<double>> PerClient(options.clients);
+    std::vector<std::thread> Threads;
+    Threads.reserve(options.clients);
+    for (auto& Latencies : PerClient) {
+        Threads.emplace_back([&]() { client(Stop, Latencies); });
+    }
+
+    auto const Started = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(options.duration / 2);
+    Stop.store(true);
+    for (auto& Thread : Threads) {
+        Thread.join();
+    }
+
+    LoadResult Result;
+    Result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Started).count();
+    for (auto& Latencies : PerClient) {
+        Result.latencies.insert(Result.latencies.end(), Latencies.begin(), Latencies.end());
+    }
+    return Result;
+}
+
+void PrintAndReport(std::string_view what, std::string_view unit, LoadResult& result, std::string_view rateUnit) {
+    auto const Count = result.latencies.size();
+    auto const Rate = static_cast<double>(Count) / result.seconds;
+    auto const P50 = Percentile(result.latencies, 50.0);
+    auto const P99 = Percentile(result.latencies, 99.0);
+    std::cout << std::format(
+        "{:<30}: p50 {:8.1f} {}, p99 {:8.1f} {}, {:10.0f} {}\n", what, P50, unit, P99, unit, Rate, rateUnit);
+    Report(std::format("{} p50", what), P50, unit);
+    Report(std::format("{} p99", what), P99, unit);
+    Report(std::format("{} throughput", what), Rate, rateUnit);
+}
+
+// Milliseconds from a stats frame's sample timestamp until it arrived; nullopt for heartbeats
+std::optional<double> FrameAgeMs(std::string_view frame) {
+    constexpr std::string_view KEY = R"("timestamp":)";
+    if (!frame.starts_with("data: ")) {
+        return std::nullopt;
+    }
+    auto const At = frame.find(KEY);
+    if (At == std::string_view::npos) {
+        return std::nullopt;
+    }
+    std::int64_t SampledMs = 0;
+    auto const* const First = frame.data() + At + KEY.size();
+    if (std::from_chars(First, frame.data() + frame.size(), SampledMs).ec != std::errc{}) {
+        return std::nullopt;
+    }
+    auto const NowUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+    return static_cast<double>(NowUs - SampledMs * 1000) / 1000.0;
+}
+
+}  // namespace
+
+// Loopback load against the real server: --clients keep-alive connections hammering /api/stats, then the
+// same number of clients on the /ws/stats event stream with a sample every 100 ms
+void RunLatencyBench(const BenchOptions& options) {
+    auto Monitor = std::make_shared<SystemMonitor>();
+    if (!Monitor->Initialize()) {
+        std::cout << "cannot initialize the system monitor\n";
+        return;
+    }
+    auto Sampler = std::make_shared<StatsSampler>(
+        Monitor, StatsSampler::Options{.cpuInterval = SAMPLE_INTERVAL, .memoryInterval = SAMPLE_INTERVAL});
+    if (!Sampler->Start()) {
+        std::cout << "cannot start the sampler\n";
+        return;
+    }
+    WebServer Server(Sampler, HTTP_PORT, WS_PORT);
+    if (!Server.Start()) {
+        std::cout << std::format("cannot listen on ports {} and {}\n", HTTP_PORT, WS_PORT);
+        Sampler->Stop();
+        return;
+    }
+
+    auto Requests = DriveClients(options, [](const std::atomic<bool>& stop, std::vector<double>& latencies) {
+        httplib::Client Client("localhost", HTTP_PORT);
+        Client.set_keep_alive(true);
+        while (!stop.load(std::memory_order_relaxed)) {
+            auto const Sent = std::chrono::steady_clock::now();
+            if (auto Response = Client.Get("/api/stats"); Response && Response->status == 200) {
+                latencies.push_back(
+                    std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - Sent).count());
+            }
+        }
+    });
+    PrintAndReport("/api/stats", "us", Requests, "req/s");
+
+    auto Frames = DriveClients(options, [](const std::atomic<bool>& stop, std::vector<double>& latencies) {
+        httplib::Client Client("localhost", HTTP_PORT);
+        std::string Pending;
+        (void)Client.Get("/ws/stats", [&](const char* data, std::size_t length) {
+            Pending.append(data, length);
+            for (auto End = Pending.find("\n\n"); End != std::string::npos; End = Pending.find("\n\n")) {
+                if (auto const Age = FrameAgeMs(std::string_view{Pending}.substr(0, End))) {
+                    latencies.push_back(*Age);
+                }
+                Pending.erase(0, End + 2);
+            }
+            return !stop.load(std::memory_order_relaxed);
+        });
+    });
+    PrintAndReport("/ws/stats sample-to-client", "ms", Frames, "frames/s");
+
+    Server.Stop();
+    Sampler->Stop();
+}
+
+}  // namespace pc_monitor::bench
@@ -0,0 +1,81 @@
+#include "bench_common.hpp"
+#include "perf_stats.hpp"
+
+#include <array>
+#include <atomic>
+#include <format>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pc_monitor::bench {
+
+namespace {
+constexpr std::size_t THREADS = 4;
+
+// What a straightforward shared histogram costs: one lock per event
+struct LockedHistogram {
+    std::mutex mutex;
+    std::array<std::uint64_t, perf::Buckets::COUNT> counts{};
+
+    void Record(std::uint64_t value) {
+        std::lock_guard<std::mutex> const Lock(mutex);
+        ++counts[perf::Buckets::Index(value)];
+    }
+};
+
+// Mean nanoseconds per event with THREADS threads recording at once
+template <typename Body>
+double ConcurrentNanosPerCall(std::chrono::nanoseconds budget, Body body) {
+    std::atomic<std::uint64_t> TotalNanos{0};
+    std::vector<std::jthread> Threads;
+    for (std::size_t T = 0; T < THREADS; ++T) {
+        Threads.emplace_back([&, T]() {
+            std::uint64_t Value = T;
+            auto const Nanos = NanosPerCall(budget, [&]() { body(Value++ % 100'000); });
+            TotalNanos.fetch_add(static_cast<std::uint64_t>(Nanos));
+        });
+    }
+    Threads.clear();
+    return static_cast<double>(TotalNanos.load()) / static_cast<double>(THREADS);
+}
+}  // namespace
+
+// Cost of the self-instrumentation probes: one event on its own thread, with THREADS threads recording into the
+// same histogram against a mutex-guarded one, and merging every shard for /debug/perf
+void RunPerfBench(const BenchOptions& options) {
+    if constexpr (!perf::ENABLED) {
+        std::cout << "built with PC_MONITOR_PERF=0, nothing to measure\n";
+        return;
+    }
+
+    auto const Budget = std::chrono::duration_cast<std::chrono::nanoseconds>(options.duration) / 5;
+    auto const Id = perf::Register("bench.record");
+
+    std::uint64_t Value = 0;
+    auto const RecordNanos = NanosPerCall(Budget, [&]() { perf::Record(Id, Value++ % 100'000); });
+    auto const TimerNanos = NanosPerCall(Budget, [&]() { perf::ScopedTimer const Timer(Id); });
+    auto const SharedNanos = ConcurrentNanosPerCall(Budget, [&](std::uint64_t value) { perf::Record(Id, value); });
+
+    LockedHistogram Locked;
+    auto const LockedNanos = ConcurrentNanosPerCall(Budget, [&](std::uint64_t value) { Locked.Record(value); });
+
+    std::size_t Histograms = 0;
+    auto const SummaryNanos = NanosPerCall(Budget, [&]() { Histograms = perf::Summaries().size(); });
+
+    std::cout << std::format("Record                        : {:10.1f} ns/op\n", RecordNanos);
+    std::cout << std::format("ScopedTimer                   : {:10.1f} ns/op\n", TimerNanos);
+    std::cout << std::format("Record, {} threads             : {:10.1f} ns/op\n", THREADS, SharedNanos);
+    std::cout << std::format("mutex histogram, {} threads    : {:10.1f} ns/op\n", THREADS, LockedNanos);
+    std::cout << std::format("Summaries                     : {:10.1f} us ({} histograms)\n",
+                             SummaryNanos / 1000.0,
+                             Histograms);
+    Report("Record", RecordNanos, "ns/op");
+    Report("ScopedTimer", TimerNanos, "ns/op");
+    Report("Record concurrent", SharedNanos, "ns/op");
+    Report("mutex histogram concurrent", LockedNanos, "ns/op");
+    Report("Summaries", SummaryNanos / 1000.0, "us");
+}
+
+}  // namespace pc_monitor::bench
@@ -0,0 +1,74 @@
+#include "bench_common.hpp"
+#include "process_monitor.hpp"
+
+#include <format>
+#include <iostream>
+#include <vector>
+
+#if defined(__linux__)
+    #include <csignal>
+
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
+
+namespace pc_monitor::bench {
+
+// Process-table scan cost with `options.processes` idle children on top of whatever the host runs; at the
+// 1 Hz sampling rate the per-scan time is also the share of one core the collector takes
+void RunProcessBench(const BenchOptions& options) {
+#if defined(__linux__)
+    std::vector<pid_t> Children;
+    Children.reserve(options.processes);
+    for (std::size_t I = 0; I < options.processes; ++I) {
+        auto const Child = fork();
+        if (Child == 0) {
+            pause();
+            _exit(0);
+        }
+        if (Child < 0) {
+            break;
+        }
+        Children.push_back(Child);
+    }
+
+    ProcessMonitor Monitor;
+    auto const InitStarted = std::chrono::steady_clock::now();
+    if (!Monitor.Initialize() || !Monitor.Scan()) {
+        std::cout << "cannot read /proc\n";
+    } else {
+        auto const InitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - InitStarted);
+        auto const Budget = std::chrono::duration_cast<std::chrono::nanoseconds>(options.duration) / 2;
+        auto const ScanNanos = NanosPerCall(Budget, [&]() { (void)Monitor.Scan(); });
+        auto const Table = Monitor.Latest();
+        std::size_t Sink = 0;
+        auto const TopNanos = NanosPerCall(Budget / 4, [&]() {
+            Sink += ProcessMonitor::Top(*Table, 20, ProcessSortKey::CPU).size();
+        });
+
+        Report("first scan", InitMs.count(), "ms");
+        Report("steady-state scan", ScanNanos / 1e6, "ms");
+        Report("top 20 by cpu", TopNanos / 1e3, "us");
+        std::cout << std::format("processes in table            : {:10} ({} spawned)\n",
+                                 Table->processes.size(),
+                                 Children.size());
+        std::cout << std::format("first scan (opens every pid)  : {:10.1f} ms\n", InitMs.count());
+        std::cout << std::format("steady-state scan             : {:10.2f} ms ({:.2f}% of one core at 1 Hz)\n",
+                                 ScanNanos / 1e6,
+                                 ScanNanos / 1e7);
+        std::cout << std::format("top 20 by cpu                 : {:10.0f} us (checksum {})\n", TopNanos / 1e3, Sink);
+    }
+
+    for (auto const Child : Children) {
+        kill(Child, SIGKILL);
+    }
+    for (auto const Child : Children) {
+        waitpid(Child, nullptr, 0);
+    }
+#else
+    (void)options;
+    std::cout << "the process benchmark forks its workload and needs Linux\n";
+#endif
+}
+
+}  // namespace pc_monitor::bench
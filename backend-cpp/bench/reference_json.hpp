@@ -0,0 +1,137 @@
+#pragma once
+
+// Standard library includes first
+#include <chrono>
+#include <ranges>
+
+// Third-party includes
+#include <nlohmann/json.hpp>
+
+// Local includes last
+#include "system_monitor.hpp"
+
+// The nlohmann DOM serializers the field-table writer replaced, kept as the reference the benches compare
+// the wire layout and cost against. Nothing outside bench/ may depend on them.
+namespace pc_monitor::bench::reference {
+
+inline nlohmann::json ToJson(const CPUCoreData& core) {
+    nlohmann::json Result{{"coreId", core.coreId}, {"usage", core.usage}, {"frequency", core.frequency}};
+    if (core.temperature.has_value()) {
+        Result["temperature"] = *core.temperature;
+    }
+    return Result;
+}
+
+inline nlohmann::json ToJson(const CpuPackageThermal& package) {
+    nlohmann::json Result{
+        {"package", package.package}, {"temperature", package.temperature}, {"throttling", package.throttling}};
+    if (package.critical.has_value()) {
+        Result["critical"] = *package.critical;
+    }
+    return Result;
+}
+
+inline nlohmann::json ToJson(const CPUUsageData& cpu) {
+    nlohmann::json CoresJson = nlohmann::json::array();
+
+    // Use C++23 ranges for transformation
+    auto CoreJsons = cpu.cores | std::views::transform([](const auto& core) { return ToJson(core); });
+
+    for (const auto& CoreJson : CoreJsons) {
+        CoresJson.push_back(CoreJson);
+    }
+
+    nlohmann::json PackagesJson = nlohmann::json::array();
+    for (const auto& Package : cpu.packages) {
+        PackagesJson.push_back(ToJson(Package));
+    }
+
+    nlohmann::json Result{{"overall", cpu.overall},
+                          {"averageFrequency", cpu.averageFrequency},
+                          {"cores", std::move(CoresJson)},
+                          {"packages", std::move(PackagesJson)},
+                          {"throttling", cpu.throttling}};
+
+    if (cpu.temperature.has_value()) {
+        Result["temperature"] = *cpu.temperature;
+    }
+
+    return Result;
+}
+
+inline nlohmann::json ToJson(const PressureStall& stall) {
+    return nlohmann::json{
+        {"avg10", stall.avg10}, {"avg60", stall.avg60}, {"avg300", stall.avg300}, {"total", stall.total}};
+}
+
+inline nlohmann::json ToJson(const ResourcePressure& pressure) {
+    nlohmann::json Result{{"some", ToJson(pressure.some)}};
+    if (pressure.full.has_value()) {
+        Result["full"] = ToJson(*pressure.full);
+    }
+    return Result;
+}
+
+inline nlohmann::json ToJson(const MemoryUsageData& memory) {
+    nlohmann::json Result{{"total", memory.total},
+                          {"used", memory.used},
+                          {"available", memory.available},
+                          {"cache", memory.cache},
+                          {"buffers", memory.buffers},
+                          {"usagePercent", memory.usagePercent},
+                          {"slab", memory.slab},
+                          {"dirty", memory.dirty},
+                          {"writeback", memory.writeback},
+                          {"swapTotal", memory.swapTotal},
+                          {"swapUsed", memory.swapUsed},
+                          {"hugePagesTotal", memory.hugePagesTotal},
+                          {"hugePagesFree", memory.hugePagesFree}};
+    if (memory.pressure.has_value()) {
+        Result["pressure"] = nlohmann::json{{"cpu", ToJson(memory.pressure->cpu)},
+                                            {"io", ToJson(memory.pressure->io)},
+                                            {"memory", ToJson(memory.pressure->memory)}};
+    }
+    return Result;
+}
+
+inline nlohmann::json ToJson(const DiskDeviceData& disk) {
+    return nlohmann::json{{"name", disk.name},
+                          {"readBytesPerSec", disk.readBytesPerSec},
+                          {"writeBytesPerSec", disk.writeBytesPerSec},
+                          {"readsPerSec", disk.readsPerSec},
+                          {"writesPerSec", disk.writesPerSec},
+                          {"queueDepth", disk.queueDepth},
+                          {"utilization", disk.utilization}};
+}
+
+inline nlohmann::json ToJson(const NetworkInterfaceData& nic) {
+    return nlohmann::json{{"name", nic.name},
+                          {"rxBytesPerSec", nic.rxBytesPerSec},
+                          {"txBytesPerSec", nic.txBytesPerSec},
+                          {"rxPacketsPerSec", nic.rxPacketsPerSec},
+                          {"txPacketsPerSec", nic.txPacketsPerSec},
+                          {"errorsPerSec", nic.errorsPerSec},
+                          {"dropsPerSec", nic.dropsPerSec}};
+}
+
+inline nlohmann::json ToJson(const SystemStats& stats) {
+    auto TimestampMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(stats.timestamp.time_since_epoch()).count();
+
+    nlohmann::json Disks = nlohmann::json::array();
+    for (const auto& Disk : stats.disks) {
+        Disks.push_back(ToJson(Disk));
+    }
+    nlohmann::json Network = nlohmann::json::array();
+    for (const auto& Interface : stats.network) {
+        Network.push_back(ToJson(Interface));
+    }
+
+    return nlohmann::json{{"cpu", ToJson(stats.cpu)},
+                          {"disks", std::move(Disks)},
+                          {"memory", ToJson(stats.memory)},
+                          {"network", std::move(Network)},
+                          {"timestamp", TimestampMs}};
+}
+
+}  // namespace pc_monitor::bench::reference
@@ -0,0 +1,144 @@
+#include "bench_common.hpp"
+#include "collector_backend.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <vector>
+
+namespace pc_monitor::bench {
+
+namespace {
+constexpr std::size_t SAMPLES = 120;
+
+// Collects every sample of a stepped replay once; Initialize() already consumed the first two
+std::vector<SystemStats> CollectAll(SystemMonitor& monitor) {
+    std::vector<SystemStats> Collected;
+    for (std::size_t I = 2; I < SAMPLES; ++I) {
+        if (auto Stats = monitor.GetCurrentStats()) {
+            Collected.push_back(std::move(*Stats));
+        }
+    }
+    return Collected;
+}
+}  // namespace
+
+// A synthetic --cores host replayed through the real procfs parser: capture size and load time, collection
+// cost at that scale, recording overhead, whether a recorded replay reproduces the same samples, how many of
+// them the heat soak throttles, and what the default interface filter saves on a host with one veth per cpu
+void RunReplayBench(const BenchOptions& options) {
+    auto const Budget = std::chrono::duration_cast<std::chrono::nanoseconds>(options.duration) / 4;
+    auto const Path = std::filesystem::temp_directory_path() / "pc-monitor-bench.capture";
+    auto const RecordedPath = std::filesystem::temp_directory_path() / "pc-monitor-bench-recorded.capture";
+
+    auto const Generated = MakeSyntheticCapture(options.cores, SAMPLES, std::chrono::seconds{1});
+    if (!Generated.Save(Path)) {
+        std::cout << "cannot write " << Path.string() << '\n';
+        return;
+    }
+    auto const FileBytes = std::filesystem::file_size(Path);
+
+    auto const LoadStarted = std::chrono::steady_clock::now();
+    auto Loaded = CollectorCapture::Load(Path);
+    auto const LoadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - LoadStarted);
+    if (!Loaded || Loaded->records.size() != Generated.records.size()) {
+        std::cout << "capture did not survive a save/load round trip\n";
+        return;
+    }
+    auto const Capture = std::make_shared<const CollectorCapture>(std::move(*Loaded));
+
+    SystemMonitor Replayed(std::make_unique<ReplayBackend>(Capture, ReplayBackend::Options{.speed = 0.0}));
+    if (!Replayed.Initialize()) {
+        std::cout << "cannot replay the capture\n";
+        return;
+    }
+    std::size_t Sink = 0;
+    auto const ReplayNanos = NanosPerCall(Budget, [&]() {
+        if (auto Stats = Replayed.GetCurrentStats()) {
+            Sink += Stats->cpu.cores.size();
+        }
+    });
+
+    // Recording wraps a stepped replay of the same capture, so the difference is the cost of capturing every
+    // raw read; a fixed number of samples keeps the file small
+    std::vector<SystemStats> Original;
+    double RecordNanos = 0.0;
+    {
+        SystemMonitor Recording(std::make_unique<RecordingBackend>(
+            std::make_unique<ReplayBackend>(Capture, ReplayBackend::Options{.speed = 0.0, .loop = false}),
+            RecordedPath));
+        if (Recording.Initialize()) {
+            auto const Started = std::chrono::steady_clock::now();
+            Original = CollectAll(Recording);
+            RecordNanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - Started).count() /
+                          static_cast<double>(std::max<std::size_t>(Original.size(), 1));
+        }
+    }
+
+    // Replaying the recording has to give back the very same samples
+    std::vector<SystemStats> Rerun;
+    if (auto Recorded = CollectorCapture::Load(RecordedPath)) {
+        SystemMonitor Again(std::make_unique<ReplayBackend>(std::make_shared<const CollectorCapture>(*Recorded),
+                                                            ReplayBackend::Options{.speed = 0.0}));
+        if (Again.Initialize()) {
+            Rerun = CollectAll(Again);
+        }
+    }
+    auto const Reproduced = std::ranges::equal(Original, Rerun, [](const SystemStats& left, const SystemStats& right) {
+        return left.cpu == right.cpu && left.memory == right.memory && left.disks == right.disks &&
+               left.network == right.network;
+    });
+
+    auto const Throttled =
+        std::ranges::count_if(Original, [](const SystemStats& stats) { return stats.cpu.throttling; });
+
+    // Same replay, with the default interface filter and with every interface kept
+    auto const NetworkNanos = [&](DeviceFilter filter, std::size_t& interfaces) {
+        SystemMonitor Monitor(std::make_unique<ReplayBackend>(Capture, ReplayBackend::Options{.speed = 0.0}));
+        Monitor.SetDeviceFilters(DeviceFilter::DefaultDisks(), std::move(filter));
+        if (!Monitor.Initialize()) {
+            return 0.0;
+        }
+        return NanosPerCall(Budget, [&]() {
+            if (auto Network = Monitor.GetNetworkStats()) {
+                interfaces = Network->size();
+            }
+        });
+    };
+    std::size_t FilteredInterfaces = 0;
+    std::size_t AllInterfaces = 0;
+    auto const FilteredNanos = NetworkNanos(DeviceFilter::DefaultNetwork(), FilteredInterfaces);
+    auto const AllNanos = NetworkNanos(DeviceFilter{}, AllInterfaces);
+
+    auto const BytesPerSample = static_cast<double>(FileBytes) / static_cast<double>(SAMPLES);
+    std::cout << std::format("capture per sample            : {:10.1f} KiB ({} records, load {:.1f} ms)\n",
+                             BytesPerSample / 1024.0,
+                             Capture->records.size(),
+                             LoadMs.count());
+    std::cout << std::format("GetCurrentStats replayed      : {:10.0f} ns/op ({} cores)\n", ReplayNanos, options.cores);
+    std::cout << std::format("GetCurrentStats recording     : {:10.0f} ns/op\n", RecordNanos);
+    std::cout << std::format(
+        "network, default filter       : {:10.0f} ns/op ({} interfaces kept)\n", FilteredNanos, FilteredInterfaces);
+    std::cout << std::format(
+        "network, all interfaces       : {:10.0f} ns/op ({} interfaces)\n", AllNanos, AllInterfaces);
+    std::cout << std::format("throttled samples             : {:10} of {} ({} packages)\n",
+                             Throttled,
+                             Original.size(),
+                             Original.empty() ? 0 : Original.front().cpu.packages.size());
+    std::cout << std::format("recorded replay reproduces    : {} ({} samples, checksum {})\n",
+                             Reproduced && !Original.empty() ? "yes" : "NO",
+                             Original.size(),
+                             Sink % 997);
+    Report("capture per sample", BytesPerSample / 1024.0, "KiB");
+    Report("capture load", LoadMs.count(), "ms");
+    Report("GetCurrentStats replayed", ReplayNanos, "ns/op");
+    Report("GetCurrentStats recording", RecordNanos, "ns/op");
+    Report("GetNetworkStats default filter", FilteredNanos, "ns/op");
+    Report("GetNetworkStats all interfaces", AllNanos, "ns/op");
+
+    std::filesystem::remove(Path);
+    std::filesystem::remove(RecordedPath);
+}
+
+}  // namespace pc_monitor::bench
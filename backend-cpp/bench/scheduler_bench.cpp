@@ -0,0 +1,126 @@
+#include "bench_common.hpp"
+#include "stats_sampler.hpp"
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+#include <format>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace pc_monitor::bench {
+
+namespace {
+constexpr auto INTERVAL = std::chrono::milliseconds{100};
+constexpr auto COLLECTION_COST = std::chrono::milliseconds{15};  // about one 5,000-process scan
+
+void PrintTask(const SamplingTaskStats& task, std::chrono::nanoseconds elapsed) {
+    auto const Expected = task.intervalMs == 0 ? 1 : elapsed / std::chrono::milliseconds{task.intervalMs};
+    std::cout << std::format("  {:<8} every {:4} ms : {:5} runs of {:5} expected, jitter mean {:6} us max {:6} us, "
+                             "{} missed\n",
+                             task.name,
+                             task.intervalMs,
+                             task.runs,
+                             Expected,
+                             task.meanJitterUs,
+                             task.maxJitterUs,
+                             task.missed);
+}
+}  // namespace
+
+// Interval accuracy of a sleep-after-work loop against the deadline scheduler with a collection that takes
+// COLLECTION_COST, the idle back-off and wake-up path, and the cost of the timer wheel itself
+void RunSchedulerBench(const BenchOptions& options) {
+    auto const Budget = std::chrono::duration_cast<std::chrono::nanoseconds>(options.duration) / 2;
+
+    // What the stream loops did: collect, then sleep a full interval
+    std::size_t SleepRuns = 0;
+    auto const SleepStarted = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - SleepStarted < Budget) {
+        std::this_thread::sleep_for(COLLECTION_COST);
+        ++SleepRuns;
+        std::this_thread::sleep_for(INTERVAL);
+    }
+    auto const SleepElapsed = std::chrono::steady_clock::now() - SleepStarted;
+    std::cout << std::format("sleep_for loop, {} ms interval: {:5} runs of {:5} expected ({:.1f} ms drift per run)\n",
+                             INTERVAL.count(),
+                             SleepRuns,
+                             SleepElapsed / INTERVAL,
+                             std::chrono::duration<double, std::milli>(SleepElapsed).count() /
+                                     static_cast<double>(SleepRuns) -
+                                 static_cast<double>(INTERVAL.count()));
+
+    auto Monitor = std::make_shared<SystemMonitor>();
+    if (!Monitor->Initialize()) {
+        std::cout << "cannot initialize the system monitor\n";
+        return;
+    }
+
+    StatsSampler Sampler(Monitor,
+                         StatsSampler::Options{.cpuInterval = INTERVAL,
+                                               .memoryInterval = INTERVAL * 5,
+                                               .idleInterval = std::chrono::seconds{1},
+                                               .idleAfter = std::chrono::hours{1}});
+    if (!Sampler.Start()) {
+        std::cout << "cannot start the sampler\n";
+        return;
+    }
+    auto const Work = Sampler.AddTask("work", INTERVAL, []() { std::this_thread::sleep_for(COLLECTION_COST); });
+    auto const SamplerStarted = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(Budget);
+    auto const SamplerElapsed = std::chrono::steady_clock::now() - SamplerStarted;
+    std::cout << "deadline scheduler:\n";
+    for (const auto& Task : Sampler.TaskStats()) {
+        PrintTask(Task, SamplerElapsed);
+    }
+    Sampler.RemoveTask(Work);
+    Sampler.Stop();
+
+    // Back off after 300 ms without demand, then measure how soon a new client gets a fresh sample
+    StatsSampler Idle(Monitor,
+                      StatsSampler::Options{.cpuInterval = INTERVAL,
+                                            .memoryInterval = INTERVAL,
+                                            .idleInterval = std::chrono::seconds{2},
+                                            .idleAfter = std::chrono::milliseconds{300}});
+    (void)Idle.Start();
+    std::this_thread::sleep_for(std::chrono::seconds{1});
+    auto const IdleSequence = Idle.Sequence();
+    std::this_thread::sleep_for(std::chrono::seconds{2});
+    auto const IdleSamples = Idle.Sequence() - IdleSequence;
+
+    auto const Before = Idle.Sequence();
+    auto const DemandAt = std::chrono::steady_clock::now();
+    Idle.NoteDemand();
+    while (Idle.Sequence() == Before) {
+        std::this_thread::yield();
+    }
+    auto const WakeUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - DemandAt);
+    std::cout << std::format("idle back-off                 : {:10} samples in 2 s (was {} while active)\n",
+                             IdleSamples,
+                             std::chrono::seconds{2} / INTERVAL);
+    std::cout << std::format("fresh sample after demand     : {:10.0f} us\n", WakeUs.count());
+    Report("fresh sample after demand", WakeUs.count(), "us");
+    Idle.Stop();
+
+    // Wheel cost: a full set of timers scheduled and expired one tick at a time
+    constexpr std::size_t TIMERS = 10'000;
+    std::vector<TimerWheel::Entry> Due;
+    Due.reserve(TIMERS);
+    auto const Origin = TimerWheel::Clock::now();
+    auto const WheelNanos = NanosPerCall(Budget / 4, [&]() {
+        TimerWheel Wheel(Origin);
+        for (std::size_t I = 0; I < TIMERS; ++I) {
+            Wheel.Schedule(I, Origin + std::chrono::milliseconds{(I * 7) % 10'000});
+        }
+        Due.clear();
+        for (auto Now = Origin; Wheel.Size() != 0; Now += TimerWheel::TICK) {
+            Wheel.Expire(Now, Due);
+        }
+    });
+    std::cout << std::format("timer wheel schedule + expire : {:10.0f} ns per timer ({} timers over 10 s)\n",
+                             WheelNanos / static_cast<double>(TIMERS),
+                             Due.size());
+    Report("timer wheel schedule + expire", WheelNanos / static_cast<double>(TIMERS), "ns/timer");
+}
+
+}  // namespace pc_monitor::bench
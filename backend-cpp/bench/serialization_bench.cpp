@@ -0,0 +1,112 @@
+#include "bench_common.hpp"
+#include "binary_codec.hpp"
+#include "json_writer.hpp"
+#include "prometheus.hpp"
+#include "reference_json.hpp"
+#include "stats_history.hpp"
+#include "web_server.hpp"
+
+#include <format>
+#include <iostream>
+#include <memory>
+
+namespace pc_monitor::bench {
+
+// SystemStats serialization through the nlohmann DOM against the field-table writer into a reused buffer
+void RunSerializationBench(const BenchOptions& options) {
+    auto const Stats = MakeSyntheticStats(options.cores);
+    auto const Budget = std::chrono::duration_cast<std::chrono::nanoseconds>(options.duration) / 2;
+
+    std::size_t Sink = 0;
+    auto const DomNanos = NanosPerCall(Budget, [&]() { Sink += reference::ToJson(Stats).dump().size(); });
+
+    std::string Buffer;
+    auto const WriterNanos = NanosPerCall(Budget, [&]() {
+        Buffer.clear();
+        json::AppendJson(Buffer, Stats);
+        Sink += Buffer.size();
+    });
+
+    bool const Equivalent = nlohmann::json::parse(Buffer) == reference::ToJson(Stats);
+
+    Report("SystemStats ToJson().dump()", DomNanos, "ns/op");
+    Report("SystemStats AppendJson", WriterNanos, "ns/op");
+    std::cout << std::format("SystemStats ToJson().dump()   : {:10.0f} ns/op\n", DomNanos);
+    std::cout << std::format("SystemStats AppendJson        : {:10.0f} ns/op\n", WriterNanos);
+    std::cout << std::format("speedup                       : {:10.2f}x\n", DomNanos / WriterNanos);
+    std::cout << std::format("output equivalent             : {} ({} bytes, checksum {})\n",
+                             Equivalent ? "yes" : "NO",
+                             Buffer.size(),
+                             Sink % 997);
+
+    // Everything rendered once per sample; /api/stats is composed from the /api/cpu and /api/memory bodies
+    auto const Snapshot = std::make_shared<const SystemStats>(Stats);
+    bool Composed = false;
+    auto const RenderNanos = NanosPerCall(Budget, [&]() {
+        auto const Rendered = json::Render(Snapshot);
+        Composed = Rendered->statsBody == Buffer;
+        Sink += Rendered->statsBody.size();
+    });
+    Report("json::Render, all bodies", RenderNanos, "ns/op");
+    std::cout << std::format("json::Render, all bodies      : {:10.0f} ns/op (/api/stats identical: {})\n",
+                             RenderNanos,
+                             Composed ? "yes" : "NO");
+
+    // Binary wire format against the JSON writer, for one snapshot and for a full history range
+    std::string Binary;
+    auto const BinaryNanos = NanosPerCall(Budget, [&]() {
+        Binary.clear();
+        binary::AppendStats(Binary, Stats);
+        Sink += Binary.size();
+    });
+    Report("SystemStats binary", BinaryNanos, "ns/op");
+    std::cout << std::format("SystemStats binary            : {:10.0f} ns/op, {} bytes ({:.1f}x smaller than JSON)\n",
+                             BinaryNanos,
+                             Binary.size(),
+                             static_cast<double>(Buffer.size()) / static_cast<double>(Binary.size()));
+
+    // Prometheus text with the per-core prefixes already built, as rendered once per sample for /metrics
+    PrometheusRenderer Prometheus;
+    std::size_t PrometheusBytes = 0;
+    auto const PrometheusNanos = NanosPerCall(Budget, [&]() {
+        PrometheusBytes = Prometheus.Render(Stats)->size();
+        Sink += PrometheusBytes;
+    });
+    Report("SystemStats Prometheus", PrometheusNanos, "ns/op");
+    std::cout << std::format(
+        "SystemStats Prometheus        : {:10.0f} ns/op, {} bytes\n", PrometheusNanos, PrometheusBytes);
+
+    // Ten minutes of 1 s buckets with slowly varying load
+    StatsHistory History;
+    auto Sample = Stats;
+    for (int Second = 0; Second < 600; ++Second) {
+        Sample.timestamp = Stats.timestamp + std::chrono::seconds{Second};
+        Sample.cpu.overall = 40.0 + static_cast<double>(Second % 20);
+        for (auto& Core : Sample.cpu.cores) {
+            Core.usage = static_cast<double>((Core.coreId * 7 + static_cast<std::uint32_t>(Second)) % 1000) / 10.0;
+        }
+        History.Append(Sample);
+    }
+
+    std::string Range;
+    auto RangeNanos = [&](WireFormat format) {
+        return NanosPerCall(Budget / 4, [&]() {
+            Range.clear();
+            History.AppendRange(Range, std::chrono::minutes{10}, std::chrono::seconds{1}, format);
+            Sink += Range.size();
+        });
+    };
+    auto const JsonRangeNanos = RangeNanos(WireFormat::JSON);
+    auto const JsonRangeBytes = Range.size();
+    auto const BinaryRangeNanos = RangeNanos(WireFormat::BINARY);
+    Report("history 10m/1s JSON", JsonRangeNanos, "ns/op");
+    Report("history 10m/1s binary", BinaryRangeNanos, "ns/op");
+    std::cout << std::format(
+        "history 10m/1s JSON           : {:10.0f} ns/op, {} bytes\n", JsonRangeNanos, JsonRangeBytes);
+    std::cout << std::format("history 10m/1s binary         : {:10.0f} ns/op, {} bytes ({:.1f}x smaller)\n",
+                             BinaryRangeNanos,
+                             Range.size(),
+                             static_cast<double>(JsonRangeBytes) / static_cast<double>(Range.size()));
+}
+
+}  // namespace pc_monitor::bench
@@ -0,0 +1,71 @@
+#include "bench_common.hpp"
+#include "metrics_store.hpp"
+
+#include <filesystem>
+#include <format>
+#include <iostream>
+
+namespace pc_monitor::bench {
+
+// One simulated day of 1-second samples: append cost, disk footprint, full-day range read and reopen scan
+void RunStoreBench(const BenchOptions& options) {
+    constexpr std::size_t SAMPLES_PER_DAY = 86'400;
+    auto const Directory = std::filesystem::temp_directory_path() / "pc-monitor-bench-store";
+    std::filesystem::remove_all(Directory);
+
+    auto Stats = MakeSyntheticStats(options.cores);
+    auto const Start = Stats.timestamp;
+    double AppendSeconds = 0.0;
+    std::size_t DiskBytes = 0;
+    {
+        MetricsStore Store(MetricsStore::Options{.directory = Directory});
+        if (!Store.Open()) {
+            std::cout << "cannot open store in " << Directory.string() << '\n';
+            return;
+        }
+
+        auto const Started = std::chrono::steady_clock::now();
+        for (std::size_t I = 0; I < SAMPLES_PER_DAY; ++I) {
+            Stats.timestamp = Start + std::chrono::seconds{I};
+            Stats.cpu.cores[I % Stats.cpu.cores.size()].usage = static_cast<double>(I % 1000) / 10.0;
+            (void)Store.Append(Stats);
+        }
+        AppendSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Started).count();
+        DiskBytes = Store.DiskBytes();
+    }
+
+    // Reopening runs the same scan as crash recovery
+    MetricsStore Store(MetricsStore::Options{.directory = Directory});
+    auto const OpenStarted = std::chrono::steady_clock::now();
+    (void)Store.Open();
+    auto const OpenMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - OpenStarted);
+
+    SystemStats Decoded;
+    std::size_t Visited = 0;
+    double OverallSum = 0.0;
+    auto const QueryStarted = std::chrono::steady_clock::now();
+    Store.Query(Start, Start + std::chrono::hours{24}, [&](const StoredSample& sample) {
+        sample.Decode(Decoded);
+        OverallSum += Decoded.cpu.cores.front().usage;
+        ++Visited;
+    });
+    auto const QueryMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - QueryStarted);
+
+    Report("append", AppendSeconds * 1e9 / static_cast<double>(SAMPLES_PER_DAY), "ns/sample");
+    Report("disk per day", static_cast<double>(DiskBytes) / (1024.0 * 1024.0), "MiB");
+    Report("reopen + tail scan", OpenMs.count(), "ms");
+    Report("query + decode one day", QueryMs.count(), "ms");
+    std::cout << std::format("append                        : {:10.0f} ns/sample\n",
+                             AppendSeconds * 1e9 / static_cast<double>(SAMPLES_PER_DAY));
+    std::cout << std::format("disk per day (segments mapped): {:10.1f} MiB\n",
+                             static_cast<double>(DiskBytes) / (1024.0 * 1024.0));
+    std::cout << std::format("reopen + tail scan            : {:10.1f} ms\n", OpenMs.count());
+    std::cout << std::format("query + decode one day        : {:10.1f} ms ({} samples, checksum {:.0f})\n",
+                             QueryMs.count(),
+                             Visited,
+                             OverallSum);
+
+    std::filesystem::remove_all(Directory);
+}
+
+}  // namespace pc_monitor::bench
@@ -0,0 +1,89 @@
+#pragma once
+
+// Standard library includes first
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Local includes last
+#include "system_monitor.hpp"
+
+namespace pc_monitor {
+
+// One threshold rule from the rules file. Per-core, per-package and per-device metrics apply it to every
+// core, package or device (disk and network rules to those `devices` matches); each of those is tracked apart.
+struct AlertRule {
+    std::string name;
+    std::string metric;  // "cpu.core.usage", "memory.available", "disk.utilization", ... (see AlertEngine)
+    bool above = true;   // fires above the threshold, or below it
+    double threshold{};
+    double clear{};  // hysteresis: a firing alert resolves once the value is back past this level
+    std::chrono::milliseconds hold{};  // the condition has to hold this long before the alert fires
+    std::string severity = "warning";
+    DeviceFilter devices{};
+};
+
+// A rule instance that started or stopped firing
+struct AlertEvent {
+    std::string rule;
+    std::string metric;
+    std::string instance;  // core id, package id or device name; empty for host-wide metrics
+    std::string severity;
+    std::string_view state;  // "firing" or "resolved"
+    double value{};          // the value that caused the transition; NaN when its core or device went away
+    double threshold{};
+    std::chrono::system_clock::time_point since{};  // when the condition started to hold
+    std::chrono::system_clock::time_point timestamp{};
+};
+
+// Threshold rules evaluated incrementally on every published sample. Rules are compiled once per core and
+// device layout into a flat array of checks, one per rule instance, with the comparison folded into a sign so
+// evaluating a check is a load, a multiply and two compares. Each check keeps O(1) state: when its condition
+// started to hold and whether it fires.
+//
+// Rules file: {"rules":[{"name":"busy-core","metric":"cpu.core.usage","above":95,"for":"30s","clear":90},
+// {"name":"low-memory","metric":"memory.available","below":2147483648,"severity":"critical"},
+// {"name":"slow-disk","metric":"disk.utilization","above":90,"for":"1m","devices":"nvme*"}]}
+// "for" takes "90", "90s", "5m" or "1h" and defaults to 0; "clear" defaults to the threshold.
+class AlertEngine {
+public:
+    // Config errors are reported with the offending rule, so they carry a message instead of a SystemError
+    static std::expected<std::vector<AlertRule>, std::string> Parse(std::string_view config);
+    static std::expected<std::vector<AlertRule>, std::string> Load(const std::filesystem::path& path);
+
+    // Rules come from Parse, so their metrics are known
+    explicit AlertEngine(std::vector<AlertRule> rules);
+    ~AlertEngine();
+
+    AlertEngine(const AlertEngine&) = delete;
+    AlertEngine& operator=(const AlertEngine&) = delete;
+    AlertEngine(AlertEngine&&) = delete;
+    AlertEngine& operator=(AlertEngine&&) = delete;
+
+    // Appends the transitions `stats` causes to `events`; not reentrant, called from the sampler thread only
+    void Evaluate(const SystemStats& stats, std::vector<AlertEvent>& events);
+
+    // Alerts firing as of the last Evaluate(), in rule order. Built on request rather than after every
+    // transition, so a flapping rule costs the sampler nothing beyond its events; safe from any thread.
+    [[nodiscard]] std::vector<AlertEvent> Firing() const;
+
+    [[nodiscard]] std::size_t RuleCount() const noexcept;
+
+    // Rule instances in the current plan
+    [[nodiscard]] std::size_t CheckCount() const;
+
+private:
+    class Plan;
+    std::unique_ptr<Plan> plan_;  // guarded by mutex_; only the sampler thread and readers of Firing() take it
+    mutable std::mutex mutex_;
+    std::chrono::system_clock::time_point lastEvaluated_{};
+};
+
+}  // namespace pc_monitor
@@ -0,0 +1,111 @@
+#pragma once
+
+// Standard library includes first
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace pc_monitor {
+
+// Asynchronous generator: the body may co_await (timers, notifiers) between co_yields, and the consumer pulls
+// values with `while (auto Value = co_await stream.Next())`. The body only runs while a Next() is pending and
+// hands control straight back to the consumer on every co_yield, so both sides share the consumer's thread.
+// A stream ends when its body returns; destroying it early is fine while no Next() is pending.
+template <typename T>
+class AsyncStream {
+public:
+    struct promise_type {
+        std::optional<T> current;
+        std::coroutine_handle<> consumer;
+
+        AsyncStream get_return_object() {
+            return AsyncStream{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        static std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        // Symmetric transfer back to whoever awaited Next()
+        struct ResumeConsumer {
+            static bool await_ready() noexcept {
+                return false;
+            }
+            static std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                return handle.promise().consumer;
+            }
+            static void await_resume() noexcept {}
+        };
+
+        ResumeConsumer yield_value(T value) {
+            current = std::move(value);
+            return {};
+        }
+
+        static ResumeConsumer final_suspend() noexcept {
+            return {};
+        }
+
+        void return_void() {}
+        static void unhandled_exception() {
+            std::terminate();
+        }
+    };
+
+    class NextAwaiter {
+    public:
+        explicit NextAwaiter(std::coroutine_handle<promise_type> producer) : producer_(producer) {}
+
+        [[nodiscard]] bool await_ready() const noexcept {
+            return !producer_ || producer_.done();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) {
+            producer_.promise().consumer = consumer;
+            producer_.promise().current.reset();
+            return producer_;
+        }
+
+        // nullopt once the body has returned
+        std::optional<T> await_resume() {
+            if (!producer_ || producer_.done()) {
+                return std::nullopt;
+            }
+            return std::move(producer_.promise().current);
+        }
+
+    private:
+        std::coroutine_handle<promise_type> producer_;
+    };
+
+    AsyncStream(const AsyncStream&) = delete;
+    AsyncStream& operator=(const AsyncStream&) = delete;
+    AsyncStream(AsyncStream&& other) noexcept : producer_(std::exchange(other.producer_, {})) {}
+    AsyncStream& operator=(AsyncStream&& other) noexcept {
+        if (this != &other) {
+            if (producer_) {
+                producer_.destroy();
+            }
+            producer_ = std::exchange(other.producer_, {});
+        }
+        return *this;
+    }
+
+    ~AsyncStream() {
+        if (producer_) {
+            producer_.destroy();
+        }
+    }
+
+    [[nodiscard]] NextAwaiter Next() {
+        return NextAwaiter{producer_};
+    }
+
+private:
+    explicit AsyncStream(std::coroutine_handle<promise_type> producer) : producer_(producer) {}
+
+    std::coroutine_handle<promise_type> producer_;
+};
+
+}  // namespace pc_monitor
@@ -0,0 +1,160 @@
+#pragma once
+
+// Standard library includes first
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Local includes last
+#include "system_monitor.hpp"
+
+namespace pc_monitor {
+
+enum class WireFormat : std::uint8_t { JSON, BINARY };
+
+}  // namespace pc_monitor
+
+// Compact binary wire format, the alternative to JSON for clients that ask for it with
+// `Accept: application/x-pc-monitor` or `?format=binary` (on /api/stats, /api/history and /ws/stats).
+//
+// A message is a 5-byte header followed by a bit stream, written most significant bit first and zero-padded
+// to a whole byte:
+//
+//   byte 0..3  "PCMB"
+//   byte 4     message type: 1 = stats snapshot, 2 = history range
+//
+// Bit-stream primitives:
+//
+//   varint     unsigned LEB128: 8-bit groups, low 7 bits of the value first, high bit set when more follow
+//   svarint    zigzag-mapped signed value ((v << 1) ^ (v >> 63)) written as a varint
+//   core ids   1 bit: 0 when the ids are 0..N-1; otherwise 1 followed by N svarints, each the difference
+//              from the previous id (the first from -1)
+//   names      varint count, then per name a varint byte length and the UTF-8 bytes
+//   doubles    Gorilla XOR chain. The first value is 64 raw IEEE-754 bits. Every later value is XORed with the
+//              previous one: '0' when equal; '10' + the meaningful bits when they fit the previous leading/
+//              trailing-zero window; otherwise '11' + 5 bits leading zeros (capped at 31) + 6 bits meaningful
+//              length (0 meaning 64) + the meaningful bits.
+//   timestamps delta-of-delta, in ms. The first is a varint, the second an svarint delta from the first. Every
+//              later one stores the change D of the delta as zigzag Z: '0' when D = 0; '10' + 7 bits Z;
+//              '110' + 9 bits Z; '1110' + 12 bits Z; otherwise '1111' + varint Z.
+//
+// Stats snapshot (type 1):
+//   varint timestamp, varint core count N, core ids, 1 bit temperature present,
+//   one double chain: overall, [temperature], memory usagePercent, usage of core 0..N-1,
+//   varint averageFrequency, core frequencies as varint first then svarint differences to the previous core,
+//   varint memory total, used, available, cache, buffers, disk names, interface names, then when there is any
+//   device one double chain of every disk's rates and then every interface's, each device in key order:
+//   disks queueDepth, readBytesPerSec, readsPerSec, utilization, writeBytesPerSec, writesPerSec; interfaces
+//   dropsPerSec, errorsPerSec, rxBytesPerSec, rxPacketsPerSec, txBytesPerSec, txPacketsPerSec. Thermal data
+//   closes the message: varint package count, per package a varint id, 1 bit critical present and 1 bit
+//   throttling; 1 bit any core temperature, followed when set by N bits telling which cores have one; then one
+//   double chain of the package temperatures, the present criticals and the present core temperatures.
+//   Memory details follow as varints: slab, dirty, writeback, swapTotal, swapUsed, hugePagesTotal,
+//   hugePagesFree; then 1 bit pressure present. When set: 1 bit full present for cpu, io and memory, one
+//   double chain of avg10, avg60, avg300 of each resource's some and (when present) full line in that order,
+//   and the totals of the same lines as varints.
+//
+// History range (type 2):
+//   varint step (ms), varint points P, varint memoryBytes, varint core count N, core ids, disk names,
+//   interface names, P timestamps, then, when P > 0, for each series three double chains of P values (avg, max,
+//   min). Series order: overall, memory available, buffers, cache, usagePercent, used, usage of core 0..N-1,
+//   frequency of core 0..N-1, the rates of every disk and then of every interface in the stats key order.
+//   Percentages and clocks are kept in single precision, so their doubles are widened floats; memory sizes
+//   and device rates are kept as doubles.
+//
+// On the /ws/stats stream every message is prefixed with its varint byte length; a zero length is a heartbeat.
+namespace pc_monitor::binary {
+
+constexpr std::string_view CONTENT_TYPE = "application/x-pc-monitor";
+constexpr std::string_view MAGIC = "PCMB";
+
+enum class MessageType : std::uint8_t { STATS = 1, HISTORY = 2 };
+
+// Appends bits most significant first into a byte string
+class BitWriter {
+public:
+    explicit BitWriter(std::string& out) noexcept : out_(out) {}
+
+    void WriteBits(std::uint64_t value, unsigned count);
+    void WriteBit(bool bit) {
+        WriteBits(bit ? 1 : 0, 1);
+    }
+    void WriteVarint(std::uint64_t value);
+    void WriteSigned(std::int64_t value);
+
+    // Varint byte length, then the bytes
+    void WriteString(std::string_view value);
+
+    // Pads the last partial byte with zeros
+    void Finish();
+
+private:
+    std::string& out_;
+    std::uint64_t current_ = 0;
+    unsigned currentBits_ = 0;
+};
+
+// Gorilla XOR compression of one series of doubles
+class XorEncoder {
+public:
+    explicit XorEncoder(BitWriter& writer) noexcept : writer_(writer) {}
+
+    void Put(double value);
+
+private:
+    BitWriter& writer_;
+    std::uint64_t previous_ = 0;
+    unsigned leading_ = 0;
+    unsigned trailing_ = 0;
+    bool first_ = true;
+    bool hasWindow_ = false;
+};
+
+// Delta-of-delta compression of increasing millisecond timestamps
+class TimestampEncoder {
+public:
+    explicit TimestampEncoder(BitWriter& writer) noexcept : writer_(writer) {}
+
+    void Put(std::int64_t timestampMs);
+
+private:
+    BitWriter& writer_;
+    std::int64_t previous_ = 0;
+    std::int64_t previousDelta_ = 0;
+    std::size_t count_ = 0;
+};
+
+void AppendHeader(std::string& out, MessageType type);
+void AppendVarint(std::string& out, std::uint64_t value);
+
+// Writes `count` core ids read through idAt(index), using a single bit for the common 0..N-1 layout
+template <typename IdAt>
+void WriteCoreIds(BitWriter& writer, std::size_t count, IdAt idAt) {
+    bool Sequential = true;
+    for (std::size_t I = 0; I < count && Sequential; ++I) {
+        Sequential = idAt(I) == I;
+    }
+    writer.WriteBit(!Sequential);
+    if (!Sequential) {
+        std::int64_t Previous = -1;
+        for (std::size_t I = 0; I < count; ++I) {
+            auto const Id = static_cast<std::int64_t>(idAt(I));
+            writer.WriteSigned(Id - Previous);
+            Previous = Id;
+        }
+    }
+}
+
+// Writes a name list: the count, then every name read through nameAt(index)
+template <typename NameAt>
+void WriteNames(BitWriter& writer, std::size_t count, NameAt nameAt) {
+    writer.WriteVarint(count);
+    for (std::size_t I = 0; I < count; ++I) {
+        writer.WriteString(nameAt(I));
+    }
+}
+
+// Complete type-1 message
+void AppendStats(std::string& out, const SystemStats& stats);
+
+}  // namespace pc_monitor::binary
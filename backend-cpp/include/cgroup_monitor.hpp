@@ -0,0 +1,80 @@
+#pragma once
+
+// Standard library includes first
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Local includes last
+#include "system_monitor.hpp"
+
+namespace pc_monitor {
+
+struct CgroupInfo {
+    std::string path;  // relative to the hierarchy root, as in /proc/[pid]/cgroup: "/system.slice/docker-1f.scope"
+    double cpu{};      // % of one core since the previous scan, descendants included
+    std::uint64_t memory{};  // memory.current, bytes; 0 without the memory controller
+    std::uint64_t anon{};    // memory.stat anon
+    std::uint64_t file{};    // memory.stat file (page cache)
+    double readBytesPerSec{};   // io.stat rbytes, summed over devices
+    double writeBytesPerSec{};  // io.stat wbytes
+
+    auto operator<=>(const CgroupInfo&) const = default;
+};
+
+enum class CgroupSortKey : std::uint8_t { CPU, MEMORY, IO };
+
+// Every cgroup below the hierarchy root, parents before children and siblings by name
+struct CgroupTable {
+    std::vector<CgroupInfo> cgroups;
+    std::chrono::system_clock::time_point timestamp{};
+};
+
+// Per-cgroup CPU, memory and I/O collector for the cgroup v2 hierarchy. The tree is walked once; inotify
+// reports created and removed cgroups afterwards, and each cgroup keeps its cpu.stat, memory.current,
+// memory.stat and io.stat open. cpu.stat counts descendants, so a subtree whose usage did not move since the
+// previous scan is skipped whole and keeps its previous memory; every REFRESH_SCANS scans everything is read.
+class CgroupMonitor {
+public:
+    using Table = std::shared_ptr<const CgroupTable>;
+
+    static constexpr std::size_t REFRESH_SCANS = 15;
+
+    CgroupMonitor();
+    ~CgroupMonitor();
+
+    CgroupMonitor(const CgroupMonitor&) = delete;
+    CgroupMonitor& operator=(const CgroupMonitor&) = delete;
+    CgroupMonitor(CgroupMonitor&&) = delete;
+    CgroupMonitor& operator=(CgroupMonitor&&) = delete;
+
+    // Empty root: /sys/fs/cgroup, or the unified mount of a hybrid hierarchy under it
+    Result<void> Initialize(std::string_view root = {});
+
+    // Reads the changed cgroups and publishes a new table; not reentrant, called from a single thread
+    Result<void> Scan();
+
+    // Latest published table, or nullptr before the first Scan()
+    [[nodiscard]] Table Latest() const noexcept {
+        return latest_.load(std::memory_order_acquire);
+    }
+
+    // The `count` largest cgroups by `key` whose path starts with `prefix`, largest first, selected with a
+    // bounded heap (O(C log count))
+    [[nodiscard]] static std::vector<CgroupInfo> Top(const CgroupTable& table,
+                                                     std::size_t count,
+                                                     CgroupSortKey key,
+                                                     std::string_view prefix = {});
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl_;
+    std::atomic<Table> latest_{};
+};
+
+}  // namespace pc_monitor
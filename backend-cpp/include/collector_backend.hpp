@@ -0,0 +1,194 @@
+#pragma once
+
+// Standard library includes first
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Local includes last
+#include "proc_file.hpp"
+#include "system_monitor.hpp"
+
+namespace pc_monitor {
+
+// Raw inputs of the procfs collector, all plain text in the kernel's format
+enum class CollectorSource : std::uint8_t {
+    STAT = 0,             // /proc/stat
+    MEMINFO = 1,          // /proc/meminfo
+    CPUINFO = 2,          // /proc/cpuinfo
+    CPU_FREQUENCY = 3,    // /sys/devices/system/cpu/cpu<index>/cpufreq/scaling_cur_freq
+    CPU_TOPOLOGY = 4,     // /sys/devices/system/cpu/cpu<index>/{topology,cache,node*}, see below
+    DISKSTATS = 5,        // /proc/diskstats
+    NET_DEV = 6,          // /proc/net/dev
+    THERMAL_SENSORS = 7,  // CPU temperature sensors under /sys/class/hwmon or /sys/class/thermal, see below
+    TEMPERATURE = 8,      // temp<n>_input or thermal_zone<n>/temp of sensor <index>, in millidegrees Celsius
+    PRESSURE = 9,         // /proc/pressure/{cpu,io,memory} for index 0, 1, 2
+};
+
+// CPU_TOPOLOGY and THERMAL_SENSORS are the sources the kernel does not render as one file; backends assemble
+// them from sysfs. CPU_TOPOLOGY has one "key value" line each, with sizes and cpu lists left in the kernel's
+// own notation:
+//   package <physical_package_id>
+//   core <core_id>
+//   node <numa node>
+//   siblings <thread_siblings_list>
+//   cache <level> <type> <size> <coherency_line_size> <shared_cpu_list>   (one line per cache index)
+//
+// THERMAL_SENSORS lists one sensor per line, line n being the sensor TEMPERATURE reads with index n; the
+// critical trip point is in millidegrees, 0 when the sensor has none:
+//   package <physical_package_id> <critical>            (coretemp "Package id", k10temp Tctl/Tdie, x86_pkg_temp)
+//   core <physical_package_id> <core_id> <critical>    (coretemp "Core")
+
+// Where the Linux collector reads its raw text from: the live procfs/sysfs files, a recorder wrapped around
+// another backend, or a replayed capture. The parser is the same for all of them, so a replay exercises the
+// exact production code path.
+class CollectorBackend {
+public:
+    virtual ~CollectorBackend() = default;
+
+    virtual Result<void> Open() = 0;
+
+    // Contents of `source` from the start, at most buffer.size() bytes (callers size the buffer for the part
+    // they parse); empty when unavailable. `index` is the cpu id for CPU_FREQUENCY and 0 otherwise. Backends
+    // holding the text in memory may return a view of it instead, valid until the next call.
+    virtual std::string_view Read(CollectorSource source, std::uint32_t index, std::span<char> buffer) = 0;
+
+    // Whole source, for initialization-time reads of files whose size is not known up front
+    virtual std::string ReadAll(CollectorSource source, std::uint32_t index) = 0;
+
+    // Wall-clock time of the data last read; the recorded time for replays
+    [[nodiscard]] virtual std::chrono::system_clock::time_point Now() const = 0;
+};
+
+// One raw read, timed from the start of its capture
+struct CaptureRecord {
+    CollectorSource source{};
+    std::uint32_t index{};
+    std::chrono::microseconds offset{};
+    std::string content;
+};
+
+// Timed raw reads of one collector run. On disk: an 8-byte magic, the start time and then varint-framed
+// records with delta-coded offsets; a torn tail left by a crash is dropped on load.
+struct CollectorCapture {
+    std::chrono::system_clock::time_point started{};
+    std::vector<CaptureRecord> records;  // in offset order
+
+    static Result<CollectorCapture> Load(const std::filesystem::path& path);
+    Result<void> Save(const std::filesystem::path& path) const;
+};
+
+// Deterministic capture of a `cores`-cpu host sampled `samples` times, `interval` apart: per-core load
+// follows phase-shifted waves, frequencies and memory drift slowly. Disks and interfaces carry traffic that
+// follows the load, next to partitions, a loop device and one veth per cpu that the default filters drop.
+// Core temperatures follow the load and the packages heat-soak every five minutes, clocking down while hot;
+// memory pressure stalls rise with the memory use. Lets any box replay a large machine.
+CollectorCapture MakeSyntheticCapture(std::size_t cores, std::size_t samples, std::chrono::milliseconds interval);
+
+// Appends every read of `inner` to a capture file as it happens, timed by the inner backend's Now()
+class RecordingBackend final : public CollectorBackend {
+public:
+    RecordingBackend(std::unique_ptr<CollectorBackend> inner, std::filesystem::path path);
+
+    Result<void> Open() override;
+    std::string_view Read(CollectorSource source, std::uint32_t index, std::span<char> buffer) override;
+    std::string ReadAll(CollectorSource source, std::uint32_t index) override;
+    [[nodiscard]] std::chrono::system_clock::time_point Now() const override {
+        return inner_->Now();
+    }
+
+private:
+    void Append(CollectorSource source, std::uint32_t index, std::string_view content);
+
+    std::unique_ptr<CollectorBackend> inner_;
+    std::filesystem::path path_;
+    std::ofstream out_;
+    std::chrono::system_clock::time_point started_{};  // inner_->Now() at Open()
+    std::chrono::microseconds lastOffset_{};
+    std::string record_;  // reused encoding buffer
+};
+
+// Feeds a capture back to the collector. At speed > 0 every source shows the record current at
+// `speed` x the time since Open(). At speed 0 each /proc/stat read steps to the next recorded one and other
+// sources show what was read before the following one, so a recorded run replays read for read, as fast as
+// the caller samples. With `loop` the capture wraps instead of holding its last record; the first sample
+// after a wrap keeps the previous usage, as counters appear to go backwards.
+class ReplayBackend final : public CollectorBackend {
+public:
+    struct Options {
+        double speed = 1.0;
+        bool loop = true;
+    };
+
+    explicit ReplayBackend(std::shared_ptr<const CollectorCapture> capture)
+        : ReplayBackend(std::move(capture), Options{}) {}
+    ReplayBackend(std::shared_ptr<const CollectorCapture> capture, Options options);
+
+    Result<void> Open() override;
+    std::string_view Read(CollectorSource source, std::uint32_t index, std::span<char> buffer) override;
+    std::string ReadAll(CollectorSource source, std::uint32_t index) override;
+    [[nodiscard]] std::chrono::system_clock::time_point Now() const override;
+
+private:
+    struct Timeline {
+        std::vector<const CaptureRecord*> records;  // in offset order
+        std::size_t next = 0;                       // step mode cursor
+    };
+
+    static std::uint64_t Key(CollectorSource source, std::uint32_t index) noexcept {
+        return (static_cast<std::uint64_t>(source) << 32) | index;
+    }
+
+    // Unwrapped replay time; Lookup() folds it into the capture when looping
+    [[nodiscard]] std::chrono::microseconds Elapsed() const;
+    [[nodiscard]] const CaptureRecord* Lookup(const Timeline& timeline, std::chrono::microseconds elapsed) const;
+    const CaptureRecord* Current(CollectorSource source, std::uint32_t index);
+
+    std::shared_ptr<const CollectorCapture> capture_;
+    Options options_;
+    std::unordered_map<std::uint64_t, Timeline> timelines_;
+    std::chrono::microseconds period_{};  // capture length plus one sample interval
+    std::chrono::steady_clock::time_point started_{};
+    std::chrono::microseconds stepElapsed_{};
+    const CaptureRecord* stepEnd_ = nullptr;  // next /proc/stat record in step mode
+    std::uint64_t laps_ = 0;
+};
+
+#if defined(__linux__)
+// The live procfs/sysfs files, kept open and re-read with pread
+class ProcfsBackend final : public CollectorBackend {
+public:
+    Result<void> Open() override;
+    std::string_view Read(CollectorSource source, std::uint32_t index, std::span<char> buffer) override;
+    std::string ReadAll(CollectorSource source, std::uint32_t index) override;
+    [[nodiscard]] std::chrono::system_clock::time_point Now() const override {
+        return std::chrono::system_clock::now();
+    }
+
+private:
+    const procfs::ProcFile* File(CollectorSource source, std::uint32_t index);
+
+    // Finds the CPU sensors, opens their inputs as temperatureFiles_ and returns the THERMAL_SENSORS text
+    std::string DiscoverThermalSensors();
+
+    procfs::ProcFile statFile_;
+    procfs::ProcFile meminfoFile_;
+    procfs::ProcFile diskstatsFile_;  // optional, like the net/dev file: empty reads when missing
+    procfs::ProcFile netDevFile_;
+    std::vector<procfs::ProcFile> frequencyFiles_;  // by cpu id, opened on first read
+    std::vector<bool> frequencyProbed_;
+    std::vector<procfs::ProcFile> temperatureFiles_;  // by sensor index, opened by discovery
+    std::array<procfs::ProcFile, 3> pressureFiles_;   // cpu, io, memory; empty reads without PSI
+};
+#endif
+
+}  // namespace pc_monitor
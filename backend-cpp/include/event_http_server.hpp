@@ -0,0 +1,84 @@
+#pragma once
+
+// Standard library includes first
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Third-party includes
+#include <httplib.h>
+
+// Local includes last
+#include "stream_hub.hpp"
+#include "system_monitor.hpp"
+
+namespace pc_monitor {
+
+// Event-driven HTTP/1.1 front end for the same handlers httplib::Server runs. A few I/O threads each own an
+// epoll set of edge-triggered non-blocking sockets (and a SO_REUSEPORT listener), so an open connection costs
+// a small buffer instead of a parked thread. Requests on a keep-alive connection may be pipelined; their
+// responses go out in order, and shared bodies (SetSharedContent) are handed to writev() as they are instead
+// of being copied. Stream routes are fed from a StreamHub: a published frame wakes the I/O thread that owns
+// the connection, which writes the shared frame to the socket.
+//
+// Handlers run on the I/O threads, so they must not block. Bodies set with a chunked content provider are not
+// supported (register those as stream routes instead); they are answered with 500. Linux only: elsewhere
+// Start() fails with INITIALIZATION_FAILED.
+class EventHttpServer {
+public:
+    struct Options {
+        std::size_t threads = 0;                   // I/O threads; 0: one per hardware thread, at most 4
+        std::chrono::seconds keepAliveTimeout{5};  // idle keep-alive connections are closed after this
+        std::chrono::seconds streamHeartbeat{15};  // written to a stream that had no frame for this long
+        std::chrono::seconds writeTimeout{30};     // a client that takes none of its pending output is dropped
+    };
+
+    // Long-lived response of a stream route, fed from `hub` until either side closes
+    struct StreamSource {
+        StreamHub* hub = nullptr;       // null: answer with the plain response the handler filled in
+        StreamHub::Frame initial;       // written first, if any
+        std::string_view heartbeat;     // static text written after `streamHeartbeat` without frames
+        std::function<void()> onFrame;  // runs on the I/O thread whenever frames were queued to the socket
+    };
+
+    using StreamHandler = std::function<StreamSource(const httplib::Request&, httplib::Response&)>;
+
+    EventHttpServer() : EventHttpServer(Options{}) {}
+    explicit EventHttpServer(Options options);
+    ~EventHttpServer();
+
+    EventHttpServer(const EventHttpServer&) = delete;
+    EventHttpServer& operator=(const EventHttpServer&) = delete;
+    EventHttpServer(EventHttpServer&&) = delete;
+    EventHttpServer& operator=(EventHttpServer&&) = delete;
+
+    // Routes match the request path exactly; register them before Start(). GET routes also answer HEAD, and
+    // OPTIONS is answered 200 on any path after the pre-routing handler ran (CORS preflight).
+    void Get(const std::string& path, httplib::Server::Handler handler);
+    void Stream(const std::string& path, StreamHandler handler);
+    void SetPreRoutingHandler(httplib::Server::HandlerWithResponse handler);
+    void SetLogger(httplib::Server::Logger logger);
+
+    Result<void> Start(const std::string& host, std::uint16_t port);
+
+    // Closes every connection, unsubscribing its streams, and joins the I/O threads
+    void Stop();
+
+    [[nodiscard]] std::size_t ThreadCount() const noexcept;
+    [[nodiscard]] std::size_t ConnectionCount() const noexcept;
+
+    // I/O threads used for Options::threads = 0: one per hardware thread, at most 4; 0 where the event server
+    // is not available
+    [[nodiscard]] static std::size_t DefaultThreads() noexcept;
+    [[nodiscard]] std::size_t StreamCount() const noexcept;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl_;
+};
+
+}  // namespace pc_monitor
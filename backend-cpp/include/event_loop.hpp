@@ -0,0 +1,288 @@
+#pragma once
+
+// Standard library includes first
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Local includes last
+#include "timer_wheel.hpp"
+
+namespace pc_monitor {
+
+class EventLoop;
+
+// Fire-and-forget coroutine owned by the EventLoop it is spawned on; the frame frees itself when the body
+// returns. Lazily started, so nothing runs until EventLoop::Spawn() hands it to the loop thread.
+class Task {
+public:
+    struct promise_type {
+        EventLoop* loop = nullptr;
+
+        Task get_return_object() {
+            return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        static std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        struct FinalAwaiter {
+            static bool await_ready() noexcept {
+                return false;
+            }
+            static void await_suspend(std::coroutine_handle<promise_type> handle) noexcept;
+            static void await_resume() noexcept {}
+        };
+
+        static FinalAwaiter final_suspend() noexcept {
+            return {};
+        }
+
+        void return_void() {}
+        static void unhandled_exception() {
+            std::terminate();
+        }
+    };
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+private:
+    friend class EventLoop;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// Single-threaded executor for coroutines: a ready queue fed from any thread and a timer wheel, both drained
+// by one loop thread. Every coroutine spawned on a loop, and everything it awaits through the loop, resumes
+// on that thread, so any number of streams share it instead of parking a thread each.
+class EventLoop {
+public:
+    using Clock = TimerWheel::Clock;
+
+    EventLoop() = default;
+    ~EventLoop();
+
+    // Disable copy and move (due to the owned thread and handles pointing back at the loop)
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+    EventLoop(EventLoop&&) = delete;
+    EventLoop& operator=(EventLoop&&) = delete;
+
+    void Start();
+
+    // Requests StopToken() and returns once every spawned task has finished; tasks are expected to watch
+    // either their own stop token or the loop's
+    void Stop();
+
+    [[nodiscard]] bool IsRunning() const noexcept {
+        return running_.load();
+    }
+
+    [[nodiscard]] std::stop_token StopToken() const noexcept {
+        return stopSource_.get_token();
+    }
+
+    // Number of spawned tasks that have not finished yet
+    [[nodiscard]] std::size_t ActiveTasks() const noexcept {
+        return activeTasks_.load();
+    }
+
+    // Starts `task` on the loop thread; callable from any thread
+    void Spawn(Task task);
+
+    // Resumes `handle` on the loop thread; callable from any thread
+    void Post(std::coroutine_handle<> handle);
+    void Post(std::span<const std::coroutine_handle<>> handles);
+
+    // co_await SleepUntil(...) resumes on the loop thread at `deadline`, or as soon as `stop` is requested, and
+    // yields false when it was cancelled
+    class SleepAwaiter {
+    public:
+        SleepAwaiter(EventLoop& loop, Clock::time_point deadline, std::stop_token stop)
+            : loop_(loop), deadline_(deadline), stop_(std::move(stop)) {}
+        ~SleepAwaiter();
+
+        SleepAwaiter(const SleepAwaiter&) = delete;
+        SleepAwaiter& operator=(const SleepAwaiter&) = delete;
+        SleepAwaiter(SleepAwaiter&&) = delete;
+        SleepAwaiter& operator=(SleepAwaiter&&) = delete;
+
+        [[nodiscard]] bool await_ready() const noexcept {
+            return stop_.stop_requested() || deadline_ <= Clock::now();
+        }
+        void await_suspend(std::coroutine_handle<> handle);
+        bool await_resume();
+
+    private:
+        struct Cancel {
+            SleepAwaiter* awaiter;
+            void operator()() const;
+        };
+
+        EventLoop& loop_;
+        Clock::time_point deadline_;
+        std::stop_token stop_;
+        TimerWheel::Key key_{};
+        bool pending_ = false;
+        std::optional<std::stop_callback<Cancel>> onStop_;
+    };
+
+    [[nodiscard]] SleepAwaiter SleepUntil(Clock::time_point deadline, std::stop_token stop = {}) {
+        return {*this, deadline, std::move(stop)};
+    }
+
+    template <typename Rep, typename Period>
+    [[nodiscard]] SleepAwaiter SleepFor(std::chrono::duration<Rep, Period> delay, std::stop_token stop = {}) {
+        return {*this, Clock::now() + std::chrono::duration_cast<Clock::duration>(delay), std::move(stop)};
+    }
+
+private:
+    friend class Task;
+
+    TimerWheel::Key AddTimer(Clock::time_point deadline, std::coroutine_handle<> handle);
+
+    // Moves a pending timer straight to the ready queue; false when it already fired
+    bool CancelTimer(TimerWheel::Key key, Clock::time_point deadline);
+    void ForgetTimer(TimerWheel::Key key, Clock::time_point deadline);
+    void TaskFinished();
+    void Run();
+
+    std::atomic<bool> running_{false};
+    std::atomic<std::size_t> activeTasks_{0};
+    std::stop_source stopSource_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<std::coroutine_handle<>> ready_;
+    TimerWheel timers_;
+    std::unordered_map<TimerWheel::Key, std::coroutine_handle<>> sleepers_;
+    std::vector<TimerWheel::Entry> expired_;
+    TimerWheel::Key nextTimerKey_{1};
+    std::thread loopThread_;
+};
+
+// Wakes coroutines waiting for a condition that another thread makes true. Notify() resumes every current
+// waiter on the loop it waits from; waiters check their condition under the notifier lock first, so a
+// Notify() that lands between the check and the suspension is never lost. A coroutine must not be destroyed
+// while it is suspended in Wait().
+class AsyncNotifier {
+    struct Waiter {
+        EventLoop* loop = nullptr;
+        std::coroutine_handle<> handle;
+    };
+
+public:
+    AsyncNotifier() = default;
+    AsyncNotifier(const AsyncNotifier&) = delete;
+    AsyncNotifier& operator=(const AsyncNotifier&) = delete;
+    AsyncNotifier(AsyncNotifier&&) = delete;
+    AsyncNotifier& operator=(AsyncNotifier&&) = delete;
+
+    // co_await Wait(...) returns true once `ready()` holds, or false as soon as `stop` is requested
+    template <typename Predicate>
+    class Awaiter {
+    public:
+        Awaiter(AsyncNotifier& notifier, EventLoop& loop, std::stop_token stop, Predicate ready)
+            : notifier_(notifier), stop_(std::move(stop)), ready_(std::move(ready)) {
+            waiter_.loop = &loop;
+        }
+
+        ~Awaiter() {
+            onStop_.reset();
+            (void)notifier_.Remove(&waiter_);
+        }
+
+        Awaiter(const Awaiter&) = delete;
+        Awaiter& operator=(const Awaiter&) = delete;
+        Awaiter(Awaiter&&) = delete;
+        Awaiter& operator=(Awaiter&&) = delete;
+
+        bool await_ready() {
+            return stop_.stop_requested() || ready_();
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            {
+                std::lock_guard<std::mutex> const Lock(notifier_.mutex_);
+                if (ready_()) {
+                    return false;
+                }
+                waiter_.handle = handle;
+                notifier_.waiters_.push_back(&waiter_);
+            }
+            onStop_.emplace(stop_, Cancel{this});
+            return true;
+        }
+
+        bool await_resume() {
+            onStop_.reset();
+            return !stop_.stop_requested();
+        }
+
+    private:
+        struct Cancel {
+            Awaiter* awaiter;
+            void operator()() const {
+                if (awaiter->notifier_.Remove(&awaiter->waiter_)) {
+                    awaiter->waiter_.loop->Post(awaiter->waiter_.handle);
+                }
+            }
+        };
+
+        AsyncNotifier& notifier_;
+        std::stop_token stop_;
+        Predicate ready_;
+        Waiter waiter_;
+        std::optional<std::stop_callback<Cancel>> onStop_;
+    };
+
+    template <typename Predicate>
+    [[nodiscard]] Awaiter<Predicate> Wait(EventLoop& loop, std::stop_token stop, Predicate ready) {
+        return {*this, loop, std::move(stop), std::move(ready)};
+    }
+
+    // Callable from any thread; the condition must already hold for the waiters being woken
+    void Notify();
+
+    [[nodiscard]] std::size_t WaiterCount() const;
+
+private:
+    // False when the waiter was already woken or never suspended
+    bool Remove(Waiter* waiter);
+
+    mutable std::mutex mutex_;
+    std::vector<Waiter*> waiters_;
+};
+
+}  // namespace pc_monitor
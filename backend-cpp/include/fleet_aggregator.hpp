@@ -0,0 +1,152 @@
+#pragma once
+
+// Standard library includes first
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace pc_monitor {
+
+// One pc-monitor instance the aggregator subscribes to
+struct UpstreamConfig {
+    std::string name;  // unique; the host's key in /api/fleet and /api/fleet/host?name=
+    std::string host;
+    std::uint16_t port = 3001;
+};
+
+// One row of /api/fleet: the upstream's connection state and a summary of its last good snapshot
+struct FleetHost {
+    std::string name;
+    std::string address;  // host:port
+    bool up = false;
+    std::optional<std::string> error{};  // why the last fetch failed, while down
+    std::uint32_t failures{};            // consecutive failed fetches
+    std::optional<std::chrono::system_clock::time_point> lastSeen{};
+    double latencyMs{};  // of the last good fetch
+
+    std::size_t cores{};
+    double cpu{};
+    std::optional<double> temperature{};
+    bool throttling = false;
+    std::uint64_t memoryTotal{};
+    std::uint64_t memoryUsed{};
+    double memoryUsagePercent{};
+    double diskReadBytesPerSec{};
+    double diskWriteBytesPerSec{};
+    double networkRxBytesPerSec{};
+    double networkTxBytesPerSec{};
+};
+
+// Fleet-wide totals over the hosts that are up
+struct FleetRollup {
+    std::size_t hosts{};
+    std::size_t up{};
+    std::size_t cores{};
+    double cpuMean{};  // weighted by core count
+    double cpuMax{};
+    std::optional<std::string> busiest{};  // host with cpuMax
+    std::optional<double> temperatureMax{};
+    std::size_t throttling{};  // hosts with a throttling package
+    std::uint64_t memoryTotal{};
+    std::uint64_t memoryUsed{};
+    double memoryUsagePercent{};
+    double diskReadBytesPerSec{};
+    double diskWriteBytesPerSec{};
+    double networkRxBytesPerSec{};
+    double networkTxBytesPerSec{};
+};
+
+// Everything the fleet endpoints serve, rendered once per change and shared by every response
+struct FleetView {
+    std::string body;  // /api/fleet
+    std::unordered_map<std::string, std::shared_ptr<const std::string>> hosts;  // name -> last /api/stats body
+    std::chrono::system_clock::time_point timestamp{};
+    std::uint64_t sequence{};
+};
+
+// Federation: polls /api/stats of every upstream over its own keep-alive connection and merges the answers
+// into one FleetView. Each upstream has a poller thread, so a host that is slow or down only delays its own
+// row: its fetch gives up after `timeout`, and retries back off exponentially (with jitter) up to
+// `maxBackoff`. A render thread rebuilds the view at most once per interval / 4, re-serializing only the rows
+// of hosts whose fetches landed since the previous rendering.
+//
+// Upstreams file: {"upstreams":[{"name":"db-1","host":"10.0.0.7","port":3001},"10.0.0.8:3001"]}
+// A bare "host:port" string names the host by its address; the port defaults to 3001.
+class FleetAggregator {
+public:
+    struct Options {
+        std::chrono::milliseconds interval{1000};
+        std::chrono::milliseconds timeout{2000};  // connect and read, per fetch
+        std::chrono::milliseconds maxBackoff{30000};
+    };
+
+    static std::expected<std::vector<UpstreamConfig>, std::string> Parse(std::string_view config);
+    static std::expected<std::vector<UpstreamConfig>, std::string> Load(const std::filesystem::path& path);
+
+    explicit FleetAggregator(std::vector<UpstreamConfig> upstreams)
+        : FleetAggregator(std::move(upstreams), Options{}) {}
+    FleetAggregator(std::vector<UpstreamConfig> upstreams, Options options);
+    ~FleetAggregator();
+
+    // Disable copy and move (due to the owned threads)
+    FleetAggregator(const FleetAggregator&) = delete;
+    FleetAggregator& operator=(const FleetAggregator&) = delete;
+    FleetAggregator(FleetAggregator&&) = delete;
+    FleetAggregator& operator=(FleetAggregator&&) = delete;
+
+    void Start();
+
+    // Aborts fetches in flight and joins every thread
+    void Stop();
+
+    // Never null: every host starts out down until its first fetch
+    [[nodiscard]] std::shared_ptr<const FleetView> Latest() const noexcept {
+        return view_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] std::size_t UpstreamCount() const noexcept {
+        return upstreams_.size();
+    }
+
+private:
+    struct Upstream;
+
+    void Poll(Upstream& upstream);
+    void Accept(Upstream& upstream, std::string body, std::chrono::steady_clock::duration latency);
+    void Fail(Upstream& upstream, std::string error);
+    void MarkDirty(Upstream& upstream);  // caller holds mutex_
+    void RenderLoop();
+    void Render();
+
+    Options options_;
+    std::vector<std::unique_ptr<Upstream>> upstreams_;
+    std::atomic<std::shared_ptr<const FleetView>> view_;
+    std::atomic<bool> running_{false};
+
+    std::mutex mutex_;  // guards every Upstream's state and dirty_
+    std::condition_variable changed_;  // a fetch landed, for the render thread
+    std::condition_variable stopping_;  // ends the pollers' and the render thread's waits
+    std::vector<std::size_t> dirty_;  // upstreams changed since the last rendering, each listed once
+
+    // Render thread only, one entry per upstream
+    std::vector<std::size_t> rendering_;  // dirty_ taken over by the rendering in progress
+    std::vector<FleetHost> hosts_;
+    std::vector<std::shared_ptr<const std::string>> bodies_;
+    std::vector<std::string> rows_;  // hosts_ serialized
+    std::uint64_t sequence_{0};
+    std::vector<std::thread> threads_;
+};
+
+}  // namespace pc_monitor
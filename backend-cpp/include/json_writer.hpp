@@ -0,0 +1,495 @@
+#pragma once
+
+// Standard library includes first
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// Local includes last
+#include "alert_rules.hpp"
+#include "cgroup_monitor.hpp"
+#include "fleet_aggregator.hpp"
+#include "perf_stats.hpp"
+#include "process_monitor.hpp"
+#include "stats_sampler.hpp"
+#include "system_monitor.hpp"
+
+namespace pc_monitor::json {
+
+// Compile-time description of one serialized member
+template <typename Struct, typename Member>
+struct Field {
+    std::string_view key;
+    Member Struct::*member;
+};
+
+// Field table per struct; the specialization is the single place a struct's JSON layout is described.
+// Keys are listed in the order nlohmann::json emitted them (alphabetical), so the output has the same
+// layout as the DOM serializer it replaces (kept in bench/reference_json.hpp as the reference).
+template <typename T>
+struct JsonFields;
+
+template <>
+struct JsonFields<CPUCoreData> {
+    static constexpr std::tuple FIELDS{Field{"coreId", &CPUCoreData::coreId},
+                                       Field{"frequency", &CPUCoreData::frequency},
+                                       Field{"temperature", &CPUCoreData::temperature},
+                                       Field{"usage", &CPUCoreData::usage}};
+};
+
+template <>
+struct JsonFields<CpuPackageThermal> {
+    static constexpr std::tuple FIELDS{Field{"critical", &CpuPackageThermal::critical},
+                                       Field{"package", &CpuPackageThermal::package},
+                                       Field{"temperature", &CpuPackageThermal::temperature},
+                                       Field{"throttling", &CpuPackageThermal::throttling}};
+};
+
+template <>
+struct JsonFields<CPUUsageData> {
+    static constexpr std::tuple FIELDS{Field{"averageFrequency", &CPUUsageData::averageFrequency},
+                                       Field{"cores", &CPUUsageData::cores},
+                                       Field{"overall", &CPUUsageData::overall},
+                                       Field{"packages", &CPUUsageData::packages},
+                                       Field{"temperature", &CPUUsageData::temperature},
+                                       Field{"throttling", &CPUUsageData::throttling}};
+};
+
+template <>
+struct JsonFields<PressureStall> {
+    static constexpr std::tuple FIELDS{Field{"avg10", &PressureStall::avg10},
+                                       Field{"avg300", &PressureStall::avg300},
+                                       Field{"avg60", &PressureStall::avg60},
+                                       Field{"total", &PressureStall::total}};
+};
+
+template <>
+struct JsonFields<ResourcePressure> {
+    static constexpr std::tuple FIELDS{Field{"full", &ResourcePressure::full},
+                                       Field{"some", &ResourcePressure::some}};
+};
+
+template <>
+struct JsonFields<SystemPressure> {
+    static constexpr std::tuple FIELDS{Field{"cpu", &SystemPressure::cpu},
+                                       Field{"io", &SystemPressure::io},
+                                       Field{"memory", &SystemPressure::memory}};
+};
+
+template <>
+struct JsonFields<MemoryUsageData> {
+    static constexpr std::tuple FIELDS{Field{"available", &MemoryUsageData::available},
+                                       Field{"buffers", &MemoryUsageData::buffers},
+                                       Field{"cache", &MemoryUsageData::cache},
+                                       Field{"dirty", &MemoryUsageData::dirty},
+                                       Field{"hugePagesFree", &MemoryUsageData::hugePagesFree},
+                                       Field{"hugePagesTotal", &MemoryUsageData::hugePagesTotal},
+                                       Field{"pressure", &MemoryUsageData::pressure},
+                                       Field{"slab", &MemoryUsageData::slab},
+                                       Field{"swapTotal", &MemoryUsageData::swapTotal},
+                                       Field{"swapUsed", &MemoryUsageData::swapUsed},
+                                       Field{"total", &MemoryUsageData::total},
+                                       Field{"usagePercent", &MemoryUsageData::usagePercent},
+                                       Field{"used", &MemoryUsageData::used},
+                                       Field{"writeback", &MemoryUsageData::writeback}};
+};
+
+template <>
+struct JsonFields<DiskDeviceData> {
+    static constexpr std::tuple FIELDS{Field{"name", &DiskDeviceData::name},
+                                       Field{"queueDepth", &DiskDeviceData::queueDepth},
+                                       Field{"readBytesPerSec", &DiskDeviceData::readBytesPerSec},
+                                       Field{"readsPerSec", &DiskDeviceData::readsPerSec},
+                                       Field{"utilization", &DiskDeviceData::utilization},
+                                       Field{"writeBytesPerSec", &DiskDeviceData::writeBytesPerSec},
+                                       Field{"writesPerSec", &DiskDeviceData::writesPerSec}};
+};
+
+template <>
+struct JsonFields<NetworkInterfaceData> {
+    static constexpr std::tuple FIELDS{Field{"dropsPerSec", &NetworkInterfaceData::dropsPerSec},
+                                       Field{"errorsPerSec", &NetworkInterfaceData::errorsPerSec},
+                                       Field{"name", &NetworkInterfaceData::name},
+                                       Field{"rxBytesPerSec", &NetworkInterfaceData::rxBytesPerSec},
+                                       Field{"rxPacketsPerSec", &NetworkInterfaceData::rxPacketsPerSec},
+                                       Field{"txBytesPerSec", &NetworkInterfaceData::txBytesPerSec},
+                                       Field{"txPacketsPerSec", &NetworkInterfaceData::txPacketsPerSec}};
+};
+
+template <>
+struct JsonFields<SystemStats> {
+    static constexpr std::tuple FIELDS{Field{"cpu", &SystemStats::cpu},
+                                       Field{"disks", &SystemStats::disks},
+                                       Field{"memory", &SystemStats::memory},
+                                       Field{"network", &SystemStats::network},
+                                       Field{"timestamp", &SystemStats::timestamp}};
+};
+
+template <>
+struct JsonFields<ProcessInfo> {
+    static constexpr std::tuple FIELDS{Field{"cpu", &ProcessInfo::cpu},
+                                       Field{"name", &ProcessInfo::name},
+                                       Field{"pid", &ProcessInfo::pid},
+                                       Field{"rss", &ProcessInfo::rss}};
+};
+
+template <>
+struct JsonFields<CgroupInfo> {
+    static constexpr std::tuple FIELDS{Field{"anon", &CgroupInfo::anon},
+                                       Field{"cpu", &CgroupInfo::cpu},
+                                       Field{"file", &CgroupInfo::file},
+                                       Field{"memory", &CgroupInfo::memory},
+                                       Field{"path", &CgroupInfo::path},
+                                       Field{"readBytesPerSec", &CgroupInfo::readBytesPerSec},
+                                       Field{"writeBytesPerSec", &CgroupInfo::writeBytesPerSec}};
+};
+
+template <>
+struct JsonFields<AlertEvent> {
+    static constexpr std::tuple FIELDS{Field{"instance", &AlertEvent::instance},
+                                       Field{"metric", &AlertEvent::metric},
+                                       Field{"rule", &AlertEvent::rule},
+                                       Field{"severity", &AlertEvent::severity},
+                                       Field{"since", &AlertEvent::since},
+                                       Field{"state", &AlertEvent::state},
+                                       Field{"threshold", &AlertEvent::threshold},
+                                       Field{"timestamp", &AlertEvent::timestamp},
+                                       Field{"value", &AlertEvent::value}};
+};
+
+template <>
+struct JsonFields<FleetHost> {
+    static constexpr std::tuple FIELDS{Field{"address", &FleetHost::address},
+                                       Field{"cores", &FleetHost::cores},
+                                       Field{"cpu", &FleetHost::cpu},
+                                       Field{"diskReadBytesPerSec", &FleetHost::diskReadBytesPerSec},
+                                       Field{"diskWriteBytesPerSec", &FleetHost::diskWriteBytesPerSec},
+                                       Field{"error", &FleetHost::error},
+                                       Field{"failures", &FleetHost::failures},
+                                       Field{"lastSeen", &FleetHost::lastSeen},
+                                       Field{"latencyMs", &FleetHost::latencyMs},
+                                       Field{"memoryTotal", &FleetHost::memoryTotal},
+                                       Field{"memoryUsagePercent", &FleetHost::memoryUsagePercent},
+                                       Field{"memoryUsed", &FleetHost::memoryUsed},
+                                       Field{"name", &FleetHost::name},
+                                       Field{"networkRxBytesPerSec", &FleetHost::networkRxBytesPerSec},
+                                       Field{"networkTxBytesPerSec", &FleetHost::networkTxBytesPerSec},
+                                       Field{"temperature", &FleetHost::temperature},
+                                       Field{"throttling", &FleetHost::throttling},
+                                       Field{"up", &FleetHost::up}};
+};
+
+template <>
+struct JsonFields<FleetRollup> {
+    static constexpr std::tuple FIELDS{Field{"busiest", &FleetRollup::busiest},
+                                       Field{"cores", &FleetRollup::cores},
+                                       Field{"cpuMax", &FleetRollup::cpuMax},
+                                       Field{"cpuMean", &FleetRollup::cpuMean},
+                                       Field{"diskReadBytesPerSec", &FleetRollup::diskReadBytesPerSec},
+                                       Field{"diskWriteBytesPerSec", &FleetRollup::diskWriteBytesPerSec},
+                                       Field{"hosts", &FleetRollup::hosts},
+                                       Field{"memoryTotal", &FleetRollup::memoryTotal},
+                                       Field{"memoryUsagePercent", &FleetRollup::memoryUsagePercent},
+                                       Field{"memoryUsed", &FleetRollup::memoryUsed},
+                                       Field{"networkRxBytesPerSec", &FleetRollup::networkRxBytesPerSec},
+                                       Field{"networkTxBytesPerSec", &FleetRollup::networkTxBytesPerSec},
+                                       Field{"temperatureMax", &FleetRollup::temperatureMax},
+                                       Field{"throttling", &FleetRollup::throttling},
+                                       Field{"up", &FleetRollup::up}};
+};
+
+template <>
+struct JsonFields<SamplingTaskStats> {
+    static constexpr std::tuple FIELDS{Field{"intervalMs", &SamplingTaskStats::intervalMs},
+                                       Field{"lastDurationUs", &SamplingTaskStats::lastDurationUs},
+                                       Field{"lastJitterUs", &SamplingTaskStats::lastJitterUs},
+                                       Field{"maxJitterUs", &SamplingTaskStats::maxJitterUs},
+                                       Field{"meanJitterUs", &SamplingTaskStats::meanJitterUs},
+                                       Field{"missed", &SamplingTaskStats::missed},
+                                       Field{"name", &SamplingTaskStats::name},
+                                       Field{"runs", &SamplingTaskStats::runs}};
+};
+
+template <>
+struct JsonFields<CpuCacheInfo> {
+    static constexpr std::tuple FIELDS{Field{"cpus", &CpuCacheInfo::cpus},
+                                       Field{"level", &CpuCacheInfo::level},
+                                       Field{"lineSize", &CpuCacheInfo::lineSize},
+                                       Field{"size", &CpuCacheInfo::size},
+                                       Field{"type", &CpuCacheInfo::type}};
+};
+
+template <>
+struct JsonFields<LogicalCpuInfo> {
+    static constexpr std::tuple FIELDS{Field{"core", &LogicalCpuInfo::core},
+                                       Field{"cpuId", &LogicalCpuInfo::cpuId},
+                                       Field{"node", &LogicalCpuInfo::node},
+                                       Field{"package", &LogicalCpuInfo::package},
+                                       Field{"siblings", &LogicalCpuInfo::siblings}};
+};
+
+template <>
+struct JsonFields<CpuTopology> {
+    static constexpr std::tuple FIELDS{Field{"caches", &CpuTopology::caches},
+                                       Field{"cpus", &CpuTopology::cpus},
+                                       Field{"logicalCpus", &CpuTopology::logicalCpus},
+                                       Field{"numaNodes", &CpuTopology::numaNodes},
+                                       Field{"packages", &CpuTopology::packages},
+                                       Field{"physicalCores", &CpuTopology::physicalCores}};
+};
+
+template <>
+struct JsonFields<perf::HistogramSummary> {
+    static constexpr std::tuple FIELDS{Field{"count", &perf::HistogramSummary::count},
+                                       Field{"max", &perf::HistogramSummary::max},
+                                       Field{"mean", &perf::HistogramSummary::mean},
+                                       Field{"min", &perf::HistogramSummary::min},
+                                       Field{"name", &perf::HistogramSummary::name},
+                                       Field{"p50", &perf::HistogramSummary::p50},
+                                       Field{"p90", &perf::HistogramSummary::p90},
+                                       Field{"p99", &perf::HistogramSummary::p99},
+                                       Field{"p999", &perf::HistogramSummary::p999},
+                                       Field{"unit", &perf::HistogramSummary::unit}};
+};
+
+template <typename T>
+concept Described = requires { JsonFields<T>::FIELDS; };
+
+inline void AppendJson(std::string& out, bool value) {
+    out += value ? "true" : "false";
+}
+
+template <std::integral T>
+void AppendJson(std::string& out, T value) {
+    char Buffer[24];
+    auto const [End, Ec] = std::to_chars(Buffer, Buffer + sizeof(Buffer), value);
+    out.append(Buffer, End);
+}
+
+// Laid out like nlohmann::json: always with a decimal point or exponent, fixed notation for decimal
+// exponents in (-4, 15], null for NaN and infinity. Digits are the shortest round-trip form, which in rare
+// cases is one digit shorter than nlohmann's Grisu2 output but parses to the same double. Floats are written
+// with the shortest digits that round-trip as float.
+template <std::floating_point T>
+void AppendJson(std::string& out, T value) {
+    if (!std::isfinite(value)) {
+        out += "null";
+        return;
+    }
+
+    char Buffer[32];
+    auto const [End, Ec] = std::to_chars(Buffer, Buffer + sizeof(Buffer), value, std::chars_format::scientific);
+    std::string_view Scientific(Buffer, static_cast<std::size_t>(End - Buffer));
+
+    if (Scientific.front() == '-') {
+        out += '-';
+        Scientific.remove_prefix(1);
+    }
+
+    auto const ExponentPos = Scientific.find('e');
+    auto ExponentText = Scientific.substr(ExponentPos + 1);
+    if (ExponentText.front() == '+') {
+        ExponentText.remove_prefix(1);
+    }
+    int Exponent = 0;
+    std::from_chars(ExponentText.data(), ExponentText.data() + ExponentText.size(), Exponent);
+
+    char Digits[20];
+    int DigitCount = 0;
+    for (char const Char : Scientific.substr(0, ExponentPos)) {
+        if (Char != '.') {
+            Digits[DigitCount++] = Char;
+        }
+    }
+
+    constexpr int MIN_EXPONENT = -4;
+    constexpr int MAX_EXPONENT = 15;
+    int const PointPos = Exponent + 1;  // digits before the decimal point
+    std::string_view const DigitView(Digits, static_cast<std::size_t>(DigitCount));
+
+    if (DigitCount <= PointPos && PointPos <= MAX_EXPONENT) {
+        out += DigitView;
+        out.append(static_cast<std::size_t>(PointPos - DigitCount), '0');
+        out += ".0";
+    } else if (0 < PointPos && PointPos <= MAX_EXPONENT) {
+        out += DigitView.substr(0, static_cast<std::size_t>(PointPos));
+        out += '.';
+        out += DigitView.substr(static_cast<std::size_t>(PointPos));
+    } else if (MIN_EXPONENT < PointPos && PointPos <= 0) {
+        out += "0.";
+        out.append(static_cast<std::size_t>(-PointPos), '0');
+        out += DigitView;
+    } else {
+        out += DigitView.front();
+        if (DigitCount > 1) {
+            out += '.';
+            out += DigitView.substr(1);
+        }
+        out += 'e';
+        out += Exponent < 0 ? '-' : '+';
+        auto const Magnitude = static_cast<unsigned>(Exponent < 0 ? -Exponent : Exponent);
+        if (Magnitude < 10) {
+            out += '0';
+        }
+        AppendJson(out, Magnitude);
+    }
+}
+
+// Quoted string; quotes, backslashes and control characters are escaped, other bytes are copied unchanged
+inline void AppendJson(std::string& out, std::string_view value) {
+    constexpr std::string_view HEX = "0123456789abcdef";
+    out += '"';
+    for (char const Char : value) {
+        switch (Char) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(Char) < 0x20) {
+                    out += "\\u00";
+                    out += HEX[static_cast<unsigned char>(Char) >> 4];
+                    out += HEX[static_cast<unsigned char>(Char) & 0xF];
+                } else {
+                    out += Char;
+                }
+        }
+    }
+    out += '"';
+}
+
+// Milliseconds since the epoch, as the frontend's `timestamp: number` expects
+template <typename Clock, typename Duration>
+void AppendJson(std::string& out, std::chrono::time_point<Clock, Duration> value) {
+    AppendJson(out, std::chrono::duration_cast<std::chrono::milliseconds>(value.time_since_epoch()).count());
+}
+
+template <Described T>
+void AppendJson(std::string& out, const T& value);
+
+template <typename T>
+void AppendJson(std::string& out, const std::vector<T>& values) {
+    out += '[';
+    for (std::size_t I = 0; I < values.size(); ++I) {
+        if (I != 0) {
+            out += ',';
+        }
+        AppendJson(out, values[I]);
+    }
+    out += ']';
+}
+
+namespace detail {
+template <typename T>
+struct IsOptional : std::false_type {};
+
+template <typename T>
+struct IsOptional<std::optional<T>> : std::true_type {};
+
+template <typename Struct, typename Member>
+void AppendField(std::string& out, const Struct& value, const Field<Struct, Member>& field, bool& first) {
+    const auto& FieldValue = value.*(field.member);
+
+    // Empty optionals are omitted rather than written as null, matching the optional `?:` frontend fields
+    if constexpr (IsOptional<Member>::value) {
+        if (!FieldValue.has_value()) {
+            return;
+        }
+    }
+
+    out += first ? "{\"" : ",\"";
+    first = false;
+    out += field.key;
+    out += "\":";
+
+    if constexpr (IsOptional<Member>::value) {
+        AppendJson(out, *FieldValue);
+    } else {
+        AppendJson(out, FieldValue);
+    }
+}
+}  // namespace detail
+
+template <Described T>
+void AppendJson(std::string& out, const T& value) {
+    bool First = true;
+    std::apply([&](const auto&... fields) { (detail::AppendField(out, value, fields, First), ...); },
+               JsonFields<T>::FIELDS);
+    out += First ? "{}" : "}";
+}
+
+// JSON already rendered for one member of a described struct
+template <typename Struct, typename Member>
+struct Prerendered {
+    Member Struct::*member;
+    std::string_view json;
+};
+
+namespace detail {
+template <typename Struct, typename Member, typename Other>
+const std::string_view* FindPrerendered(Member Struct::*member, const Prerendered<Struct, Other>& body) {
+    if constexpr (std::is_same_v<Member, Other>) {
+        if (body.member == member) {
+            return &body.json;
+        }
+    }
+    return nullptr;
+}
+
+template <typename Struct, typename Member, typename... Others>
+void AppendFieldReusing(std::string& out,
+                        const Struct& value,
+                        const Field<Struct, Member>& field,
+                        bool& first,
+                        const Prerendered<Struct, Others>&... bodies) {
+    const std::string_view* Body = nullptr;
+    ((Body = Body != nullptr ? Body : FindPrerendered(field.member, bodies)), ...);
+    if (Body == nullptr) {
+        AppendField(out, value, field, first);
+        return;
+    }
+
+    out += first ? "{\"" : ",\"";
+    first = false;
+    out += field.key;
+    out += "\":";
+    out += *Body;
+}
+}  // namespace detail
+
+// Like AppendJson, but members with a Prerendered body are copied from it instead of being serialized again.
+// Keys, order and membership still come from JsonFields<T>; bodies for optional members are not supported.
+template <Described T, typename... Members>
+void AppendJsonReusing(std::string& out, const T& value, const Prerendered<T, Members>&... bodies) {
+    bool First = true;
+    std::apply(
+        [&](const auto&... fields) { (detail::AppendFieldReusing(out, value, fields, First, bodies...), ...); },
+        JsonFields<T>::FIELDS);
+    out += First ? "{}" : "}";
+}
+
+// Serializes into a fresh string; hot paths should reuse a buffer with AppendJson instead
+template <typename T>
+std::string ToJsonString(const T& value) {
+    std::string Out;
+    AppendJson(Out, value);
+    return Out;
+}
+
+}  // namespace pc_monitor::json
@@ -0,0 +1,136 @@
+#pragma once
+
+// Standard library includes first
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+// Local includes last
+#include "system_monitor.hpp"
+
+namespace pc_monitor {
+
+// Fixed-size file mapped into memory; writable mappings are shared so data survives a process crash
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Opens (creating and sizing it when writable) and maps the whole file
+    Result<void> Open(const std::filesystem::path& path, std::size_t size, bool writable);
+    void Close();
+
+    // Schedules dirty pages for write-back without waiting
+    void Flush();
+
+    [[nodiscard]] std::span<std::byte> Bytes() const noexcept {
+        return {data_, size_};
+    }
+
+private:
+    std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+#if defined(_WIN32)
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int file_ = -1;
+#endif
+};
+
+// One stored sample, decoded straight from the mapped record
+class StoredSample {
+public:
+    explicit StoredSample(const std::byte* record, std::span<const std::uint32_t> coreIds) noexcept
+        : record_(record), coreIds_(coreIds) {}
+
+    [[nodiscard]] std::chrono::system_clock::time_point Timestamp() const noexcept;
+
+    // Fills `out`, reusing its core vector, at the stored resolution (0.1 % and 0.1 °C)
+    void Decode(SystemStats& out) const;
+
+private:
+    const std::byte* record_;
+    std::span<const std::uint32_t> coreIds_;
+};
+
+// Append-only on-disk history of sampled SystemStats.
+//
+// Samples go into fixed-size memory-mapped segment files named by their first timestamp. Each segment has a
+// header with the core layout and then fixed-size binary records, each ending in a CRC-32. Opening the store
+// scans the newest segment up to the first record that is zero or fails its checksum. That is the torn tail
+// of a crash, and appending resumes there. A segment is rotated when full or when the core layout changes.
+// Segments whose newest sample is older than the retention window are deleted on rotation.
+class MetricsStore {
+public:
+    struct Options {
+        std::filesystem::path directory;
+        std::size_t segmentBytes = std::size_t{8} * 1024 * 1024;
+        std::chrono::hours retention{48};
+    };
+
+    using Visitor = std::function<void(const StoredSample&)>;
+
+    explicit MetricsStore(Options options);
+    ~MetricsStore();
+
+    MetricsStore(const MetricsStore&) = delete;
+    MetricsStore& operator=(const MetricsStore&) = delete;
+    MetricsStore(MetricsStore&&) = delete;
+    MetricsStore& operator=(MetricsStore&&) = delete;
+
+    // Maps existing segments, recovering the tail of the newest one
+    Result<void> Open();
+
+    Result<void> Append(const SystemStats& stats);
+
+    // Visits the stored samples with from <= timestamp <= to in time order
+    void Query(std::chrono::system_clock::time_point from,
+               std::chrono::system_clock::time_point to,
+               const Visitor& visitor) const;
+
+    [[nodiscard]] std::size_t SampleCount() const;
+    [[nodiscard]] std::size_t DiskBytes() const;
+
+private:
+    struct Segment {
+        std::filesystem::path path;
+        MappedFile file;
+        std::vector<std::uint32_t> coreIds;
+        std::size_t recordSize = 0;
+        std::size_t recordOffset = 0;  // first record, after the header and core table
+        std::size_t capacity = 0;      // records that fit
+        std::size_t count = 0;         // valid records
+        std::int64_t firstMs = 0;
+        std::int64_t lastMs = 0;
+        bool writable = false;
+
+        [[nodiscard]] const std::byte* Record(std::size_t index) const noexcept {
+            return file.Bytes().data() + recordOffset + (index * recordSize);
+        }
+    };
+
+    using SegmentPtr = std::unique_ptr<Segment>;
+
+    // Maps an existing segment and counts its valid records; a writable segment also gets its torn tail cleared
+    Result<SegmentPtr> LoadSegment(const std::filesystem::path& path, bool writable) const;
+    Result<void> Rotate(const SystemStats& stats);
+    void ApplyRetention(std::int64_t newestMs);
+
+    Options options_;
+    mutable std::mutex mutex_;
+    std::vector<SegmentPtr> segments_;  // oldest first; the last one takes appends
+};
+
+}  // namespace pc_monitor
@@ -0,0 +1,126 @@
+#pragma once
+
+// Standard library includes first
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Self-instrumentation. Built with PC_MONITOR_PERF=0 every probe below is an empty inline function, so call
+// sites compile to nothing and no clock is read.
+#if !defined(PC_MONITOR_PERF)
+    #define PC_MONITOR_PERF 1
+#endif
+
+namespace pc_monitor::perf {
+
+inline constexpr bool ENABLED = PC_MONITOR_PERF != 0;
+
+enum class Unit : std::uint8_t { NANOSECONDS, BYTES };
+
+// Process-wide counters, kept per thread and summed on read
+enum class Counter : std::uint8_t { BYTES_WRITTEN, COUNT };
+
+using HistogramId = std::uint16_t;
+
+// Log-linear buckets in the style of HdrHistogram: 16 linear steps per power of two, so every value from 1 up
+// to 2^64 is reported within 1/16 of what was recorded
+struct Buckets {
+    static constexpr unsigned SUB_BITS = 4;
+    static constexpr std::size_t SUB_BUCKETS = std::size_t{1} << SUB_BITS;
+    static constexpr std::size_t COUNT = SUB_BUCKETS + ((64 - SUB_BITS) * SUB_BUCKETS);
+
+    static constexpr std::size_t Index(std::uint64_t value) noexcept {
+        if (value < SUB_BUCKETS) {
+            return static_cast<std::size_t>(value);
+        }
+        auto const Shift = static_cast<unsigned>(std::bit_width(value)) - SUB_BITS - 1;
+        return SUB_BUCKETS + (Shift * SUB_BUCKETS) + static_cast<std::size_t>((value >> Shift) - SUB_BUCKETS);
+    }
+
+    // Midpoint of the values that land in `index`
+    static constexpr std::uint64_t Value(std::size_t index) noexcept {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        auto const Shift = static_cast<unsigned>((index - SUB_BUCKETS) / SUB_BUCKETS);
+        auto const Lowest = static_cast<std::uint64_t>(SUB_BUCKETS + ((index - SUB_BUCKETS) % SUB_BUCKETS)) << Shift;
+        return Lowest + (((std::uint64_t{1} << Shift) - 1) / 2);
+    }
+};
+
+// One histogram merged over every thread
+struct HistogramSummary {
+    std::string name;
+    std::string_view unit;  // "ns" or "bytes"
+    std::uint64_t count{};
+    double mean{};
+    std::uint64_t min{};
+    std::uint64_t p50{};
+    std::uint64_t p90{};
+    std::uint64_t p99{};
+    std::uint64_t p999{};
+    std::uint64_t max{};
+};
+
+#if PC_MONITOR_PERF
+
+// Looks up or registers a histogram by name; ids are stable for the life of the process. Registering takes
+// a lock, so call sites keep the id (function-local statics, members) rather than registering per event.
+HistogramId Register(std::string_view name, Unit unit = Unit::NANOSECONDS);
+
+// Adds one value to the calling thread's shard with relaxed, uncontended atomics; never locks after the
+// thread's first event
+void Record(HistogramId id, std::uint64_t value) noexcept;
+void Add(Counter counter, std::uint64_t value) noexcept;
+
+// Merges every shard, including those of threads that have exited since
+std::vector<HistogramSummary> Summaries();
+std::uint64_t Total(Counter counter);
+
+// Records the nanoseconds until it goes out of scope
+class ScopedTimer {
+public:
+    explicit ScopedTimer(HistogramId id) noexcept : id_(id), started_(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        Record(id_,
+               static_cast<std::uint64_t>(
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started_)
+                       .count()));
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+    ScopedTimer(ScopedTimer&&) = delete;
+    ScopedTimer& operator=(ScopedTimer&&) = delete;
+
+private:
+    HistogramId id_;
+    std::chrono::steady_clock::time_point started_;
+};
+
+#else
+
+inline HistogramId Register(std::string_view /* name */, Unit /* unit */ = Unit::NANOSECONDS) {
+    return 0;
+}
+inline void Record(HistogramId /* id */, std::uint64_t /* value */) noexcept {}
+inline void Add(Counter /* counter */, std::uint64_t /* value */) noexcept {}
+inline std::vector<HistogramSummary> Summaries() {
+    return {};
+}
+inline std::uint64_t Total(Counter /* counter */) {
+    return 0;
+}
+
+class ScopedTimer {
+public:
+    explicit ScopedTimer(HistogramId /* id */) noexcept {}
+};
+
+#endif
+
+}  // namespace pc_monitor::perf
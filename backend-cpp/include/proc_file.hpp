@@ -0,0 +1,139 @@
+#pragma once
+
+// Standard library includes first
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+// procfs/sysfs helpers shared by the Linux collectors
+#if defined(__linux__)
+    #include <fcntl.h>
+    #include <sys/resource.h>
+    #include <unistd.h>
+
+namespace pc_monitor::procfs {
+
+// procfs/sysfs file kept open for the lifetime of the collector and re-read from offset 0 with pread,
+// so a sample costs one syscall per file instead of open/read/close
+class ProcFile {
+public:
+    ProcFile() = default;
+    explicit ProcFile(const char* path) : fd_(::open(path, O_RDONLY | O_CLOEXEC)) {}
+
+    ~ProcFile() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    ProcFile(const ProcFile&) = delete;
+    ProcFile& operator=(const ProcFile&) = delete;
+
+    ProcFile(ProcFile&& other) noexcept : fd_(std::exchange(other.fd_, -1)) {}
+    ProcFile& operator=(ProcFile&& other) noexcept {
+        if (this != &other) {
+            if (fd_ >= 0) {
+                ::close(fd_);
+            }
+            fd_ = std::exchange(other.fd_, -1);
+        }
+        return *this;
+    }
+
+    [[nodiscard]] bool IsOpen() const noexcept {
+        return fd_ >= 0;
+    }
+
+    // Fills buffer from the start of the file; returns the bytes read (empty on error)
+    [[nodiscard]] std::string_view Read(std::span<char> buffer) const noexcept {
+        std::size_t Total = 0;
+        while (fd_ >= 0 && Total < buffer.size()) {
+            auto const Count =
+                ::pread(fd_, buffer.data() + Total, buffer.size() - Total, static_cast<off_t>(Total));
+            if (Count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (Count <= 0) {
+                break;
+            }
+            Total += static_cast<std::size_t>(Count);
+        }
+        return {buffer.data(), Total};
+    }
+
+    // Single pread for files the kernel renders in one piece (/proc/[pid]/stat and similar), which saves the
+    // extra end-of-file read of Read() when the buffer has room to spare
+    [[nodiscard]] std::string_view ReadOnce(std::span<char> buffer) const noexcept {
+        while (fd_ >= 0) {
+            auto const Count = ::pread(fd_, buffer.data(), buffer.size(), 0);
+            if (Count < 0 && errno == EINTR) {
+                continue;
+            }
+            return {buffer.data(), Count < 0 ? 0 : static_cast<std::size_t>(Count)};
+        }
+        return {};
+    }
+
+    // Initialization-time helper for files whose size is not known up front
+    [[nodiscard]] std::string ReadAll() const {
+        std::string Content(4096, '\0');
+        while (true) {
+            auto const View = Read(Content);
+            if (View.size() < Content.size()) {
+                Content.resize(View.size());
+                return Content;
+            }
+            Content.resize(Content.size() * 2);
+        }
+    }
+
+private:
+    int fd_ = -1;
+};
+
+inline std::string_view NextLine(std::string_view& text) noexcept {
+    auto const End = text.find('\n');
+    auto const Line = text.substr(0, End);
+    text.remove_prefix(End == std::string_view::npos ? text.size() : End + 1);
+    return Line;
+}
+
+// Parses the next blank-separated unsigned integer and advances past it
+template <typename T>
+bool NextUnsigned(std::string_view& text, T& value) noexcept {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    auto const [Ptr, Ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (Ec != std::errc{}) {
+        return false;
+    }
+    text.remove_prefix(static_cast<std::size_t>(Ptr - text.data()));
+    return true;
+}
+
+// Raises the soft descriptor limit to the hard one and returns the result (SIZE_MAX when unlimited, 0 when
+// unknown); collectors that cache descriptors per process or per cgroup budget a share of it
+inline std::size_t RaiseDescriptorLimit() noexcept {
+    rlimit Limit{};
+    if (getrlimit(RLIMIT_NOFILE, &Limit) != 0) {
+        return 0;
+    }
+    if (Limit.rlim_cur < Limit.rlim_max) {
+        rlimit Raised = Limit;
+        Raised.rlim_cur = Limit.rlim_max;
+        if (setrlimit(RLIMIT_NOFILE, &Raised) == 0) {
+            Limit = Raised;
+        }
+    }
+    return Limit.rlim_cur == RLIM_INFINITY ? SIZE_MAX : static_cast<std::size_t>(Limit.rlim_cur);
+}
+
+}  // namespace pc_monitor::procfs
+
+#endif
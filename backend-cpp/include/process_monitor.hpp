@@ -0,0 +1,71 @@
+#pragma once
+
+// Standard library includes first
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Local includes last
+#include "system_monitor.hpp"
+
+namespace pc_monitor {
+
+struct ProcessInfo {
+    std::uint32_t pid{};
+    std::string name;     // executable name (comm on Linux, image name on Windows)
+    double cpu{};         // % of one core since the previous scan; 0 on the first scan that sees the process
+    std::uint64_t rss{};  // resident set / working set, bytes
+
+    auto operator<=>(const ProcessInfo&) const = default;
+};
+
+enum class ProcessSortKey : std::uint8_t { CPU, RSS };
+
+// Every process seen by one scan, in pid order
+struct ProcessTable {
+    std::vector<ProcessInfo> processes;
+    std::chrono::system_clock::time_point timestamp{};
+};
+
+// Per-process CPU and memory collector. Handles to live processes stay open between scans; each scan lists
+// the current pids and diffs them against the previous scan, so only new processes are opened and only
+// exited ones are closed. CPU% comes from the tick delta of each process between two scans.
+class ProcessMonitor {
+public:
+    using Table = std::shared_ptr<const ProcessTable>;
+
+    ProcessMonitor();
+    ~ProcessMonitor();
+
+    ProcessMonitor(const ProcessMonitor&) = delete;
+    ProcessMonitor& operator=(const ProcessMonitor&) = delete;
+    ProcessMonitor(ProcessMonitor&&) = delete;
+    ProcessMonitor& operator=(ProcessMonitor&&) = delete;
+
+    Result<void> Initialize();
+
+    // Rescans and publishes a new table; not reentrant, called from a single thread
+    Result<void> Scan();
+
+    // Latest published table, or nullptr before the first Scan()
+    [[nodiscard]] Table Latest() const noexcept {
+        return latest_.load(std::memory_order_acquire);
+    }
+
+    // The `count` largest entries by `key`, largest first, selected with a bounded heap (O(P log count))
+    [[nodiscard]] static std::vector<ProcessInfo> Top(const ProcessTable& table,
+                                                      std::size_t count,
+                                                      ProcessSortKey key);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> pImpl_;
+    std::atomic<Table> latest_{};
+};
+
+}  // namespace pc_monitor
@@ -0,0 +1,55 @@
+#pragma once
+
+// Standard library includes first
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Local includes last
+#include "system_monitor.hpp"
+
+namespace pc_monitor {
+
+// Prometheus text exposition (format 0.0.4) of published samples. Per-core and per-device series prefixes are
+// built once per layout, so rendering a sample only appends numbers between precomputed strings; the result is shared
+// by every scrape until the next sample. The server's own metrics are appended per scrape instead, so the
+// latency histograms are only merged when someone asks for them.
+class PrometheusRenderer {
+public:
+    static constexpr std::string_view CONTENT_TYPE = "text/plain; version=0.0.4; charset=utf-8";
+
+    // Server state that is not part of the sample
+    struct ServerGauges {
+        std::size_t sseClients{};
+        std::size_t binaryStreamClients{};
+        std::size_t webSocketClients{};
+    };
+
+    // Not thread-safe; called from the sampler thread only
+    std::shared_ptr<const std::string> Render(const SystemStats& stats);
+
+    // Stream clients, bytes written and the latency histograms; safe from any thread
+    static void AppendServerMetrics(std::string& out, const ServerGauges& gauges);
+
+private:
+    void BuildLayout(const std::vector<CPUCoreData>& cores);
+    void BuildPackageLayout(const std::vector<CpuPackageThermal>& packages);
+
+    std::vector<std::uint32_t> coreIds_;       // layout the prefixes were built for
+    std::vector<std::string> usagePrefixes_;   // `pc_monitor_cpu_core_usage_percent{core="N"} `
+    std::vector<std::string> frequencyPrefixes_;
+    std::vector<std::string> temperaturePrefixes_;
+    std::vector<std::uint32_t> packageIds_;
+    std::vector<std::string> packageTemperaturePrefixes_;  // `pc_monitor_cpu_package_..{package="N"} `
+    std::vector<std::string> packageThrottlingPrefixes_;
+    std::vector<std::string> diskNames_;
+    std::vector<std::string> diskPrefixes_;  // by rate field, then disk: `pc_monitor_disk_..{device="sda"} `
+    std::vector<std::string> interfaceNames_;
+    std::vector<std::string> interfacePrefixes_;
+    std::size_t lastSize_ = 0;                 // reserve hint for the next rendering
+};
+
+}  // namespace pc_monitor
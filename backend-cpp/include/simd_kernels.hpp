@@ -0,0 +1,63 @@
+#pragma once
+
+// Standard library includes first
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string_view>
+
+namespace pc_monitor::simd {
+
+// Count, sum, extremes and sum of squared deviations of one contiguous array
+struct Summary {
+    std::size_t count = 0;
+    double sum = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    double m2 = 0.0;  // sum of squared deviations from the mean
+
+    [[nodiscard]] double Mean() const noexcept {
+        return count == 0 ? 0.0 : sum / static_cast<double>(count);
+    }
+    [[nodiscard]] double Variance() const noexcept {
+        return count == 0 ? 0.0 : m2 / static_cast<double>(count);
+    }
+    [[nodiscard]] double StdDev() const noexcept {
+        return std::sqrt(Variance());
+    }
+
+    // Summary of the concatenation of two disjoint arrays (pairwise update of Chan et al.)
+    [[nodiscard]] static Summary Merge(const Summary& a, const Summary& b) noexcept;
+};
+
+// Kernels dispatched once at startup: AVX2 on x86-64 CPUs that support it, portable scalar code otherwise.
+// Set PC_MONITOR_SIMD=scalar in the environment to force the fallback.
+[[nodiscard]] std::string_view ActiveKernel() noexcept;
+
+[[nodiscard]] double Sum(std::span<const double> values) noexcept;
+[[nodiscard]] double Mean(std::span<const double> values) noexcept;
+[[nodiscard]] Summary Summarize(std::span<const double> values) noexcept;
+[[nodiscard]] Summary Summarize(std::span<const float> values) noexcept;
+
+// Adds each value to buckets[floor((value - lower) / (upper - lower) * buckets.size())]. Values below the
+// range and NaN land in the first bucket, values at or above it in the last.
+void Histogram(std::span<const double> values, double lower, double upper, std::span<std::uint32_t> buckets) noexcept;
+void Histogram(std::span<const float> values, double lower, double upper, std::span<std::uint32_t> buckets) noexcept;
+
+// Upper edge of the bucket where the cumulative count reaches `quantile` (0..1) of the total
+[[nodiscard]] double Percentile(std::span<const std::uint32_t> buckets,
+                                double lower,
+                                double upper,
+                                double quantile) noexcept;
+
+// The portable implementations, always available (used as the fallback and as the benchmark baseline)
+namespace scalar {
+double Sum(std::span<const double> values) noexcept;
+Summary Summarize(std::span<const double> values) noexcept;
+Summary Summarize(std::span<const float> values) noexcept;
+void Histogram(std::span<const double> values, double lower, double upper, std::span<std::uint32_t> buckets) noexcept;
+void Histogram(std::span<const float> values, double lower, double upper, std::span<std::uint32_t> buckets) noexcept;
+}  // namespace scalar
+
+}  // namespace pc_monitor::simd
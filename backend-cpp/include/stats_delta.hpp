@@ -0,0 +1,70 @@
+#pragma once
+
+// Standard library includes first
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Local includes last
+#include "system_monitor.hpp"
+
+namespace pc_monitor {
+
+// SystemStats reduced to the resolution clients display. Two samples whose quantized values are equal
+// produce no delta, so values that barely move between ticks cost nothing on the wire.
+struct QuantizedStats {
+    std::int64_t overall{};  // tenths of a percent
+    std::uint64_t averageFrequency{};
+    std::optional<std::int64_t> temperature;  // tenths of a degree
+    std::vector<std::uint32_t> coreIds;       // core at each index; deltas only apply while it is unchanged
+    std::vector<std::int64_t> coreUsage;      // tenths of a percent, by core index
+    std::vector<std::uint64_t> coreFrequency;
+    std::vector<std::optional<std::int64_t>> coreTemperature;  // tenths of a degree
+    std::vector<std::uint32_t> packageIds;
+    std::vector<std::int64_t> packageTemperature;              // tenths of a degree, by package index
+    std::vector<bool> packageThrottling;
+    bool throttling{};
+
+    std::uint64_t memoryTotal{};
+    std::uint64_t memoryUsed{};
+    std::uint64_t memoryAvailable{};
+    std::uint64_t memoryCache{};
+    std::uint64_t memoryBuffers{};
+    std::int64_t memoryUsagePercent{};  // tenths of a percent
+    std::uint64_t memorySlab{};
+    std::uint64_t memoryDirty{};
+    std::uint64_t memoryWriteback{};
+    std::uint64_t memorySwapTotal{};
+    std::uint64_t memorySwapUsed{};
+    std::uint64_t memoryHugePagesTotal{};
+    std::uint64_t memoryHugePagesFree{};
+
+    // Pressure is sent whole whenever one of its averages moves by a hundredth; the stall totals ride along
+    std::optional<SystemPressure> pressure;
+    std::vector<std::int64_t> pressureAverages;  // hundredths of a percent
+
+    std::vector<std::string> diskNames;
+    std::vector<std::string> interfaceNames;
+    std::array<std::vector<std::int64_t>, DISK_RATE_FIELDS.size()> diskRates{};  // tenths, by field then device
+    std::array<std::vector<std::int64_t>, NETWORK_RATE_FIELDS.size()> networkRates{};
+
+    static QuantizedStats From(const SystemStats& stats);
+};
+
+namespace json {
+
+// Appends {"type":"delta","seq":..,"timestamp":..,"data":{...}} with only the fields whose quantized value
+// differs between before and after. Per-core, per-package and per-device changes are [index, value] pairs.
+// Returns false without writing anything when the core IDs, the thermal packages or the device list changed
+// and a full snapshot is needed instead.
+bool AppendStatsDelta(std::string& out,
+                      const QuantizedStats& before,
+                      const QuantizedStats& after,
+                      std::uint64_t sequence,
+                      std::int64_t timestampMs);
+
+}  // namespace json
+
+}  // namespace pc_monitor
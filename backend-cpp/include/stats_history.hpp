@@ -0,0 +1,130 @@
+#pragma once
+
+// Standard library includes first
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+// Local includes last
+#include "binary_codec.hpp"
+#include "system_monitor.hpp"
+
+namespace pc_monitor {
+
+// Fixed-capacity history of published samples at several resolutions. Every tier is a ring of time buckets
+// holding min/max/sum per series, folded in as samples arrive, so a range query only copies finished
+// aggregates out. Storage is column-major (one contiguous run of buckets per series) and allocated once per
+// core layout; the footprint is bounded by the tier capacities and reported by MemoryBytes(). Percentages and
+// clocks are kept as float; memory sizes and device rates as double, since float would round them to several
+// bytes above 16 MiB and hour/day sums would drift. Disks and interfaces that come and go keep the other
+// columns: surviving series move over, new ones start at zero. Queries copy the buckets they select under a
+// shared lock and format from the copy, so Append never waits on a formatter.
+class StatsHistory {
+public:
+    struct Tier {
+        std::chrono::seconds step;
+        std::size_t capacity;  // buckets kept
+    };
+
+    // 10 minutes at 1s, 2 hours at 10s, 24 hours at 60s
+    static constexpr std::array<Tier, 3> TIERS{Tier{std::chrono::seconds{1}, 600},
+                                               Tier{std::chrono::seconds{10}, 720},
+                                               Tier{std::chrono::seconds{60}, 1440}};
+
+    // Age of the oldest sample any tier still covers
+    static constexpr std::chrono::seconds SPAN =
+        TIERS.back().step * static_cast<std::int64_t>(TIERS.back().capacity);
+
+    StatsHistory() = default;
+
+    void Append(const SystemStats& stats);
+
+    // Finest tier step whose capacity covers `range`, or the coarsest tier when none does
+    [[nodiscard]] static std::chrono::seconds StepFor(std::chrono::seconds range) noexcept;
+
+    // Appends the buckets of the tier with exactly `step` that fall inside the last `range`, as JSON or as a
+    // binary history message. Returns false without writing anything when no tier has that step.
+    bool AppendRange(std::string& out,
+                     std::chrono::seconds range,
+                     std::chrono::seconds step,
+                     WireFormat format = WireFormat::JSON) const;
+
+    // Appends min/max/mean/stddev/p50/p95/p99 of every series over the last `range` as JSON, on the tier
+    // StepFor(range) picks. Extremes come from the bucket min/max columns; the rest describe bucket averages.
+    // cpu.spread summarizes the per-core mean usage across cores.
+    void AppendSummary(std::string& out, std::chrono::seconds range) const;
+
+    [[nodiscard]] std::size_t MemoryBytes() const;
+
+private:
+    template <typename T>
+    struct Columns {
+        std::vector<T> min;  // [row * capacity + slot]
+        std::vector<T> max;
+        std::vector<T> sum;
+    };
+
+    struct Ring {
+        std::int64_t stepMs{};
+        std::size_t capacity{};
+        std::size_t head{};  // slot of the newest bucket
+        std::size_t size{};
+        std::vector<std::int64_t> bucketStart;  // per slot, ms since the epoch
+        std::vector<std::uint32_t> count;       // samples folded into each slot
+        Columns<float> narrow;                  // CPU overall, memory usagePercent, per-core usage and frequency
+        Columns<double> wide;                   // memory sizes, then the device rates
+    };
+
+    // Row of a series (in wire order) within the narrow or the wide columns
+    struct Location {
+        bool wide{};
+        std::size_t row{};
+    };
+
+    // Buckets of a ring that fall inside a range, oldest first: slots first, first + 1, ... modulo capacity
+    struct Window {
+        std::size_t first{};
+        std::size_t points{};
+    };
+
+    // Copy of everything a query formats, taken under the lock so the formatting and the summaries run without
+    // it. `window` holds only the selected buckets, oldest first from slot 0.
+    struct Snapshot {
+        Ring window;
+        std::vector<std::uint32_t> coreIds;
+        std::vector<std::string> diskNames;
+        std::vector<std::string> interfaceNames;
+        std::size_t memoryBytes{};
+    };
+
+    void ResetLayout(const SystemStats& stats);
+    void RemapDevices(const SystemStats& stats);
+    [[nodiscard]] static std::size_t DiskSeries(const Snapshot& snapshot) noexcept;
+    [[nodiscard]] static std::size_t NetworkSeries(const Snapshot& snapshot) noexcept;
+    [[nodiscard]] static std::size_t SeriesCount(const Snapshot& snapshot) noexcept;
+    [[nodiscard]] static Location Locate(const Snapshot& snapshot, std::size_t series) noexcept;
+    [[nodiscard]] static Window WindowFor(const Ring& ring, std::chrono::seconds range) noexcept;
+    [[nodiscard]] Snapshot SnapshotLocked(std::size_t tier, std::chrono::seconds range) const;
+    [[nodiscard]] std::size_t MemoryBytesLocked() const;
+    static void AppendSeries(std::string& out, const Ring& window, Location where);
+    static double AppendSeriesSummary(std::string& out,
+                                      const Ring& window,
+                                      Location where,
+                                      std::vector<double>& averages);
+    static void AppendJsonRange(std::string& out, const Snapshot& snapshot);
+    static void AppendBinaryRange(std::string& out, const Snapshot& snapshot);
+
+    mutable std::shared_mutex mutex_;
+    std::array<Ring, TIERS.size()> rings_{};
+    std::vector<std::uint32_t> coreIds_;
+    std::vector<std::string> diskNames_;
+    std::vector<std::string> interfaceNames_;
+    std::vector<float> narrowSample_;  // scratch rows for Append, in column order
+    std::vector<double> wideSample_;
+};
+
+}  // namespace pc_monitor
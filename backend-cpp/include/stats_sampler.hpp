@@ -0,0 +1,176 @@
+#pragma once
+
+// Standard library includes first
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Local includes last
+#include "async_stream.hpp"
+#include "event_loop.hpp"
+#include "perf_stats.hpp"
+#include "system_monitor.hpp"
+#include "timer_wheel.hpp"
+
+namespace pc_monitor {
+
+// Deadline bookkeeping of one scheduled task; jitter is how late a run started relative to its deadline
+struct SamplingTaskStats {
+    std::string name;
+    std::int64_t intervalMs{};      // effective interval right now, 0 for a one-shot task
+    std::uint64_t runs{};
+    std::uint64_t missed{};         // deadlines skipped because a run started a whole interval late
+    std::int64_t lastJitterUs{};
+    std::int64_t maxJitterUs{};
+    std::int64_t meanJitterUs{};
+    std::int64_t lastDurationUs{};  // wall time of the last run
+
+    auto operator<=>(const SamplingTaskStats&) const = default;
+};
+
+// Single owner of the SystemMonitor collector. One background thread runs every metric group on its own
+// absolute deadlines from a timer wheel, so intervals do not drift by the collection time, and publishes
+// each result as an immutable snapshot; readers only load the latest pointer, so request cost is
+// independent of collection cost and collection rate is independent of client count.
+//
+// When nothing has consumed a sample for `idleAfter`, every interval stretches to at least `idleInterval`;
+// the next NoteDemand() restores the configured intervals and runs the stretched tasks straight away.
+class StatsSampler {
+public:
+    using Snapshot = std::shared_ptr<const SystemStats>;
+    using Listener = std::function<void(const Snapshot&)>;
+    using ListenerId = std::uint64_t;
+    using Task = std::function<void()>;
+    using TaskId = std::uint64_t;
+
+    struct Options {
+        std::chrono::milliseconds cpuInterval{1000};
+        std::chrono::milliseconds memoryInterval{1000};
+        std::chrono::milliseconds diskInterval{1000};
+        std::chrono::milliseconds networkInterval{1000};
+        std::chrono::milliseconds idleInterval{5000};
+        std::chrono::milliseconds idleAfter{30000};
+    };
+
+    explicit StatsSampler(std::shared_ptr<SystemMonitor> monitor) : StatsSampler(std::move(monitor), Options{}) {}
+    StatsSampler(std::shared_ptr<SystemMonitor> monitor, Options options);
+    ~StatsSampler();
+
+    // Disable copy and move (due to atomic members and the owned thread)
+    StatsSampler(const StatsSampler&) = delete;
+    StatsSampler& operator=(const StatsSampler&) = delete;
+    StatsSampler(StatsSampler&&) = delete;
+    StatsSampler& operator=(StatsSampler&&) = delete;
+
+    // Takes the first sample synchronously, so Latest() is never empty after a successful Start()
+    Result<void> Start();
+    void Stop();
+    [[nodiscard]] bool IsRunning() const noexcept {
+        return running_.load();
+    }
+
+    // Latest published snapshot, or nullptr before the first successful sample
+    [[nodiscard]] Snapshot Latest() const noexcept {
+        return latest_.load(std::memory_order_acquire);
+    }
+
+    // Number of snapshots published so far
+    [[nodiscard]] std::uint64_t Sequence() const noexcept {
+        return sequence_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] const Options& Settings() const noexcept {
+        return options_;
+    }
+
+    // Topology of the sampled host; immutable, unlike the collector itself, so safe off the sampler thread
+    [[nodiscard]] const CpuTopology& Topology() const noexcept {
+        return monitor_->Topology();
+    }
+
+    // Listeners run on the sampler thread right after each publish, so per-sample work such as
+    // serialization happens once per sample instead of once per request. A listener added after
+    // Start() is invoked immediately with the current snapshot.
+    ListenerId AddListener(Listener listener);
+    void RemoveListener(ListenerId id);
+
+    // The current snapshot, then every later one, resumed on `loop` instead of the sampler thread; a consumer
+    // that falls behind skips straight to the newest snapshot. Ends once `stop` is requested, and counts as
+    // demand for as long as it is consumed.
+    AsyncStream<Snapshot> Subscribe(EventLoop& loop, std::stop_token stop);
+
+    // Extra metric group run on the sampler thread every `interval` after the snapshot of the same tick is
+    // published, first as soon as possible; a zero interval runs it once. RemoveTask() waits for a run in
+    // progress to finish.
+    TaskId AddTask(std::string name, std::chrono::milliseconds interval, Task task);
+    void RemoveTask(TaskId id);
+
+    // Marks the samples as wanted: cheap while active, wakes the sampler when it had backed off
+    void NoteDemand();
+    [[nodiscard]] bool IsIdle() const noexcept {
+        return idle_.load();
+    }
+
+    // Jitter and missed-deadline counts of every task, built-in groups ("cpu", "memory", "disk", "network") first
+    [[nodiscard]] std::vector<SamplingTaskStats> TaskStats() const;
+
+private:
+    struct ScheduledTask {
+        TaskId id{};
+        std::chrono::milliseconds interval{};
+        Task run;
+        bool publishes = false;  // built-in group feeding the snapshot
+        TimerWheel::Clock::time_point deadline{};
+        std::int64_t totalJitterUs{};
+        perf::HistogramId latency{};  // "collect.<name>" in /debug/perf
+        SamplingTaskStats stats;
+    };
+
+    TaskId AddTaskLocked(std::string name, std::chrono::milliseconds interval, bool publishes, Task task);
+    [[nodiscard]] std::chrono::milliseconds EffectiveInterval(const ScheduledTask& task) const noexcept;
+    void Reschedule(ScheduledTask& task, TimerWheel::Clock::time_point started, TimerWheel::Clock::time_point now);
+    void RunBatch(std::vector<ScheduledTask*>& batch);
+    void Publish();
+    void Run();
+
+    std::shared_ptr<SystemMonitor> monitor_;
+    Options options_;
+
+    std::atomic<Snapshot> latest_{};
+    std::atomic<std::uint64_t> sequence_{0};
+    std::atomic<bool> running_{false};
+
+    std::mutex listenersMutex_;
+    std::vector<std::pair<ListenerId, Listener>> listeners_;
+    ListenerId nextListenerId_{1};
+    AsyncNotifier published_;
+
+    // Latest value of every built-in group; only touched by Start() and the sampler thread
+    SystemStats current_{};
+    bool pendingPublish_ = false;  // a group was collected since the last publish
+
+    // Lock order: runMutex_ (held while a batch runs tasks) before mutex_ (wheel and task table)
+    std::mutex runMutex_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    TimerWheel wheel_;
+    std::vector<std::unique_ptr<ScheduledTask>> tasks_;
+    std::vector<TimerWheel::Entry> due_;
+    TaskId nextTaskId_{1};
+    bool rearmed_ = false;  // the earliest deadline moved while the thread was waiting
+
+    std::atomic<TimerWheel::Clock::rep> lastDemand_{0};
+    std::atomic<bool> idle_{false};
+    std::thread samplerThread_;
+};
+
+}  // namespace pc_monitor
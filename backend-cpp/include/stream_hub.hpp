@@ -0,0 +1,94 @@
+#pragma once
+
+// Standard library includes first
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pc_monitor {
+
+// Fan-out of pre-rendered stream frames to any number of subscribers. Publishing pushes one shared
+// pointer into each subscriber's bounded queue; nothing is serialized or collected per client.
+class StreamHub {
+public:
+    using Frame = std::shared_ptr<const std::string>;
+
+    // Called on the publishing thread after a frame is queued and when the subscription closes, for consumers
+    // that poll with TryNext() from an event loop instead of parking a thread in WaitNext()
+    using ReadyCallback = std::function<void()>;
+
+    // One connected stream client
+    class Subscription {
+    public:
+        Subscription(std::size_t capacity, ReadyCallback onReady) : onReady_(std::move(onReady)), queue_(capacity) {}
+
+        // Next queued frame, waiting up to timeout; nullptr on timeout or once closed
+        Frame WaitNext(std::chrono::milliseconds timeout);
+
+        // Next queued frame without waiting; nullptr when none is queued
+        Frame TryNext();
+
+        [[nodiscard]] bool IsClosed() const noexcept {
+            return closed_.load();
+        }
+
+        // Frames discarded because this client fell behind
+        [[nodiscard]] std::uint64_t Dropped() const noexcept {
+            return dropped_.load();
+        }
+
+    private:
+        friend class StreamHub;
+
+        // Returns false when the client has fallen too far behind and should be disconnected
+        bool Push(const Frame& frame, std::size_t maxBacklogDrops);
+        void Close();
+
+        ReadyCallback onReady_;  // set before the subscription is visible to Publish, then read-only
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        std::vector<Frame> queue_;  // ring buffer of fixed capacity
+        std::size_t head_{0};
+        std::size_t count_{0};
+        std::size_t backlogDrops_{0};  // drops since the client last consumed a frame
+        std::atomic<std::uint64_t> dropped_{0};
+        std::atomic<bool> closed_{false};
+    };
+
+    // queueCapacity frames are buffered per client; when full the oldest frame is dropped, and a client
+    // that drops maxBacklogDrops frames in a row without reading is disconnected
+    explicit StreamHub(std::size_t queueCapacity = 4, std::size_t maxBacklogDrops = 30);
+
+    // Registers a client; `initial` (if any) is queued so the client gets the current frame immediately.
+    // Unsubscribe() closes the subscription, which runs `onReady` once more, synchronously on the calling thread,
+    // so the owner can drain the closed state; once Unsubscribe() returns, `onReady` is not called again.
+    std::shared_ptr<Subscription> Subscribe(const Frame& initial, ReadyCallback onReady = nullptr);
+    void Unsubscribe(const std::shared_ptr<Subscription>& subscription);
+
+    void Publish(const Frame& frame);
+
+    // Wakes and closes every subscription, e.g. on shutdown
+    void CloseAll();
+
+    [[nodiscard]] std::size_t SubscriberCount() const;
+    [[nodiscard]] std::uint64_t DisconnectedSlowConsumers() const noexcept {
+        return slowDisconnects_.load();
+    }
+
+private:
+    std::size_t queueCapacity_;
+    std::size_t maxBacklogDrops_;
+
+    mutable std::mutex subscribersMutex_;
+    std::vector<std::shared_ptr<Subscription>> subscribers_;
+    std::atomic<std::uint64_t> slowDisconnects_{0};
+};
+
+}  // namespace pc_monitor
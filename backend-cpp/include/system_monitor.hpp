@@ -1,21 +1,34 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <charconv>
 #include <chrono>
 #include <cmath>
-#include <coroutine>
 #include <expected>
 #include <format>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <ranges>
 #include <span>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace pc_monitor {
 
+class CollectorBackend;
+
 // Modern C++23 error handling
-enum class SystemError : std::uint8_t { PERMISSION_DENIED, SYSTEM_ERROR, INITIALIZATION_FAILED, DATA_UNAVAILABLE };
+enum class SystemError : std::uint8_t {
+    PERMISSION_DENIED,
+    SYSTEM_ERROR,
+    INITIALIZATION_FAILED,
+    DATA_UNAVAILABLE,
+    INVALID_REQUEST
+};
 
 template <typename T>
 using Result = std::expected<T, SystemError>;
@@ -23,35 +36,187 @@ using Result = std::expected<T, SystemError>;
 // Core data structures using C++23 features
 struct CPUCoreData {
     std::uint32_t coreId;
-    double usage;             // 0-100%
-    std::uint64_t frequency;  // MHz
+    double usage;                         // 0-100%
+    std::uint64_t frequency;              // MHz
+    std::optional<double> temperature{};  // Celsius, of the physical core; shared by SMT siblings
 
     auto operator<=>(const CPUCoreData&) const = default;
 };
 
+// Thermal state of one CPU package
+struct CpuPackageThermal {
+    std::uint32_t package{};
+    double temperature{};            // Celsius, the package sensor or else the hottest core
+    std::optional<double> critical;  // Celsius, when the sensor reports a critical trip point
+    bool throttling{};               // near its critical temperature while clocked well below its peak
+
+    auto operator<=>(const CpuPackageThermal&) const = default;
+};
+
 struct CPUUsageData {
     double overall{};                   // 0-100%
-    std::optional<double> temperature;  // Celsius
+    std::optional<double> temperature;  // Celsius, the hottest package
     std::uint64_t averageFrequency{};   // MHz
     std::vector<CPUCoreData> cores{};
+    std::vector<CpuPackageThermal> packages{};  // empty without temperature sensors
+    bool throttling{};                          // any package throttling
 
     auto operator<=>(const CPUUsageData&) const = default;
 };
 
+// One line of /proc/pressure/<resource>: the share of wall time in which tasks stalled on the resource
+struct PressureStall {
+    double avg10{};  // %, over the last 10 s
+    double avg60{};
+    double avg300{};
+    std::uint64_t total{};  // us stalled since boot
+
+    auto operator<=>(const PressureStall&) const = default;
+};
+
+// "some": at least one task stalled; "full": all non-idle tasks stalled at once (missing for cpu before 5.13)
+struct ResourcePressure {
+    PressureStall some{};
+    std::optional<PressureStall> full{};
+
+    auto operator<=>(const ResourcePressure&) const = default;
+};
+
+// Pressure stall information of the whole system
+struct SystemPressure {
+    ResourcePressure cpu{};
+    ResourcePressure io{};
+    ResourcePressure memory{};
+
+    auto operator<=>(const SystemPressure&) const = default;
+};
+
 struct MemoryUsageData {
     std::uint64_t total;      // bytes
     std::uint64_t used;       // bytes
     std::uint64_t available;  // bytes
-    std::uint64_t cache;      // bytes
+    std::uint64_t cache;      // bytes, page cache
     std::uint64_t buffers;    // bytes
     double usagePercent;      // calculated 0-100%
+    std::uint64_t slab{};     // bytes of kernel slab (Windows: paged and nonpaged pool)
+    std::uint64_t dirty{};    // bytes waiting to be written back
+    std::uint64_t writeback{};
+    std::uint64_t swapTotal{};  // bytes (Windows: page file beyond physical memory)
+    std::uint64_t swapUsed{};
+    std::uint64_t hugePagesTotal{};  // bytes in the default-size huge page pool
+    std::uint64_t hugePagesFree{};
+    std::optional<SystemPressure> pressure{};  // absent without PSI (kernels before 4.20, psi=0, Windows)
 
     auto operator<=>(const MemoryUsageData&) const = default;
 };
 
+// One CPU cache, listed once however many logical cpus share it
+struct CpuCacheInfo {
+    std::uint32_t level{};              // 1, 2, 3
+    std::string type;                   // "data", "instruction" or "unified"
+    std::uint64_t size{};               // bytes
+    std::uint32_t lineSize{};           // bytes
+    std::vector<std::uint32_t> cpus{};  // logical cpus sharing it
+
+    auto operator<=>(const CpuCacheInfo&) const = default;
+};
+
+struct LogicalCpuInfo {
+    std::uint32_t cpuId{};                  // matches CPUCoreData::coreId
+    std::uint32_t package{};
+    std::uint32_t core{};                   // physical core id within the package
+    std::uint32_t node{};                   // NUMA node
+    std::vector<std::uint32_t> siblings{};  // logical cpus of the same physical core, including this one
+
+    auto operator<=>(const LogicalCpuInfo&) const = default;
+};
+
+// Processor layout, discovered once by SystemMonitor::Initialize()
+struct CpuTopology {
+    std::uint32_t packages{};
+    std::uint32_t physicalCores{};
+    std::uint32_t logicalCpus{};
+    std::uint32_t numaNodes{};
+    std::vector<LogicalCpuInfo> cpus{};
+    std::vector<CpuCacheInfo> caches{};  // by level, then type
+
+    auto operator<=>(const CpuTopology&) const = default;
+};
+
+// Block device activity between two samples, from the kernel's cumulative counters
+struct DiskDeviceData {
+    std::string name;           // kernel name, e.g. "nvme0n1"
+    double queueDepth{};        // average requests in flight
+    double readBytesPerSec{};
+    double readsPerSec{};       // completed read requests
+    double utilization{};       // 0-100% of the time with a request in flight
+    double writeBytesPerSec{};
+    double writesPerSec{};      // completed write requests
+
+    auto operator<=>(const DiskDeviceData&) const = default;
+};
+
+struct NetworkInterfaceData {
+    std::string name;
+    double dropsPerSec{};   // received and transmitted packets dropped
+    double errorsPerSec{};  // receive and transmit errors
+    double rxBytesPerSec{};
+    double rxPacketsPerSec{};
+    double txBytesPerSec{};
+    double txPacketsPerSec{};
+
+    auto operator<=>(const NetworkInterfaceData&) const = default;
+};
+
+// Rate members in key order, for code that treats every rate of a device alike (history series, deltas)
+template <typename Device>
+struct RateField {
+    std::string_view key;
+    double Device::*member;
+};
+
+inline constexpr std::array DISK_RATE_FIELDS{
+    RateField<DiskDeviceData>{"queueDepth", &DiskDeviceData::queueDepth},
+    RateField<DiskDeviceData>{"readBytesPerSec", &DiskDeviceData::readBytesPerSec},
+    RateField<DiskDeviceData>{"readsPerSec", &DiskDeviceData::readsPerSec},
+    RateField<DiskDeviceData>{"utilization", &DiskDeviceData::utilization},
+    RateField<DiskDeviceData>{"writeBytesPerSec", &DiskDeviceData::writeBytesPerSec},
+    RateField<DiskDeviceData>{"writesPerSec", &DiskDeviceData::writesPerSec}};
+
+inline constexpr std::array NETWORK_RATE_FIELDS{
+    RateField<NetworkInterfaceData>{"dropsPerSec", &NetworkInterfaceData::dropsPerSec},
+    RateField<NetworkInterfaceData>{"errorsPerSec", &NetworkInterfaceData::errorsPerSec},
+    RateField<NetworkInterfaceData>{"rxBytesPerSec", &NetworkInterfaceData::rxBytesPerSec},
+    RateField<NetworkInterfaceData>{"rxPacketsPerSec", &NetworkInterfaceData::rxPacketsPerSec},
+    RateField<NetworkInterfaceData>{"txBytesPerSec", &NetworkInterfaceData::txBytesPerSec},
+    RateField<NetworkInterfaceData>{"txPacketsPerSec", &NetworkInterfaceData::txPacketsPerSec}};
+
+// Which disks or network interfaces get collected, by name. Patterns are shell globs ('*', '?' and sets such
+// as [0-9]); a device is kept when it matches no exclude pattern and, if there are include patterns, one of
+// those. Collectors decide once per name, so an excluded device costs a name lookup per sample.
+struct DeviceFilter {
+    std::vector<std::string> include{};
+    std::vector<std::string> exclude{};
+
+    [[nodiscard]] bool Matches(std::string_view name) const;
+
+    // Comma-separated patterns, exclusions prefixed with '!': "eth*,wlan*" or "!veth*,!lo"
+    static DeviceFilter Parse(std::string_view spec);
+
+    // Whole disks: no partitions, loop, ram or optical devices
+    static DeviceFilter DefaultDisks();
+
+    // No loopback, and none of the per-container veth pairs and bridges of container hosts
+    static DeviceFilter DefaultNetwork();
+
+    auto operator<=>(const DeviceFilter&) const = default;
+};
+
 struct SystemStats {
     CPUUsageData cpu;
     MemoryUsageData memory{};
+    std::vector<DiskDeviceData> disks{};
+    std::vector<NetworkInterfaceData> network{};
     std::chrono::system_clock::time_point timestamp{};
 
     auto operator<=>(const SystemStats&) const = default;
@@ -61,6 +226,10 @@ struct SystemStats {
 class SystemMonitor {
 public:
     explicit SystemMonitor();
+
+    // Reads raw counters through `backend` (recording, replay) instead of the live files; Linux only, as the
+    // Windows collector has no text sources to feed
+    explicit SystemMonitor(std::unique_ptr<CollectorBackend> backend);
     ~SystemMonitor();
 
     // Disable copy, enable move
@@ -72,69 +241,20 @@ public:
     Result<void> Initialize();
     Result<SystemStats> GetCurrentStats();
 
-    // C++23 coroutine generator for streaming data
-    struct StatsGenerator {
-        struct PromiseType {
-            SystemStats current_value;
-
-            StatsGenerator get_return_object() {
-                return StatsGenerator{std::coroutine_handle<PromiseType>::from_promise(*this)};
-            }
-
-            static std::suspend_always initial_suspend() noexcept {
-                return {};
-            }
-            static std::suspend_always final_suspend() noexcept {
-                return {};
-            }
-
-            std::suspend_always yield_value(SystemStats stats) {
-                current_value = std::move(stats);
-                return {};
-            }
-
-            void return_void() {}
-            static void unhandled_exception() {
-                std::terminate();
-            }
-        };
-
-        using promise_type = PromiseType;
-        std::coroutine_handle<PromiseType> coro;
-
-        explicit StatsGenerator(std::coroutine_handle<PromiseType> h) : coro(h) {}
-
-        ~StatsGenerator() {
-            if (coro) {
-                coro.destroy();
-            }
-        }
-
-        StatsGenerator(const StatsGenerator&) = delete;
-        StatsGenerator& operator=(const StatsGenerator&) = delete;
-
-        StatsGenerator(StatsGenerator&& other) noexcept : coro(std::exchange(other.coro, {})) {}
-        StatsGenerator& operator=(StatsGenerator&& other) noexcept {
-            if (this != &other) {
-                if (coro) {
-                    coro.destroy();
-                }
-                coro = std::exchange(other.coro, {});
-            }
-            return *this;
-        }
-
-        [[nodiscard]] bool move_next() const {
-            coro.resume();
-            return !coro.done();
-        }
-
-        [[nodiscard]] SystemStats current_value() const {
-            return coro.promise().current_value;
-        }
-    };
-
-    StatsGenerator StreamStats(std::chrono::milliseconds interval = std::chrono::milliseconds{1000});
+    // One metric group at a time, for callers that sample the groups on different intervals
+    Result<CPUUsageData> GetCpuStats();
+    Result<MemoryUsageData> GetMemoryStats();
+    Result<std::vector<DiskDeviceData>> GetDiskStats();
+    Result<std::vector<NetworkInterfaceData>> GetNetworkStats();
+
+    // Devices to collect; takes effect at the next Initialize(). Defaults to DefaultDisks()/DefaultNetwork().
+    void SetDeviceFilters(DeviceFilter disks, DeviceFilter network);
+
+    // Wall-clock time for stamping samples; the recorded time when replaying a capture
+    [[nodiscard]] std::chrono::system_clock::time_point Now() const;
+
+    // Fixed once Initialize() succeeds, so any thread may read it from then on; empty before
+    [[nodiscard]] const CpuTopology& Topology() const noexcept;
 
 private:
     class Impl;
@@ -172,6 +292,27 @@ inline std::string FormatBytes(std::uint64_t bytes) {
 inline std::string FormatPercentage(double percent) {
     return std::format("{:.1f}%", std::clamp(percent, 0.0, 100.0));
 }
+
+// "90", "90s", "5m" or "1h"; nullopt for anything else
+inline std::optional<std::chrono::seconds> ParseDuration(std::string_view text) {
+    std::int64_t Value = 0;
+    auto const [End, Ec] = std::from_chars(text.data(), text.data() + text.size(), Value);
+    if (Ec != std::errc{} || Value <= 0) {
+        return std::nullopt;
+    }
+
+    std::string_view const Unit(End, static_cast<std::size_t>(text.data() + text.size() - End));
+    if (Unit.empty() || Unit == "s") {
+        return std::chrono::seconds{Value};
+    }
+    if (Unit == "m") {
+        return std::chrono::minutes{Value};
+    }
+    if (Unit == "h") {
+        return std::chrono::hours{Value};
+    }
+    return std::nullopt;
+}
 }  // namespace utils
 
 }  // namespace pc_monitor
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+// Standard library includes first
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace pc_monitor {
+
+// Hashed timing wheel of absolute steady-clock deadlines. Slot i holds every entry whose deadline falls in a
+// tick congruent to i, so scheduling and cancelling are O(1) and expiring only visits the slots between the
+// previous and the current tick. Deadlines further out than one revolution share slots with nearer ones and
+// are skipped until their own revolution comes round. Not thread-safe; StatsSampler owns and locks it.
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Key = std::uint64_t;
+
+    static constexpr auto TICK = std::chrono::milliseconds{10};
+    static constexpr std::size_t SLOTS = 512;  // 5.12 s per revolution
+
+    struct Entry {
+        Key key{};
+        Clock::time_point deadline{};
+    };
+
+    explicit TimerWheel(Clock::time_point origin = Clock::now()) : origin_(origin) {}
+
+    // Deadlines already in the past go into the current tick and expire on the next Expire()
+    void Schedule(Key key, Clock::time_point deadline);
+
+    // `deadline` must be the one the entry was scheduled with; returns false when no such entry is pending
+    bool Cancel(Key key, Clock::time_point deadline);
+
+    // Earliest pending deadline, or nullopt when the wheel is empty
+    [[nodiscard]] std::optional<Clock::time_point> NextDeadline() const;
+
+    // Moves every entry with deadline <= now into `due`, earliest first
+    void Expire(Clock::time_point now, std::vector<Entry>& due);
+
+    [[nodiscard]] std::size_t Size() const noexcept {
+        return size_;
+    }
+
+private:
+    [[nodiscard]] std::uint64_t TickOf(Clock::time_point time) const noexcept;
+
+    Clock::time_point origin_;
+    std::uint64_t cursor_{0};  // first tick not yet fully expired
+    std::size_t size_{0};
+    std::array<std::vector<Entry>, SLOTS> slots_{};
+};
+
+}  // namespace pc_monitor
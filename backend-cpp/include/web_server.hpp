@@ -2,24 +2,74 @@
 
 // Standard library includes first
 #include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
 #include <string_view>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 // Third-party includes
 #include <httplib.h>
 #include <nlohmann/json.hpp>
 
 // Local includes last
+#include "alert_rules.hpp"
+#include "binary_codec.hpp"
+#include "cgroup_monitor.hpp"
+#include "event_http_server.hpp"
+#include "fleet_aggregator.hpp"
+#include "metrics_store.hpp"
+#include "perf_stats.hpp"
+#include "prometheus.hpp"
+#include "process_monitor.hpp"
+#include "stats_delta.hpp"
+#include "stats_history.hpp"
+#include "stats_sampler.hpp"
+#include "stream_hub.hpp"
 #include "system_monitor.hpp"
+#include "websocket.hpp"
 
 namespace pc_monitor {
 
+// One published sample serialized once. Every response and stream frame for that sample shares these
+// buffers; they are immutable after rendering and freed when the last response referencing them is done.
+struct RenderedStats {
+    StatsSampler::Snapshot stats;
+    std::string statsBody;    // /api/stats
+    std::string cpuBody;      // /api/cpu
+    std::string memoryBody;   // /api/memory
+    std::string streamFrame;  // SSE "data: {type:stats,timestamp,data}\n\n" for /ws/stats
+    std::string binaryBody;   // /api/stats as a binary stats message
+    std::string binaryFrame;  // binaryBody with its length prefix, for the binary /ws/stats stream
+
+    // Ref-counted view of one body that keeps the whole rendering alive
+    static std::shared_ptr<const std::string> Share(const std::shared_ptr<const RenderedStats>& rendered,
+                                                    const std::string RenderedStats::*body) {
+        return {rendered, &((*rendered).*body)};
+    }
+};
+
+// Serves a shared buffer straight from memory without copying it into the response
+void SetSharedContent(httplib::Response& res, std::shared_ptr<const std::string> body, const char* contentType);
+
 class WebServer {
 public:
-    explicit WebServer(std::shared_ptr<SystemMonitor> monitor, std::uint16_t port = 3001);
+    // WebSocket clients connect to ws://host:wsPort/ws/stats; httplib cannot upgrade connections, so
+    // the WebSocket transport listens on its own port. When a store is given, /api/history starts out with
+    // the samples it kept from earlier runs. Alert rules are evaluated on every published sample. With a fleet
+    // aggregator, /api/fleet serves the upstream instances it polls. With ioThreads, HTTP is served by an
+    // EventHttpServer with that many I/O threads instead of httplib's thread per connection.
+    explicit WebServer(std::shared_ptr<StatsSampler> sampler,
+                       std::uint16_t port = 3001,
+                       std::uint16_t wsPort = 3003,
+                       const std::shared_ptr<const MetricsStore>& store = nullptr,
+                       std::vector<AlertRule> rules = {},
+                       std::shared_ptr<const FleetAggregator> fleet = nullptr,
+                       std::size_t ioThreads = 0);
     ~WebServer();
 
     // Disable copy and move (due to atomic members)
@@ -37,33 +87,93 @@ public:
 private:
     void SetupRoutes();
     void SetupCors();
+
+    // GET route with its own request latency histogram in /debug/perf
+    void Route(const std::string& path, httplib::Server::Handler handler);
+
     void HandleCpuEndpoint(const httplib::Request& req, httplib::Response& res);
     void HandleMemoryEndpoint(const httplib::Request& req, httplib::Response& res);
     void HandleStatsEndpoint(const httplib::Request& req, httplib::Response& res);
+    void HandleHistoryEndpoint(const httplib::Request& req, httplib::Response& res);
+    void HandleHistorySummaryEndpoint(const httplib::Request& req, httplib::Response& res);
+    void HandleProcessesEndpoint(const httplib::Request& req, httplib::Response& res);
+    void HandleCgroupsEndpoint(const httplib::Request& req, httplib::Response& res);
+    void HandleAlertsEndpoint(const httplib::Request& req, httplib::Response& res);
+    void HandleFleetEndpoint(const httplib::Request& req, httplib::Response& res);
+    void HandleFleetHostEndpoint(const httplib::Request& req, httplib::Response& res);
+    void HandleSamplingEndpoint(const httplib::Request& req, httplib::Response& res);
+    void HandlePerfEndpoint(const httplib::Request& req, httplib::Response& res);
+    void HandleMetricsEndpoint(const httplib::Request& req, httplib::Response& res);
+
+    // Renders each published snapshot once on the sampler thread
+    void RenderSnapshot(const StatsSampler::Snapshot& stats);
+    void SendRendered(httplib::Response& res,
+                      const std::string RenderedStats::*body,
+                      std::string_view what,
+                      const char* contentType = "application/json");
+
+    // Server-Sent Events stream fed from streamHub_, or length-prefixed binary messages from binaryStreamHub_
+    void HandleStatsStream(const httplib::Request& req, httplib::Response& res);
+    EventHttpServer::StreamSource StatsStreamSource(WireFormat format, httplib::Response& res);
 
-    // WebSocket support
-    void HandleWebSocket(const httplib::Request& req, httplib::Response& res);
+    // WebSocket support: a full snapshot on connect, then per-sample deltas
+    void HandleWebSocketOpen(const std::shared_ptr<WebSocketConnection>& client);
     void BroadcastStats();
+    void BroadcastAlerts(const std::vector<std::string>& messages);
+    // Drops closed clients from wsClients_ and returns the open ones; the caller holds clientsMutex_
+    std::vector<std::shared_ptr<WebSocketConnection>> CollectClientsLocked();
     void StartBroadcastThread();
 
-    std::shared_ptr<SystemMonitor> monitor_;
-    std::unique_ptr<httplib::Server> server_{};
+    std::shared_ptr<StatsSampler> sampler_;
+    std::shared_ptr<const std::string> topologyBody_;  // /api/topology
+    StatsSampler::ListenerId renderListener_{};
+    std::atomic<std::shared_ptr<const RenderedStats>> rendered_{};
+    PrometheusRenderer prometheus_;  // only used by RenderSnapshot
+    std::atomic<std::shared_ptr<const std::string>> metrics_{};
+    StatsHistory history_;
+    AlertEngine alerts_;                   // evaluated by RenderSnapshot
+    std::vector<AlertEvent> alertEvents_;  // RenderSnapshot scratch
+
+    // Rescanned by a sampler task on its own interval; processTask_ is 0 when /proc cannot be read
+    ProcessMonitor processes_;
+    StatsSampler::TaskId processTask_{};
+    CgroupMonitor cgroups_;  // cgroupTask_ is 0 without a cgroup v2 hierarchy
+    StatsSampler::TaskId cgroupTask_{};
+    std::shared_ptr<const FleetAggregator> fleet_;  // null unless federating
+    StreamHub streamHub_;
+    StreamHub binaryStreamHub_;
+    std::atomic<std::size_t> pooledStreams_{0};  // open httplib streams, each holding a pool worker
+    std::unique_ptr<httplib::Server> server_{};       // null when eventServer_ serves HTTP
+    std::unique_ptr<EventHttpServer> eventServer_{};  // only with ioThreads
     std::uint16_t port_;
-    std::atomic<bool> running_{false};
+    std::unordered_map<std::string, perf::HistogramId> routeLatency_;  // filled by SetupRoutes, then read-only
+    std::atomic<bool> running_{false};  // serving; cleared by Stop() or when httplib's accept loop ends
+    bool started_{false};               // Start() succeeded and Stop() has not cleaned up yet
+    std::thread listenThread_;          // httplib accept loop (not with eventServer_)
 
     // WebSocket clients management
+    std::uint16_t wsPort_;
+    std::unique_ptr<WebSocketListener> wsListener_;
     std::mutex clientsMutex_;
-    std::set<std::weak_ptr<httplib::Response>, std::owner_less<std::weak_ptr<httplib::Response>>> wsClients_;
+    std::set<std::weak_ptr<WebSocketConnection>, std::owner_less<std::weak_ptr<WebSocketConnection>>> wsClients_;
+    std::atomic<std::size_t> wsClientCount_{0};  // wsClients_.size(), readable without clientsMutex_
     std::thread broadcastThread_;
     std::atomic<bool> shouldBroadcast_{false};
+    std::mutex broadcastMutex_;
+    std::condition_variable broadcastWake_;
+    std::uint64_t renderSequence_{0};  // bumped by RenderSnapshot under broadcastMutex_
+    std::vector<std::string> wsPendingAlerts_;  // alert messages not yet sent (guarded by broadcastMutex_)
+
+    // Delta baseline shared by every client that received the previous frame (guarded by clientsMutex_)
+    StatsSampler::Snapshot wsLastBroadcast_;
+    QuantizedStats wsBaseline_;
+    std::uint64_t wsSequence_{0};
+    std::shared_ptr<const std::string> wsFullFrame_;
 };
 
 // JSON serialization functions using C++23 features
 namespace json {
-nlohmann::json ToJson(const CPUCoreData& core);
-nlohmann::json ToJson(const CPUUsageData& cpu);
-nlohmann::json ToJson(const MemoryUsageData& memory);
-nlohmann::json ToJson(const SystemStats& stats);
+std::shared_ptr<const RenderedStats> Render(StatsSampler::Snapshot stats);
 
 inline nlohmann::json ErrorResponse(SystemError error, std::string_view message) {
     return nlohmann::json{
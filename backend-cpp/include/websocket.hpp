@@ -0,0 +1,117 @@
+#pragma once
+
+// Standard library includes first
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Local includes last
+#include "system_monitor.hpp"
+
+namespace pc_monitor {
+
+#if defined(_WIN32)
+using SocketHandle = std::uintptr_t;
+#else
+using SocketHandle = int;
+#endif
+
+// Server side of one RFC 6455 connection whose opening handshake has completed
+class WebSocketConnection {
+public:
+    explicit WebSocketConnection(SocketHandle socket);
+    ~WebSocketConnection();
+
+    WebSocketConnection(const WebSocketConnection&) = delete;
+    WebSocketConnection& operator=(const WebSocketConnection&) = delete;
+    WebSocketConnection(WebSocketConnection&&) = delete;
+    WebSocketConnection& operator=(WebSocketConnection&&) = delete;
+
+    // Sends one unfragmented frame without blocking: what the socket does not take is queued and flushed by
+    // the listener thread. On failure, or once the queue would exceed its bound, the connection is closed and
+    // false returned.
+    bool SendText(std::string_view payload);
+    bool SendFrame(std::uint8_t opcode, std::string_view payload);
+
+    // Sends a close frame (best effort) and shuts the socket down
+    void Close(std::uint16_t code = 1000);
+
+    [[nodiscard]] bool IsOpen() const noexcept {
+        return open_.load();
+    }
+
+    // Sequence number of the last stats frame accepted for this client. Queued frames are written whole and
+    // in order (or the connection is closed), so it is the baseline the client holds for the next delta.
+    std::uint64_t lastSequence{0};
+
+private:
+    friend class WebSocketListener;
+
+    void ShutdownLocked();
+    bool HasPendingOutput();
+    // Writes queued output until the socket would block; false once the connection failed
+    bool FlushPending();
+
+    std::mutex sendMutex_;
+    SocketHandle socket_;
+    std::string pendingOutput_;  // guarded by sendMutex_
+    std::atomic<bool> open_{true};
+    std::string readBuffer_;  // touched by the listener thread only
+};
+
+// Minimal RFC 6455 server: accepts connections for one path, completes the handshake, answers ping and
+// close frames, and hands each open connection to the owner, which does all application-level sending.
+class WebSocketListener {
+public:
+    using OpenHandler = std::function<void(const std::shared_ptr<WebSocketConnection>&)>;
+
+    WebSocketListener(std::string path, OpenHandler onOpen);
+    ~WebSocketListener();
+
+    WebSocketListener(const WebSocketListener&) = delete;
+    WebSocketListener& operator=(const WebSocketListener&) = delete;
+    WebSocketListener(WebSocketListener&&) = delete;
+    WebSocketListener& operator=(WebSocketListener&&) = delete;
+
+    Result<void> Start(const std::string& host, std::uint16_t port);
+    void Stop();
+
+    [[nodiscard]] std::size_t ConnectionCount() const noexcept {
+        return connectionCount_.load();
+    }
+
+private:
+    struct PendingHandshake {
+        SocketHandle socket;
+        std::string request;
+        std::chrono::steady_clock::time_point accepted;
+    };
+
+    void Run();
+    void AcceptPending();
+    // Returns false once the pending socket has been answered (upgraded or rejected)
+    bool ReadHandshake(PendingHandshake& pending);
+    // Returns false when the connection ended
+    bool ReadFrames(WebSocketConnection& connection);
+
+    std::string path_;
+    OpenHandler onOpen_;
+
+    SocketHandle listenSocket_;
+    std::atomic<bool> running_{false};
+    std::thread ioThread_;
+
+    std::chrono::steady_clock::time_point acceptResume_{};  // listener not polled before this (I/O thread only)
+    std::vector<PendingHandshake> pending_;
+    std::vector<std::shared_ptr<WebSocketConnection>> connections_;
+    std::atomic<std::size_t> connectionCount_{0};
+};
+
+}  // namespace pc_monitor
@@ -0,0 +1,566 @@
+#include "alert_rules.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <utility>
+
+#include <nlohmann/json.hpp>
+
+namespace pc_monitor {
+
+namespace {
+constexpr std::string_view FIRING = "firing";
+constexpr std::string_view RESOLVED = "resolved";
+constexpr double MISSING = std::numeric_limits<double>::quiet_NaN();
+
+// What one rule instance reads from a sample
+enum class Source : std::uint8_t { HOST, CORE, PACKAGE, DISK, NETWORK };
+
+template <typename Data>
+struct Reading {
+    std::string_view metric;
+    double (*read)(const Data&);
+};
+
+double PressureAverage(const std::optional<SystemPressure>& pressure,
+                       ResourcePressure SystemPressure::*resource,
+                       bool full) {
+    if (!pressure) {
+        return MISSING;
+    }
+    const auto& Resource = (*pressure).*resource;
+    if (full) {
+        return Resource.full ? Resource.full->avg10 : MISSING;
+    }
+    return Resource.some.avg10;
+}
+
+// Pressure metrics read the 10 s average
+constexpr std::array HOST_READINGS{
+    Reading<SystemStats>{"cpu.overall", [](const SystemStats& stats) { return stats.cpu.overall; }},
+    Reading<SystemStats>{"cpu.temperature",
+                         [](const SystemStats& stats) { return stats.cpu.temperature.value_or(MISSING); }},
+    Reading<SystemStats>{"memory.usagePercent", [](const SystemStats& stats) { return stats.memory.usagePercent; }},
+    Reading<SystemStats>{"memory.available",
+                         [](const SystemStats& stats) { return static_cast<double>(stats.memory.available); }},
+    Reading<SystemStats>{"memory.used",
+                         [](const SystemStats& stats) { return static_cast<double>(stats.memory.used); }},
+    Reading<SystemStats>{"memory.cache",
+                         [](const SystemStats& stats) { return static_cast<double>(stats.memory.cache); }},
+    Reading<SystemStats>{"memory.dirty",
+                         [](const SystemStats& stats) { return static_cast<double>(stats.memory.dirty); }},
+    Reading<SystemStats>{"memory.writeback",
+                         [](const SystemStats& stats) { return static_cast<double>(stats.memory.writeback); }},
+    Reading<SystemStats>{"memory.swapUsed",
+                         [](const SystemStats& stats) { return static_cast<double>(stats.memory.swapUsed); }},
+    Reading<SystemStats>{"pressure.cpu.some",
+                         [](const SystemStats& stats) {
+                             return PressureAverage(stats.memory.pressure, &SystemPressure::cpu, false);
+                         }},
+    Reading<SystemStats>{"pressure.io.some",
+                         [](const SystemStats& stats) {
+                             return PressureAverage(stats.memory.pressure, &SystemPressure::io, false);
+                         }},
+    Reading<SystemStats>{"pressure.io.full",
+                         [](const SystemStats& stats) {
+                             return PressureAverage(stats.memory.pressure, &SystemPressure::io, true);
+                         }},
+    Reading<SystemStats>{"pressure.memory.some",
+                         [](const SystemStats& stats) {
+                             return PressureAverage(stats.memory.pressure, &SystemPressure::memory, false);
+                         }},
+    Reading<SystemStats>{"pressure.memory.full",
+                         [](const SystemStats& stats) {
+                             return PressureAverage(stats.memory.pressure, &SystemPressure::memory, true);
+                         }},
+};
+
+constexpr std::array CORE_READINGS{
+    Reading<CPUCoreData>{"cpu.core.usage", [](const CPUCoreData& core) { return core.usage; }},
+    Reading<CPUCoreData>{"cpu.core.frequency",
+                         [](const CPUCoreData& core) { return static_cast<double>(core.frequency); }},
+    Reading<CPUCoreData>{"cpu.core.temperature",
+                         [](const CPUCoreData& core) { return core.temperature.value_or(MISSING); }},
+};
+
+constexpr std::array PACKAGE_READINGS{
+    Reading<CpuPackageThermal>{"cpu.package.temperature",
+                               [](const CpuPackageThermal& package) { return package.temperature; }},
+};
+
+constexpr std::string_view DISK_PREFIX = "disk.";
+constexpr std::string_view NETWORK_PREFIX = "network.";
+
+struct Probe {
+    Source source{};
+    std::uint8_t field{};
+};
+
+template <typename Table>
+std::optional<std::uint8_t> FieldIndex(const Table& table, std::string_view metric) {
+    auto const Found = std::ranges::find(table, metric, [](const auto& entry) {
+        if constexpr (requires { entry.metric; }) {
+            return entry.metric;
+        } else {
+            return entry.key;
+        }
+    });
+    if (Found == table.end()) {
+        return std::nullopt;
+    }
+    return static_cast<std::uint8_t>(Found - table.begin());
+}
+
+std::optional<Probe> Resolve(std::string_view metric) {
+    if (auto const Field = FieldIndex(HOST_READINGS, metric)) {
+        return Probe{Source::HOST, *Field};
+    }
+    if (auto const Field = FieldIndex(CORE_READINGS, metric)) {
+        return Probe{Source::CORE, *Field};
+    }
+    if (auto const Field = FieldIndex(PACKAGE_READINGS, metric)) {
+        return Probe{Source::PACKAGE, *Field};
+    }
+    if (metric.starts_with(DISK_PREFIX)) {
+        if (auto const Field = FieldIndex(DISK_RATE_FIELDS, metric.substr(DISK_PREFIX.size()))) {
+            return Probe{Source::DISK, *Field};
+        }
+    }
+    if (metric.starts_with(NETWORK_PREFIX)) {
+        if (auto const Field = FieldIndex(NETWORK_RATE_FIELDS, metric.substr(NETWORK_PREFIX.size()))) {
+            return Probe{Source::NETWORK, *Field};
+        }
+    }
+    return std::nullopt;
+}
+
+std::int64_t ToMs(std::chrono::system_clock::time_point time) noexcept {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point FromMs(std::int64_t ms) noexcept {
+    return std::chrono::system_clock::time_point{std::chrono::milliseconds{ms}};
+}
+
+// The field `member` of every element, in order
+template <typename Element, typename Value>
+std::vector<Value> Project(const std::vector<Element>& elements, Value Element::*member) {
+    std::vector<Value> Result;
+    Result.reserve(elements.size());
+    for (const auto& Item : elements) {
+        Result.push_back(Item.*member);
+    }
+    return Result;
+}
+
+const nlohmann::json* Member(const nlohmann::json& object, const char* key) {
+    auto const Found = object.find(key);
+    return Found == object.end() ? nullptr : &*Found;
+}
+}  // namespace
+
+class AlertEngine::Plan {
+public:
+    // One rule's comparison, folded into a sign so every test is "greater than", and its instances, which
+    // are contiguous in `checks`
+    struct RuleBlock {
+        double sign{};   // +1 for above, -1 for below
+        double enter{};  // sign * threshold
+        double exit{};   // sign * clear
+        std::int64_t holdMs{};
+        std::uint32_t rule{};
+        std::uint32_t first{};
+        std::uint32_t count{};
+        Probe probe;
+    };
+
+    // State of one rule instance; its label lives in the parallel `instances`
+    struct CheckState {
+        double value{};             // the value it fired with
+        std::int64_t sinceMs = -1;  // when the condition started to hold; -1 while it does not
+        std::uint32_t instance{};   // index into the sample's cores, packages, disks or interfaces
+        bool firing = false;
+    };
+
+    std::vector<AlertRule> rules;
+    std::vector<Probe> probes;  // by rule
+    std::vector<RuleBlock> blocks;
+    std::vector<CheckState> checks;
+    std::vector<std::string> instances;
+
+    // Layout the checks were built for
+    bool built = false;
+    std::vector<std::uint32_t> coreIds;
+    std::vector<std::uint32_t> packageIds;
+    std::vector<std::string> diskNames;
+    std::vector<std::string> interfaceNames;
+
+    explicit Plan(std::vector<AlertRule> parsed) : rules(std::move(parsed)) {
+        probes.reserve(rules.size());
+        for (const auto& Rule : rules) {
+            probes.push_back(Resolve(Rule.metric).value_or(Probe{}));
+        }
+    }
+
+    void Evaluate(const SystemStats& stats, std::vector<AlertEvent>& events) {
+        if (rules.empty()) {
+            return;
+        }
+        if (!built || !SameLayout(stats)) {
+            Rebuild(stats, events);
+        }
+
+        // The reads are dispatched once per rule, so the loop over its instances inlines them
+        for (const auto& Compiled : blocks) {
+            auto const Field = Compiled.probe.field;
+            switch (Compiled.probe.source) {
+                case Source::HOST:
+                    WithReading<HOST_READINGS>(Field, [&](auto read) {
+                        Run(Compiled, std::span(&stats, 1), read, stats.timestamp, events);
+                    });
+                    break;
+                case Source::CORE:
+                    WithReading<CORE_READINGS>(Field, [&](auto read) {
+                        Run(Compiled, std::span(stats.cpu.cores), read, stats.timestamp, events);
+                    });
+                    break;
+                case Source::PACKAGE:
+                    WithReading<PACKAGE_READINGS>(Field, [&](auto read) {
+                        Run(Compiled, std::span(stats.cpu.packages), read, stats.timestamp, events);
+                    });
+                    break;
+                case Source::DISK:
+                    Run(Compiled,
+                        std::span(stats.disks),
+                        [Member = DISK_RATE_FIELDS[Field].member](const DiskDeviceData& disk) { return disk.*Member; },
+                        stats.timestamp,
+                        events);
+                    break;
+                case Source::NETWORK:
+                    Run(Compiled,
+                        std::span(stats.network),
+                        [Member = NETWORK_RATE_FIELDS[Field].member](const NetworkInterfaceData& nic) {
+                            return nic.*Member;
+                        },
+                        stats.timestamp,
+                        events);
+                    break;
+            }
+        }
+    }
+
+    [[nodiscard]] std::vector<AlertEvent> FiringAlerts(std::chrono::system_clock::time_point now) const {
+        std::vector<AlertEvent> Result;
+        for (const auto& Compiled : blocks) {
+            for (auto I = Compiled.first; I < Compiled.first + Compiled.count; ++I) {
+                if (checks[I].firing) {
+                    Result.push_back(MakeEvent(Compiled.rule, I, FIRING, checks[I].value, now));
+                }
+            }
+        }
+        return Result;
+    }
+
+private:
+    // Calls body with a reader for table[field] fixed at compile time
+    template <const auto& TABLE, std::size_t N = 0, typename Body>
+    static void WithReading(std::size_t field, Body&& body) {
+        if constexpr (N < TABLE.size()) {
+            if (field == N) {
+                body([](const auto& data) { return TABLE[N].read(data); });
+                return;
+            }
+            WithReading<TABLE, N + 1>(field, std::forward<Body>(body));
+        }
+    }
+
+    // Most checks stay quiet or stay firing from one sample to the next; those are told apart from the rest
+    // without a data-dependent branch, which would mispredict on every core whose value sits near a threshold
+    template <typename Data, typename Read>
+    void Run(const RuleBlock& block,
+             std::span<const Data> items,
+             Read read,
+             std::chrono::system_clock::time_point timestamp,
+             std::vector<AlertEvent>& events) {
+        for (auto I = block.first; I < block.first + block.count; ++I) {
+            const auto& Check = checks[I];
+            auto const Value = read(items[Check.instance]);
+            auto const Signed = block.sign * Value;
+            bool const Up = Signed > block.enter;  // NaN (no reading) is neither up nor down
+            bool const Down = Signed <= block.exit;
+            bool const Moving = Check.firing ? Down : (Up | (Check.sinceMs >= 0));
+            if (Moving) [[unlikely]] {
+                Step(block, I, Value, Up, timestamp, events);
+            }
+        }
+    }
+
+    void Step(const RuleBlock& block,
+              std::uint32_t check,
+              double value,
+              bool up,
+              std::chrono::system_clock::time_point timestamp,
+              std::vector<AlertEvent>& events) {
+        auto& Check = checks[check];
+        if (std::isnan(value)) {
+            return;  // the state carries over
+        }
+        if (Check.firing) {
+            events.push_back(MakeEvent(block.rule, check, RESOLVED, value, timestamp));
+            Check.firing = false;
+            Check.sinceMs = -1;
+            return;
+        }
+        if (!up) {
+            Check.sinceMs = -1;  // fell back before the hold elapsed
+            return;
+        }
+
+        auto const NowMs = ToMs(timestamp);
+        if (Check.sinceMs < 0) {
+            Check.sinceMs = NowMs;
+        }
+        if (NowMs - Check.sinceMs >= block.holdMs) {
+            Check.firing = true;
+            Check.value = value;
+            events.push_back(MakeEvent(block.rule, check, FIRING, value, timestamp));
+        }
+    }
+
+    [[nodiscard]] AlertEvent MakeEvent(std::uint32_t rule,
+                                       std::size_t check,
+                                       std::string_view state,
+                                       double value,
+                                       std::chrono::system_clock::time_point timestamp) const {
+        const auto& Rule = rules[rule];
+        return AlertEvent{.rule = Rule.name,
+                          .metric = Rule.metric,
+                          .instance = instances[check],
+                          .severity = Rule.severity,
+                          .state = state,
+                          .value = value,
+                          .threshold = Rule.threshold,
+                          .since = FromMs(checks[check].sinceMs),
+                          .timestamp = timestamp};
+    }
+
+    [[nodiscard]] bool SameLayout(const SystemStats& stats) const {
+        return std::ranges::equal(coreIds, stats.cpu.cores, {}, {}, &CPUCoreData::coreId) &&
+               std::ranges::equal(packageIds, stats.cpu.packages, {}, {}, &CpuPackageThermal::package) &&
+               std::ranges::equal(diskNames, stats.disks, {}, {}, &DiskDeviceData::name) &&
+               std::ranges::equal(interfaceNames, stats.network, {}, {}, &NetworkInterfaceData::name);
+    }
+
+    // One block per rule with a check per matching core, package or device. Instances that survive keep
+    // their state by (rule, label); those that went away while firing resolve with no value.
+    void Rebuild(const SystemStats& stats, std::vector<AlertEvent>& events) {
+        std::map<std::pair<std::uint32_t, std::string>, CheckState> Previous;
+        for (const auto& Compiled : blocks) {
+            for (auto I = Compiled.first; I < Compiled.first + Compiled.count; ++I) {
+                Previous.emplace(std::pair{Compiled.rule, std::move(instances[I])}, checks[I]);
+            }
+        }
+        blocks.clear();
+        checks.clear();
+        instances.clear();
+
+        auto const Add = [&](std::uint32_t rule, std::size_t instance, std::string label) {
+            CheckState Added{.instance = static_cast<std::uint32_t>(instance)};
+            if (auto const Kept = Previous.find(std::pair{rule, label}); Kept != Previous.end()) {
+                Added.value = Kept->second.value;
+                Added.sinceMs = Kept->second.sinceMs;
+                Added.firing = Kept->second.firing;
+                Previous.erase(Kept);
+            }
+            checks.push_back(Added);
+            instances.push_back(std::move(label));
+        };
+
+        for (std::uint32_t R = 0; R < rules.size(); ++R) {
+            const auto& Rule = rules[R];
+            auto const First = static_cast<std::uint32_t>(checks.size());
+            switch (probes[R].source) {
+                case Source::HOST:
+                    Add(R, 0, {});
+                    break;
+                case Source::CORE:
+                    for (std::size_t I = 0; I < stats.cpu.cores.size(); ++I) {
+                        Add(R, I, std::to_string(stats.cpu.cores[I].coreId));
+                    }
+                    break;
+                case Source::PACKAGE:
+                    for (std::size_t I = 0; I < stats.cpu.packages.size(); ++I) {
+                        Add(R, I, std::to_string(stats.cpu.packages[I].package));
+                    }
+                    break;
+                case Source::DISK:
+                    for (std::size_t I = 0; I < stats.disks.size(); ++I) {
+                        if (Rule.devices.Matches(stats.disks[I].name)) {
+                            Add(R, I, stats.disks[I].name);
+                        }
+                    }
+                    break;
+                case Source::NETWORK:
+                    for (std::size_t I = 0; I < stats.network.size(); ++I) {
+                        if (Rule.devices.Matches(stats.network[I].name)) {
+                            Add(R, I, stats.network[I].name);
+                        }
+                    }
+                    break;
+            }
+            auto const Sign = Rule.above ? 1.0 : -1.0;
+            blocks.push_back(RuleBlock{.sign = Sign,
+                                   .enter = Sign * Rule.threshold,
+                                   .exit = Sign * Rule.clear,
+                                   .holdMs = Rule.hold.count(),
+                                   .rule = R,
+                                   .first = First,
+                                   .count = static_cast<std::uint32_t>(checks.size()) - First,
+                                   .probe = probes[R]});
+        }
+
+        for (auto& [Key, Gone] : Previous) {
+            if (Gone.firing) {
+                const auto& Rule = rules[Key.first];
+                events.push_back(AlertEvent{.rule = Rule.name,
+                                            .metric = Rule.metric,
+                                            .instance = std::move(Key.second),
+                                            .severity = Rule.severity,
+                                            .state = RESOLVED,
+                                            .value = MISSING,
+                                            .threshold = Rule.threshold,
+                                            .since = FromMs(Gone.sinceMs),
+                                            .timestamp = stats.timestamp});
+            }
+        }
+
+        coreIds = Project(stats.cpu.cores, &CPUCoreData::coreId);
+        packageIds = Project(stats.cpu.packages, &CpuPackageThermal::package);
+        diskNames = Project(stats.disks, &DiskDeviceData::name);
+        interfaceNames = Project(stats.network, &NetworkInterfaceData::name);
+        built = true;
+    }
+};
+
+std::expected<std::vector<AlertRule>, std::string> AlertEngine::Parse(std::string_view config) {
+    auto const Document = nlohmann::json::parse(config, nullptr, false);
+    const auto* List = Document.is_object() ? Member(Document, "rules") : nullptr;
+    if (List == nullptr || !List->is_array()) {
+        return std::unexpected(std::string(R"(expected {"rules":[...]})"));
+    }
+
+    std::vector<AlertRule> Rules;
+    Rules.reserve(List->size());
+    for (const auto& Entry : *List) {
+        auto const Fail = [&](std::string_view what) {
+            return std::unexpected(std::format("rule {}: {}", Rules.size() + 1, what));
+        };
+        if (!Entry.is_object()) {
+            return Fail("not an object");
+        }
+
+        AlertRule Rule;
+        const auto* Name = Member(Entry, "name");
+        const auto* Metric = Member(Entry, "metric");
+        if (Name == nullptr || !Name->is_string() || Metric == nullptr || !Metric->is_string()) {
+            return Fail("needs a name and a metric");
+        }
+        Rule.name = Name->get<std::string>();
+        Rule.metric = Metric->get<std::string>();
+        if (!Resolve(Rule.metric)) {
+            return Fail(std::format("unknown metric {}", Rule.metric));
+        }
+
+        const auto* Above = Member(Entry, "above");
+        const auto* Below = Member(Entry, "below");
+        const auto* Threshold = Above != nullptr ? Above : Below;
+        if ((Above == nullptr) == (Below == nullptr) || !Threshold->is_number()) {
+            return Fail("needs a number for exactly one of above and below");
+        }
+        Rule.above = Above != nullptr;
+        Rule.threshold = Threshold->get<double>();
+
+        Rule.clear = Rule.threshold;
+        if (const auto* Clear = Member(Entry, "clear")) {
+            if (!Clear->is_number()) {
+                return Fail("clear must be a number");
+            }
+            Rule.clear = Clear->get<double>();
+            if (Rule.above ? Rule.clear > Rule.threshold : Rule.clear < Rule.threshold) {
+                return Fail("clear must be on the resolved side of the threshold");
+            }
+        }
+
+        if (const auto* Hold = Member(Entry, "for")) {
+            std::optional<std::chrono::seconds> Parsed;
+            if (Hold->is_string()) {
+                Parsed = utils::ParseDuration(Hold->get<std::string>());
+            } else if (Hold->is_number_unsigned()) {
+                Parsed = std::chrono::seconds{Hold->get<std::int64_t>()};
+            }
+            if (!Parsed) {
+                return Fail("for must look like 30s, 5m or 1h");
+            }
+            Rule.hold = *Parsed;
+        }
+
+        if (const auto* Severity = Member(Entry, "severity")) {
+            if (!Severity->is_string() || (*Severity != "warning" && *Severity != "critical")) {
+                return Fail("severity must be warning or critical");
+            }
+            Rule.severity = Severity->get<std::string>();
+        }
+
+        if (const auto* Devices = Member(Entry, "devices")) {
+            if (!Devices->is_string()) {
+                return Fail(R"(devices must be a pattern list such as "nvme*,!loop*")");
+            }
+            Rule.devices = DeviceFilter::Parse(Devices->get<std::string>());
+        }
+        Rules.push_back(std::move(Rule));
+    }
+    return Rules;
+}
+
+std::expected<std::vector<AlertRule>, std::string> AlertEngine::Load(const std::filesystem::path& path) {
+    std::ifstream In(path, std::ios::binary);
+    std::ostringstream Content;
+    if (!In || !(Content << In.rdbuf())) {
+        return std::unexpected(std::format("cannot read {}", path.string()));
+    }
+    return Parse(Content.view());
+}
+
+AlertEngine::AlertEngine(std::vector<AlertRule> rules) : plan_(std::make_unique<Plan>(std::move(rules))) {}
+
+AlertEngine::~AlertEngine() = default;
+
+void AlertEngine::Evaluate(const SystemStats& stats, std::vector<AlertEvent>& events) {
+    std::lock_guard<std::mutex> const Lock(mutex_);
+    plan_->Evaluate(stats, events);
+    lastEvaluated_ = stats.timestamp;
+}
+
+std::vector<AlertEvent> AlertEngine::Firing() const {
+    std::lock_guard<std::mutex> const Lock(mutex_);
+    return plan_->FiringAlerts(lastEvaluated_);
+}
+
+std::size_t AlertEngine::RuleCount() const noexcept {
+    return plan_->rules.size();
+}
+
+std::size_t AlertEngine::CheckCount() const {
+    std::lock_guard<std::mutex> const Lock(mutex_);
+    return plan_->checks.size();
+}
+
+}  // namespace pc_monitor
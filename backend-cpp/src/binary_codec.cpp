@@ -0,0 +1,267 @@
+#include "binary_codec.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+namespace pc_monitor::binary {
+
+namespace {
+constexpr unsigned MAX_LEADING_ZEROS = 31;
+
+std::uint64_t ZigZag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+}  // namespace
+
+void BitWriter::WriteBits(std::uint64_t value, unsigned count) {
+    if (count > 32) {
+        WriteBits(value >> 32, count - 32);
+        count = 32;
+    }
+
+    // At most 7 bits are pending, so 32 more always fit the 64-bit accumulator
+    current_ = (current_ << count) | (value & ((std::uint64_t{1} << count) - 1));
+    currentBits_ += count;
+    while (currentBits_ >= 8) {
+        currentBits_ -= 8;
+        out_ += static_cast<char>(current_ >> currentBits_);
+    }
+}
+
+void BitWriter::WriteVarint(std::uint64_t value) {
+    while (value >= 0x80) {
+        WriteBits((value & 0x7F) | 0x80, 8);
+        value >>= 7;
+    }
+    WriteBits(value, 8);
+}
+
+void BitWriter::WriteSigned(std::int64_t value) {
+    WriteVarint(ZigZag(value));
+}
+
+void BitWriter::WriteString(std::string_view value) {
+    WriteVarint(value.size());
+    for (char const Char : value) {
+        WriteBits(static_cast<std::uint8_t>(Char), 8);
+    }
+}
+
+void BitWriter::Finish() {
+    if (currentBits_ != 0) {
+        WriteBits(0, 8 - currentBits_);
+    }
+}
+
+void XorEncoder::Put(double value) {
+    auto const Bits = std::bit_cast<std::uint64_t>(value);
+    if (first_) {
+        writer_.WriteBits(Bits, 64);
+        previous_ = Bits;
+        first_ = false;
+        return;
+    }
+
+    auto const Xor = Bits ^ previous_;
+    previous_ = Bits;
+    if (Xor == 0) {
+        writer_.WriteBit(false);
+        return;
+    }
+    writer_.WriteBit(true);
+
+    auto Leading = static_cast<unsigned>(std::countl_zero(Xor));
+    auto const Trailing = static_cast<unsigned>(std::countr_zero(Xor));
+    if (Leading > MAX_LEADING_ZEROS) {
+        Leading = MAX_LEADING_ZEROS;
+    }
+
+    // Reuse the previous window when the meaningful bits fit inside it
+    if (hasWindow_ && Leading >= leading_ && Trailing >= trailing_) {
+        writer_.WriteBit(false);
+        writer_.WriteBits(Xor >> trailing_, 64 - leading_ - trailing_);
+        return;
+    }
+
+    unsigned const Meaningful = 64 - Leading - Trailing;
+    writer_.WriteBit(true);
+    writer_.WriteBits(Leading, 5);
+    writer_.WriteBits(Meaningful & 0x3F, 6);
+    writer_.WriteBits(Xor >> Trailing, Meaningful);
+    leading_ = Leading;
+    trailing_ = Trailing;
+    hasWindow_ = true;
+}
+
+void TimestampEncoder::Put(std::int64_t timestampMs) {
+    if (count_++ == 0) {
+        writer_.WriteVarint(static_cast<std::uint64_t>(timestampMs));
+        previous_ = timestampMs;
+        return;
+    }
+
+    auto const Delta = timestampMs - previous_;
+    previous_ = timestampMs;
+    if (count_ == 2) {
+        writer_.WriteSigned(Delta);
+        previousDelta_ = Delta;
+        return;
+    }
+
+    auto const Encoded = ZigZag(Delta - previousDelta_);
+    previousDelta_ = Delta;
+    if (Encoded == 0) {
+        writer_.WriteBit(false);
+    } else if (Encoded < (1U << 7)) {
+        writer_.WriteBits(0b10, 2);
+        writer_.WriteBits(Encoded, 7);
+    } else if (Encoded < (1U << 9)) {
+        writer_.WriteBits(0b110, 3);
+        writer_.WriteBits(Encoded, 9);
+    } else if (Encoded < (1U << 12)) {
+        writer_.WriteBits(0b1110, 4);
+        writer_.WriteBits(Encoded, 12);
+    } else {
+        writer_.WriteBits(0b1111, 4);
+        writer_.WriteVarint(Encoded);
+    }
+}
+
+void AppendHeader(std::string& out, MessageType type) {
+    out += MAGIC;
+    out += static_cast<char>(type);
+}
+
+void AppendVarint(std::string& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+void AppendStats(std::string& out, const SystemStats& stats) {
+    const auto& Cores = stats.cpu.cores;
+    AppendHeader(out, MessageType::STATS);
+
+    BitWriter Writer(out);
+    Writer.WriteVarint(static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(stats.timestamp.time_since_epoch()).count()));
+    Writer.WriteVarint(Cores.size());
+    WriteCoreIds(Writer, Cores.size(), [&](std::size_t index) { return Cores[index].coreId; });
+    Writer.WriteBit(stats.cpu.temperature.has_value());
+
+    XorEncoder Values(Writer);
+    Values.Put(stats.cpu.overall);
+    if (stats.cpu.temperature) {
+        Values.Put(*stats.cpu.temperature);
+    }
+    Values.Put(stats.memory.usagePercent);
+    for (const auto& Core : Cores) {
+        Values.Put(Core.usage);
+    }
+
+    Writer.WriteVarint(stats.cpu.averageFrequency);
+    std::int64_t PreviousFrequency = 0;
+    for (std::size_t I = 0; I < Cores.size(); ++I) {
+        auto const Frequency = static_cast<std::int64_t>(Cores[I].frequency);
+        if (I == 0) {
+            Writer.WriteVarint(Cores[I].frequency);
+        } else {
+            Writer.WriteSigned(Frequency - PreviousFrequency);
+        }
+        PreviousFrequency = Frequency;
+    }
+
+    Writer.WriteVarint(stats.memory.total);
+    Writer.WriteVarint(stats.memory.used);
+    Writer.WriteVarint(stats.memory.available);
+    Writer.WriteVarint(stats.memory.cache);
+    Writer.WriteVarint(stats.memory.buffers);
+
+    WriteNames(Writer, stats.disks.size(), [&](std::size_t index) -> std::string_view {
+        return stats.disks[index].name;
+    });
+    WriteNames(Writer, stats.network.size(), [&](std::size_t index) -> std::string_view {
+        return stats.network[index].name;
+    });
+    XorEncoder Rates(Writer);
+    for (const auto& Disk : stats.disks) {
+        for (const auto& Field : DISK_RATE_FIELDS) {
+            Rates.Put(Disk.*Field.member);
+        }
+    }
+    for (const auto& Interface : stats.network) {
+        for (const auto& Field : NETWORK_RATE_FIELDS) {
+            Rates.Put(Interface.*Field.member);
+        }
+    }
+
+    const auto& Packages = stats.cpu.packages;
+    Writer.WriteVarint(Packages.size());
+    for (const auto& Package : Packages) {
+        Writer.WriteVarint(Package.package);
+        Writer.WriteBit(Package.critical.has_value());
+        Writer.WriteBit(Package.throttling);
+    }
+    auto const AnyCoreTemperature =
+        std::ranges::any_of(Cores, [](const CPUCoreData& core) { return core.temperature.has_value(); });
+    Writer.WriteBit(AnyCoreTemperature);
+    if (AnyCoreTemperature) {
+        for (const auto& Core : Cores) {
+            Writer.WriteBit(Core.temperature.has_value());
+        }
+    }
+    XorEncoder Temperatures(Writer);
+    for (const auto& Package : Packages) {
+        Temperatures.Put(Package.temperature);
+    }
+    for (const auto& Package : Packages) {
+        if (Package.critical) {
+            Temperatures.Put(*Package.critical);
+        }
+    }
+    for (const auto& Core : Cores) {
+        if (Core.temperature) {
+            Temperatures.Put(*Core.temperature);
+        }
+    }
+
+    const auto& Memory = stats.memory;
+    for (auto const Bytes : {Memory.slab,
+                             Memory.dirty,
+                             Memory.writeback,
+                             Memory.swapTotal,
+                             Memory.swapUsed,
+                             Memory.hugePagesTotal,
+                             Memory.hugePagesFree}) {
+        Writer.WriteVarint(Bytes);
+    }
+    Writer.WriteBit(Memory.pressure.has_value());
+    if (Memory.pressure) {
+        std::array<const ResourcePressure*, 3> const Resources{
+            &Memory.pressure->cpu, &Memory.pressure->io, &Memory.pressure->memory};
+        for (const auto* Resource : Resources) {
+            Writer.WriteBit(Resource->full.has_value());
+        }
+        auto const ForEachStall = [&](auto&& visit) {
+            for (const auto* Resource : Resources) {
+                visit(Resource->some);
+                if (Resource->full) {
+                    visit(*Resource->full);
+                }
+            }
+        };
+        XorEncoder Averages(Writer);
+        ForEachStall([&](const PressureStall& stall) {
+            Averages.Put(stall.avg10);
+            Averages.Put(stall.avg60);
+            Averages.Put(stall.avg300);
+        });
+        ForEachStall([&](const PressureStall& stall) { Writer.WriteVarint(stall.total); });
+    }
+    Writer.Finish();
+}
+
+}  // namespace pc_monitor::binary
@@ -0,0 +1,500 @@
+#include "cgroup_monitor.hpp"
+
+#include "proc_file.hpp"
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+#include <utility>
+
+#if defined(__linux__)
+    #include <cerrno>
+    #include <cstdint>
+    #include <cstring>
+    #include <unordered_map>
+
+    #include <dirent.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+namespace pc_monitor {
+
+#if defined(_WIN32)
+
+// Windows has no cgroup hierarchy to walk, so the collector never initializes and /api/cgroups answers 500
+class CgroupMonitor::Impl {
+public:
+    Result<void> Initialize(std::string_view /*root*/) {
+        return std::unexpected(SystemError::INITIALIZATION_FAILED);
+    }
+
+    Result<void> Scan(CgroupTable& /*table*/) {
+        return std::unexpected(SystemError::DATA_UNAVAILABLE);
+    }
+};
+
+#elif defined(__linux__)
+namespace {
+
+using procfs::ProcFile;
+
+enum CgroupFile : std::uint8_t { CPU_STAT, MEMORY_CURRENT, MEMORY_STAT, IO_STAT, FILE_COUNT };
+
+constexpr std::array<std::string_view, FILE_COUNT> FILE_NAMES{
+    "/cpu.stat", "/memory.current", "/memory.stat", "/io.stat"};
+
+// Pure v2 mount first, then the v2 half of a hybrid setup
+constexpr std::array<std::string_view, 2> DEFAULT_ROOTS{"/sys/fs/cgroup", "/sys/fs/cgroup/unified"};
+
+// Directory events only: cgroupfs creates and removes the interface files itself, without notifications
+constexpr std::uint32_t WATCH_EVENTS = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+// Value of the first line that starts with `key` (trailing blank included)
+bool FindKey(std::string_view text, std::string_view key, std::uint64_t& value) noexcept {
+    while (!text.empty()) {
+        auto Line = procfs::NextLine(text);
+        if (Line.starts_with(key)) {
+            Line.remove_prefix(key.size());
+            return procfs::NextUnsigned(Line, value);
+        }
+    }
+    return false;
+}
+
+// io.stat: "MAJ:MIN rbytes=N wbytes=N rios=N wios=N dbytes=N dios=N" per device
+void SumIoStat(std::string_view text, std::uint64_t& readBytes, std::uint64_t& writeBytes) noexcept {
+    constexpr std::string_view READ_KEY = "rbytes=";
+    constexpr std::string_view WRITE_KEY = "wbytes=";
+    readBytes = 0;
+    writeBytes = 0;
+    while (!text.empty()) {
+        auto Line = procfs::NextLine(text);
+        while (!Line.empty()) {
+            auto const End = Line.find(' ');
+            auto Token = Line.substr(0, End);
+            Line.remove_prefix(End == std::string_view::npos ? Line.size() : End + 1);
+
+            std::uint64_t Value = 0;
+            if (Token.starts_with(READ_KEY)) {
+                Token.remove_prefix(READ_KEY.size());
+                readBytes += procfs::NextUnsigned(Token, Value) ? Value : 0;
+            } else if (Token.starts_with(WRITE_KEY)) {
+                Token.remove_prefix(WRITE_KEY.size());
+                writeBytes += procfs::NextUnsigned(Token, Value) ? Value : 0;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+class CgroupMonitor::Impl {
+public:
+    struct Node {
+        std::string name;
+        CgroupInfo info;  // path, and the values of the last scan that read this cgroup
+        std::array<ProcFile, FILE_COUNT> files;
+        bool cached = false;  // files were opened within the descriptor budget; otherwise opened per read
+        int watch = -1;
+        std::uint64_t usage{};  // cpu.stat usage_usec at the previous scan
+        bool measured = false;  // usage holds a previous reading
+        std::uint64_t readBytes{};
+        std::uint64_t writeBytes{};
+        std::chrono::steady_clock::time_point ioRead{};  // when readBytes and writeBytes were read
+        std::vector<std::unique_ptr<Node>> children;     // sorted by name
+    };
+
+    std::string root;  // hierarchy mount point
+    Node tree;         // the root cgroup; its own files are not read
+    std::unordered_map<int, Node*> watches;
+    int inotify = -1;
+    bool polling = false;  // no inotify, or out of watches: the tree is reconciled every REFRESH_SCANS scans
+    bool rescan = false;   // the event queue overflowed
+    std::size_t handleBudget{};
+    std::size_t openHandles{};
+    std::size_t cgroups{};  // nodes below the root
+    std::size_t scans{};
+    std::chrono::steady_clock::time_point previousScan{};
+    std::string path;  // scratch for absolute paths
+    std::array<char, 4096> buffer{};
+
+    Impl() = default;
+
+    ~Impl() {
+        if (inotify >= 0) {
+            close(inotify);
+        }
+    }
+
+    Impl(const Impl&) = delete;
+    Impl& operator=(const Impl&) = delete;
+    Impl(Impl&&) = delete;
+    Impl& operator=(Impl&&) = delete;
+
+    Result<void> Initialize(std::string_view mount) {
+        if (mount.empty()) {
+            for (auto const Candidate : DEFAULT_ROOTS) {
+                path.assign(Candidate);
+                path += "/cgroup.controllers";
+                if (access(path.c_str(), F_OK) == 0) {
+                    mount = Candidate;
+                    break;
+                }
+            }
+        }
+        while (mount.size() > 1 && mount.ends_with('/')) {
+            mount.remove_suffix(1);
+        }
+        root.assign(mount);
+        if (root.empty()) {
+            return std::unexpected(SystemError::INITIALIZATION_FAILED);  // no cgroup v2 hierarchy mounted
+        }
+        if (access(root.c_str(), R_OK | X_OK) != 0) {
+            return std::unexpected(errno == EACCES ? SystemError::PERMISSION_DENIED
+                                                   : SystemError::INITIALIZATION_FAILED);
+        }
+
+        // Four cached descriptors per cgroup from a quarter of the limit; the process monitor keeps half
+        auto const Limit = procfs::RaiseDescriptorLimit();
+        handleBudget = Limit == SIZE_MAX ? SIZE_MAX : Limit / 4;
+
+        inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        polling = inotify < 0;
+        Watch(tree);
+        Reconcile(tree);
+        previousScan = std::chrono::steady_clock::now();
+        return {};
+    }
+
+    Result<void> Scan(CgroupTable& table) {
+        DrainEvents();
+        auto const Refresh = scans++ % REFRESH_SCANS == 0;
+        if (rescan || (polling && Refresh)) {
+            rescan = false;
+            Reconcile(tree);
+        }
+
+        auto const Now = std::chrono::steady_clock::now();
+        auto const ElapsedUsec = std::chrono::duration<double, std::micro>(Now - previousScan).count();
+        previousScan = Now;
+
+        table.cgroups.reserve(cgroups);
+        for (auto& Child : tree.children) {
+            Sample(*Child, true, Refresh, Now, ElapsedUsec, table);
+        }
+        return {};
+    }
+
+private:
+    // Preorder: a cgroup whose cpu.stat did not move had no running descendants either, so its subtree is
+    // reported from the previous reads without touching a file, except on refresh scans. Memory can still shrink
+    // under reclaim and dirty pages still get written back while a cgroup sleeps; refresh scans pick that up,
+    // with the I/O of the gap averaged over it.
+    void Sample(Node& node,
+                bool parentBusy,
+                bool refresh,
+                std::chrono::steady_clock::time_point now,
+                double elapsedUsec,
+                CgroupTable& table) {
+        auto Busy = false;
+        node.info.cpu = 0.0;
+        if (parentBusy || refresh) {
+            std::uint64_t Usage = 0;
+            if (FindKey(Read(node, CPU_STAT), "usage_usec ", Usage)) {
+                Busy = !node.measured || Usage != node.usage;
+                if (node.measured && Usage > node.usage && elapsedUsec > 0.0) {
+                    node.info.cpu = 100.0 * static_cast<double>(Usage - node.usage) / elapsedUsec;
+                }
+                node.usage = Usage;
+                node.measured = true;
+            } else {
+                Busy = true;  // cannot tell; do not prune
+            }
+        }
+
+        if (refresh && node.cached) {
+            ReopenMissing(node);
+        }
+        if (Busy || refresh) {
+            ReadMemoryAndIo(node, now);
+        } else {
+            node.info.readBytesPerSec = 0.0;
+            node.info.writeBytesPerSec = 0.0;
+        }
+        table.cgroups.push_back(node.info);
+
+        for (auto& Child : node.children) {
+            Sample(*Child, Busy, refresh, now, elapsedUsec, table);
+        }
+    }
+
+    void ReadMemoryAndIo(Node& node, std::chrono::steady_clock::time_point now) {
+        auto Current = Read(node, MEMORY_CURRENT);
+        std::uint64_t Bytes = 0;
+        if (procfs::NextUnsigned(Current, Bytes)) {
+            node.info.memory = Bytes;
+        }
+
+        // anon and file are the first two lines
+        auto const Stat = Read(node, MEMORY_STAT);
+        (void)FindKey(Stat, "anon ", node.info.anon);
+        (void)FindKey(Stat, "file ", node.info.file);
+
+        std::uint64_t ReadBytes = 0;
+        std::uint64_t WriteBytes = 0;
+        SumIoStat(Read(node, IO_STAT), ReadBytes, WriteBytes);
+        auto const Seconds = std::chrono::duration<double>(now - node.ioRead).count();
+        auto const Measured = node.ioRead != std::chrono::steady_clock::time_point{} && Seconds > 0.0;
+        node.info.readBytesPerSec =
+            Measured && ReadBytes > node.readBytes ? static_cast<double>(ReadBytes - node.readBytes) / Seconds : 0.0;
+        node.info.writeBytesPerSec = Measured && WriteBytes > node.writeBytes
+                                         ? static_cast<double>(WriteBytes - node.writeBytes) / Seconds
+                                         : 0.0;
+        node.readBytes = ReadBytes;
+        node.writeBytes = WriteBytes;
+        node.ioRead = now;
+    }
+
+    // A cached cgroup reads its open files; files of a disabled controller stay closed and read as empty
+    std::string_view Read(Node& node, CgroupFile file) {
+        if (node.cached) {
+            return node.files[file].ReadOnce(buffer);
+        }
+        ProcFile const Uncached(AbsolutePath(node, FILE_NAMES[file]));
+        return Uncached.ReadOnce(buffer);
+    }
+
+    // Controllers enabled in the parent's cgroup.subtree_control after the cgroup was opened
+    void ReopenMissing(Node& node) {
+        for (std::size_t I = 0; I < FILE_COUNT; ++I) {
+            if (!node.files[I].IsOpen()) {
+                node.files[I] = ProcFile(AbsolutePath(node, FILE_NAMES[I]));
+                openHandles += node.files[I].IsOpen() ? 1 : 0;
+            }
+        }
+    }
+
+    const char* AbsolutePath(const Node& node, std::string_view file) {
+        path.assign(root);
+        path += node.info.path;
+        path += file;
+        return path.c_str();
+    }
+
+    void Watch(Node& node) {
+        if (polling) {
+            return;
+        }
+        node.watch = inotify_add_watch(inotify, AbsolutePath(node, {}), WATCH_EVENTS);
+        if (node.watch >= 0) {
+            watches[node.watch] = &node;
+        } else if (errno == ENOSPC) {
+            polling = true;  // fs.inotify.max_user_watches reached
+        }
+    }
+
+    static std::string_view NameOf(const std::unique_ptr<Node>& child) noexcept {
+        return child->name;
+    }
+
+    Node& AddChild(Node& parent, std::string_view name) {
+        auto const Position = std::ranges::lower_bound(parent.children, name, {}, &NameOf);
+        if (Position != parent.children.end() && (*Position)->name == name) {
+            return **Position;
+        }
+
+        auto Child = std::make_unique<Node>();
+        Child->name.assign(name);
+        Child->info.path = parent.info.path + '/';
+        Child->info.path += name;
+        Watch(*Child);
+        if (openHandles + FILE_COUNT <= handleBudget) {
+            Child->cached = true;
+            ReopenMissing(*Child);
+        }
+        ++cgroups;
+        return **parent.children.insert(Position, std::move(Child));
+    }
+
+    void Release(Node& node) {
+        for (auto& Child : node.children) {
+            Release(*Child);
+        }
+        node.children.clear();
+        if (node.watch >= 0) {
+            // Fails harmlessly when the kernel already dropped the watch with the directory
+            inotify_rm_watch(inotify, node.watch);
+            watches.erase(node.watch);
+            node.watch = -1;
+        }
+        for (auto& File : node.files) {
+            if (File.IsOpen()) {
+                File = ProcFile();
+                --openHandles;
+            }
+        }
+        --cgroups;
+    }
+
+    void RemoveChild(Node& parent, std::string_view name) {
+        auto const Position = std::ranges::lower_bound(parent.children, name, {}, &NameOf);
+        if (Position != parent.children.end() && (*Position)->name == name) {
+            Release(**Position);
+            parent.children.erase(Position);
+        }
+    }
+
+    // Brings the subtree in line with the directories: walks it at startup, after a queue overflow and in
+    // polling mode. The watch of a directory is added before it is listed, so no child can slip in between.
+    void Reconcile(Node& node) {
+        DIR* Directory = opendir(AbsolutePath(node, {}));
+        if (Directory == nullptr) {
+            return;  // removed meanwhile; its parent's event or the next reconcile drops it
+        }
+        std::vector<std::string> Names;
+        while (const dirent* Dirent = readdir(Directory)) {
+            std::string_view const Name = Dirent->d_name;
+            if (Dirent->d_type == DT_DIR && Name != "." && Name != "..") {
+                Names.emplace_back(Name);
+            }
+        }
+        closedir(Directory);
+        std::ranges::sort(Names);
+
+        std::erase_if(node.children, [&](const std::unique_ptr<Node>& child) {
+            if (std::ranges::binary_search(Names, child->name)) {
+                return false;
+            }
+            Release(*child);
+            return true;
+        });
+        for (const auto& Name : Names) {
+            AddChild(node, Name);
+        }
+        for (auto& Child : node.children) {
+            Reconcile(*Child);
+        }
+    }
+
+    void DrainEvents() {
+        if (inotify < 0) {
+            return;
+        }
+        alignas(inotify_event) std::array<char, 4096> Events;
+        while (true) {
+            auto const Length = read(inotify, Events.data(), Events.size());
+            if (Length < 0 && errno == EINTR) {
+                continue;
+            }
+            if (Length <= 0) {
+                return;  // EAGAIN: drained
+            }
+            for (std::size_t Offset = 0; Offset < static_cast<std::size_t>(Length);) {
+                inotify_event Event;
+                std::memcpy(&Event, Events.data() + Offset, sizeof(Event));
+                std::string_view const Name = Event.len == 0 ? std::string_view{}
+                                                             : std::string_view(Events.data() + Offset + sizeof(Event));
+                Offset += sizeof(Event) + Event.len;
+                Apply(Event, Name);
+            }
+        }
+    }
+
+    void Apply(const inotify_event& event, std::string_view name) {
+        if ((event.mask & IN_Q_OVERFLOW) != 0) {
+            rescan = true;
+            return;
+        }
+        auto const Watched = watches.find(event.wd);
+        if (Watched == watches.end()) {
+            return;  // watch of a cgroup removed already
+        }
+        auto& Parent = *Watched->second;
+        if ((event.mask & IN_IGNORED) != 0) {
+            Parent.watch = -1;
+            watches.erase(Watched);
+            return;
+        }
+        if ((event.mask & IN_ISDIR) == 0 || name.empty()) {
+            return;
+        }
+
+        // A renamed cgroup leaves under its old name and arrives under the new one
+        if ((event.mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+            Reconcile(AddChild(Parent, name));
+        } else if ((event.mask & (IN_DELETE | IN_MOVED_FROM)) != 0) {
+            RemoveChild(Parent, name);
+        }
+    }
+};
+
+#else
+    #error "CgroupMonitor has no collector backend for this platform"
+#endif
+
+CgroupMonitor::CgroupMonitor() : pImpl_(std::make_unique<Impl>()) {}
+
+CgroupMonitor::~CgroupMonitor() = default;
+
+Result<void> CgroupMonitor::Initialize(std::string_view root) {
+    return pImpl_->Initialize(root);
+}
+
+Result<void> CgroupMonitor::Scan() {
+    auto Table = std::make_shared<CgroupTable>();
+    Table->timestamp = std::chrono::system_clock::now();
+    if (auto Scanned = pImpl_->Scan(*Table); !Scanned) {
+        return Scanned;
+    }
+    latest_.store(std::move(Table), std::memory_order_release);
+    return {};
+}
+
+std::vector<CgroupInfo> CgroupMonitor::Top(const CgroupTable& table,
+                                           std::size_t count,
+                                           CgroupSortKey key,
+                                           std::string_view prefix) {
+    auto const Io = [](const CgroupInfo* info) { return info->readBytesPerSec + info->writeBytesPerSec; };
+
+    // Orders by the sort key descending, then by path, so equal keys come out in a stable order
+    auto const Before = [key, &Io](const CgroupInfo* a, const CgroupInfo* b) {
+        if (key == CgroupSortKey::CPU && a->cpu != b->cpu) {
+            return a->cpu > b->cpu;
+        }
+        if (key == CgroupSortKey::MEMORY && a->memory != b->memory) {
+            return a->memory > b->memory;
+        }
+        if (key == CgroupSortKey::IO && Io(a) != Io(b)) {
+            return Io(a) > Io(b);
+        }
+        return a->path < b->path;
+    };
+
+    // Bounded heap whose front is the weakest of the best `count` seen so far
+    std::vector<const CgroupInfo*> Heap;
+    Heap.reserve(std::min(count, table.cgroups.size()) + 1);
+    for (const auto& Cgroup : table.cgroups) {
+        if (!Cgroup.path.starts_with(prefix)) {
+            continue;
+        }
+        if (Heap.size() < count) {
+            Heap.push_back(&Cgroup);
+            std::ranges::push_heap(Heap, Before);
+        } else if (count != 0 && Before(&Cgroup, Heap.front())) {
+            std::ranges::pop_heap(Heap, Before);
+            Heap.back() = &Cgroup;
+            std::ranges::push_heap(Heap, Before);
+        }
+    }
+    std::ranges::sort_heap(Heap, Before);
+
+    std::vector<CgroupInfo> Result;
+    Result.reserve(Heap.size());
+    for (const auto* Cgroup : Heap) {
+        Result.push_back(*Cgroup);
+    }
+    return Result;
+}
+
+}  // namespace pc_monitor
@@ -0,0 +1,842 @@
+#include "collector_backend.hpp"
+
+#include "binary_codec.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <format>
+#include <functional>
+#include <iterator>
+#include <numbers>
+#include <numeric>
+#include <optional>
+
+namespace pc_monitor {
+
+namespace {
+
+constexpr std::string_view CAPTURE_MAGIC = "PCMCAP1\n";
+constexpr auto MAX_SOURCE = static_cast<std::uint8_t>(CollectorSource::PRESSURE);
+
+void AppendCaptureHeader(std::string& out, std::chrono::system_clock::time_point started) {
+    out.append(CAPTURE_MAGIC);
+    auto const StartedUs =
+        std::chrono::duration_cast<std::chrono::microseconds>(started.time_since_epoch()).count();
+    binary::AppendVarint(out, static_cast<std::uint64_t>(std::max<std::int64_t>(StartedUs, 0)));
+}
+
+void AppendCaptureRecord(std::string& out,
+                         CollectorSource source,
+                         std::uint32_t index,
+                         std::chrono::microseconds delta,
+                         std::string_view content) {
+    out += static_cast<char>(source);
+    binary::AppendVarint(out, index);
+    binary::AppendVarint(out, static_cast<std::uint64_t>(std::max<std::int64_t>(delta.count(), 0)));
+    binary::AppendVarint(out, content.size());
+    out.append(content);
+}
+
+// Kernel cpu list notation ("0-3,8") of the cpus [first, first + count) and [second, second + count)
+std::string CpuRanges(std::size_t first, std::size_t second, std::size_t count) {
+    auto const Range = [count](std::size_t start) {
+        return count == 1 ? std::format("{}", start) : std::format("{}-{}", start, start + count - 1);
+    };
+    return first == second ? Range(first) : Range(first) + "," + Range(second);
+}
+
+// Two packages (one NUMA node each) of SMT pairs numbered the way Linux does, cpu N and N + cores/2 sharing a
+// physical core; odd core counts get one package without SMT
+struct SyntheticLayout {
+    bool smt{};
+    std::size_t physical{};  // physical cores; cpu N is core N % physical
+    std::size_t packages{};
+    std::size_t perPackage{};  // physical cores per package; core K is in package K / perPackage
+
+    explicit SyntheticLayout(std::size_t cores)
+        : smt(cores >= 2 && cores % 2 == 0),
+          physical(smt ? cores / 2 : cores),
+          packages(physical >= 2 && physical % 2 == 0 ? 2 : 1),
+          perPackage(physical / packages) {}
+
+    // THERMAL_SENSORS index of a package sensor, followed by one sensor per core of the package
+    [[nodiscard]] std::size_t PackageSensor(std::size_t package) const noexcept {
+        return package * (perPackage + 1);
+    }
+};
+
+void AppendSyntheticTopology(CollectorCapture& capture, std::size_t cores) {
+    SyntheticLayout const Layout(cores);
+    auto const PerPackage = Layout.perPackage;
+
+    for (std::size_t Cpu = 0; Cpu < cores; ++Cpu) {
+        auto const Core = Cpu % Layout.physical;
+        auto const Package = Core / PerPackage;
+        auto const Siblings = Layout.smt ? CpuRanges(Core, Core + Layout.physical, 1) : std::format("{}", Cpu);
+        auto const PackageCpus = CpuRanges(Package * PerPackage,
+                                           Layout.smt ? (Package * PerPackage) + Layout.physical : Package * PerPackage,
+                                           PerPackage);
+        auto Text = std::format(
+            "package {}\ncore {}\nnode {}\nsiblings {}\n", Package, Core % PerPackage, Package, Siblings);
+        Text += std::format("cache 1 Data 48K 64 {}\n", Siblings);
+        Text += std::format("cache 1 Instruction 32K 64 {}\n", Siblings);
+        Text += std::format("cache 2 Unified 2048K 64 {}\n", Siblings);
+        Text += std::format("cache 3 Unified 32768K 64 {}\n", PackageCpus);
+        capture.records.push_back(
+            {CollectorSource::CPU_TOPOLOGY, static_cast<std::uint32_t>(Cpu), std::chrono::microseconds{0}, Text});
+    }
+}
+
+// coretemp-style sensors: per package one package sensor and one per physical core, critical at 100 C
+void AppendSyntheticThermalSensors(CollectorCapture& capture, const SyntheticLayout& layout) {
+    std::string Text;
+    for (std::size_t Package = 0; Package < layout.packages; ++Package) {
+        std::format_to(std::back_inserter(Text), "package {} 100000\n", Package);
+        for (std::size_t Core = 0; Core < layout.perPackage; ++Core) {
+            std::format_to(std::back_inserter(Text), "core {} {} 100000\n", Package, Core);
+        }
+    }
+    capture.records.push_back({CollectorSource::THERMAL_SENSORS, 0, std::chrono::microseconds{0}, Text});
+}
+
+// /proc/meminfo of a host using `usedShare` of `totalKb`, with the kernel's key order and column layout
+void AppendSyntheticMeminfo(std::string& text, std::uint64_t totalKb, double usedShare) {
+    auto const AvailableKb = static_cast<std::uint64_t>(static_cast<double>(totalKb) * (1.0 - usedShare));
+    auto const DirtyKb = static_cast<std::uint64_t>(static_cast<double>(totalKb) * usedShare / 400.0);
+    auto const SwapKb = totalKb / 8;
+    auto const Line = [&text](std::string_view key, std::uint64_t value, std::string_view unit = " kB") {
+        std::format_to(std::back_inserter(text), "{:<15}{:>9}{}\n", std::format("{}:", key), value, unit);
+    };
+    text.clear();
+    Line("MemTotal", totalKb);
+    Line("MemFree", AvailableKb / 2);
+    Line("MemAvailable", AvailableKb);
+    Line("Buffers", totalKb / 64);
+    Line("Cached", totalKb / 5);
+    Line("SwapCached", 0);
+    Line("Active", totalKb / 4);
+    Line("Inactive", totalKb / 8);
+    Line("SwapTotal", SwapKb);
+    Line("SwapFree", SwapKb - static_cast<std::uint64_t>(static_cast<double>(SwapKb) * usedShare / 4.0));
+    Line("Dirty", DirtyKb);
+    Line("Writeback", DirtyKb / 16);
+    Line("AnonPages", totalKb / 4);
+    Line("Shmem", totalKb / 100);
+    Line("KReclaimable", totalKb / 50);
+    Line("Slab", totalKb / 40);
+    Line("SReclaimable", totalKb / 50);
+    Line("SUnreclaim", (totalKb / 40) - (totalKb / 50));
+    Line("PageTables", totalKb / 500);
+    Line("HugePages_Total", 512, "");
+    Line("HugePages_Free", 128, "");
+    Line("HugePages_Rsvd", 0, "");
+    Line("Hugepagesize", 2048);
+}
+
+// Pressure stall averages of one resource, moving toward `share` percent like the kernel's decaying averages
+struct SyntheticPressure {
+    double share{};
+    std::array<double, 3> averages{};  // 10 s, 60 s, 300 s
+    double totalUs{};
+};
+
+void AppendSyntheticPressure(std::string& text, SyntheticPressure& pressure, double seconds) {
+    constexpr std::array<double, 3> WINDOWS{10.0, 60.0, 300.0};
+    for (std::size_t I = 0; I < WINDOWS.size(); ++I) {
+        pressure.averages[I] += (pressure.share - pressure.averages[I]) * (1.0 - std::exp(-seconds / WINDOWS[I]));
+    }
+    pressure.totalUs += pressure.share / 100.0 * seconds * 1e6;
+    text.clear();
+    for (std::string_view const Kind : {"some", "full"}) {
+        auto const Scale = Kind == "some" ? 1.0 : 0.5;
+        std::format_to(std::back_inserter(text),
+                       "{} avg10={:.2f} avg60={:.2f} avg300={:.2f} total={:.0f}\n",
+                       Kind,
+                       pressure.averages[0] * Scale,
+                       pressure.averages[1] * Scale,
+                       pressure.averages[2] * Scale,
+                       std::floor(pressure.totalUs * Scale));
+    }
+}
+
+// Cumulative counters of one synthetic device, advanced every sample by `scale` times the host's load
+struct SyntheticDevice {
+    std::string name;
+    double scale{};
+    std::array<double, 8> totals{};
+};
+
+// /proc/diskstats lines: two busy NVMe disks, a partition that mirrors the first one and an idle loop device
+void AppendSyntheticDiskstats(std::string& text, std::vector<SyntheticDevice>& disks, double load, double seconds) {
+    constexpr double SECTOR = 512.0;
+    constexpr double READ_BYTES = 48.0 * 1024 * 1024;  // per second at full load
+    constexpr double WRITE_BYTES = 16.0 * 1024 * 1024;
+    text.clear();
+    for (std::size_t I = 0; I < disks.size(); ++I) {
+        auto& [Name, Scale, Totals] = disks[I];
+        auto const Reads = 900.0 * load * Scale * seconds;
+        auto const Writes = 300.0 * load * Scale * seconds;
+        auto const BusyMs = 1000.0 * seconds * std::min(1.0, 1.2 * load * Scale);
+        Totals[0] += Reads;
+        Totals[1] += READ_BYTES * load * Scale * seconds / SECTOR;
+        Totals[2] += Reads * 0.1;
+        Totals[3] += Writes;
+        Totals[4] += WRITE_BYTES * load * Scale * seconds / SECTOR;
+        Totals[5] += Writes * 0.4;
+        Totals[6] += BusyMs;
+        Totals[7] += BusyMs * (1.0 + (4.0 * load * Scale));
+        std::format_to(std::back_inserter(text),
+                       "{:4} {:7} {} {:.0f} 0 {:.0f} {:.0f} {:.0f} 0 {:.0f} {:.0f} 0 {:.0f} {:.0f}\n",
+                       Name.starts_with("loop") ? 7 : 259,
+                       I,
+                       Name,
+                       std::floor(Totals[0]),
+                       std::floor(Totals[1]),
+                       std::floor(Totals[2]),
+                       std::floor(Totals[3]),
+                       std::floor(Totals[4]),
+                       std::floor(Totals[5]),
+                       std::floor(Totals[6]),
+                       std::floor(Totals[7]));
+    }
+}
+
+// /proc/net/dev: loopback, an uplink that follows the load, a quiet second port and the container veths
+void AppendSyntheticNetDev(std::string& text, std::vector<SyntheticDevice>& interfaces, double load, double seconds) {
+    constexpr double RX_BYTES = 80.0 * 1024 * 1024;  // per second at full load
+    constexpr double TX_BYTES = 20.0 * 1024 * 1024;
+    constexpr double BYTES_PER_PACKET = 1200.0;
+    text = "Inter-|   Receive                                                |  Transmit\n"
+           " face |bytes    packets errs drop fifo frame compressed multicast|"
+           "bytes    packets errs drop fifo colls carrier compressed\n";
+    for (auto& [Name, Scale, Totals] : interfaces) {
+        auto const Rx = RX_BYTES * load * Scale * seconds;
+        auto const Tx = TX_BYTES * load * Scale * seconds;
+        Totals[0] += Rx;
+        Totals[1] += Rx / BYTES_PER_PACKET;
+        Totals[2] += load > 0.6 ? 3.0 * Scale * seconds : 0.0;
+        Totals[3] += Tx;
+        Totals[4] += Tx / BYTES_PER_PACKET;
+        std::format_to(std::back_inserter(text),
+                       "{:>6}: {:.0f} {:.0f} 0 {:.0f} 0 0 0 0 {:.0f} {:.0f} 0 0 0 0 0 0\n",
+                       Name,
+                       std::floor(Totals[0]),
+                       std::floor(Totals[1]),
+                       std::floor(Totals[2]),
+                       std::floor(Totals[3]),
+                       std::floor(Totals[4]));
+    }
+}
+
+bool ReadVarint(std::string_view& in, std::uint64_t& value) noexcept {
+    value = 0;
+    for (unsigned Shift = 0; Shift < 64 && !in.empty(); Shift += 7) {
+        auto const Byte = static_cast<std::uint8_t>(in.front());
+        in.remove_prefix(1);
+        value |= static_cast<std::uint64_t>(Byte & 0x7F) << Shift;
+        if ((Byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+// CollectorCapture implementation
+Result<CollectorCapture> CollectorCapture::Load(const std::filesystem::path& path) {
+    std::ifstream In(path, std::ios::binary);
+    if (!In) {
+        return std::unexpected(SystemError::DATA_UNAVAILABLE);
+    }
+    std::string const Content{std::istreambuf_iterator<char>(In), std::istreambuf_iterator<char>()};
+
+    std::string_view Remaining = Content;
+    std::uint64_t StartedUs = 0;
+    if (!Remaining.starts_with(CAPTURE_MAGIC)) {
+        return std::unexpected(SystemError::DATA_UNAVAILABLE);
+    }
+    Remaining.remove_prefix(CAPTURE_MAGIC.size());
+    if (!ReadVarint(Remaining, StartedUs)) {
+        return std::unexpected(SystemError::DATA_UNAVAILABLE);
+    }
+
+    CollectorCapture Capture;
+    Capture.started = std::chrono::system_clock::time_point{
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::microseconds{StartedUs})};
+
+    // Stops at the first incomplete record, which is where a recorder that did not shut down cleanly ended
+    std::chrono::microseconds Offset{0};
+    while (!Remaining.empty()) {
+        auto const Source = static_cast<std::uint8_t>(Remaining.front());
+        Remaining.remove_prefix(1);
+        std::uint64_t Index = 0;
+        std::uint64_t DeltaUs = 0;
+        std::uint64_t Length = 0;
+        if (Source > MAX_SOURCE || !ReadVarint(Remaining, Index) || !ReadVarint(Remaining, DeltaUs) ||
+            !ReadVarint(Remaining, Length) || Length > Remaining.size()) {
+            break;
+        }
+        Offset += std::chrono::microseconds{DeltaUs};
+        Capture.records.push_back(CaptureRecord{.source = static_cast<CollectorSource>(Source),
+                                                .index = static_cast<std::uint32_t>(Index),
+                                                .offset = Offset,
+                                                .content = std::string(Remaining.substr(0, Length))});
+        Remaining.remove_prefix(Length);
+    }
+    return Capture;
+}
+
+Result<void> CollectorCapture::Save(const std::filesystem::path& path) const {
+    std::string Encoded;
+    AppendCaptureHeader(Encoded, started);
+    std::chrono::microseconds Previous{0};
+    for (const auto& Record : records) {
+        AppendCaptureRecord(Encoded, Record.source, Record.index, Record.offset - Previous, Record.content);
+        Previous = Record.offset;
+    }
+
+    std::ofstream Out(path, std::ios::binary | std::ios::trunc);
+    Out.write(Encoded.data(), static_cast<std::streamsize>(Encoded.size()));
+    if (!Out) {
+        return std::unexpected(SystemError::SYSTEM_ERROR);
+    }
+    return {};
+}
+
+CollectorCapture MakeSyntheticCapture(std::size_t cores, std::size_t samples, std::chrono::milliseconds interval) {
+    // /proc/stat counts USER_HZ (100 Hz) jiffies
+    constexpr double JIFFIES_PER_MS = 0.1;
+    constexpr std::uint64_t KIB_PER_CORE = std::uint64_t{2} * 1024 * 1024;  // 2 GiB of RAM per cpu
+
+    struct Counters {
+        double user = 0.0;
+        double system = 0.0;
+        double idle = 0.0;
+    };
+
+    CollectorCapture Capture;
+    Capture.started = std::chrono::system_clock::time_point{std::chrono::milliseconds{1'700'000'000'000}};
+    SyntheticLayout const Layout(cores);
+    Capture.records.reserve((samples * (cores + Layout.physical + Layout.packages + 7)) + cores + 1);
+    AppendSyntheticTopology(Capture, cores);
+    if (cores != 0) {
+        AppendSyntheticThermalSensors(Capture, Layout);
+    }
+
+    std::vector<SyntheticDevice> Disks{{"nvme0n1", 1.0}, {"nvme0n1p1", 1.0}, {"nvme1n1", 0.4}, {"loop0", 0.0}};
+    std::vector<SyntheticDevice> Interfaces{{"lo", 0.02}, {"eth0", 1.0}, {"eth1", 0.05}};
+    for (std::size_t Core = 0; Core < cores; ++Core) {
+        Interfaces.push_back({std::format("veth{:x}", 0x5a00 + Core), 0.01});
+    }
+
+    std::vector<Counters> PerCore(cores);
+    std::vector<double> Load(cores);
+    std::vector<double> PackageCelsius(Layout.packages);
+    std::array<SyntheticPressure, 3> Pressure{};
+    auto const Jiffies = static_cast<double>(interval.count()) * JIFFIES_PER_MS;
+    auto const TotalKb = KIB_PER_CORE * std::max<std::size_t>(cores, 1);
+    std::string Text;
+    for (std::size_t Sample = 0; Sample < samples; ++Sample) {
+        auto const Offset = std::chrono::duration_cast<std::chrono::microseconds>(interval * Sample);
+        auto const Seconds = std::chrono::duration<double>(Offset).count();
+
+        // Each core rides a one-minute wave with its own phase and baseline
+        Counters Aggregate;
+        for (std::size_t Core = 0; Core < cores; ++Core) {
+            auto const Phase = (Seconds / 60.0) + (static_cast<double>(Core) / static_cast<double>(cores));
+            auto const Base = 0.15 + (0.35 * static_cast<double>(Core % 7) / 6.0);
+            Load[Core] = std::clamp(Base + (0.3 * std::sin(2.0 * std::numbers::pi * Phase)), 0.02, 0.98);
+
+            auto& Counter = PerCore[Core];
+            Counter.user += Jiffies * Load[Core] * 0.8;
+            Counter.system += Jiffies * Load[Core] * 0.2;
+            Counter.idle += Jiffies * (1.0 - Load[Core]);
+            Aggregate.user += std::floor(Counter.user);
+            Aggregate.system += std::floor(Counter.system);
+            Aggregate.idle += std::floor(Counter.idle);
+        }
+
+        auto const AppendCpuLine = [&Text](std::string_view name, const Counters& counters) {
+            std::format_to(std::back_inserter(Text),
+                           "{} {:.0f} 0 {:.0f} {:.0f} 0 0 0 0 0 0\n",
+                           name,
+                           std::floor(counters.user),
+                           std::floor(counters.system),
+                           std::floor(counters.idle));
+        };
+        Text.clear();
+        AppendCpuLine("cpu ", Aggregate);
+        for (std::size_t Core = 0; Core < cores; ++Core) {
+            AppendCpuLine(std::format("cpu{}", Core), PerCore[Core]);
+        }
+        Text.append("intr 0\nctxt 0\n");
+        Capture.records.push_back({CollectorSource::STAT, 0, Offset, Text});
+
+        // Memory use breathes over five minutes
+        auto const UsedShare = 0.35 + (0.1 * std::sin(2.0 * std::numbers::pi * Seconds / 300.0));
+        AppendSyntheticMeminfo(Text, TotalKb, UsedShare);
+        Capture.records.push_back({CollectorSource::MEMINFO, 0, Offset, Text});
+
+        // Device traffic follows the mean load
+        auto const MeanLoad =
+            cores == 0 ? 0.0 : std::accumulate(Load.begin(), Load.end(), 0.0) / static_cast<double>(cores);
+        auto const Elapsed = Sample == 0 ? 0.0 : std::chrono::duration<double>(interval).count();
+        AppendSyntheticDiskstats(Text, Disks, MeanLoad, Elapsed);
+        Capture.records.push_back({CollectorSource::DISKSTATS, 0, Offset, Text});
+        AppendSyntheticNetDev(Text, Interfaces, MeanLoad, Elapsed);
+        Capture.records.push_back({CollectorSource::NET_DEV, 0, Offset, Text});
+
+        // Cpu stalls follow the mean load, memory stalls set in as the memory use passes 40%
+        auto const MemoryStall = std::max(0.0, (UsedShare - 0.4) * 200.0);
+        for (std::uint32_t Resource = 0; Resource < Pressure.size(); ++Resource) {
+            Pressure[Resource].share = std::array{MeanLoad * 20.0, MeanLoad * 2.0, MemoryStall}[Resource];
+            AppendSyntheticPressure(Text, Pressure[Resource], Elapsed);
+            Capture.records.push_back({CollectorSource::PRESSURE, Resource, Offset, Text});
+        }
+
+        // Cores run 35-95 C with their load, plus a heat soak of up to 10 C that sweeps each package every five
+        // minutes; the package sensor reads a degree above its hottest core
+        for (std::size_t Package = 0; Package < Layout.packages && cores != 0; ++Package) {
+            auto const Soak = 10.0 * std::max(0.0,
+                                              std::sin(2.0 * std::numbers::pi *
+                                                       ((Seconds / 300.0) + (static_cast<double>(Package) / 2.0))));
+            auto const Sensor = Layout.PackageSensor(Package);
+            PackageCelsius[Package] = 0.0;
+            for (std::size_t Core = 0; Core < Layout.perPackage; ++Core) {
+                auto const Celsius = 35.0 + (60.0 * Load[(Package * Layout.perPackage) + Core]) + Soak;
+                PackageCelsius[Package] = std::max(PackageCelsius[Package], Celsius + 1.0);
+                Capture.records.push_back({CollectorSource::TEMPERATURE,
+                                           static_cast<std::uint32_t>(Sensor + 1 + Core),
+                                           Offset,
+                                           std::format("{:.0f}\n", Celsius * 1000.0)});
+            }
+            Capture.records.push_back({CollectorSource::TEMPERATURE,
+                                       static_cast<std::uint32_t>(Sensor),
+                                       Offset,
+                                       std::format("{:.0f}\n", PackageCelsius[Package] * 1000.0)});
+        }
+
+        // A package above 92 C clocks its cores down by 30%
+        for (std::size_t Core = 0; Core < cores; ++Core) {
+            auto Khz = 2'400'000 + (static_cast<std::uint64_t>(Load[Core] * 1'200.0) * 1'000);
+            if (PackageCelsius[(Core % Layout.physical) / Layout.perPackage] > 92.0) {
+                Khz = Khz * 7 / 10;
+            }
+            Capture.records.push_back(
+                {CollectorSource::CPU_FREQUENCY, static_cast<std::uint32_t>(Core), Offset, std::format("{}\n", Khz)});
+        }
+    }
+    return Capture;
+}
+
+// RecordingBackend implementation
+RecordingBackend::RecordingBackend(std::unique_ptr<CollectorBackend> inner, std::filesystem::path path)
+    : inner_(std::move(inner)), path_(std::move(path)) {}
+
+Result<void> RecordingBackend::Open() {
+    if (auto Opened = inner_->Open(); !Opened) {
+        return Opened;
+    }
+
+    out_ = std::ofstream(path_, std::ios::binary | std::ios::trunc);
+    if (!out_) {
+        return std::unexpected(SystemError::SYSTEM_ERROR);
+    }
+    started_ = inner_->Now();
+    record_.clear();
+    AppendCaptureHeader(record_, started_);
+    out_.write(record_.data(), static_cast<std::streamsize>(record_.size()));
+    lastOffset_ = {};
+    return {};
+}
+
+std::string_view RecordingBackend::Read(CollectorSource source, std::uint32_t index, std::span<char> buffer) {
+    auto const Content = inner_->Read(source, index, buffer);
+    Append(source, index, Content);
+    return Content;
+}
+
+std::string RecordingBackend::ReadAll(CollectorSource source, std::uint32_t index) {
+    auto Content = inner_->ReadAll(source, index);
+    Append(source, index, Content);
+    return Content;
+}
+
+void RecordingBackend::Append(CollectorSource source, std::uint32_t index, std::string_view content) {
+    if (!out_.is_open() || content.empty()) {
+        return;
+    }
+    // Timed by the inner backend's clock, so recording a replay keeps its timeline and the rates computed from
+    // it; a wall clock that steps back holds the previous offset instead
+    auto const Offset = std::max(std::chrono::duration_cast<std::chrono::microseconds>(inner_->Now() - started_),
+                                 lastOffset_);
+    record_.clear();
+    AppendCaptureRecord(record_, source, index, Offset - lastOffset_, content);
+    lastOffset_ = Offset;
+    out_.write(record_.data(), static_cast<std::streamsize>(record_.size()));
+}
+
+// ReplayBackend implementation
+ReplayBackend::ReplayBackend(std::shared_ptr<const CollectorCapture> capture, Options options)
+    : capture_(std::move(capture)), options_(options) {
+    for (const auto& Record : capture_->records) {
+        timelines_[Key(Record.source, Record.index)].records.push_back(&Record);
+    }
+
+    // Wrapping adds one sample interval after the last record, so the loop keeps the capture's cadence
+    auto const Stat = timelines_.find(Key(CollectorSource::STAT, 0));
+    if (Stat != timelines_.end() && !capture_->records.empty()) {
+        const auto& Samples = Stat->second.records;
+        auto const Interval = Samples.size() > 1
+                                  ? (Samples.back()->offset - Samples.front()->offset) /
+                                        static_cast<std::int64_t>(Samples.size() - 1)
+                                  : std::chrono::microseconds{std::chrono::seconds{1}};
+        period_ = capture_->records.back().offset + std::max(Interval, std::chrono::microseconds{1});
+    }
+}
+
+Result<void> ReplayBackend::Open() {
+    if (!timelines_.contains(Key(CollectorSource::STAT, 0))) {
+        return std::unexpected(SystemError::INITIALIZATION_FAILED);
+    }
+    for (auto& [SourceKey, Timeline] : timelines_) {
+        Timeline.next = 0;
+    }
+    started_ = std::chrono::steady_clock::now();
+    stepElapsed_ = {};
+    stepEnd_ = capture_->records.data();
+    laps_ = 0;
+    return {};
+}
+
+std::string_view ReplayBackend::Read(CollectorSource source, std::uint32_t index, std::span<char> buffer) {
+    const auto* Record = Current(source, index);
+    return Record != nullptr ? std::string_view{Record->content}.substr(0, buffer.size()) : std::string_view{};
+}
+
+std::string ReplayBackend::ReadAll(CollectorSource source, std::uint32_t index) {
+    const auto* Record = Current(source, index);
+    return Record != nullptr ? Record->content : std::string{};
+}
+
+const CaptureRecord* ReplayBackend::Current(CollectorSource source, std::uint32_t index) {
+    auto const Found = timelines_.find(Key(source, index));
+    if (Found == timelines_.end()) {
+        return nullptr;
+    }
+
+    auto& Timeline = Found->second;
+    if (options_.speed > 0.0) {
+        return Lookup(Timeline, Elapsed());
+    }
+    if (source != CollectorSource::STAT) {
+        // Whatever was read before the next /proc/stat read; records point into one vector, so their addresses
+        // follow capture order even where timestamps tie
+        auto const After = std::ranges::lower_bound(Timeline.records, stepEnd_, std::less<>{});
+        return After == Timeline.records.begin() ? Timeline.records.front() : *std::prev(After);
+    }
+
+    // Step mode: every /proc/stat read is the next sample
+    const auto* Record = Timeline.records[Timeline.next];
+    stepElapsed_ = (period_ * static_cast<std::int64_t>(laps_)) + Record->offset;
+    if (++Timeline.next == Timeline.records.size()) {
+        if (options_.loop) {
+            Timeline.next = 0;
+            ++laps_;
+        } else {
+            --Timeline.next;
+        }
+    }
+    stepEnd_ = Timeline.next != 0 && Timeline.records[Timeline.next] != Record
+                   ? Timeline.records[Timeline.next]
+                   : capture_->records.data() + capture_->records.size();
+    return Record;
+}
+
+std::chrono::system_clock::time_point ReplayBackend::Now() const {
+    return capture_->started + Elapsed();
+}
+
+std::chrono::microseconds ReplayBackend::Elapsed() const {
+    if (options_.speed <= 0.0) {
+        return stepElapsed_;
+    }
+    auto const RealUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started_);
+    return std::chrono::microseconds{static_cast<std::int64_t>(RealUs.count() * options_.speed)};
+}
+
+const CaptureRecord* ReplayBackend::Lookup(const Timeline& timeline, std::chrono::microseconds elapsed) const {
+    if (options_.loop && period_.count() > 0) {
+        elapsed %= period_;
+    }
+
+    // Latest record at or before `elapsed`, or the first one before the source has been read at all
+    auto const After = std::ranges::upper_bound(timeline.records, elapsed, {}, &CaptureRecord::offset);
+    return After == timeline.records.begin() ? timeline.records.front() : *std::prev(After);
+}
+
+#if defined(__linux__)
+namespace {
+// Contents of a one-line sysfs attribute without the trailing newline; `missing` when it cannot be read
+std::string ReadAttribute(const std::string& path, std::string_view missing = {}) {
+    auto Value = procfs::ProcFile(path.c_str()).ReadAll();
+    while (!Value.empty() && (Value.back() == '\n' || Value.back() == ' ')) {
+        Value.pop_back();
+    }
+    return Value.empty() ? std::string(missing) : Value;
+}
+
+// Only read by Initialize(), so the files are opened and closed again rather than kept
+std::string ReadSysfsTopology(std::uint32_t cpu) {
+    auto const Base = std::format("/sys/devices/system/cpu/cpu{}", cpu);
+    std::string Text;
+    auto const AppendLine = [&Text](std::string_view key, const std::string& value) {
+        if (!value.empty()) {
+            Text.append(key).append(" ").append(value).append("\n");
+        }
+    };
+    AppendLine("package", ReadAttribute(Base + "/topology/physical_package_id"));
+    AppendLine("core", ReadAttribute(Base + "/topology/core_id"));
+
+    // Each cpu directory links to its NUMA node as node<id>
+    std::error_code Error;
+    for (std::filesystem::directory_iterator It(Base, Error), End; !Error && It != End; It.increment(Error)) {
+        auto const Name = It->path().filename().string();
+        if (Name.size() > 4 && Name.starts_with("node") && Name[4] >= '0' && Name[4] <= '9') {
+            AppendLine("node", Name.substr(4));
+            break;
+        }
+    }
+    AppendLine("siblings", ReadAttribute(Base + "/topology/thread_siblings_list"));
+
+    for (std::size_t Index = 0;; ++Index) {
+        auto const Cache = std::format("{}/cache/index{}", Base, Index);
+        auto const Level = ReadAttribute(Cache + "/level");
+        if (Level.empty()) {
+            break;
+        }
+        Text += std::format("cache {} {} {} {} {}\n",
+                            Level,
+                            ReadAttribute(Cache + "/type", "Unified"),
+                            ReadAttribute(Cache + "/size", "0K"),
+                            ReadAttribute(Cache + "/coherency_line_size", "0"),
+                            ReadAttribute(Cache + "/shared_cpu_list", std::to_string(cpu)));
+    }
+    return Text;
+}
+
+// Entries of `directory` named <prefix><number><suffix>, in numeric order
+std::vector<std::pair<std::uint32_t, std::filesystem::path>> NumberedEntries(const std::filesystem::path& directory,
+                                                                             std::string_view prefix,
+                                                                             std::string_view suffix = {}) {
+    std::vector<std::pair<std::uint32_t, std::filesystem::path>> Entries;
+    std::error_code Error;
+    for (std::filesystem::directory_iterator It(directory, Error), End; !Error && It != End; It.increment(Error)) {
+        auto const Name = It->path().filename().string();
+        if (!Name.starts_with(prefix) || !Name.ends_with(suffix) || Name.size() == prefix.size() + suffix.size()) {
+            continue;
+        }
+        std::string_view Digits(Name);
+        Digits = Digits.substr(prefix.size(), Digits.size() - prefix.size() - suffix.size());
+        std::uint32_t Number = 0;
+        auto const Parsed = std::from_chars(Digits.data(), Digits.data() + Digits.size(), Number);
+        if (Parsed.ec == std::errc{} && Parsed.ptr == Digits.data() + Digits.size()) {
+            Entries.emplace_back(Number, It->path());
+        }
+    }
+    std::ranges::sort(Entries);
+    return Entries;
+}
+
+// Number right after `prefix` in `text`: 3 for ("Core 3", "Core ")
+std::optional<std::uint32_t> NumberAfter(std::string_view text, std::string_view prefix) {
+    std::uint32_t Number = 0;
+    if (!text.starts_with(prefix) ||
+        std::from_chars(text.data() + prefix.size(), text.data() + text.size(), Number).ec != std::errc{}) {
+        return std::nullopt;
+    }
+    return Number;
+}
+
+struct SysfsSensor {
+    std::string line;   // THERMAL_SENSORS line, without the newline
+    std::string input;  // file holding the millidegree reading
+};
+
+// coretemp (Intel) labels its package and core sensors; k10temp and zenpower (AMD) expose one die temperature
+// per package, with the packages probed in PCI order
+void FindHwmonSensors(std::vector<SysfsSensor>& sensors) {
+    std::uint32_t AmdPackage = 0;
+    for (const auto& [Number, Hwmon] : NumberedEntries("/sys/class/hwmon", "hwmon")) {
+        auto const Name = ReadAttribute((Hwmon / "name").string());
+        auto const Inputs = NumberedEntries(Hwmon, "temp", "_input");
+        auto const Attribute = [&Hwmon](std::uint32_t index, std::string_view attribute) {
+            return std::format("{}/temp{}_{}", Hwmon.string(), index, attribute);
+        };
+
+        if (Name == "coretemp") {
+            // The platform device is coretemp.<package> on kernels that do not label the package sensor
+            std::error_code Error;
+            auto const Device = std::filesystem::canonical(Hwmon / "device", Error).filename().string();
+            auto Package = NumberAfter(Device, "coretemp.").value_or(0);
+            for (const auto& [Index, Input] : Inputs) {
+                if (auto const Labelled = NumberAfter(ReadAttribute(Attribute(Index, "label")), "Package id ")) {
+                    Package = *Labelled;
+                }
+            }
+            for (const auto& [Index, Input] : Inputs) {
+                auto const Label = ReadAttribute(Attribute(Index, "label"));
+                auto const Critical = ReadAttribute(Attribute(Index, "crit"), "0");
+                if (Label.starts_with("Package id ")) {
+                    sensors.push_back({std::format("package {} {}", Package, Critical), Input.string()});
+                } else if (auto const Core = NumberAfter(Label, "Core ")) {
+                    sensors.push_back({std::format("core {} {} {}", Package, *Core, Critical), Input.string()});
+                }
+            }
+        } else if ((Name == "k10temp" || Name == "zenpower") && !Inputs.empty()) {
+            // Tdie is the die itself; Tctl may carry a fan-control offset, so it is only the fallback
+            auto Chosen = Inputs.front();
+            for (std::string_view const Wanted : {"Tctl", "Tdie"}) {
+                for (const auto& Entry : Inputs) {
+                    if (ReadAttribute(Attribute(Entry.first, "label")) == Wanted) {
+                        Chosen = Entry;
+                    }
+                }
+            }
+            auto const Critical = ReadAttribute(Attribute(Chosen.first, "crit"), "0");
+            sensors.push_back({std::format("package {} {}", AmdPackage++, Critical), Chosen.second.string()});
+        }
+    }
+}
+
+// Thermal zones, for hosts without a CPU hwmon driver: x86_pkg_temp per package, or the SoC zone of ARM boards
+void FindThermalZones(std::vector<SysfsSensor>& sensors) {
+    std::uint32_t Package = 0;
+    for (const auto& [Number, Zone] : NumberedEntries("/sys/class/thermal", "thermal_zone")) {
+        auto const Type = ReadAttribute((Zone / "type").string());
+        bool const Soc = Type == "cpu-thermal" || Type == "cpu_thermal" || Type == "soc_thermal";
+        if (Type != "x86_pkg_temp" && !(Soc && sensors.empty())) {
+            continue;
+        }
+
+        std::string Critical = "0";
+        for (std::size_t Trip = 0;; ++Trip) {
+            auto const TripType = ReadAttribute(std::format("{}/trip_point_{}_type", Zone.string(), Trip));
+            if (TripType.empty()) {
+                break;
+            }
+            if (TripType == "critical") {
+                Critical = ReadAttribute(std::format("{}/trip_point_{}_temp", Zone.string(), Trip), "0");
+                break;
+            }
+        }
+        sensors.push_back({std::format("package {} {}", Package++, Critical), (Zone / "temp").string()});
+    }
+}
+}  // namespace
+
+// ProcfsBackend implementation
+Result<void> ProcfsBackend::Open() {
+    statFile_ = procfs::ProcFile("/proc/stat");
+    meminfoFile_ = procfs::ProcFile("/proc/meminfo");
+    if (!statFile_.IsOpen() || !meminfoFile_.IsOpen()) {
+        auto const Error = errno == EACCES ? SystemError::PERMISSION_DENIED : SystemError::INITIALIZATION_FAILED;
+        statFile_ = {};
+        meminfoFile_ = {};
+        return std::unexpected(Error);
+    }
+    diskstatsFile_ = procfs::ProcFile("/proc/diskstats");
+    netDevFile_ = procfs::ProcFile("/proc/net/dev");
+    pressureFiles_ = {procfs::ProcFile("/proc/pressure/cpu"),
+                      procfs::ProcFile("/proc/pressure/io"),
+                      procfs::ProcFile("/proc/pressure/memory")};
+    frequencyFiles_.clear();
+    frequencyProbed_.clear();
+    temperatureFiles_.clear();
+    return {};
+}
+
+std::string ProcfsBackend::DiscoverThermalSensors() {
+    std::vector<SysfsSensor> Sensors;
+    FindHwmonSensors(Sensors);
+    if (Sensors.empty()) {
+        FindThermalZones(Sensors);
+    }
+
+    std::string Text;
+    temperatureFiles_.clear();
+    for (const auto& Sensor : Sensors) {
+        temperatureFiles_.emplace_back(Sensor.input.c_str());
+        Text.append(Sensor.line).append("\n");
+    }
+    return Text;
+}
+
+const procfs::ProcFile* ProcfsBackend::File(CollectorSource source, std::uint32_t index) {
+    switch (source) {
+        case CollectorSource::STAT:
+            return &statFile_;
+        case CollectorSource::MEMINFO:
+            return &meminfoFile_;
+        case CollectorSource::DISKSTATS:
+            return &diskstatsFile_;
+        case CollectorSource::NET_DEV:
+            return &netDevFile_;
+        case CollectorSource::CPU_FREQUENCY:
+            // Probed once, so hosts without cpufreq (VMs, containers) do not retry the open on every sample
+            if (index >= frequencyProbed_.size()) {
+                frequencyFiles_.resize(index + 1);
+                frequencyProbed_.resize(index + 1, false);
+            }
+            if (!frequencyProbed_[index]) {
+                auto const Path = std::format("/sys/devices/system/cpu/cpu{}/cpufreq/scaling_cur_freq", index);
+                frequencyFiles_[index] = procfs::ProcFile(Path.c_str());
+                frequencyProbed_[index] = true;
+            }
+            return &frequencyFiles_[index];
+        case CollectorSource::TEMPERATURE:
+            return index < temperatureFiles_.size() ? &temperatureFiles_[index] : nullptr;
+        case CollectorSource::PRESSURE:
+            return index < pressureFiles_.size() ? &pressureFiles_[index] : nullptr;
+        case CollectorSource::CPUINFO:
+        case CollectorSource::CPU_TOPOLOGY:
+        case CollectorSource::THERMAL_SENSORS:
+            break;
+    }
+    return nullptr;
+}
+
+std::string_view ProcfsBackend::Read(CollectorSource source, std::uint32_t index, std::span<char> buffer) {
+    if (source == CollectorSource::CPUINFO) {
+        return procfs::ProcFile("/proc/cpuinfo").Read(buffer);
+    }
+    if (source == CollectorSource::CPU_TOPOLOGY || source == CollectorSource::THERMAL_SENSORS) {
+        auto const Text = source == CollectorSource::CPU_TOPOLOGY ? ReadSysfsTopology(index) : DiscoverThermalSensors();
+        auto const Size = std::min(Text.size(), buffer.size());
+        std::copy_n(Text.data(), Size, buffer.data());
+        return {buffer.data(), Size};
+    }
+    const auto* Opened = File(source, index);
+    return Opened != nullptr ? Opened->Read(buffer) : std::string_view{};
+}
+
+std::string ProcfsBackend::ReadAll(CollectorSource source, std::uint32_t index) {
+    if (source == CollectorSource::CPUINFO) {
+        return procfs::ProcFile("/proc/cpuinfo").ReadAll();
+    }
+    if (source == CollectorSource::CPU_TOPOLOGY) {
+        return ReadSysfsTopology(index);
+    }
+    if (source == CollectorSource::THERMAL_SENSORS) {
+        return DiscoverThermalSensors();
+    }
+    const auto* Opened = File(source, index);
+    return Opened != nullptr ? Opened->ReadAll() : std::string{};
+}
+#endif
+
+}  // namespace pc_monitor
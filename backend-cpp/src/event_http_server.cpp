@@ -0,0 +1,876 @@
+#include "event_http_server.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+    #include <array>
+    #include <cerrno>
+    #include <charconv>
+    #include <deque>
+    #include <expected>
+
+    #include <netdb.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <sys/socket.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+#endif
+
+namespace pc_monitor {
+
+#if defined(__linux__)
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t MAX_THREADS = 4;
+constexpr std::size_t MAX_HEADER_SIZE = 8 * 1024;
+constexpr std::size_t MAX_BODY_SIZE = 64 * 1024;
+constexpr std::size_t READ_CHUNK = 16 * 1024;
+constexpr std::size_t MAX_EVENTS = 256;
+constexpr std::size_t MAX_IOVECS = 64;
+constexpr int SWEEP_INTERVAL_MS = 1000;
+
+// Pipelined requests are left unparsed while this much output is queued, so a client that sends without
+// reading cannot grow its queue without bound
+constexpr std::size_t MAX_QUEUED_OUTPUT = 1024 * 1024;
+
+// epoll user data of the two descriptors every I/O thread has besides its connections
+constexpr std::uint64_t LISTENER_ID = 0;
+constexpr std::uint64_t WAKE_ID = 1;
+constexpr std::uint64_t FIRST_CONNECTION_ID = 2;
+
+std::string_view ReasonPhrase(int status) {
+    switch (status) {
+        case 200:
+            return "OK";
+        case 204:
+            return "No Content";
+        case 400:
+            return "Bad Request";
+        case 404:
+            return "Not Found";
+        case 413:
+            return "Payload Too Large";
+        case 431:
+            return "Request Header Fields Too Large";
+        case 500:
+            return "Internal Server Error";
+        case 501:
+            return "Not Implemented";
+        case 503:
+            return "Service Unavailable";
+        default:
+            return status < 400 ? "OK" : "Error";
+    }
+}
+
+bool EqualsIgnoreCase(std::string_view left, std::string_view right) {
+    return std::ranges::equal(left, right, [](char L, char R) {
+        return std::tolower(static_cast<unsigned char>(L)) == std::tolower(static_cast<unsigned char>(R));
+    });
+}
+
+std::string_view Trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// %XX escapes, and '+' as a blank in query strings
+std::string Decode(std::string_view text, bool plusIsBlank) {
+    std::string Decoded;
+    Decoded.reserve(text.size());
+    for (std::size_t I = 0; I < text.size(); ++I) {
+        unsigned Byte = 0;
+        if (text[I] == '%' && I + 2 < text.size() &&
+            std::from_chars(text.data() + I + 1, text.data() + I + 3, Byte, 16).ptr == text.data() + I + 3) {
+            Decoded += static_cast<char>(Byte);
+            I += 2;
+        } else {
+            Decoded += plusIsBlank && text[I] == '+' ? ' ' : text[I];
+        }
+    }
+    return Decoded;
+}
+
+void ParseQuery(std::string_view query, httplib::Params& params) {
+    while (!query.empty()) {
+        auto const Pair = query.substr(0, query.find('&'));
+        query.remove_prefix(std::min(query.size(), Pair.size() + 1));
+        if (Pair.empty()) {
+            continue;
+        }
+        auto const Equals = Pair.find('=');
+        params.emplace(Decode(Pair.substr(0, Equals), true),
+                       Equals == std::string_view::npos ? std::string{} : Decode(Pair.substr(Equals + 1), true));
+    }
+}
+
+// Parses the request at the start of `input` into `request`. Returns its size in bytes, 0 while it is still
+// incomplete, or the HTTP status to answer a malformed one with.
+std::expected<std::size_t, int> ParseRequest(std::string_view input, httplib::Request& request, bool& keepAlive) {
+    auto const HeaderEnd = input.find("\r\n\r\n");
+    if (HeaderEnd == std::string_view::npos ? input.size() > MAX_HEADER_SIZE : HeaderEnd > MAX_HEADER_SIZE) {
+        return std::unexpected(431);
+    }
+    if (HeaderEnd == std::string_view::npos) {
+        return 0;
+    }
+
+    // "GET /path?query HTTP/1.1"
+    std::string_view Remaining = input.substr(0, HeaderEnd + 2);
+    auto const RequestLine = Remaining.substr(0, Remaining.find("\r\n"));
+    Remaining.remove_prefix(RequestLine.size() + 2);
+    auto const MethodEnd = RequestLine.find(' ');
+    auto const TargetEnd = RequestLine.rfind(' ');
+    if (MethodEnd == std::string_view::npos || TargetEnd <= MethodEnd + 1) {
+        return std::unexpected(400);
+    }
+    auto const Target = RequestLine.substr(MethodEnd + 1, TargetEnd - MethodEnd - 1);
+    auto const Version = RequestLine.substr(TargetEnd + 1);
+    if (!Version.starts_with("HTTP/1.")) {
+        return std::unexpected(400);
+    }
+
+    request.method = RequestLine.substr(0, MethodEnd);
+    auto const QueryStart = Target.find('?');
+    request.path = Decode(Target.substr(0, QueryStart), false);
+    if (QueryStart != std::string_view::npos) {
+        ParseQuery(Target.substr(QueryStart + 1), request.params);
+    }
+
+    keepAlive = Version != "HTTP/1.0";
+    std::size_t BodySize = 0;
+    while (!Remaining.empty()) {
+        auto const Line = Remaining.substr(0, Remaining.find("\r\n"));
+        Remaining.remove_prefix(std::min(Remaining.size(), Line.size() + 2));
+
+        auto const Colon = Line.find(':');
+        if (Colon == std::string_view::npos) {
+            return std::unexpected(400);
+        }
+        auto const Name = Trim(Line.substr(0, Colon));
+        auto const Value = Trim(Line.substr(Colon + 1));
+        if (EqualsIgnoreCase(Name, "Connection")) {
+            keepAlive = EqualsIgnoreCase(Value, "close") ? false : EqualsIgnoreCase(Value, "keep-alive") || keepAlive;
+        } else if (EqualsIgnoreCase(Name, "Content-Length")) {
+            auto const [End, Ec] = std::from_chars(Value.data(), Value.data() + Value.size(), BodySize);
+            if (Ec != std::errc{} || End != Value.data() + Value.size()) {
+                return std::unexpected(400);
+            }
+        } else if (EqualsIgnoreCase(Name, "Transfer-Encoding")) {
+            // No route takes a request body, so chunked uploads are not worth decoding
+            return std::unexpected(501);
+        }
+        request.headers.emplace(Name, Value);
+    }
+
+    if (BodySize > MAX_BODY_SIZE) {
+        return std::unexpected(413);
+    }
+    auto const Size = HeaderEnd + 4 + BodySize;
+    if (input.size() < Size) {
+        return 0;
+    }
+    request.body = input.substr(HeaderEnd + 4, BodySize);
+    return Size;
+}
+
+// Bytes queued for the socket, kept alive by `owner` until they have been written
+struct Segment {
+    std::shared_ptr<const void> owner;
+    const char* data;
+    std::size_t size;
+};
+
+// One response: the handler's Response, which owns the body, and the status line and headers in front of it
+struct Reply {
+    httplib::Response response;
+    std::string head;
+};
+
+struct Connection {
+    std::uint64_t id{};
+    int socket = -1;
+    std::string input;
+    std::deque<Segment> output;
+    std::size_t outputOffset = 0;  // bytes of output.front() already written
+    std::size_t queuedBytes = 0;
+    bool closeAfterWrite = false;
+    bool peerClosed = false;
+    Clock::time_point lastActivity;
+
+    // Set once a stream route answered; from then on the connection only carries frames
+    StreamHub* hub = nullptr;
+    std::shared_ptr<StreamHub::Subscription> subscription;
+    std::string_view heartbeat;
+    std::function<void()> onFrame;
+    Clock::time_point lastFrame;
+};
+
+void Enqueue(Connection& connection, Segment segment) {
+    if (segment.size != 0) {
+        connection.queuedBytes += segment.size;
+        connection.output.push_back(std::move(segment));
+    }
+}
+
+// Gathers the queued segments into as few sendmsg() calls as the socket takes; false on a socket error. Unlike
+// writev(), sendmsg() can suppress SIGPIPE for a peer that went away.
+bool Flush(Connection& connection) {
+    std::array<iovec, MAX_IOVECS> Vectors{};
+    while (!connection.output.empty()) {
+        std::size_t Count = 0;
+        for (auto It = connection.output.begin(); It != connection.output.end() && Count < Vectors.size(); ++It) {
+            auto const Skip = Count == 0 ? connection.outputOffset : 0;
+            Vectors[Count++] = iovec{.iov_base = const_cast<char*>(It->data + Skip), .iov_len = It->size - Skip};
+        }
+
+        msghdr Message{};
+        Message.msg_iov = Vectors.data();
+        Message.msg_iovlen = Count;
+        auto const Written = ::sendmsg(connection.socket, &Message, MSG_NOSIGNAL);
+        if (Written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+
+        auto Remaining = static_cast<std::size_t>(Written);
+        connection.queuedBytes -= Remaining;
+        connection.lastActivity = Clock::now();
+        while (Remaining != 0) {
+            auto const Left = connection.output.front().size - connection.outputOffset;
+            if (Remaining < Left) {
+                connection.outputOffset += Remaining;
+                break;
+            }
+            Remaining -= Left;
+            connection.outputOffset = 0;
+            connection.output.pop_front();
+        }
+    }
+    return true;
+}
+
+void CloseDescriptor(int& descriptor) {
+    if (descriptor >= 0) {
+        ::close(descriptor);
+        descriptor = -1;
+    }
+}
+
+}  // namespace
+
+class EventHttpServer::Impl {
+public:
+    explicit Impl(Options options) : options_(options) {
+        if (options_.threads == 0) {
+            options_.threads = DefaultThreads();
+        }
+    }
+
+    ~Impl() {
+        Stop();
+    }
+
+    Impl(const Impl&) = delete;
+    Impl& operator=(const Impl&) = delete;
+    Impl(Impl&&) = delete;
+    Impl& operator=(Impl&&) = delete;
+
+    void Get(const std::string& path, httplib::Server::Handler handler) {
+        routes_.insert_or_assign(path, std::move(handler));
+    }
+
+    void Stream(const std::string& path, StreamHandler handler) {
+        streams_.insert_or_assign(path, std::move(handler));
+    }
+
+    void SetPreRoutingHandler(httplib::Server::HandlerWithResponse handler) {
+        preRouting_ = std::move(handler);
+    }
+
+    void SetLogger(httplib::Server::Logger logger) {
+        logger_ = std::move(logger);
+    }
+
+    Result<void> Start(const std::string& host, std::uint16_t port) {
+        if (running_.load()) {
+            return std::unexpected(SystemError::SYSTEM_ERROR);
+        }
+
+        // Every thread listens on the same address with SO_REUSEPORT, and the kernel spreads new
+        // connections across them
+        addrinfo Hints{};
+        Hints.ai_family = AF_UNSPEC;
+        Hints.ai_socktype = SOCK_STREAM;
+        Hints.ai_flags = AI_PASSIVE;
+        addrinfo* Addresses = nullptr;
+        auto const Service = std::to_string(port);
+        if (getaddrinfo(host.c_str(), Service.c_str(), &Hints, &Addresses) != 0 || Addresses == nullptr) {
+            return std::unexpected(SystemError::INITIALIZATION_FAILED);
+        }
+
+        const addrinfo* Bound = nullptr;
+        for (const auto* Address = Addresses; Address != nullptr && Bound == nullptr; Address = Address->ai_next) {
+            if (auto const Socket = Listen(*Address); Socket >= 0) {
+                ::close(Socket);
+                Bound = Address;
+            }
+        }
+
+        for (std::size_t I = 0; I < options_.threads; ++I) {
+            auto& Added = *workers_.emplace_back(std::make_unique<Worker>());
+            Added.listener = Bound != nullptr ? Listen(*Bound) : -1;
+            Added.epoll = ::epoll_create1(EPOLL_CLOEXEC);
+            Added.wake = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+            epoll_event ListenerEvent{.events = EPOLLIN | EPOLLET, .data = {.u64 = LISTENER_ID}};
+            epoll_event WakeEvent{.events = EPOLLIN, .data = {.u64 = WAKE_ID}};
+            if (Added.listener < 0 || Added.epoll < 0 || Added.wake < 0 ||
+                ::epoll_ctl(Added.epoll, EPOLL_CTL_ADD, Added.listener, &ListenerEvent) != 0 ||
+                ::epoll_ctl(Added.epoll, EPOLL_CTL_ADD, Added.wake, &WakeEvent) != 0) {
+                freeaddrinfo(Addresses);
+                Release();
+                return std::unexpected(SystemError::INITIALIZATION_FAILED);
+            }
+        }
+        freeaddrinfo(Addresses);
+
+        running_.store(true);
+        for (auto& Each : workers_) {
+            Each->thread = std::thread([this, &Each = *Each]() { Run(Each); });
+        }
+        return {};
+    }
+
+    void Stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        for (auto& Each : workers_) {
+            Each->Wake();
+        }
+        for (auto& Each : workers_) {
+            if (Each->thread.joinable()) {
+                Each->thread.join();
+            }
+        }
+        Release();
+    }
+
+    [[nodiscard]] std::size_t ThreadCount() const noexcept {
+        return options_.threads;
+    }
+
+    [[nodiscard]] std::size_t ConnectionCount() const noexcept {
+        return connectionCount_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] std::size_t StreamCount() const noexcept {
+        return streamCount_.load(std::memory_order_relaxed);
+    }
+
+private:
+    // One I/O thread and everything only it touches, except the ready list that publishers append to
+    struct Worker {
+        int listener = -1;
+        int epoll = -1;
+        int wake = -1;  // eventfd, written when `ready` becomes non-empty and on Stop()
+        std::thread thread;
+        std::unordered_map<std::uint64_t, std::unique_ptr<Connection>> connections;
+        std::uint64_t nextId = FIRST_CONNECTION_ID;
+        bool acceptStalled = false;  // accept4() ran out of descriptors; the edge-triggered listener won't fire again
+
+        std::mutex readyMutex;
+        std::vector<std::uint64_t> ready;  // streams with queued frames or a closed subscription
+
+        void Wake() const {
+            std::uint64_t const One = 1;
+            (void)::write(wake, &One, sizeof(One));
+        }
+
+        // Called by StreamHub on the publishing thread; one wakeup covers every stream readied before the
+        // I/O thread gets to them
+        void Ready(std::uint64_t id) {
+            bool WasEmpty = false;
+            {
+                std::lock_guard<std::mutex> const Lock(readyMutex);
+                WasEmpty = ready.empty();
+                ready.push_back(id);
+            }
+            if (WasEmpty) {
+                Wake();
+            }
+        }
+    };
+
+    static int Listen(const addrinfo& address) {
+        auto const Socket = ::socket(address.ai_family, address.ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (Socket < 0) {
+            return -1;
+        }
+        int const Enable = 1;
+        ::setsockopt(Socket, SOL_SOCKET, SO_REUSEADDR, &Enable, sizeof(Enable));
+        ::setsockopt(Socket, SOL_SOCKET, SO_REUSEPORT, &Enable, sizeof(Enable));
+        if (::bind(Socket, address.ai_addr, address.ai_addrlen) != 0 || ::listen(Socket, SOMAXCONN) != 0) {
+            ::close(Socket);
+            return -1;
+        }
+        return Socket;
+    }
+
+    // Closes every connection and descriptor; the threads have been joined (or never started)
+    void Release() {
+        for (auto& Each : workers_) {
+            while (!Each->connections.empty()) {
+                Close(*Each, Each->connections.begin()->first);
+            }
+            CloseDescriptor(Each->listener);
+            CloseDescriptor(Each->wake);
+            CloseDescriptor(Each->epoll);
+        }
+        workers_.clear();
+    }
+
+    void Run(Worker& worker) {
+        std::array<epoll_event, MAX_EVENTS> Events{};
+        auto NextSweep = Clock::now() + std::chrono::milliseconds{SWEEP_INTERVAL_MS};
+        while (running_.load(std::memory_order_relaxed)) {
+            auto const Count =
+                ::epoll_wait(worker.epoll, Events.data(), static_cast<int>(Events.size()), SWEEP_INTERVAL_MS);
+            for (int I = 0; I < Count; ++I) {
+                auto const Id = Events[static_cast<std::size_t>(I)].data.u64;
+                if (Id == LISTENER_ID) {
+                    Accept(worker);
+                } else if (Id == WAKE_ID) {
+                    Pump(worker);
+                } else if (auto Found = worker.connections.find(Id); Found != worker.connections.end()) {
+                    if (!Drive(worker, *Found->second)) {
+                        Close(worker, Id);
+                    }
+                }
+            }
+
+            if (auto const Now = Clock::now(); Now >= NextSweep) {
+                Sweep(worker, Now);
+                NextSweep = Now + std::chrono::milliseconds{SWEEP_INTERVAL_MS};
+            }
+        }
+    }
+
+    void Accept(Worker& worker) {
+        while (true) {
+            auto const Socket = ::accept4(worker.listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (Socket < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) {
+                    continue;
+                }
+                // Out of descriptors: the backlog keeps its connections, retried from Close() and Sweep()
+                worker.acceptStalled = errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM;
+                return;
+            }
+
+            int const NoDelay = 1;
+            ::setsockopt(Socket, IPPROTO_TCP, TCP_NODELAY, &NoDelay, sizeof(NoDelay));
+
+            auto const Id = worker.nextId++;
+            epoll_event Event{.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, .data = {.u64 = Id}};
+            if (::epoll_ctl(worker.epoll, EPOLL_CTL_ADD, Socket, &Event) != 0) {
+                ::close(Socket);
+                continue;
+            }
+            auto Created = std::make_unique<Connection>();
+            Created->id = Id;
+            Created->socket = Socket;
+            Created->lastActivity = Clock::now();
+            worker.connections.emplace(Id, std::move(Created));
+            connectionCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void Close(Worker& worker, std::uint64_t id) {
+        auto Found = worker.connections.find(id);
+        if (Found == worker.connections.end()) {
+            return;
+        }
+        auto& Closing = *Found->second;
+        if (Closing.subscription) {
+            Closing.hub->Unsubscribe(Closing.subscription);
+            streamCount_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        ::close(Closing.socket);
+        worker.connections.erase(Found);
+        connectionCount_.fetch_sub(1, std::memory_order_relaxed);
+
+        if (worker.acceptStalled && running_.load(std::memory_order_relaxed)) {
+            Accept(worker);
+        }
+    }
+
+    // Reads, answers and writes until the socket would block; false once the connection is done with
+    bool Drive(Worker& worker, Connection& connection) {
+        std::array<char, READ_CHUNK> Buffer;
+        while (true) {
+            if (connection.subscription ? !Feed(connection) : !Flush(connection)) {
+                return false;
+            }
+            if (connection.closeAfterWrite && connection.output.empty()) {
+                return false;
+            }
+            if (connection.queuedBytes >= MAX_QUEUED_OUTPUT) {
+                return true;  // resumed by EPOLLOUT once the client reads
+            }
+            if (!connection.subscription && Answer(worker, connection)) {
+                continue;
+            }
+            if (connection.peerClosed) {
+                return !connection.output.empty() && !connection.subscription;
+            }
+
+            auto const Received = ::recv(connection.socket, Buffer.data(), Buffer.size(), 0);
+            if (Received > 0) {
+                // A stream client, or one whose connection is closing, has nothing more to say that is answered
+                if (!connection.subscription && !connection.closeAfterWrite) {
+                    connection.input.append(Buffer.data(), static_cast<std::size_t>(Received));
+                }
+                connection.lastActivity = Clock::now();
+            } else if (Received == 0) {
+                connection.peerClosed = true;
+            } else if (errno != EINTR) {
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+        }
+    }
+
+    // Answers the complete requests at the front of the input, in order, until a response closes the
+    // connection, a stream starts or enough output is queued; true when anything was answered
+    bool Answer(Worker& worker, Connection& connection) {
+        std::size_t Consumed = 0;
+        bool Answered = false;
+        while (!connection.closeAfterWrite && !connection.subscription &&
+               connection.queuedBytes < MAX_QUEUED_OUTPUT) {
+            httplib::Request Request;
+            bool KeepAlive = true;
+            auto const Parsed =
+                ParseRequest(std::string_view(connection.input).substr(Consumed), Request, KeepAlive);
+            if (!Parsed) {
+                // The framing of anything after a malformed request is unknown, so the connection ends here
+                auto Error = std::make_shared<Reply>();
+                Error->response.status = Parsed.error();
+                QueueReply(connection, std::move(Error), false, false);
+                Consumed = connection.input.size();
+                Answered = true;
+                break;
+            }
+            if (*Parsed == 0) {
+                break;
+            }
+            Consumed += *Parsed;
+            Dispatch(worker, connection, Request, KeepAlive);
+            Answered = true;
+        }
+        connection.input.erase(0, Consumed);
+        return Answered;
+    }
+
+    void Dispatch(Worker& worker, Connection& connection, const httplib::Request& request, bool keepAlive) {
+        auto Answered = std::make_shared<Reply>();
+        bool const Head = request.method == "HEAD";
+        StreamSource Source;
+        bool Routed = true;
+        try {
+            auto& Response = Answered->response;
+            if (preRouting_ && preRouting_(request, Response) == httplib::Server::HandlerResponse::Handled) {
+                // The pre-routing handler answered on its own
+            } else if (request.method == "OPTIONS") {
+                Response.status = 200;
+            } else if (auto Route = routes_.find(request.path);
+                       (request.method == "GET" || Head) && Route != routes_.end()) {
+                Route->second(request, Response);
+            } else if (auto Stream = streams_.find(request.path);
+                       request.method == "GET" && Stream != streams_.end()) {
+                Source = Stream->second(request, Response);
+            } else {
+                Routed = false;
+            }
+        } catch (...) {
+            Answered = std::make_shared<Reply>();
+            Answered->response.status = 500;
+            Source = {};
+        }
+        if (Answered->response.status == -1) {
+            Answered->response.status = Routed ? 200 : 404;
+        }
+
+        if (logger_) {
+            logger_(request, Answered->response);
+        }
+        if (Source.hub != nullptr) {
+            OpenStream(worker, connection, std::move(Answered), std::move(Source));
+        } else {
+            QueueReply(connection, std::move(Answered), keepAlive, Head);
+        }
+    }
+
+    static void AppendHead(Reply& reply, bool keepAlive, const std::size_t* contentLength) {
+        auto& Head = reply.head;
+        auto const& Response = reply.response;
+        Head.reserve(256);
+        Head.append("HTTP/1.1 ").append(std::to_string(Response.status)).append(" ");
+        Head.append(ReasonPhrase(Response.status)).append("\r\n");
+        for (const auto& [Name, Value] : Response.headers) {
+            if (!EqualsIgnoreCase(Name, "Content-Length") && !EqualsIgnoreCase(Name, "Connection")) {
+                Head.append(Name).append(": ").append(Value).append("\r\n");
+            }
+        }
+        if (contentLength != nullptr) {
+            Head.append("Content-Length: ").append(std::to_string(*contentLength)).append("\r\n");
+        }
+        Head.append(keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n");
+    }
+
+    // Queues the head and body of a plain response. A content provider's bytes are not copied: they are
+    // written straight from the memory it points the sink at, which the Response keeps alive.
+    static void QueueReply(Connection& connection, std::shared_ptr<Reply> reply, bool keepAlive, bool head) {
+        auto& Response = reply->response;
+        std::vector<Segment> Body;
+        std::size_t Length = Response.body.size();
+        if (Response.is_chunked_content_provider_) {
+            reply = std::make_shared<Reply>();
+            reply->response.status = 500;
+            Length = 0;
+        } else if (Response.content_provider_) {
+            Length = Response.content_length_;
+            std::size_t Offset = 0;
+            httplib::DataSink Sink;
+            Sink.write = [&](const char* data, std::size_t size) {
+                Body.push_back(Segment{.owner = reply, .data = data, .size = size});
+                Offset += size;
+                return true;
+            };
+            Sink.is_writable = []() { return true; };
+            while (Offset < Length) {
+                if (!Response.content_provider_(Offset, Length - Offset, Sink)) {
+                    Body.clear();
+                    reply = std::make_shared<Reply>();
+                    reply->response.status = 500;
+                    Length = 0;
+                    break;
+                }
+            }
+        } else if (!head) {
+            Body.push_back(Segment{.owner = reply, .data = Response.body.data(), .size = Length});
+        }
+
+        AppendHead(*reply, keepAlive, &Length);
+        Enqueue(connection, Segment{.owner = reply, .data = reply->head.data(), .size = reply->head.size()});
+        if (!head) {
+            for (auto& Piece : Body) {
+                Enqueue(connection, std::move(Piece));
+            }
+        }
+        connection.closeAfterWrite = connection.closeAfterWrite || !keepAlive;
+    }
+
+    // The body of a stream runs until the connection closes, so it carries no length and the connection is
+    // never reused
+    void OpenStream(Worker& worker, Connection& connection, std::shared_ptr<Reply> reply, StreamSource source) {
+        AppendHead(*reply, false, nullptr);
+        Enqueue(connection, Segment{.owner = reply, .data = reply->head.data(), .size = reply->head.size()});
+
+        connection.hub = source.hub;
+        connection.heartbeat = source.heartbeat;
+        connection.onFrame = std::move(source.onFrame);
+        connection.lastFrame = Clock::now();
+        connection.subscription =
+            source.hub->Subscribe(source.initial, [&worker, Id = connection.id]() { worker.Ready(Id); });
+        streamCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Moves the frames published since the last pump onto the stream sockets of the worker
+    void Pump(Worker& worker) {
+        std::uint64_t Drained = 0;
+        (void)::read(worker.wake, &Drained, sizeof(Drained));
+
+        std::vector<std::uint64_t> Ready;
+        {
+            std::lock_guard<std::mutex> const Lock(worker.readyMutex);
+            Ready.swap(worker.ready);
+        }
+        for (auto const Id : Ready) {
+            auto Found = worker.connections.find(Id);
+            if (Found != worker.connections.end() && !Feed(*Found->second)) {
+                Close(worker, Id);
+            }
+        }
+    }
+
+    // Takes queued frames only once the previous ones are written, so a stalled client falls behind in the
+    // hub, whose drop and disconnect policy then applies
+    static bool Feed(Connection& connection) {
+        if (connection.subscription->IsClosed()) {
+            return false;
+        }
+        bool Queued = false;
+        if (connection.output.empty()) {
+            while (auto Frame = connection.subscription->TryNext()) {
+                auto const* Data = Frame->data();
+                auto const Size = Frame->size();
+                Enqueue(connection, Segment{.owner = std::move(Frame), .data = Data, .size = Size});
+                Queued = true;
+            }
+        }
+        if (Queued) {
+            connection.lastFrame = Clock::now();
+            if (connection.onFrame) {
+                connection.onFrame();
+            }
+        }
+        return Flush(connection);
+    }
+
+    // Retries a stalled accept, heartbeats for quiet streams, and closes connections that sat idle or could not
+    // be written to
+    void Sweep(Worker& worker, Clock::time_point now) {
+        // Descriptors may have been freed outside this worker (other workers, the rest of the process)
+        if (worker.acceptStalled) {
+            Accept(worker);
+        }
+
+        std::vector<std::uint64_t> Expired;
+        for (auto& [Id, Each] : worker.connections) {
+            auto const Idle = now - Each->lastActivity;
+            if (!Each->output.empty()) {
+                if (Idle > options_.writeTimeout) {
+                    Expired.push_back(Id);
+                }
+            } else if (Each->subscription) {
+                if (now - Each->lastFrame >= options_.streamHeartbeat) {
+                    Each->lastFrame = now;
+                    Enqueue(*Each,
+                            Segment{.owner = nullptr, .data = Each->heartbeat.data(), .size = Each->heartbeat.size()});
+                    if (!Flush(*Each)) {
+                        Expired.push_back(Id);
+                    }
+                }
+            } else if (Idle > options_.keepAliveTimeout) {
+                Expired.push_back(Id);
+            }
+        }
+        for (auto const Id : Expired) {
+            Close(worker, Id);
+        }
+    }
+
+    Options options_;
+    std::unordered_map<std::string, httplib::Server::Handler> routes_;
+    std::unordered_map<std::string, StreamHandler> streams_;
+    httplib::Server::HandlerWithResponse preRouting_;
+    httplib::Server::Logger logger_;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> running_{false};
+    std::atomic<std::size_t> connectionCount_{0};
+    std::atomic<std::size_t> streamCount_{0};
+};
+
+#else
+
+// Other platforms keep the thread-per-connection httplib server
+class EventHttpServer::Impl {
+public:
+    explicit Impl(Options options) : options_(options) {}
+
+    void Get(const std::string& /*path*/, httplib::Server::Handler /*handler*/) {}
+    void Stream(const std::string& /*path*/, StreamHandler /*handler*/) {}
+    void SetPreRoutingHandler(httplib::Server::HandlerWithResponse /*handler*/) {}
+    void SetLogger(httplib::Server::Logger /*logger*/) {}
+
+    Result<void> Start(const std::string& /*host*/, std::uint16_t /*port*/) {
+        return std::unexpected(SystemError::INITIALIZATION_FAILED);
+    }
+    void Stop() {}
+
+    [[nodiscard]] std::size_t ThreadCount() const noexcept {
+        return options_.threads;
+    }
+    [[nodiscard]] std::size_t ConnectionCount() const noexcept {
+        return 0;
+    }
+    [[nodiscard]] std::size_t StreamCount() const noexcept {
+        return 0;
+    }
+
+private:
+    Options options_;
+};
+
+#endif
+
+EventHttpServer::EventHttpServer(Options options) : pImpl_(std::make_unique<Impl>(options)) {}
+
+EventHttpServer::~EventHttpServer() = default;
+
+void EventHttpServer::Get(const std::string& path, httplib::Server::Handler handler) {
+    pImpl_->Get(path, std::move(handler));
+}
+
+void EventHttpServer::Stream(const std::string& path, StreamHandler handler) {
+    pImpl_->Stream(path, std::move(handler));
+}
+
+void EventHttpServer::SetPreRoutingHandler(httplib::Server::HandlerWithResponse handler) {
+    pImpl_->SetPreRoutingHandler(std::move(handler));
+}
+
+void EventHttpServer::SetLogger(httplib::Server::Logger logger) {
+    pImpl_->SetLogger(std::move(logger));
+}
+
+Result<void> EventHttpServer::Start(const std::string& host, std::uint16_t port) {
+    return pImpl_->Start(host, port);
+}
+
+void EventHttpServer::Stop() {
+    pImpl_->Stop();
+}
+
+std::size_t EventHttpServer::ThreadCount() const noexcept {
+    return pImpl_->ThreadCount();
+}
+
+std::size_t EventHttpServer::ConnectionCount() const noexcept {
+    return pImpl_->ConnectionCount();
+}
+
+std::size_t EventHttpServer::StreamCount() const noexcept {
+    return pImpl_->StreamCount();
+}
+
+std::size_t EventHttpServer::DefaultThreads() noexcept {
+#if defined(__linux__)
+    return std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, MAX_THREADS);
+#else
+    return 0;
+#endif
+}
+
+}  // namespace pc_monitor
@@ -0,0 +1,213 @@
+#include "event_loop.hpp"
+
+#include <algorithm>
+
+namespace pc_monitor {
+
+void Task::promise_type::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+    auto* Loop = handle.promise().loop;
+    handle.destroy();
+    Loop->TaskFinished();
+}
+
+EventLoop::~EventLoop() {
+    Stop();
+}
+
+void EventLoop::Start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+
+    if (stopSource_.stop_requested()) {
+        stopSource_ = std::stop_source{};
+    }
+    loopThread_ = std::thread([this]() { Run(); });
+}
+
+void EventLoop::Stop() {
+    if (running_.exchange(false)) {
+        // Stop callbacks of sleeping tasks run here and post them back to the loop
+        stopSource_.request_stop();
+        {
+            std::lock_guard<std::mutex> const Lock(mutex_);
+        }
+        wake_.notify_all();
+
+        if (loopThread_.joinable()) {
+            loopThread_.join();
+        }
+    }
+}
+
+void EventLoop::Spawn(Task task) {
+    auto Handle = std::exchange(task.handle_, {});
+    Handle.promise().loop = this;
+    activeTasks_.fetch_add(1);
+    Post(Handle);
+}
+
+void EventLoop::Post(std::coroutine_handle<> handle) {
+    bool WasEmpty = false;
+    {
+        std::lock_guard<std::mutex> const Lock(mutex_);
+        WasEmpty = ready_.empty();
+        ready_.push_back(handle);
+    }
+
+    // The loop only sleeps on an empty queue, so fanning out to many waiters costs one wake-up
+    if (WasEmpty) {
+        wake_.notify_one();
+    }
+}
+
+void EventLoop::Post(std::span<const std::coroutine_handle<>> handles) {
+    bool WasEmpty = false;
+    {
+        std::lock_guard<std::mutex> const Lock(mutex_);
+        WasEmpty = ready_.empty();
+        ready_.insert(ready_.end(), handles.begin(), handles.end());
+    }
+    if (WasEmpty && !handles.empty()) {
+        wake_.notify_one();
+    }
+}
+
+void EventLoop::TaskFinished() {
+    // Runs on the loop thread, which checks for shutdown after every batch
+    activeTasks_.fetch_sub(1);
+}
+
+TimerWheel::Key EventLoop::AddTimer(Clock::time_point deadline, std::coroutine_handle<> handle) {
+    // Only called from the loop thread, which recomputes its next wake-up after the current batch
+    std::lock_guard<std::mutex> const Lock(mutex_);
+    auto const Key = nextTimerKey_++;
+    timers_.Schedule(Key, deadline);
+    sleepers_.emplace(Key, handle);
+    return Key;
+}
+
+bool EventLoop::CancelTimer(TimerWheel::Key key, Clock::time_point deadline) {
+    {
+        std::lock_guard<std::mutex> const Lock(mutex_);
+        if (!timers_.Cancel(key, deadline)) {
+            return false;
+        }
+        auto const Found = sleepers_.find(key);
+        ready_.push_back(Found->second);
+        sleepers_.erase(Found);
+    }
+    wake_.notify_one();
+    return true;
+}
+
+void EventLoop::ForgetTimer(TimerWheel::Key key, Clock::time_point deadline) {
+    std::lock_guard<std::mutex> const Lock(mutex_);
+    if (timers_.Cancel(key, deadline)) {
+        sleepers_.erase(key);
+    }
+}
+
+void EventLoop::Run() {
+    std::vector<std::coroutine_handle<>> Batch;
+    std::unique_lock<std::mutex> Lock(mutex_);
+
+    auto const Finished = [this]() { return stopSource_.stop_requested() && activeTasks_.load() == 0; };
+    while (true) {
+        expired_.clear();
+        timers_.Expire(Clock::now(), expired_);
+        for (const auto& Entry : expired_) {
+            auto const Found = sleepers_.find(Entry.key);
+            ready_.push_back(Found->second);
+            sleepers_.erase(Found);
+        }
+
+        if (ready_.empty()) {
+            if (Finished()) {
+                break;
+            }
+            auto const Wake = [this, &Finished]() { return !ready_.empty() || Finished(); };
+            if (auto const Next = timers_.NextDeadline()) {
+                wake_.wait_until(Lock, *Next, Wake);
+            } else {
+                wake_.wait(Lock, Wake);
+            }
+            continue;
+        }
+
+        // Resumed without the lock, so coroutines can post, sleep and cancel freely
+        Batch.swap(ready_);
+        Lock.unlock();
+        for (auto Handle : Batch) {
+            Handle.resume();
+        }
+        Batch.clear();
+        Lock.lock();
+    }
+}
+
+EventLoop::SleepAwaiter::~SleepAwaiter() {
+    onStop_.reset();
+    if (pending_) {
+        loop_.ForgetTimer(key_, deadline_);
+    }
+}
+
+void EventLoop::SleepAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    key_ = loop_.AddTimer(deadline_, handle);
+    pending_ = true;
+
+    // Runs straight away when stop was requested in between, which posts the coroutine right back
+    onStop_.emplace(stop_, Cancel{this});
+}
+
+bool EventLoop::SleepAwaiter::await_resume() {
+    onStop_.reset();
+    pending_ = false;
+    return !stop_.stop_requested();
+}
+
+void EventLoop::SleepAwaiter::Cancel::operator()() const {
+    (void)awaiter->loop_.CancelTimer(awaiter->key_, awaiter->deadline_);
+}
+
+void AsyncNotifier::Notify() {
+    std::vector<Waiter> Woken;
+    {
+        std::lock_guard<std::mutex> const Lock(mutex_);
+        Woken.reserve(waiters_.size());
+        for (auto* Waiter : waiters_) {
+            Woken.push_back(*Waiter);
+        }
+        waiters_.clear();
+    }
+
+    // Posted without the lock, so woken coroutines can wait again right away; runs that share a loop go in
+    // with one lock and at most one wake-up
+    std::vector<std::coroutine_handle<>> Handles;
+    for (std::size_t First = 0; First < Woken.size();) {
+        auto* Loop = Woken[First].loop;
+        Handles.clear();
+        for (; First < Woken.size() && Woken[First].loop == Loop; ++First) {
+            Handles.push_back(Woken[First].handle);
+        }
+        Loop->Post(Handles);
+    }
+}
+
+std::size_t AsyncNotifier::WaiterCount() const {
+    std::lock_guard<std::mutex> const Lock(mutex_);
+    return waiters_.size();
+}
+
+bool AsyncNotifier::Remove(Waiter* waiter) {
+    std::lock_guard<std::mutex> const Lock(mutex_);
+    auto const Found = std::ranges::find(waiters_, waiter);
+    if (Found == waiters_.end()) {
+        return false;
+    }
+    waiters_.erase(Found);
+    return true;
+}
+
+}  // namespace pc_monitor
@@ -0,0 +1,402 @@
+#include "fleet_aggregator.hpp"
+
+#include "json_writer.hpp"
+#include "perf_stats.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <utility>
+
+#include <httplib.h>
+#include <nlohmann/json.hpp>
+
+namespace pc_monitor {
+
+namespace {
+constexpr std::uint16_t DEFAULT_PORT = 3001;
+constexpr unsigned MAX_BACKOFF_DOUBLINGS = 16;
+
+double Number(const nlohmann::json& object, const char* key) {
+    auto const Found = object.find(key);
+    return Found != object.end() && Found->is_number() ? Found->get<double>() : 0.0;
+}
+
+std::uint64_t Count(const nlohmann::json& object, const char* key) {
+    auto const Found = object.find(key);
+    return Found != object.end() && Found->is_number_unsigned() ? Found->get<std::uint64_t>() : 0;
+}
+
+const nlohmann::json& Child(const nlohmann::json& object, const char* key) {
+    static const nlohmann::json EMPTY = nlohmann::json::object();
+    auto const Found = object.find(key);
+    return Found != object.end() ? *Found : EMPTY;
+}
+
+// Fills the summary fields of `host` from an upstream /api/stats body; false when it is not one
+bool Summarize(std::string_view body, FleetHost& host) {
+    auto const Stats = nlohmann::json::parse(body, nullptr, false);
+    if (!Stats.is_object() || !Stats.contains("cpu") || !Stats.contains("memory")) {
+        return false;
+    }
+
+    const auto& Cpu = Child(Stats, "cpu");
+    const auto& Cores = Child(Cpu, "cores");
+    host.cores = Cores.is_array() ? Cores.size() : 0;
+    host.cpu = Number(Cpu, "overall");
+    host.temperature.reset();
+    if (auto const Found = Cpu.find("temperature"); Found != Cpu.end() && Found->is_number()) {
+        host.temperature = Found->get<double>();
+    }
+    auto const Throttling = Cpu.find("throttling");
+    host.throttling = Throttling != Cpu.end() && Throttling->is_boolean() && Throttling->get<bool>();
+
+    const auto& Memory = Child(Stats, "memory");
+    host.memoryTotal = Count(Memory, "total");
+    host.memoryUsed = Count(Memory, "used");
+    host.memoryUsagePercent = Number(Memory, "usagePercent");
+
+    host.diskReadBytesPerSec = 0.0;
+    host.diskWriteBytesPerSec = 0.0;
+    if (const auto& Disks = Child(Stats, "disks"); Disks.is_array()) {
+        for (const auto& Disk : Disks) {
+            host.diskReadBytesPerSec += Number(Disk, "readBytesPerSec");
+            host.diskWriteBytesPerSec += Number(Disk, "writeBytesPerSec");
+        }
+    }
+    host.networkRxBytesPerSec = 0.0;
+    host.networkTxBytesPerSec = 0.0;
+    if (const auto& Network = Child(Stats, "network"); Network.is_array()) {
+        for (const auto& Nic : Network) {
+            host.networkRxBytesPerSec += Number(Nic, "rxBytesPerSec");
+            host.networkTxBytesPerSec += Number(Nic, "txBytesPerSec");
+        }
+    }
+    return true;
+}
+
+FleetRollup Rollup(const std::vector<FleetHost>& hosts) {
+    FleetRollup Result{.hosts = hosts.size()};
+    double WeightedCpu = 0.0;
+    for (const auto& Host : hosts) {
+        if (!Host.up) {
+            continue;
+        }
+        ++Result.up;
+        Result.cores += Host.cores;
+        WeightedCpu += Host.cpu * static_cast<double>(Host.cores);
+        if (!Result.busiest || Host.cpu > Result.cpuMax) {
+            Result.cpuMax = Host.cpu;
+            Result.busiest = Host.name;
+        }
+        if (Host.temperature && (!Result.temperatureMax || *Host.temperature > *Result.temperatureMax)) {
+            Result.temperatureMax = Host.temperature;
+        }
+        Result.throttling += Host.throttling ? 1 : 0;
+        Result.memoryTotal += Host.memoryTotal;
+        Result.memoryUsed += Host.memoryUsed;
+        Result.diskReadBytesPerSec += Host.diskReadBytesPerSec;
+        Result.diskWriteBytesPerSec += Host.diskWriteBytesPerSec;
+        Result.networkRxBytesPerSec += Host.networkRxBytesPerSec;
+        Result.networkTxBytesPerSec += Host.networkTxBytesPerSec;
+    }
+    if (Result.cores != 0) {
+        Result.cpuMean = WeightedCpu / static_cast<double>(Result.cores);
+    }
+    if (Result.memoryTotal != 0) {
+        Result.memoryUsagePercent =
+            100.0 * static_cast<double>(Result.memoryUsed) / static_cast<double>(Result.memoryTotal);
+    }
+    return Result;
+}
+
+// "host:port" or "host"
+std::optional<UpstreamConfig> ParseAddress(std::string_view address) {
+    UpstreamConfig Upstream{.name = std::string(address), .host = std::string(address), .port = DEFAULT_PORT};
+    if (auto const Colon = address.rfind(':'); Colon != std::string_view::npos) {
+        auto const Port = address.substr(Colon + 1);
+        auto const [End, Ec] = std::from_chars(Port.data(), Port.data() + Port.size(), Upstream.port);
+        if (Ec != std::errc{} || End != Port.data() + Port.size() || Upstream.port == 0) {
+            return std::nullopt;
+        }
+        Upstream.host = std::string(address.substr(0, Colon));
+    }
+    if (Upstream.host.empty()) {
+        return std::nullopt;
+    }
+    return Upstream;
+}
+}  // namespace
+
+struct FleetAggregator::Upstream {
+    UpstreamConfig config;
+    httplib::Client client;
+    std::minstd_rand jitter;
+    std::size_t index;  // in upstreams_
+
+    // Guarded by FleetAggregator::mutex_
+    FleetHost host;
+    std::shared_ptr<const std::string> body;  // last good /api/stats
+    bool dirty = true;                        // listed in dirty_; every host starts out unrendered
+
+    Upstream(UpstreamConfig upstream, std::chrono::milliseconds timeout, std::size_t position)
+        : config(std::move(upstream)),
+          client(config.host, config.port),
+          jitter(static_cast<std::uint32_t>(position + 1)),
+          index(position) {
+        auto const Seconds = static_cast<time_t>(timeout.count() / 1000);
+        auto const Micros = static_cast<time_t>((timeout.count() % 1000) * 1000);
+        client.set_keep_alive(true);
+        client.set_connection_timeout(Seconds, Micros);
+        client.set_read_timeout(Seconds, Micros);
+        client.set_write_timeout(Seconds, Micros);
+
+        host.name = config.name;
+        host.address = std::format("{}:{}", config.host, config.port);
+        host.error = "not fetched yet";
+    }
+};
+
+std::expected<std::vector<UpstreamConfig>, std::string> FleetAggregator::Parse(std::string_view config) {
+    auto const Document = nlohmann::json::parse(config, nullptr, false);
+    auto const List = Document.find("upstreams");
+    if (List == Document.end() || !List->is_array()) {
+        return std::unexpected(std::string(R"(expected {"upstreams":[...]})"));
+    }
+
+    std::vector<UpstreamConfig> Upstreams;
+    std::set<std::string, std::less<>> Names;
+    for (const auto& Entry : *List) {
+        auto const Fail = [&](std::string_view what) {
+            return std::unexpected(std::format("upstream {}: {}", Upstreams.size() + 1, what));
+        };
+
+        std::optional<UpstreamConfig> Parsed;
+        if (Entry.is_string()) {
+            Parsed = ParseAddress(Entry.get<std::string>());
+        } else if (Entry.is_object() && Entry.contains("host") && Entry["host"].is_string()) {
+            Parsed = ParseAddress(Entry["host"].get<std::string>());
+            if (Parsed && Entry.contains("port")) {
+                auto const Port = Entry["port"].is_number_unsigned() ? Entry["port"].get<std::uint64_t>() : 0;
+                if (Port == 0 || Port > 65535) {
+                    return Fail("port must be 1-65535");
+                }
+                Parsed->port = static_cast<std::uint16_t>(Port);
+                Parsed->name = std::format("{}:{}", Parsed->host, Parsed->port);
+            }
+            if (Parsed && Entry.contains("name")) {
+                if (!Entry["name"].is_string() || Entry["name"].get<std::string>().empty()) {
+                    return Fail("name must be a non-empty string");
+                }
+                Parsed->name = Entry["name"].get<std::string>();
+            }
+        }
+        if (!Parsed) {
+            return Fail(R"(expected "host:port" or {"name","host","port"})");
+        }
+        if (!Names.insert(Parsed->name).second) {
+            return Fail(std::format("duplicate name {}", Parsed->name));
+        }
+        Upstreams.push_back(std::move(*Parsed));
+    }
+    if (Upstreams.empty()) {
+        return std::unexpected(std::string("no upstreams"));
+    }
+    return Upstreams;
+}
+
+std::expected<std::vector<UpstreamConfig>, std::string> FleetAggregator::Load(const std::filesystem::path& path) {
+    std::ifstream In(path, std::ios::binary);
+    std::ostringstream Content;
+    if (!In || !(Content << In.rdbuf())) {
+        return std::unexpected(std::format("cannot read {}", path.string()));
+    }
+    return Parse(Content.view());
+}
+
+FleetAggregator::FleetAggregator(std::vector<UpstreamConfig> upstreams, Options options) : options_(options) {
+    upstreams_.reserve(upstreams.size());
+    for (auto& Config : upstreams) {
+        dirty_.push_back(upstreams_.size());
+        upstreams_.push_back(std::make_unique<Upstream>(std::move(Config), options_.timeout, upstreams_.size()));
+    }
+    hosts_.resize(upstreams_.size());
+    bodies_.resize(upstreams_.size());
+    rows_.resize(upstreams_.size());
+    Render();
+}
+
+FleetAggregator::~FleetAggregator() {
+    Stop();
+}
+
+void FleetAggregator::Start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    threads_.reserve(upstreams_.size() + 1);
+    for (auto& Entry : upstreams_) {
+        threads_.emplace_back([this, &Entry]() { Poll(*Entry); });
+    }
+    threads_.emplace_back([this]() { RenderLoop(); });
+}
+
+void FleetAggregator::Stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> const Lock(mutex_);
+        changed_.notify_all();
+        stopping_.notify_all();
+    }
+    for (auto& Entry : upstreams_) {
+        Entry->client.stop();  // shuts the socket of a fetch in flight
+    }
+    for (auto& Thread : threads_) {
+        Thread.join();
+    }
+    threads_.clear();
+}
+
+// Fetches are paced from their start, so a slow answer does not stretch the interval; failures retry after
+// interval * 2^failures, capped and spread by +-20% so hosts that fail together do not retry together
+void FleetAggregator::Poll(Upstream& upstream) {
+    std::uniform_real_distribution<double> Spread(0.8, 1.2);
+    while (running_.load()) {
+        auto const Started = std::chrono::steady_clock::now();
+        auto Response = upstream.client.Get("/api/stats");
+        auto const Latency = std::chrono::steady_clock::now() - Started;
+
+        if (Response && Response->status == 200) {
+            Accept(upstream, std::move(Response->body), Latency);
+        } else {
+            Fail(upstream,
+                 Response ? std::format("HTTP {}", Response->status) : httplib::to_string(Response.error()));
+        }
+
+        std::unique_lock<std::mutex> Lock(mutex_);
+        auto const Failures = upstream.host.failures;
+
+        auto Delay = std::chrono::duration_cast<std::chrono::steady_clock::duration>(options_.interval);
+        if (Failures != 0) {
+            auto const Doublings = std::min(Failures, MAX_BACKOFF_DOUBLINGS);
+            auto const Backoff = std::min<std::chrono::steady_clock::duration>(Delay * (1ULL << Doublings),
+                                                                                options_.maxBackoff);
+            Delay = std::chrono::duration_cast<std::chrono::steady_clock::duration>(Backoff *
+                                                                                   Spread(upstream.jitter));
+        }
+        stopping_.wait_until(Lock, Started + Delay, [this]() { return !running_.load(); });
+    }
+}
+
+void FleetAggregator::Accept(Upstream& upstream, std::string body, std::chrono::steady_clock::duration latency) {
+    // Parsed outside the lock; only the summary and the shared body are swapped in under it
+    FleetHost Summary;
+    if (!Summarize(body, Summary)) {
+        Fail(upstream, "not a stats body");
+        return;
+    }
+    auto Body = std::make_shared<const std::string>(std::move(body));
+
+    std::lock_guard<std::mutex> const Lock(mutex_);
+    Summary.name = std::move(upstream.host.name);
+    Summary.address = std::move(upstream.host.address);
+    Summary.up = true;
+    Summary.lastSeen = std::chrono::system_clock::now();
+    Summary.latencyMs = std::chrono::duration<double, std::milli>(latency).count();
+    upstream.host = std::move(Summary);
+    upstream.body = std::move(Body);
+    MarkDirty(upstream);
+}
+
+// The host stays in the view with its last summary and body, marked down
+void FleetAggregator::Fail(Upstream& upstream, std::string error) {
+    std::lock_guard<std::mutex> const Lock(mutex_);
+    upstream.host.up = false;
+    upstream.host.error = std::move(error);
+    ++upstream.host.failures;
+    MarkDirty(upstream);
+}
+
+void FleetAggregator::MarkDirty(Upstream& upstream) {
+    if (!upstream.dirty) {
+        upstream.dirty = true;
+        dirty_.push_back(upstream.index);
+    }
+    changed_.notify_one();
+}
+
+// Renders are at least interval / 4 apart, so fetches landing together share one, however many hosts there are
+void FleetAggregator::RenderLoop() {
+    auto const Tick = options_.interval / 4;
+    while (running_.load()) {
+        {
+            std::unique_lock<std::mutex> Lock(mutex_);
+            changed_.wait(Lock, [this]() { return !dirty_.empty() || !running_.load(); });
+        }
+        if (!running_.load()) {
+            break;
+        }
+
+        auto const Rendered = std::chrono::steady_clock::now();
+        Render();
+        std::unique_lock<std::mutex> Lock(mutex_);
+        stopping_.wait_until(Lock, Rendered + Tick, [this]() { return !running_.load(); });
+    }
+}
+
+void FleetAggregator::Render() {
+    static auto const RenderLatency = perf::Register("serialize.fleet");
+    perf::ScopedTimer const Timer(RenderLatency);
+
+    // Only the hosts that changed are copied under the lock and re-serialized
+    {
+        std::lock_guard<std::mutex> const Lock(mutex_);
+        rendering_.swap(dirty_);
+        for (auto const Index : rendering_) {
+            auto& Entry = *upstreams_[Index];
+            Entry.dirty = false;
+            hosts_[Index] = Entry.host;
+            bodies_[Index] = Entry.body;
+        }
+    }
+    for (auto const Index : rendering_) {
+        rows_[Index].clear();
+        json::AppendJson(rows_[Index], hosts_[Index]);
+    }
+    rendering_.clear();
+
+    auto View = std::make_shared<FleetView>();
+    View->hosts.reserve(upstreams_.size());
+    std::size_t RowBytes = 0;
+    for (std::size_t I = 0; I < upstreams_.size(); ++I) {
+        if (bodies_[I]) {
+            View->hosts.emplace(upstreams_[I]->config.name, bodies_[I]);
+        }
+        RowBytes += rows_[I].size() + 1;
+    }
+
+    View->timestamp = std::chrono::system_clock::now();
+    View->sequence = ++sequence_;
+    View->body.reserve(512 + RowBytes);
+    View->body += R"({"hosts":[)";
+    for (std::size_t I = 0; I < rows_.size(); ++I) {
+        if (I != 0) {
+            View->body += ',';
+        }
+        View->body += rows_[I];
+    }
+    View->body += R"(],"rollup":)";
+    json::AppendJson(View->body, Rollup(hosts_));
+    View->body += R"(,"timestamp":)";
+    json::AppendJson(View->body, View->timestamp);
+    View->body += '}';
+    view_.store(std::move(View), std::memory_order_release);
+}
+
+}  // namespace pc_monitor
@@ -1,30 +1,216 @@
+#include "collector_backend.hpp"
+#include "event_http_server.hpp"
+#include "event_loop.hpp"
+#include "metrics_store.hpp"
+#include "stats_sampler.hpp"
 #include "system_monitor.hpp"
 #include "web_server.hpp"
 
 #include <atomic>
+#include <chrono>
 #include <csignal>
+#include <filesystem>
 #include <format>
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <ctime>
+#include <pthread.h>
+#include <signal.h>
+#endif
 
 namespace {
-std::atomic<bool> should_exit{false};
+// How often the main thread rechecks that the server is still up while waiting for a shutdown signal
+constexpr auto SHUTDOWN_POLL_INTERVAL = std::chrono::milliseconds{250};
+
+#if defined(__linux__)
+// SIGINT/SIGTERM stay blocked in every thread and are taken synchronously by WaitForShutdown, so no handler
+// ever runs in signal context. Must be called before any thread is started; threads inherit the mask.
+sigset_t shutdown_signals() {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    return signals;
+}
+
+void install_signal_handling() {
+    const auto signals = shutdown_signals();
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+}
+
+// Blocks until SIGINT/SIGTERM arrives (returns the signal) or the server stops on its own (returns 0)
+int wait_for_shutdown(const pc_monitor::WebServer& server) {
+    const auto signals = shutdown_signals();
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(SHUTDOWN_POLL_INTERVAL);
+    const timespec timeout{
+        .tv_sec = static_cast<time_t>(seconds.count()),
+        .tv_nsec = static_cast<long>(std::chrono::nanoseconds{SHUTDOWN_POLL_INTERVAL - seconds}.count()),
+    };
+    while (server.IsRunning()) {
+        if (const int signal = sigtimedwait(&signals, nullptr, &timeout); signal > 0) {
+            return signal;
+        }
+        // EAGAIN is the poll timeout, EINTR another signal; either way recheck the server
+    }
+    return 0;
+}
+#else
+// Only a lock-free store happens in signal context; the main thread polls the flag
+std::atomic<int> received_signal{0};
+static_assert(std::atomic<int>::is_always_lock_free);
 
 void signal_handler(int signal) {
-    std::cout << std::format("\nReceived signal {}, shutting down gracefully...\n", signal);
-    should_exit.store(true);
+    received_signal.store(signal, std::memory_order_relaxed);
+}
+
+void install_signal_handling() {
+    std::signal(SIGINT, signal_handler);
+    std::signal(SIGTERM, signal_handler);
+}
+
+int wait_for_shutdown(const pc_monitor::WebServer& server) {
+    while (server.IsRunning()) {
+        if (const int signal = received_signal.load(std::memory_order_relaxed); signal != 0) {
+            return signal;
+        }
+        std::this_thread::sleep_for(SHUTDOWN_POLL_INTERVAL);
+    }
+    return 0;
+}
+#endif
+
+// Prints the latest published snapshot every few seconds until the loop stops
+pc_monitor::Task display_stats(pc_monitor::EventLoop& loop, const pc_monitor::StatsSampler& sampler) {
+    constexpr auto DISPLAY_INTERVAL = std::chrono::seconds{5};
+    auto next_display = pc_monitor::EventLoop::Clock::now();
+
+    do {
+        if (const auto current_stats = sampler.Latest()) {
+            const auto seconds =
+                std::chrono::duration_cast<std::chrono::seconds>(current_stats->timestamp.time_since_epoch()).count();
+
+            // Display real-time stats using C++23 formatting
+            std::cout << std::format("⏱️  [{}] CPU: {} | Memory: {} | Cores: {}\r",
+                                     seconds % 60,
+                                     pc_monitor::utils::FormatPercentage(current_stats->cpu.overall),
+                                     pc_monitor::utils::FormatPercentage(current_stats->memory.usagePercent),
+                                     current_stats->cpu.cores.size());
+            std::cout.flush();
+        }
+        next_display += DISPLAY_INTERVAL;
+    } while (co_await loop.SleepUntil(next_display, loop.StopToken()));
 }
 }  // namespace
 
-int main() {
+int main(int argc, char** argv) {
     try {
-        // Set up signal handling
-        std::signal(SIGINT, signal_handler);
-        std::signal(SIGTERM, signal_handler);
+        // --store <dir> keeps sampled stats on disk across restarts; --cpu-interval/--memory-interval/
+        // --disk-interval/--network-interval <ms> set how often each metric group is collected, and --disks/
+        // --interfaces <patterns> which devices ("eth*,wlan*", "!veth*"; see DeviceFilter::Parse).
+        // --record <file> captures the raw counters as they are read; --replay <file> or --synthetic-cores <n>
+        // serve a capture instead of this host, at --replay-speed times the recorded pace (0 steps one sample
+        // per collection). --rules <file> loads alert rules (see AlertEngine); --fleet <file> polls the listed
+        // instances and serves them under /api/fleet (see FleetAggregator). --port/--ws-port <n> move the HTTP
+        // and WebSocket listeners, e.g. to run several instances on one machine. HTTP and the SSE streams are
+        // served by epoll I/O threads (see EventHttpServer), one per hardware thread up to 4 unless --io-threads
+        // <n> says otherwise; --io-threads 0 (and platforms without epoll) use httplib's thread per connection,
+        // where /ws/stats is capped because every stream holds a worker.
+        std::filesystem::path store_dir;
+        std::filesystem::path rules_path;
+        std::filesystem::path fleet_path;
+        std::uint16_t port = 3001;
+        std::uint16_t ws_port = 3003;
+        std::size_t io_threads = pc_monitor::EventHttpServer::DefaultThreads();
+        std::filesystem::path record_path;
+        std::filesystem::path replay_path;
+        std::size_t synthetic_cores = 0;
+        pc_monitor::ReplayBackend::Options replay;
+        pc_monitor::StatsSampler::Options sampling;
+        auto disk_filter = pc_monitor::DeviceFilter::DefaultDisks();
+        auto network_filter = pc_monitor::DeviceFilter::DefaultNetwork();
+        for (int i = 1; i + 1 < argc; ++i) {
+            std::string_view const option = argv[i];
+            if (option == "--store") {
+                store_dir = argv[++i];
+            } else if (option == "--cpu-interval") {
+                sampling.cpuInterval = std::chrono::milliseconds{std::stoll(argv[++i])};
+            } else if (option == "--memory-interval") {
+                sampling.memoryInterval = std::chrono::milliseconds{std::stoll(argv[++i])};
+            } else if (option == "--disk-interval") {
+                sampling.diskInterval = std::chrono::milliseconds{std::stoll(argv[++i])};
+            } else if (option == "--network-interval") {
+                sampling.networkInterval = std::chrono::milliseconds{std::stoll(argv[++i])};
+            } else if (option == "--disks") {
+                disk_filter = pc_monitor::DeviceFilter::Parse(argv[++i]);
+            } else if (option == "--interfaces") {
+                network_filter = pc_monitor::DeviceFilter::Parse(argv[++i]);
+            } else if (option == "--record") {
+                record_path = argv[++i];
+            } else if (option == "--replay") {
+                replay_path = argv[++i];
+            } else if (option == "--replay-speed") {
+                replay.speed = std::stod(argv[++i]);
+            } else if (option == "--rules") {
+                rules_path = argv[++i];
+            } else if (option == "--fleet") {
+                fleet_path = argv[++i];
+            } else if (option == "--port") {
+                port = static_cast<std::uint16_t>(std::stoul(argv[++i]));
+            } else if (option == "--ws-port") {
+                ws_port = static_cast<std::uint16_t>(std::stoul(argv[++i]));
+            } else if (option == "--io-threads") {
+                io_threads = std::stoull(argv[++i]);
+            } else if (option == "--synthetic-cores") {
+                synthetic_cores = std::stoull(argv[++i]);
+            }
+        }
+
+        // Set up signal handling before any worker thread exists
+        install_signal_handling();
 
         std::cout << "PC Monitor (C++23) - Starting...\n";
 
+        // Collector source: this host by default, or a recorded/synthetic capture
+        std::unique_ptr<pc_monitor::CollectorBackend> backend;
+        if (!replay_path.empty() || synthetic_cores != 0) {
+            std::shared_ptr<const pc_monitor::CollectorCapture> capture;
+            if (!replay_path.empty()) {
+                auto loaded = pc_monitor::CollectorCapture::Load(replay_path);
+                if (!loaded) {
+                    std::cerr << std::format("Failed to load capture {}\n", replay_path.string());
+                    return 1;
+                }
+                capture = std::make_shared<const pc_monitor::CollectorCapture>(std::move(*loaded));
+            } else {
+                // Ten minutes at one sample per second
+                capture = std::make_shared<const pc_monitor::CollectorCapture>(
+                    pc_monitor::MakeSyntheticCapture(synthetic_cores, 600, std::chrono::seconds{1}));
+            }
+            std::cout << std::format("🔁 Replaying {} raw reads at {}x\n", capture->records.size(), replay.speed);
+            backend = std::make_unique<pc_monitor::ReplayBackend>(std::move(capture), replay);
+        }
+        if (!record_path.empty()) {
+#if defined(__linux__)
+            if (!backend) {
+                backend = std::make_unique<pc_monitor::ProcfsBackend>();
+            }
+#endif
+            if (!backend) {
+                std::cerr << "--record needs the procfs collector (Linux) or a replayed capture\n";
+                return 1;
+            }
+            backend = std::make_unique<pc_monitor::RecordingBackend>(std::move(backend), record_path);
+            std::cout << std::format("⏺️  Recording raw counters to {}\n", record_path.string());
+        }
+
         // Initialize system monitor
-        auto monitor = std::make_shared<pc_monitor::SystemMonitor>();
+        auto monitor = std::make_shared<pc_monitor::SystemMonitor>(std::move(backend));
+        monitor->SetDeviceFilters(std::move(disk_filter), std::move(network_filter));
 
         auto init_result = monitor->Initialize();
         if (!init_result) {
@@ -34,19 +220,90 @@ int main() {
 
         std::cout << "✅ System monitor initialized\n";
 
+        // Single background sampler shared by every HTTP handler and the console loop
+        auto sampler = std::make_shared<pc_monitor::StatsSampler>(monitor, sampling);
+
+        auto sampler_result = sampler->Start();
+        if (!sampler_result) {
+            std::cerr << "Failed to start stats sampler\n";
+            return 1;
+        }
+
+        std::cout << std::format(
+            "⏱️  Sampling: CPU every {}ms, memory every {}ms, disks every {}ms, network every {}ms ({}ms when idle)\n",
+            sampling.cpuInterval.count(),
+            sampling.memoryInterval.count(),
+            sampling.diskInterval.count(),
+            sampling.networkInterval.count(),
+            sampling.idleInterval.count());
+
         // Test system stats
-        auto stats = monitor->GetCurrentStats();
+        auto stats = sampler->Latest();
         if (stats) {
             std::cout << std::format("🖥️  CPU Usage: {}\n", pc_monitor::utils::FormatPercentage(stats->cpu.overall));
             std::cout << std::format("💾 Memory Usage: {} ({})\n",
                                      pc_monitor::utils::FormatBytes(stats->memory.used),
                                      pc_monitor::utils::FormatPercentage(stats->memory.usagePercent));
             std::cout << std::format("🔥 CPU Cores: {} detected\n", stats->cpu.cores.size());
+            std::cout << std::format(
+                "💽 Devices: {} disk(s), {} network interface(s)\n", stats->disks.size(), stats->network.size());
+        }
+        if (auto const& topology = monitor->Topology(); topology.logicalCpus != 0) {
+            std::cout << std::format("🧩 Topology: {} package(s), {} physical cores, {} NUMA node(s), {} caches\n",
+                                     topology.packages,
+                                     topology.physicalCores,
+                                     topology.numaNodes,
+                                     topology.caches.size());
+        }
+
+        std::shared_ptr<pc_monitor::MetricsStore> store;
+        if (!store_dir.empty()) {
+            store = std::make_shared<pc_monitor::MetricsStore>(
+                pc_monitor::MetricsStore::Options{.directory = store_dir});
+            if (!store->Open()) {
+                std::cerr << std::format("Failed to open metrics store in {}\n", store_dir.string());
+                return 1;
+            }
+            std::cout << std::format(
+                "💾 Metrics store: {} ({} samples kept)\n", store_dir.string(), store->SampleCount());
+        }
+
+        std::vector<pc_monitor::AlertRule> rules;
+        if (!rules_path.empty()) {
+            auto loaded = pc_monitor::AlertEngine::Load(rules_path);
+            if (!loaded) {
+                std::cerr << std::format(
+                    "Failed to load alert rules from {}: {}\n", rules_path.string(), loaded.error());
+                return 1;
+            }
+            rules = std::move(*loaded);
+            std::cout << std::format("🔔 Alert rules: {} from {}\n", rules.size(), rules_path.string());
+        }
+
+        std::shared_ptr<pc_monitor::FleetAggregator> fleet;
+        if (!fleet_path.empty()) {
+            auto upstreams = pc_monitor::FleetAggregator::Load(fleet_path);
+            if (!upstreams) {
+                std::cerr << std::format(
+                    "Failed to load fleet upstreams from {}: {}\n", fleet_path.string(), upstreams.error());
+                return 1;
+            }
+            fleet = std::make_shared<pc_monitor::FleetAggregator>(std::move(*upstreams));
+            fleet->Start();
+            std::cout << std::format(
+                "🌐 Fleet: polling {} upstreams from {}\n", fleet->UpstreamCount(), fleet_path.string());
         }
 
         // Start web server
-        constexpr std::uint16_t PORT = 3001;
-        auto server = std::make_unique<pc_monitor::WebServer>(monitor, PORT);
+        auto server = std::make_unique<pc_monitor::WebServer>(
+            sampler, port, ws_port, store, std::move(rules), fleet, io_threads);
+
+        // Persist every published sample after the server has restored its history from the store
+        pc_monitor::StatsSampler::ListenerId store_listener{};
+        if (store) {
+            store_listener = sampler->AddListener(
+                [store](const pc_monitor::StatsSampler::Snapshot& snapshot) { (void)store->Append(*snapshot); });
+        }
 
         auto server_result = server->Start();
         if (!server_result) {
@@ -54,40 +311,52 @@ int main() {
             return 1;
         }
 
-        std::cout << std::format("🚀 Server running on http://localhost:{}\n", PORT);
+        std::cout << std::format("🚀 Server running on http://localhost:{}\n", port);
+        if (io_threads != 0) {
+            std::cout << std::format("⚡ HTTP served by {} epoll I/O thread(s)\n", io_threads);
+        } else {
+            std::cout << "⚡ HTTP served by httplib's thread pool; /ws/stats is limited to 64 clients\n";
+        }
         std::cout << "Available endpoints:\n";
-        std::cout << "  • GET /api/stats   - Complete system stats\n";
+        std::cout << "  • GET /api/stats   - Complete system stats, including per-disk and per-interface rates\n";
         std::cout << "  • GET /api/cpu     - CPU usage data\n";
         std::cout << "  • GET /api/memory  - Memory usage data\n";
         std::cout << "  • GET /health      - Health check\n";
-        std::cout << "  • GET /ws/stats    - WebSocket/SSE stats stream\n";
+        std::cout << "  • GET /api/processes - Top processes (?top=20&sort=cpu|rss)\n";
+        std::cout << "  • GET /api/cgroups - Top cgroups (?top=20&sort=cpu|memory|io&prefix=/system.slice)\n";
+        std::cout << "  • GET /api/history - CPU/memory/disk/network history (?range=5m&step=1s|10s|1m)\n";
+        std::cout << "  • GET /api/history/summary - min/max/mean/stddev/percentiles over a range (?range=1h)\n";
+        std::cout << "  • GET /api/alerts  - Firing alerts; transitions also go out on both stats streams\n";
+        std::cout << "  • GET /api/fleet   - Fleet rollup and per-host rows (with --fleet)\n";
+        std::cout << "  • GET /api/fleet/host - An upstream's last /api/stats (?name=db-1)\n";
+        std::cout << "  • GET /api/sampling - Per-task sampling intervals, jitter and missed deadlines\n";
+        std::cout << "  • GET /api/topology - Packages, physical cores, SMT siblings, NUMA nodes and caches\n";
+        std::cout << "  • GET /metrics     - Prometheus exposition of the latest sample\n";
+        std::cout << "  • GET /debug/perf  - Server latency histograms, bytes written and stream clients\n";
+        std::cout << "  • GET /ws/stats    - Server-Sent Events stats stream\n";
+        std::cout << std::format("  • WS  ws://localhost:{}/ws/stats - WebSocket stats stream (deltas)\n", ws_port);
         std::cout << R"(\nPress Ctrl+C to stop...\n\n)";
 
-        // Main loop - demonstrate C++23 coroutine usage
-        auto stats_stream = monitor->StreamStats(std::chrono::seconds{5});
-
-        while (!should_exit.load() && server->IsRunning()) {
-            if (stats_stream.move_next()) {
-                const auto current_stats = stats_stream.current_value();
-
-                // Display real-time stats using C++23 formatting
-                std::cout << std::format("⏱️  [{}] CPU: {} | Memory: {} | Cores: {}\r",
-                                         std::chrono::duration_cast<std::chrono::seconds>(
-                                             std::chrono::system_clock::now().time_since_epoch())
-                                                 .count() %
-                                             60,
-                                         pc_monitor::utils::FormatPercentage(current_stats.cpu.overall),
-                                         pc_monitor::utils::FormatPercentage(current_stats.memory.usagePercent),
-                                         current_stats.cpu.cores.size());
-                std::cout.flush();
-            }
+        // Console output runs as a coroutine on its own loop; the main thread just waits for a signal or for
+        // the server to stop
+        pc_monitor::EventLoop console_loop;
+        console_loop.Start();
+        console_loop.Spawn(display_stats(console_loop, *sampler));
 
-            // Small delay to prevent busy waiting
-            std::this_thread::sleep_for(std::chrono::milliseconds{100});
+        if (const int signal = wait_for_shutdown(*server); signal != 0) {
+            std::cout << std::format("\nReceived signal {}, shutting down gracefully...\n", signal);
         }
 
         std::cout << "\n🛑 Shutting down server...\n";
+        console_loop.Stop();
         server->Stop();
+        if (fleet) {
+            fleet->Stop();
+        }
+        if (store) {
+            sampler->RemoveListener(store_listener);
+        }
+        sampler->Stop();
         std::cout << "✅ Shutdown complete\n";
 
     } catch (const std::exception& e) {
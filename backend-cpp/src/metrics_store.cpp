@@ -0,0 +1,587 @@
+#include "metrics_store.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <format>
+#include <limits>
+#include <ranges>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <cerrno>
+
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace pc_monitor {
+
+namespace {
+
+// On-disk layout, native byte order (little-endian on every supported target).
+//
+// Segment header, 64 bytes:
+//   0  char[8] magic "PCMSEG01"     24 i64 creation time, ms since the epoch
+//   8  u32     format version       32 u32 CRC-32 of bytes [0, 32) and the core table
+//   12 u32     core count N         36 reserved
+//   16 u32     record size
+//   20 u32     offset of record 0
+// followed by N u32 core ids, then records from the next 64-byte boundary.
+//
+// Record, 60 + 4N bytes:
+//   0  i64 timestamp, ms            48 u16 overall CPU, tenths of a percent
+//   8  u64 memory total             50 u16 memory usage, tenths of a percent
+//   16 u64 memory used              52 i16 temperature, tenths of a degree (INT16_MIN when absent)
+//   24 u64 memory available         54 u16 average frequency, MHz
+//   32 u64 memory cache             56 u16[N] core usage, tenths of a percent
+//   40 u64 memory buffers           56+2N u16[N] core frequency, MHz
+//   56+4N u32 CRC-32 of the preceding record bytes
+constexpr std::array<char, 8> SEGMENT_MAGIC{'P', 'C', 'M', 'S', 'E', 'G', '0', '1'};
+constexpr std::uint32_t FORMAT_VERSION = 1;
+constexpr std::size_t HEADER_BYTES = 64;
+constexpr std::size_t HEADER_CRC_OFFSET = 32;
+constexpr std::size_t RECORD_ALIGNMENT = 64;
+constexpr std::size_t RECORD_FIXED_BYTES = 56;
+constexpr std::size_t CRC_BYTES = 4;
+constexpr std::int16_t NO_TEMPERATURE = std::numeric_limits<std::int16_t>::min();
+constexpr std::string_view SEGMENT_EXTENSION = ".seg";
+
+constexpr std::array<std::uint32_t, 256> CRC_TABLE = [] {
+    std::array<std::uint32_t, 256> Table{};
+    for (std::uint32_t I = 0; I < Table.size(); ++I) {
+        std::uint32_t Value = I;
+        for (int Bit = 0; Bit < 8; ++Bit) {
+            Value = (Value & 1U) != 0 ? 0xEDB88320U ^ (Value >> 1) : Value >> 1;
+        }
+        Table[I] = Value;
+    }
+    return Table;
+}();
+
+std::uint32_t Crc32(const std::byte* data, std::size_t size, std::uint32_t crc = 0) {
+    crc = ~crc;
+    for (std::size_t I = 0; I < size; ++I) {
+        crc = CRC_TABLE[(crc ^ std::to_integer<std::uint32_t>(data[I])) & 0xFFU] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+template <typename T>
+void Store(std::byte* base, std::size_t offset, T value) {
+    std::memcpy(base + offset, &value, sizeof(T));
+}
+
+template <typename T>
+T Load(const std::byte* base, std::size_t offset) {
+    T Value;
+    std::memcpy(&Value, base + offset, sizeof(T));
+    return Value;
+}
+
+std::size_t RecordSize(std::size_t coreCount) {
+    return RECORD_FIXED_BYTES + (4 * coreCount) + CRC_BYTES;
+}
+
+std::size_t RecordOffset(std::size_t coreCount) {
+    auto const End = HEADER_BYTES + (coreCount * sizeof(std::uint32_t));
+    return (End + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+}
+
+std::uint16_t ToTenths(double value) {
+    return static_cast<std::uint16_t>(std::clamp(std::lround(value * 10.0), 0L, 0xFFFFL));
+}
+
+std::uint16_t ToU16(std::uint64_t value) {
+    return static_cast<std::uint16_t>(value > 0xFFFFU ? 0xFFFFU : value);
+}
+
+std::int64_t ToMilliseconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+bool IsValidRecord(const std::byte* record, std::size_t recordSize, std::int64_t previousMs) {
+    auto const TimestampMs = Load<std::int64_t>(record, 0);
+    auto const PayloadBytes = recordSize - CRC_BYTES;
+    return TimestampMs != 0 && TimestampMs >= previousMs &&
+           Crc32(record, PayloadBytes) == Load<std::uint32_t>(record, PayloadBytes);
+}
+
+bool SameCoreLayout(std::span<const std::uint32_t> coreIds, const std::vector<CPUCoreData>& cores) {
+    return std::ranges::equal(coreIds, cores, {}, {}, [](const CPUCoreData& core) { return core.coreId; });
+}
+
+}  // namespace
+
+// MappedFile
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)),
+#if defined(_WIN32)
+      file_(std::exchange(other.file_, nullptr)), mapping_(std::exchange(other.mapping_, nullptr)) {
+}
+#else
+      file_(std::exchange(other.file_, -1)) {
+}
+#endif
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+#if defined(_WIN32)
+        file_ = std::exchange(other.file_, nullptr);
+        mapping_ = std::exchange(other.mapping_, nullptr);
+#else
+        file_ = std::exchange(other.file_, -1);
+#endif
+    }
+    return *this;
+}
+
+#if defined(_WIN32)
+
+Result<void> MappedFile::Open(const std::filesystem::path& path, std::size_t size, bool writable) {
+    Close();
+
+    file_ = CreateFileW(path.c_str(),
+                        GENERIC_READ | (writable ? GENERIC_WRITE : 0),
+                        FILE_SHARE_READ | FILE_SHARE_DELETE,
+                        nullptr,
+                        writable ? OPEN_ALWAYS : OPEN_EXISTING,
+                        FILE_ATTRIBUTE_NORMAL,
+                        nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+        file_ = nullptr;
+        return std::unexpected(GetLastError() == ERROR_ACCESS_DENIED ? SystemError::PERMISSION_DENIED
+                                                                     : SystemError::SYSTEM_ERROR);
+    }
+
+    LARGE_INTEGER FileSize{};
+    GetFileSizeEx(file_, &FileSize);
+    auto const Existing = static_cast<std::size_t>(FileSize.QuadPart);
+    auto const MapSize = size == 0 ? Existing : size;
+    if (MapSize == 0 || (!writable && MapSize > Existing)) {
+        Close();
+        return std::unexpected(SystemError::DATA_UNAVAILABLE);
+    }
+
+    // A writable mapping larger than the file extends it with zeros
+    auto const MapSize64 = static_cast<std::uint64_t>(MapSize);
+    mapping_ = CreateFileMappingW(file_,
+                                  nullptr,
+                                  writable ? PAGE_READWRITE : PAGE_READONLY,
+                                  static_cast<DWORD>(MapSize64 >> 32),
+                                  static_cast<DWORD>(MapSize64 & 0xFFFFFFFFU),
+                                  nullptr);
+    if (mapping_ == nullptr) {
+        Close();
+        return std::unexpected(SystemError::SYSTEM_ERROR);
+    }
+
+    data_ = static_cast<std::byte*>(MapViewOfFile(mapping_, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, MapSize));
+    if (data_ == nullptr) {
+        Close();
+        return std::unexpected(SystemError::SYSTEM_ERROR);
+    }
+    size_ = MapSize;
+    return {};
+}
+
+void MappedFile::Close() {
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+        data_ = nullptr;
+    }
+    if (mapping_ != nullptr) {
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+    }
+    if (file_ != nullptr) {
+        CloseHandle(file_);
+        file_ = nullptr;
+    }
+    size_ = 0;
+}
+
+void MappedFile::Flush() {
+    if (data_ != nullptr) {
+        FlushViewOfFile(data_, 0);
+    }
+}
+
+#else
+
+Result<void> MappedFile::Open(const std::filesystem::path& path, std::size_t size, bool writable) {
+    Close();
+
+    file_ = ::open(path.c_str(), (writable ? O_RDWR | O_CREAT : O_RDONLY) | O_CLOEXEC, 0644);
+    if (file_ < 0) {
+        return std::unexpected(errno == EACCES ? SystemError::PERMISSION_DENIED : SystemError::SYSTEM_ERROR);
+    }
+
+    struct stat Info{};
+    if (fstat(file_, &Info) != 0) {
+        Close();
+        return std::unexpected(SystemError::SYSTEM_ERROR);
+    }
+    auto const Existing = static_cast<std::size_t>(Info.st_size);
+    auto const MapSize = size == 0 ? Existing : size;
+    if (MapSize == 0 || (!writable && MapSize > Existing)) {
+        Close();
+        return std::unexpected(SystemError::DATA_UNAVAILABLE);
+    }
+
+    // Growing the file leaves a zero-filled (sparse) tail, which is what "no record here" looks like
+    if (writable && Existing < MapSize && ftruncate(file_, static_cast<off_t>(MapSize)) != 0) {
+        Close();
+        return std::unexpected(SystemError::SYSTEM_ERROR);
+    }
+
+    void* const Mapped =
+        mmap(nullptr, MapSize, PROT_READ | (writable ? PROT_WRITE : 0), MAP_SHARED, file_, 0);
+    if (Mapped == MAP_FAILED) {
+        Close();
+        return std::unexpected(SystemError::SYSTEM_ERROR);
+    }
+
+    data_ = static_cast<std::byte*>(Mapped);
+    size_ = MapSize;
+    return {};
+}
+
+void MappedFile::Close() {
+    if (data_ != nullptr) {
+        munmap(data_, size_);
+        data_ = nullptr;
+    }
+    if (file_ >= 0) {
+        ::close(file_);
+        file_ = -1;
+    }
+    size_ = 0;
+}
+
+void MappedFile::Flush() {
+    if (data_ != nullptr) {
+        msync(data_, size_, MS_ASYNC);
+    }
+}
+
+#endif
+
+// StoredSample
+
+std::chrono::system_clock::time_point StoredSample::Timestamp() const noexcept {
+    return std::chrono::system_clock::time_point{std::chrono::milliseconds{Load<std::int64_t>(record_, 0)}};
+}
+
+void StoredSample::Decode(SystemStats& out) const {
+    out.timestamp = Timestamp();
+
+    out.memory.total = Load<std::uint64_t>(record_, 8);
+    out.memory.used = Load<std::uint64_t>(record_, 16);
+    out.memory.available = Load<std::uint64_t>(record_, 24);
+    out.memory.cache = Load<std::uint64_t>(record_, 32);
+    out.memory.buffers = Load<std::uint64_t>(record_, 40);
+    out.memory.usagePercent = Load<std::uint16_t>(record_, 50) / 10.0;
+
+    out.cpu.overall = Load<std::uint16_t>(record_, 48) / 10.0;
+    auto const Temperature = Load<std::int16_t>(record_, 52);
+    out.cpu.temperature =
+        Temperature == NO_TEMPERATURE ? std::nullopt : std::optional<double>(Temperature / 10.0);
+    out.cpu.averageFrequency = Load<std::uint16_t>(record_, 54);
+
+    auto const CoreCount = coreIds_.size();
+    out.cpu.cores.resize(CoreCount);
+    for (std::size_t I = 0; I < CoreCount; ++I) {
+        out.cpu.cores[I] = CPUCoreData{
+            .coreId = coreIds_[I],
+            .usage = Load<std::uint16_t>(record_, RECORD_FIXED_BYTES + (2 * I)) / 10.0,
+            .frequency = Load<std::uint16_t>(record_, RECORD_FIXED_BYTES + (2 * CoreCount) + (2 * I))};
+    }
+}
+
+// MetricsStore
+
+MetricsStore::MetricsStore(Options options) : options_(std::move(options)) {}
+
+MetricsStore::~MetricsStore() {
+    std::lock_guard<std::mutex> const Lock(mutex_);
+    if (!segments_.empty()) {
+        segments_.back()->file.Flush();
+    }
+}
+
+Result<MetricsStore::SegmentPtr> MetricsStore::LoadSegment(const std::filesystem::path& path, bool writable) const {
+    auto Loaded = std::make_unique<Segment>();
+    Loaded->path = path;
+    Loaded->writable = writable;
+    if (auto Opened = Loaded->file.Open(path, 0, writable); !Opened) {
+        return std::unexpected(Opened.error());
+    }
+
+    auto const Bytes = Loaded->file.Bytes();
+    const auto* const Base = Bytes.data();
+    if (Bytes.size() < HEADER_BYTES || std::memcmp(Base, SEGMENT_MAGIC.data(), SEGMENT_MAGIC.size()) != 0 ||
+        Load<std::uint32_t>(Base, 8) != FORMAT_VERSION) {
+        return std::unexpected(SystemError::DATA_UNAVAILABLE);
+    }
+
+    auto const CoreCount = Load<std::uint32_t>(Base, 12);
+    Loaded->recordSize = Load<std::uint32_t>(Base, 16);
+    Loaded->recordOffset = Load<std::uint32_t>(Base, 20);
+    if (Loaded->recordSize != RecordSize(CoreCount) || Loaded->recordOffset != RecordOffset(CoreCount) ||
+        Loaded->recordOffset > Bytes.size()) {
+        return std::unexpected(SystemError::DATA_UNAVAILABLE);
+    }
+
+    auto const HeaderCrc = Crc32(Base + HEADER_BYTES,
+                                 CoreCount * sizeof(std::uint32_t),
+                                 Crc32(Base, HEADER_CRC_OFFSET));
+    if (HeaderCrc != Load<std::uint32_t>(Base, HEADER_CRC_OFFSET)) {
+        return std::unexpected(SystemError::DATA_UNAVAILABLE);
+    }
+
+    Loaded->coreIds.resize(CoreCount);
+    std::memcpy(Loaded->coreIds.data(), Base + HEADER_BYTES, CoreCount * sizeof(std::uint32_t));
+    Loaded->capacity = (Bytes.size() - Loaded->recordOffset) / Loaded->recordSize;
+
+    // Records are written strictly in order, so the valid prefix ends at the first empty or torn one
+    std::int64_t PreviousMs = std::numeric_limits<std::int64_t>::min();
+    while (Loaded->count < Loaded->capacity &&
+           IsValidRecord(Loaded->Record(Loaded->count), Loaded->recordSize, PreviousMs)) {
+        PreviousMs = Load<std::int64_t>(Loaded->Record(Loaded->count), 0);
+        ++Loaded->count;
+    }
+    if (Loaded->count != 0) {
+        Loaded->firstMs = Load<std::int64_t>(Loaded->Record(0), 0);
+        Loaded->lastMs = PreviousMs;
+    }
+
+    // Pages of later records can reach the disk before earlier ones, so clear everything past the valid
+    // prefix; otherwise stale records could look valid again once appends catch up with them
+    if (writable) {
+        auto* const Tail = Bytes.data() + Loaded->recordOffset + (Loaded->count * Loaded->recordSize);
+        auto const TailBytes = static_cast<std::size_t>(Bytes.data() + Bytes.size() - Tail);
+        if (std::any_of(Tail, Tail + TailBytes, [](std::byte value) { return value != std::byte{0}; })) {
+            std::memset(Tail, 0, TailBytes);
+        }
+    }
+
+    return Loaded;
+}
+
+Result<void> MetricsStore::Open() {
+    std::lock_guard<std::mutex> const Lock(mutex_);
+
+    std::error_code Error;
+    std::filesystem::create_directories(options_.directory, Error);
+    if (Error) {
+        return std::unexpected(Error == std::errc::permission_denied ? SystemError::PERMISSION_DENIED
+                                                                     : SystemError::SYSTEM_ERROR);
+    }
+
+    // Names are zero-padded first timestamps, so lexical order is time order
+    std::vector<std::filesystem::path> Paths;
+    for (const auto& Entry : std::filesystem::directory_iterator(options_.directory, Error)) {
+        if (Entry.is_regular_file() && Entry.path().extension() == SEGMENT_EXTENSION) {
+            Paths.push_back(Entry.path());
+        }
+    }
+    std::ranges::sort(Paths);
+
+    segments_.clear();
+    for (std::size_t I = 0; I < Paths.size(); ++I) {
+        // Only the newest segment is reopened for appending
+        auto Loaded = LoadSegment(Paths[I], I + 1 == Paths.size());
+        if (!Loaded) {
+            continue;
+        }
+        if ((*Loaded)->count == 0) {
+            (*Loaded)->file.Close();
+            std::filesystem::remove(Paths[I], Error);
+            continue;
+        }
+        segments_.push_back(std::move(*Loaded));
+    }
+
+    if (!segments_.empty()) {
+        ApplyRetention(segments_.back()->lastMs);
+    }
+    return {};
+}
+
+Result<void> MetricsStore::Rotate(const SystemStats& stats) {
+    auto const TimestampMs = ToMilliseconds(stats.timestamp);
+    auto const CoreCount = stats.cpu.cores.size();
+
+    auto Created = std::make_unique<Segment>();
+    Created->path = options_.directory / std::format("{:016}{}", TimestampMs, SEGMENT_EXTENSION);
+    Created->recordSize = RecordSize(CoreCount);
+    Created->recordOffset = RecordOffset(CoreCount);
+    Created->writable = true;
+    if (options_.segmentBytes < Created->recordOffset + Created->recordSize) {
+        return std::unexpected(SystemError::INITIALIZATION_FAILED);
+    }
+
+    // A leftover file with the same name was not loadable; start it from zeros
+    std::error_code Error;
+    std::filesystem::remove(Created->path, Error);
+    if (auto Opened = Created->file.Open(Created->path, options_.segmentBytes, true); !Opened) {
+        return Opened;
+    }
+
+    Created->capacity = (options_.segmentBytes - Created->recordOffset) / Created->recordSize;
+    for (const auto& Core : stats.cpu.cores) {
+        Created->coreIds.push_back(Core.coreId);
+    }
+
+    auto* const Base = Created->file.Bytes().data();
+    std::memcpy(Base, SEGMENT_MAGIC.data(), SEGMENT_MAGIC.size());
+    Store(Base, 8, FORMAT_VERSION);
+    Store(Base, 12, static_cast<std::uint32_t>(CoreCount));
+    Store(Base, 16, static_cast<std::uint32_t>(Created->recordSize));
+    Store(Base, 20, static_cast<std::uint32_t>(Created->recordOffset));
+    Store(Base, 24, TimestampMs);
+    std::memcpy(Base + HEADER_BYTES, Created->coreIds.data(), CoreCount * sizeof(std::uint32_t));
+    Store(Base,
+          HEADER_CRC_OFFSET,
+          Crc32(Base + HEADER_BYTES, CoreCount * sizeof(std::uint32_t), Crc32(Base, HEADER_CRC_OFFSET)));
+
+    if (!segments_.empty()) {
+        segments_.back()->file.Flush();
+    }
+    segments_.push_back(std::move(Created));
+    ApplyRetention(TimestampMs);
+    return {};
+}
+
+void MetricsStore::ApplyRetention(std::int64_t newestMs) {
+    auto const CutoffMs = newestMs - std::chrono::duration_cast<std::chrono::milliseconds>(options_.retention).count();
+
+    // The active segment is never dropped
+    while (segments_.size() > 1 && segments_.front()->lastMs < CutoffMs) {
+        auto Expired = std::move(segments_.front());
+        segments_.erase(segments_.begin());
+        Expired->file.Close();
+        std::error_code Error;
+        std::filesystem::remove(Expired->path, Error);
+    }
+}
+
+Result<void> MetricsStore::Append(const SystemStats& stats) {
+    std::lock_guard<std::mutex> const Lock(mutex_);
+
+    auto const TimestampMs = ToMilliseconds(stats.timestamp);
+    auto* Active = segments_.empty() ? nullptr : segments_.back().get();
+
+    // Records stay in time order so recovery and range queries can rely on it; samples from a wall clock
+    // that stepped back are not stored
+    if (Active != nullptr && TimestampMs < Active->lastMs) {
+        return {};
+    }
+
+    if (Active == nullptr || !Active->writable || Active->count == Active->capacity ||
+        !SameCoreLayout(Active->coreIds, stats.cpu.cores)) {
+        if (auto Rotated = Rotate(stats); !Rotated) {
+            return Rotated;
+        }
+        Active = segments_.back().get();
+    }
+
+    auto const CoreCount = stats.cpu.cores.size();
+    auto* const Record = Active->file.Bytes().data() + Active->recordOffset + (Active->count * Active->recordSize);
+
+    Store(Record, 8, stats.memory.total);
+    Store(Record, 16, stats.memory.used);
+    Store(Record, 24, stats.memory.available);
+    Store(Record, 32, stats.memory.cache);
+    Store(Record, 40, stats.memory.buffers);
+    Store(Record, 48, ToTenths(stats.cpu.overall));
+    Store(Record, 50, ToTenths(stats.memory.usagePercent));
+    Store(Record,
+          52,
+          stats.cpu.temperature ? static_cast<std::int16_t>(std::clamp(std::lround(*stats.cpu.temperature * 10.0),
+                                                                       -0x7FFFL,
+                                                                       0x7FFFL))
+                                : NO_TEMPERATURE);
+    Store(Record, 54, ToU16(stats.cpu.averageFrequency));
+    for (std::size_t I = 0; I < CoreCount; ++I) {
+        Store(Record, RECORD_FIXED_BYTES + (2 * I), ToTenths(stats.cpu.cores[I].usage));
+        Store(Record, RECORD_FIXED_BYTES + (2 * CoreCount) + (2 * I), ToU16(stats.cpu.cores[I].frequency));
+    }
+
+    // The timestamp makes the record visible to recovery; the checksum written last seals it
+    Store(Record, 0, TimestampMs);
+    auto const PayloadBytes = Active->recordSize - CRC_BYTES;
+    Store(Record, PayloadBytes, Crc32(Record, PayloadBytes));
+
+    if (Active->count == 0) {
+        Active->firstMs = TimestampMs;
+    }
+    Active->lastMs = TimestampMs;
+    ++Active->count;
+    return {};
+}
+
+void MetricsStore::Query(std::chrono::system_clock::time_point from,
+                         std::chrono::system_clock::time_point to,
+                         const Visitor& visitor) const {
+    std::lock_guard<std::mutex> const Lock(mutex_);
+
+    auto const FromMs = ToMilliseconds(from);
+    auto const ToMs = ToMilliseconds(to);
+
+    for (const auto& Stored : segments_) {
+        if (Stored->count == 0 || Stored->lastMs < FromMs || Stored->firstMs > ToMs) {
+            continue;
+        }
+
+        // Records are sorted by time, so the first match is found by bisection over the mapped records
+        auto const Indices = std::views::iota(std::size_t{0}, Stored->count);
+        auto const FirstIt = std::ranges::partition_point(
+            Indices, [&](std::size_t index) { return Load<std::int64_t>(Stored->Record(index), 0) < FromMs; });
+        auto const First = FirstIt == Indices.end() ? Stored->count : *FirstIt;
+
+        for (auto Index = First; Index < Stored->count; ++Index) {
+            const auto* const Record = Stored->Record(Index);
+            if (Load<std::int64_t>(Record, 0) > ToMs) {
+                return;
+            }
+            visitor(StoredSample(Record, Stored->coreIds));
+        }
+    }
+}
+
+std::size_t MetricsStore::SampleCount() const {
+    std::lock_guard<std::mutex> const Lock(mutex_);
+    std::size_t Count = 0;
+    for (const auto& Stored : segments_) {
+        Count += Stored->count;
+    }
+    return Count;
+}
+
+std::size_t MetricsStore::DiskBytes() const {
+    std::lock_guard<std::mutex> const Lock(mutex_);
+    std::size_t Bytes = 0;
+    for (const auto& Stored : segments_) {
+        Bytes += Stored->file.Bytes().size();
+    }
+    return Bytes;
+}
+
+}  // namespace pc_monitor
@@ -0,0 +1,260 @@
+#include "perf_stats.hpp"
+
+#if PC_MONITOR_PERF
+
+    #include <algorithm>
+    #include <array>
+    #include <atomic>
+    #include <limits>
+    #include <memory>
+    #include <mutex>
+    #include <ranges>
+
+namespace pc_monitor::perf {
+
+namespace {
+constexpr std::size_t MAX_HISTOGRAMS = 128;
+constexpr auto COUNTERS = static_cast<std::size_t>(Counter::COUNT);
+
+// Only the owning thread writes, so plain load/store pairs stand in for read-modify-write instructions;
+// readers see each field torn-free but possibly a few events behind the others
+void Bump(std::atomic<std::uint64_t>& value, std::uint64_t delta) noexcept {
+    value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+struct Histogram {
+    std::array<std::atomic<std::uint64_t>, Buckets::COUNT> counts{};
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<std::uint64_t> min{std::numeric_limits<std::uint64_t>::max()};
+    std::atomic<std::uint64_t> max{0};
+
+    void Add(std::uint64_t value) noexcept {
+        Bump(counts[Buckets::Index(value)], 1);
+        Bump(sum, value);
+        if (value < min.load(std::memory_order_relaxed)) {
+            min.store(value, std::memory_order_relaxed);
+        }
+        if (value > max.load(std::memory_order_relaxed)) {
+            max.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    // Only used on the retired shard, under the registry lock
+    void Merge(const Histogram& other) noexcept {
+        for (std::size_t I = 0; I < Buckets::COUNT; ++I) {
+            Bump(counts[I], other.counts[I].load(std::memory_order_relaxed));
+        }
+        Bump(sum, other.sum.load(std::memory_order_relaxed));
+        min.store(std::min(min.load(std::memory_order_relaxed), other.min.load(std::memory_order_relaxed)),
+                  std::memory_order_relaxed);
+        max.store(std::max(max.load(std::memory_order_relaxed), other.max.load(std::memory_order_relaxed)),
+                  std::memory_order_relaxed);
+    }
+};
+
+// One thread's histograms, allocated on first use so a thread pays only for the ids it records
+struct Shard {
+    std::array<std::atomic<Histogram*>, MAX_HISTOGRAMS> histograms{};
+    std::array<std::atomic<std::uint64_t>, COUNTERS> counters{};
+
+    Shard() = default;
+    Shard(const Shard&) = delete;
+    Shard& operator=(const Shard&) = delete;
+    Shard(Shard&&) = delete;
+    Shard& operator=(Shard&&) = delete;
+    ~Shard() {
+        for (auto& Entry : histograms) {
+            delete Entry.load(std::memory_order_relaxed);
+        }
+    }
+
+    Histogram& At(HistogramId id) {
+        auto* Existing = histograms[id].load(std::memory_order_relaxed);
+        if (Existing == nullptr) {
+            // Published with release so a concurrent Summaries() sees zeroed buckets, never garbage
+            Existing = new Histogram();
+            histograms[id].store(Existing, std::memory_order_release);
+        }
+        return *Existing;
+    }
+};
+
+struct Definition {
+    std::string name;
+    Unit unit{};
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<Definition> definitions;
+    std::vector<Shard*> shards;  // of live threads
+    Shard retired;               // everything recorded by threads that have exited
+};
+
+// Never destroyed: threads may still exit, and retire their shards, during static destruction
+Registry& TheRegistry() {
+    static auto* const Instance = new Registry();
+    return *Instance;
+}
+
+void Retire(Shard* shard) {
+    auto& Registry = TheRegistry();
+    std::lock_guard<std::mutex> const Lock(Registry.mutex);
+    std::erase(Registry.shards, shard);
+    for (std::size_t Id = 0; Id < MAX_HISTOGRAMS; ++Id) {
+        if (auto const* Histogram = shard->histograms[Id].load(std::memory_order_relaxed)) {
+            Registry.retired.At(static_cast<HistogramId>(Id)).Merge(*Histogram);
+        }
+    }
+    for (std::size_t I = 0; I < COUNTERS; ++I) {
+        Bump(Registry.retired.counters[I], shard->counters[I].load(std::memory_order_relaxed));
+    }
+    delete shard;
+}
+
+struct ShardHandle {
+    Shard* shard = nullptr;
+
+    ShardHandle() = default;
+    ShardHandle(const ShardHandle&) = delete;
+    ShardHandle& operator=(const ShardHandle&) = delete;
+    ShardHandle(ShardHandle&&) = delete;
+    ShardHandle& operator=(ShardHandle&&) = delete;
+    ~ShardHandle() {
+        if (shard != nullptr) {
+            Retire(shard);
+        }
+    }
+};
+
+thread_local ShardHandle CurrentShard;
+
+Shard& LocalShard() {
+    if (CurrentShard.shard == nullptr) {
+        auto Owned = std::make_unique<Shard>();
+        auto& Registry = TheRegistry();
+        std::lock_guard<std::mutex> const Lock(Registry.mutex);
+        Registry.shards.push_back(Owned.get());
+        CurrentShard.shard = Owned.release();
+    }
+    return *CurrentShard.shard;
+}
+
+std::uint64_t Percentile(const std::vector<std::uint64_t>& counts, std::uint64_t total, double fraction) {
+    // Nearest rank, like the bench helper
+    auto const Rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(fraction * static_cast<double>(total) + 0.999999));
+    std::uint64_t Seen = 0;
+    for (std::size_t I = 0; I < counts.size(); ++I) {
+        Seen += counts[I];
+        if (Seen >= Rank) {
+            return Buckets::Value(I);
+        }
+    }
+    return 0;
+}
+}  // namespace
+
+HistogramId Register(std::string_view name, Unit unit) {
+    auto& Registry = TheRegistry();
+    std::lock_guard<std::mutex> const Lock(Registry.mutex);
+    auto const Found = std::ranges::find(Registry.definitions, name, &Definition::name);
+    if (Found != Registry.definitions.end()) {
+        return static_cast<HistogramId>(Found - Registry.definitions.begin());
+    }
+    if (Registry.definitions.size() == MAX_HISTOGRAMS) {
+        // Out of slots: Record() drops events for this id
+        return static_cast<HistogramId>(MAX_HISTOGRAMS);
+    }
+    Registry.definitions.push_back({std::string(name), unit});
+    return static_cast<HistogramId>(Registry.definitions.size() - 1);
+}
+
+void Record(HistogramId id, std::uint64_t value) noexcept {
+    if (id < MAX_HISTOGRAMS) {
+        LocalShard().At(id).Add(value);
+    }
+}
+
+void Add(Counter counter, std::uint64_t value) noexcept {
+    Bump(LocalShard().counters[static_cast<std::size_t>(counter)], value);
+}
+
+std::vector<HistogramSummary> Summaries() {
+    auto& Registry = TheRegistry();
+    std::lock_guard<std::mutex> const Lock(Registry.mutex);
+
+    std::vector<HistogramSummary> Result;
+    Result.reserve(Registry.definitions.size());
+    std::vector<std::uint64_t> Counts(Buckets::COUNT);
+    for (std::size_t Id = 0; Id < Registry.definitions.size(); ++Id) {
+        std::ranges::fill(Counts, 0);
+        std::uint64_t Sum = 0;
+        std::uint64_t Min = std::numeric_limits<std::uint64_t>::max();
+        std::uint64_t Max = 0;
+        auto const Accumulate = [&](const Shard& shard) {
+            auto const* Histogram = shard.histograms[Id].load(std::memory_order_acquire);
+            if (Histogram == nullptr) {
+                return;
+            }
+            for (std::size_t I = 0; I < Buckets::COUNT; ++I) {
+                Counts[I] += Histogram->counts[I].load(std::memory_order_relaxed);
+            }
+            Sum += Histogram->sum.load(std::memory_order_relaxed);
+            Min = std::min(Min, Histogram->min.load(std::memory_order_relaxed));
+            Max = std::max(Max, Histogram->max.load(std::memory_order_relaxed));
+        };
+        Accumulate(Registry.retired);
+        for (const auto* Shard : Registry.shards) {
+            Accumulate(*Shard);
+        }
+
+        const auto& Definition = Registry.definitions[Id];
+        auto& Summary = Result.emplace_back();
+        Summary.name = Definition.name;
+        Summary.unit = Definition.unit == Unit::BYTES ? "bytes" : "ns";
+        for (auto const Count : Counts) {
+            Summary.count += Count;
+        }
+        if (Summary.count == 0) {
+            continue;
+        }
+
+        // Add() bumps the bucket before it publishes the extremes, so a concurrent read can see a count while
+        // min and max are still unset (Min > Max, which std::clamp must not get); the occupied buckets bound
+        // the values then
+        if (Min > Max) {
+            auto const IsOccupied = [](std::uint64_t count) { return count != 0; };
+            auto const First = std::ranges::find_if(Counts, IsOccupied) - Counts.begin();
+            auto const Last = Counts.rend() - std::ranges::find_if(Counts | std::views::reverse, IsOccupied) - 1;
+            Min = Buckets::Value(static_cast<std::size_t>(First));
+            Max = Buckets::Value(static_cast<std::size_t>(Last));
+        }
+
+        // Bucket midpoints can overshoot the exact extremes, which are tracked separately
+        auto const Clamp = [&](std::uint64_t value) { return std::clamp(value, Min, Max); };
+        Summary.mean = static_cast<double>(Sum) / static_cast<double>(Summary.count);
+        Summary.min = Min;
+        Summary.p50 = Clamp(Percentile(Counts, Summary.count, 0.50));
+        Summary.p90 = Clamp(Percentile(Counts, Summary.count, 0.90));
+        Summary.p99 = Clamp(Percentile(Counts, Summary.count, 0.99));
+        Summary.p999 = Clamp(Percentile(Counts, Summary.count, 0.999));
+        Summary.max = Max;
+    }
+    return Result;
+}
+
+std::uint64_t Total(Counter counter) {
+    auto& Registry = TheRegistry();
+    std::lock_guard<std::mutex> const Lock(Registry.mutex);
+    auto const Index = static_cast<std::size_t>(counter);
+    auto Sum = Registry.retired.counters[Index].load(std::memory_order_relaxed);
+    for (const auto* Shard : Registry.shards) {
+        Sum += Shard->counters[Index].load(std::memory_order_relaxed);
+    }
+    return Sum;
+}
+
+}  // namespace pc_monitor::perf
+
+#endif
@@ -0,0 +1,471 @@
+#include "process_monitor.hpp"
+
+#include "proc_file.hpp"
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+#include <utility>
+
+#if defined(_WIN32)
+    #include <windows.h>
+
+    #include <psapi.h>
+    #pragma comment(lib, "psapi.lib")
+#elif defined(__linux__)
+    #include <cerrno>
+    #include <charconv>
+    #include <cstdint>
+
+    #include <dirent.h>
+    #include <unistd.h>
+#endif
+
+namespace pc_monitor {
+
+#if defined(_WIN32)
+
+// A process handle keeps its pid from being reused, so an entry stays valid until the pid leaves the list
+class ProcessMonitor::Impl {
+public:
+    struct Entry {
+        DWORD pid{};
+        HANDLE process = nullptr;
+        std::uint64_t cpuTime{};  // kernel + user, 100 ns units, at the previous scan
+        ProcessInfo info;
+
+        Entry() = default;
+        Entry(const Entry&) = delete;
+        Entry& operator=(const Entry&) = delete;
+        Entry(Entry&& other) noexcept
+            : pid(other.pid),
+              process(std::exchange(other.process, nullptr)),
+              cpuTime(other.cpuTime),
+              info(std::move(other.info)) {}
+        Entry& operator=(Entry&& other) noexcept {
+            if (this != &other) {
+                Close();
+                pid = other.pid;
+                process = std::exchange(other.process, nullptr);
+                cpuTime = other.cpuTime;
+                info = std::move(other.info);
+            }
+            return *this;
+        }
+        ~Entry() {
+            Close();
+        }
+
+        void Close() {
+            if (process != nullptr) {
+                CloseHandle(process);
+                process = nullptr;
+            }
+        }
+    };
+
+    std::vector<Entry> entries;  // sorted by pid
+    std::vector<Entry> spare;    // reused by the next merge
+    std::vector<DWORD> pids;
+    std::uint64_t previousScan{};  // FILETIME of the previous scan, 100 ns units
+
+    Result<void> Initialize() {
+        pids.resize(1024);
+        return {};
+    }
+
+    Result<void> Scan(ProcessTable& table) {
+        if (!ListPids()) {
+            return std::unexpected(SystemError::DATA_UNAVAILABLE);
+        }
+        Merge();
+
+        auto const Now = CurrentFileTime();
+        auto const Elapsed = previousScan == 0 ? 0 : Now - previousScan;
+        previousScan = Now;
+
+        table.processes.reserve(entries.size());
+        for (auto& Entry : entries) {
+            FILETIME Creation;
+            FILETIME Exit;
+            FILETIME Kernel;
+            FILETIME User;
+            PROCESS_MEMORY_COUNTERS Counters{};
+            Counters.cb = sizeof(Counters);
+            if (Entry.process == nullptr || GetProcessTimes(Entry.process, &Creation, &Exit, &Kernel, &User) == 0 ||
+                GetProcessMemoryInfo(Entry.process, &Counters, sizeof(Counters)) == 0) {
+                continue;
+            }
+
+            auto const CpuTime = ToUint64(Kernel) + ToUint64(User);
+            Entry.info.cpu = Elapsed == 0 || Entry.cpuTime == 0 || CpuTime < Entry.cpuTime
+                                 ? 0.0
+                                 : 100.0 * static_cast<double>(CpuTime - Entry.cpuTime) / static_cast<double>(Elapsed);
+            Entry.cpuTime = CpuTime;
+            Entry.info.rss = Counters.WorkingSetSize;
+            table.processes.push_back(Entry.info);
+        }
+        return {};
+    }
+
+private:
+    bool ListPids() {
+        // EnumProcesses cannot report the total, so grow until the result leaves room to spare
+        while (true) {
+            DWORD Bytes = 0;
+            if (EnumProcesses(pids.data(), static_cast<DWORD>(pids.size() * sizeof(DWORD)), &Bytes) == 0) {
+                return false;
+            }
+            if (Bytes < pids.size() * sizeof(DWORD)) {
+                pids.resize(Bytes / sizeof(DWORD));
+                std::ranges::sort(pids);
+                return true;
+            }
+            pids.resize(pids.size() * 2);
+        }
+    }
+
+    // Walks the sorted entries and pids together: exited pids are closed, new ones opened
+    void Merge() {
+        spare.clear();
+        spare.reserve(pids.size());
+        std::size_t Old = 0;
+        for (auto const Pid : pids) {
+            while (Old < entries.size() && entries[Old].pid < Pid) {
+                ++Old;
+            }
+            if (Old < entries.size() && entries[Old].pid == Pid) {
+                spare.push_back(std::move(entries[Old++]));
+                continue;
+            }
+            spare.push_back(Open(Pid));
+        }
+        std::swap(entries, spare);
+        pids.resize(pids.capacity());
+    }
+
+    static Entry Open(DWORD pid) {
+        Entry Result;
+        Result.pid = pid;
+        Result.info.pid = static_cast<std::uint32_t>(pid);
+        Result.process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+        if (Result.process == nullptr) {
+            return Result;
+        }
+
+        std::array<wchar_t, MAX_PATH> Path{};
+        auto Length = static_cast<DWORD>(Path.size());
+        if (QueryFullProcessImageNameW(Result.process, 0, Path.data(), &Length) != 0) {
+            std::wstring_view Image(Path.data(), Length);
+            Image.remove_prefix(Image.find_last_of(L'\\') + 1);
+            auto const Bytes = WideCharToMultiByte(
+                CP_UTF8, 0, Image.data(), static_cast<int>(Image.size()), nullptr, 0, nullptr, nullptr);
+            Result.info.name.resize(static_cast<std::size_t>(Bytes));
+            WideCharToMultiByte(CP_UTF8,
+                                0,
+                                Image.data(),
+                                static_cast<int>(Image.size()),
+                                Result.info.name.data(),
+                                Bytes,
+                                nullptr,
+                                nullptr);
+        }
+        return Result;
+    }
+
+    static std::uint64_t ToUint64(const FILETIME& time) noexcept {
+        return (static_cast<std::uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    }
+
+    static std::uint64_t CurrentFileTime() noexcept {
+        FILETIME Now;
+        GetSystemTimeAsFileTime(&Now);
+        return ToUint64(Now);
+    }
+};
+
+#elif defined(__linux__)
+namespace {
+
+using procfs::ProcFile;
+
+// Skips `count` blank-separated fields
+void SkipFields(std::string_view& text, std::size_t count) noexcept {
+    for (std::size_t I = 0; I < count; ++I) {
+        auto const Start = text.find_first_not_of(' ');
+        auto const End = text.find(' ', Start);
+        text.remove_prefix(End == std::string_view::npos ? text.size() : End);
+    }
+}
+
+using PathBuffer = std::array<char, 32>;
+
+// "/proc/<pid>/stat", NUL-terminated in a stack buffer
+const char* StatPath(std::uint32_t pid, PathBuffer& buffer) noexcept {
+    constexpr std::string_view PREFIX = "/proc/";
+    constexpr std::string_view SUFFIX = "/stat";
+    auto* Out = std::ranges::copy(PREFIX, buffer.data()).out;
+    Out = std::to_chars(Out, buffer.data() + buffer.size(), pid).ptr;
+    Out = std::ranges::copy(SUFFIX, Out).out;
+    *Out = '\0';
+    return buffer.data();
+}
+
+struct PidStat {
+    std::string_view comm;
+    std::uint64_t ticks{};      // utime + stime
+    std::uint64_t startTime{};  // clock ticks after boot
+    std::uint64_t rssPages{};
+};
+
+// /proc/[pid]/stat: "pid (comm) state ppid ... utime(14) stime(15) ... starttime(22) vsize(23) rss(24) ...".
+// comm may contain blanks and parentheses, so the fields are counted from the last ')'.
+bool ParsePidStat(std::string_view content, PidStat& stat) noexcept {
+    auto const Open = content.find('(');
+    auto const Close = content.rfind(')');
+    if (Open == std::string_view::npos || Close == std::string_view::npos || Close < Open) {
+        return false;
+    }
+    stat.comm = content.substr(Open + 1, Close - Open - 1);
+    content.remove_prefix(Close + 1);
+
+    std::uint64_t UserTicks = 0;
+    std::uint64_t SystemTicks = 0;
+    SkipFields(content, 11);  // state .. cmajflt (fields 3-13)
+    if (!procfs::NextUnsigned(content, UserTicks) || !procfs::NextUnsigned(content, SystemTicks)) {
+        return false;
+    }
+    SkipFields(content, 6);  // cutime .. itrealvalue (fields 16-21)
+    if (!procfs::NextUnsigned(content, stat.startTime)) {
+        return false;
+    }
+    SkipFields(content, 1);  // vsize
+    stat.ticks = UserTicks + SystemTicks;
+    return procfs::NextUnsigned(content, stat.rssPages);
+}
+
+}  // namespace
+
+class ProcessMonitor::Impl {
+public:
+    struct Entry {
+        std::uint32_t pid{};
+        ProcFile statFile;          // closed when over the descriptor budget; then opened per scan
+        std::uint64_t startTime{};  // tells a reused pid apart from the process seen before
+        std::uint64_t ticks{};      // utime + stime at the previous scan
+        bool measured = false;      // ticks hold a previous reading
+        ProcessInfo info;
+    };
+
+    std::vector<Entry> entries;  // sorted by pid
+    std::vector<Entry> spare;    // reused by the next merge
+    std::vector<std::uint32_t> pids;
+    DIR* proc = nullptr;
+    std::size_t handleBudget{};
+    std::size_t openHandles{};
+    double ticksPerSecond{};
+    std::uint64_t pageSize{};
+    std::chrono::steady_clock::time_point previousScan{};
+
+    Impl() = default;
+
+    ~Impl() {
+        if (proc != nullptr) {
+            closedir(proc);
+        }
+    }
+
+    Impl(const Impl&) = delete;
+    Impl& operator=(const Impl&) = delete;
+    Impl(Impl&&) = delete;
+    Impl& operator=(Impl&&) = delete;
+
+    Result<void> Initialize() {
+        proc = opendir("/proc");
+        if (proc == nullptr) {
+            return std::unexpected(errno == EACCES ? SystemError::PERMISSION_DENIED
+                                                   : SystemError::INITIALIZATION_FAILED);
+        }
+        ticksPerSecond = static_cast<double>(sysconf(_SC_CLK_TCK));
+        pageSize = static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+
+        // One cached descriptor per process: raise the soft limit to the hard one and keep half of it for
+        // sockets and everything else; processes past the budget are read with open/read/close
+        auto const Limit = procfs::RaiseDescriptorLimit();
+        handleBudget = Limit == SIZE_MAX ? SIZE_MAX : Limit / 2;
+        return {};
+    }
+
+    Result<void> Scan(ProcessTable& table) {
+        if (!ListPids()) {
+            return std::unexpected(SystemError::DATA_UNAVAILABLE);
+        }
+        Merge();
+
+        auto const Now = std::chrono::steady_clock::now();
+        auto const ElapsedTicks = std::chrono::duration<double>(Now - previousScan).count() * ticksPerSecond;
+        previousScan = Now;
+
+        table.processes.reserve(entries.size());
+        std::array<char, 1024> Buffer;
+        PidStat Stat;
+        for (auto& Entry : entries) {
+            if (!ReadStat(Entry, Buffer, Stat)) {
+                continue;  // exited since the listing
+            }
+
+            if (!Entry.measured || Stat.startTime != Entry.startTime) {
+                // First sighting of this process: the tick delta starts now
+                Entry.startTime = Stat.startTime;
+                Entry.info.name.assign(Stat.comm);
+                Entry.info.cpu = 0.0;
+                Entry.measured = true;
+            } else {
+                auto const Delta = Stat.ticks >= Entry.ticks ? Stat.ticks - Entry.ticks : 0;
+                Entry.info.cpu = ElapsedTicks > 0.0 ? 100.0 * static_cast<double>(Delta) / ElapsedTicks : 0.0;
+            }
+            Entry.ticks = Stat.ticks;
+            Entry.info.rss = Stat.rssPages * pageSize;
+            table.processes.push_back(Entry.info);
+        }
+        return {};
+    }
+
+private:
+    // Numeric entries of /proc, sorted; the directory stays open and is rewound for every scan
+    bool ListPids() {
+        pids.clear();
+        rewinddir(proc);
+        errno = 0;
+        while (const dirent* Dirent = readdir(proc)) {
+            std::string_view Name = Dirent->d_name;
+            std::uint32_t Pid = 0;
+            if (Dirent->d_type == DT_DIR && procfs::NextUnsigned(Name, Pid) && Name.empty()) {
+                pids.push_back(Pid);
+            }
+        }
+        if (errno != 0) {
+            return false;
+        }
+        std::ranges::sort(pids);
+        return true;
+    }
+
+    // Walks the sorted entries and pids together: entries of exited pids are dropped (closing their
+    // descriptors) and new pids get an entry; the surviving ones keep their open files
+    void Merge() {
+        spare.clear();
+        spare.reserve(pids.size());
+        std::size_t Old = 0;
+        for (auto const Pid : pids) {
+            for (; Old < entries.size() && entries[Old].pid < Pid; ++Old) {
+                Release(entries[Old]);
+            }
+            if (Old < entries.size() && entries[Old].pid == Pid) {
+                spare.push_back(std::move(entries[Old++]));
+                continue;
+            }
+
+            auto& Added = spare.emplace_back();
+            Added.pid = Pid;
+            Added.info.pid = Pid;
+            OpenCached(Added);
+        }
+        for (; Old < entries.size(); ++Old) {
+            Release(entries[Old]);
+        }
+        std::swap(entries, spare);
+        spare.clear();
+    }
+
+    void OpenCached(Entry& entry) {
+        if (openHandles < handleBudget) {
+            PathBuffer Path;
+            entry.statFile = ProcFile(StatPath(entry.pid, Path));
+            openHandles += entry.statFile.IsOpen() ? 1 : 0;
+        }
+    }
+
+    void Release(Entry& entry) {
+        if (entry.statFile.IsOpen()) {
+            entry.statFile = ProcFile();
+            --openHandles;
+        }
+    }
+
+    bool ReadStat(Entry& entry, std::span<char> buffer, PidStat& stat) {
+        if (entry.statFile.IsOpen()) {
+            if (ParsePidStat(entry.statFile.ReadOnce(buffer), stat)) {
+                return true;
+            }
+
+            // A cached descriptor fails once its process is gone, even when the pid was reused since
+            Release(entry);
+            OpenCached(entry);
+            return entry.statFile.IsOpen() && ParsePidStat(entry.statFile.ReadOnce(buffer), stat);
+        }
+
+        PathBuffer Path;
+        ProcFile const Uncached(StatPath(entry.pid, Path));
+        return ParsePidStat(Uncached.ReadOnce(buffer), stat);
+    }
+};
+
+#else
+    #error "ProcessMonitor has no collector backend for this platform"
+#endif
+
+ProcessMonitor::ProcessMonitor() : pImpl_(std::make_unique<Impl>()) {}
+
+ProcessMonitor::~ProcessMonitor() = default;
+
+Result<void> ProcessMonitor::Initialize() {
+    return pImpl_->Initialize();
+}
+
+Result<void> ProcessMonitor::Scan() {
+    auto Table = std::make_shared<ProcessTable>();
+    Table->timestamp = std::chrono::system_clock::now();
+    if (auto Scanned = pImpl_->Scan(*Table); !Scanned) {
+        return Scanned;
+    }
+    latest_.store(std::move(Table), std::memory_order_release);
+    return {};
+}
+
+std::vector<ProcessInfo> ProcessMonitor::Top(const ProcessTable& table, std::size_t count, ProcessSortKey key) {
+    // Orders by the sort key descending, then by pid, so equal keys come out in a stable order
+    auto const Before = [key](const ProcessInfo* a, const ProcessInfo* b) {
+        if (key == ProcessSortKey::CPU && a->cpu != b->cpu) {
+            return a->cpu > b->cpu;
+        }
+        if (key == ProcessSortKey::RSS && a->rss != b->rss) {
+            return a->rss > b->rss;
+        }
+        return a->pid < b->pid;
+    };
+
+    // Bounded heap whose front is the weakest of the best `count` seen so far
+    std::vector<const ProcessInfo*> Heap;
+    Heap.reserve(std::min(count, table.processes.size()) + 1);
+    for (const auto& Process : table.processes) {
+        if (Heap.size() < count) {
+            Heap.push_back(&Process);
+            std::ranges::push_heap(Heap, Before);
+        } else if (count != 0 && Before(&Process, Heap.front())) {
+            std::ranges::pop_heap(Heap, Before);
+            Heap.back() = &Process;
+            std::ranges::push_heap(Heap, Before);
+        }
+    }
+    std::ranges::sort_heap(Heap, Before);
+
+    std::vector<ProcessInfo> Result;
+    Result.reserve(Heap.size());
+    for (const auto* Process : Heap) {
+        Result.push_back(*Process);
+    }
+    return Result;
+}
+
+}  // namespace pc_monitor
@@ -0,0 +1,379 @@
+#include "prometheus.hpp"
+
+#include "json_writer.hpp"
+#include "perf_stats.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace pc_monitor {
+
+namespace {
+constexpr std::string_view CORE_USAGE = "pc_monitor_cpu_core_usage_percent";
+constexpr std::string_view CORE_FREQUENCY = "pc_monitor_cpu_core_frequency_mhz";
+constexpr std::string_view CORE_TEMPERATURE = "pc_monitor_cpu_core_temperature_celsius";
+constexpr std::string_view PACKAGE_TEMPERATURE = "pc_monitor_cpu_package_temperature_celsius";
+constexpr std::string_view PACKAGE_THROTTLING = "pc_monitor_cpu_package_throttling";
+
+struct RateMetric {
+    std::string_view name;
+    std::string_view help;
+};
+
+// In DISK_RATE_FIELDS / NETWORK_RATE_FIELDS order
+constexpr std::array<RateMetric, DISK_RATE_FIELDS.size()> DISK_METRICS{
+    RateMetric{"pc_monitor_disk_queue_depth", "Average requests in flight per disk."},
+    RateMetric{"pc_monitor_disk_read_bytes_per_second", "Bytes read per second per disk."},
+    RateMetric{"pc_monitor_disk_reads_per_second", "Completed reads per second per disk."},
+    RateMetric{"pc_monitor_disk_utilization_percent", "Time with a request in flight per disk, 0-100."},
+    RateMetric{"pc_monitor_disk_write_bytes_per_second", "Bytes written per second per disk."},
+    RateMetric{"pc_monitor_disk_writes_per_second", "Completed writes per second per disk."}};
+
+constexpr std::array<RateMetric, NETWORK_RATE_FIELDS.size()> NETWORK_METRICS{
+    RateMetric{"pc_monitor_network_drops_per_second", "Dropped packets per second per interface."},
+    RateMetric{"pc_monitor_network_errors_per_second", "Receive and transmit errors per second per interface."},
+    RateMetric{"pc_monitor_network_receive_bytes_per_second", "Bytes received per second per interface."},
+    RateMetric{"pc_monitor_network_receive_packets_per_second", "Packets received per second per interface."},
+    RateMetric{"pc_monitor_network_transmit_bytes_per_second", "Bytes sent per second per interface."},
+    RateMetric{"pc_monitor_network_transmit_packets_per_second", "Packets sent per second per interface."}};
+
+// Prometheus spells the non-finite values out; everything else reads fine in the JSON number layout
+void AppendValue(std::string& out, double value) {
+    if (std::isnan(value)) {
+        out += "NaN";
+    } else if (std::isinf(value)) {
+        out += value > 0 ? "+Inf" : "-Inf";
+    } else {
+        json::AppendJson(out, value);
+    }
+}
+
+void AppendValue(std::string& out, std::uint64_t value) {
+    json::AppendJson(out, value);
+}
+
+void AppendHeader(std::string& out, std::string_view name, std::string_view type, std::string_view help) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+template <typename T>
+void AppendGauge(std::string& out, std::string_view name, std::string_view help, T value) {
+    AppendHeader(out, name, "gauge", help);
+    out += name;
+    out += ' ';
+    AppendValue(out, value);
+    out += '\n';
+}
+
+// Backslash, double quote and newline are the only characters label values escape
+void AppendLabelValue(std::string& out, std::string_view value) {
+    for (char const Char : value) {
+        switch (Char) {
+            case '\\':
+                out += "\\\\";
+                break;
+            case '"':
+                out += "\\\"";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            default:
+                out += Char;
+        }
+    }
+}
+
+// Rebuilds `prefixes` (by metric, then device) when the device names differ from `names`
+template <typename Device, std::size_t N>
+void BuildDevicePrefixes(std::vector<std::string>& names,
+                         std::vector<std::string>& prefixes,
+                         const std::vector<Device>& devices,
+                         std::string_view label,
+                         const std::array<RateMetric, N>& metrics) {
+    if (std::ranges::equal(names, devices, {}, {}, &Device::name)) {
+        return;
+    }
+
+    names.clear();
+    prefixes.clear();
+    for (const auto& Entry : devices) {
+        names.push_back(Entry.name);
+    }
+    for (const auto& Metric : metrics) {
+        for (const auto& Name : names) {
+            auto& Prefix = prefixes.emplace_back(Metric.name);
+            Prefix += '{';
+            Prefix += label;
+            Prefix += "=\"";
+            AppendLabelValue(Prefix, Name);
+            Prefix += "\"} ";
+        }
+    }
+}
+
+template <typename Device, std::size_t N>
+void AppendDeviceGauges(std::string& out,
+                        const std::vector<Device>& devices,
+                        const std::array<RateField<Device>, N>& fields,
+                        const std::array<RateMetric, N>& metrics,
+                        const std::vector<std::string>& prefixes) {
+    if (devices.empty()) {
+        return;
+    }
+    for (std::size_t F = 0; F < N; ++F) {
+        AppendHeader(out, metrics[F].name, "gauge", metrics[F].help);
+        for (std::size_t D = 0; D < devices.size(); ++D) {
+            out += prefixes[(F * devices.size()) + D];
+            AppendValue(out, devices[D].*fields[F].member);
+            out += '\n';
+        }
+    }
+}
+
+// Every PSI line as averages by window and a stall counter, labelled by resource and kind
+void AppendPressure(std::string& out, const SystemPressure& pressure) {
+    constexpr double MICROS_PER_SECOND = 1e6;
+    std::array<std::pair<std::string_view, const ResourcePressure*>, 3> const Resources{
+        std::pair{std::string_view("cpu"), &pressure.cpu},
+        std::pair{std::string_view("io"), &pressure.io},
+        std::pair{std::string_view("memory"), &pressure.memory}};
+    auto const ForEachStall = [&](auto&& visit) {
+        for (const auto& [Resource, Lines] : Resources) {
+            visit(Resource, "some", Lines->some);
+            if (Lines->full) {
+                visit(Resource, "full", *Lines->full);
+            }
+        }
+    };
+    auto const AppendLabels = [&out](std::string_view name, std::string_view resource, std::string_view kind) {
+        out += name;
+        out += R"({resource=")";
+        out += resource;
+        out += R"(",kind=")";
+        out += kind;
+        out += '"';
+    };
+
+    AppendHeader(out,
+                 "pc_monitor_pressure_stall_percent",
+                 "gauge",
+                 "Share of wall time with tasks stalled on the resource, averaged over the window.");
+    ForEachStall([&](std::string_view resource, std::string_view kind, const PressureStall& stall) {
+        for (const auto& [Window, Value] : {std::pair{std::string_view("10s"), stall.avg10},
+                                            std::pair{std::string_view("60s"), stall.avg60},
+                                            std::pair{std::string_view("300s"), stall.avg300}}) {
+            AppendLabels("pc_monitor_pressure_stall_percent", resource, kind);
+            out += R"(,window=")";
+            out += Window;
+            out += R"("} )";
+            AppendValue(out, Value);
+            out += '\n';
+        }
+    });
+    AppendHeader(out, "pc_monitor_pressure_stalled_seconds_total", "counter", "Time with tasks stalled since boot.");
+    ForEachStall([&](std::string_view resource, std::string_view kind, const PressureStall& stall) {
+        AppendLabels("pc_monitor_pressure_stalled_seconds_total", resource, kind);
+        out += "} ";
+        AppendValue(out, static_cast<double>(stall.total) / MICROS_PER_SECOND);
+        out += '\n';
+    });
+}
+
+}  // namespace
+
+void PrometheusRenderer::AppendServerMetrics(std::string& out, const ServerGauges& gauges) {
+    AppendHeader(out, "pc_monitor_stream_clients", "gauge", "Connected stream clients by transport.");
+    out += R"(pc_monitor_stream_clients{transport="sse"} )";
+    AppendValue(out, std::uint64_t{gauges.sseClients});
+    out += "\n" R"(pc_monitor_stream_clients{transport="binary"} )";
+    AppendValue(out, std::uint64_t{gauges.binaryStreamClients});
+    out += "\n" R"(pc_monitor_stream_clients{transport="websocket"} )";
+    AppendValue(out, std::uint64_t{gauges.webSocketClients});
+    out += '\n';
+
+    if constexpr (!perf::ENABLED) {
+        return;
+    }
+
+    AppendHeader(out, "pc_monitor_bytes_written_total", "counter", "Response and stream bytes written.");
+    out += "pc_monitor_bytes_written_total ";
+    AppendValue(out, perf::Total(perf::Counter::BYTES_WRITTEN));
+    out += '\n';
+
+    // Same histograms as /debug/perf; quantiles are bucket midpoints, within 1/16 of the recorded values
+    constexpr double NANOS_PER_SECOND = 1e9;
+    AppendHeader(out,
+                 "pc_monitor_latency_seconds",
+                 "summary",
+                 "Collection, serialization and request latency of the server itself.");
+    for (const auto& Histogram : perf::Summaries()) {
+        if (Histogram.unit != "ns") {
+            continue;
+        }
+        auto const AppendSeries = [&](std::string_view suffix, std::string_view quantile) {
+            out += "pc_monitor_latency_seconds";
+            out += suffix;
+            out += R"({name=")";
+            AppendLabelValue(out, Histogram.name);
+            if (!quantile.empty()) {
+                out += R"(",quantile=")";
+                out += quantile;
+            }
+            out += R"("} )";
+        };
+        for (const auto& [Quantile, Value] : {std::pair{std::string_view("0.5"), Histogram.p50},
+                                              std::pair{std::string_view("0.9"), Histogram.p90},
+                                              std::pair{std::string_view("0.99"), Histogram.p99},
+                                              std::pair{std::string_view("0.999"), Histogram.p999}}) {
+            // Quantiles of an empty summary are NaN by convention
+            AppendSeries("", Quantile);
+            AppendValue(out,
+                        Histogram.count == 0 ? std::numeric_limits<double>::quiet_NaN()
+                                             : static_cast<double>(Value) / NANOS_PER_SECOND);
+            out += '\n';
+        }
+        AppendSeries("_sum", {});
+        AppendValue(out, Histogram.mean * static_cast<double>(Histogram.count) / NANOS_PER_SECOND);
+        out += '\n';
+        AppendSeries("_count", {});
+        AppendValue(out, Histogram.count);
+        out += '\n';
+    }
+}
+
+void PrometheusRenderer::BuildLayout(const std::vector<CPUCoreData>& cores) {
+    coreIds_.clear();
+    usagePrefixes_.clear();
+    frequencyPrefixes_.clear();
+    temperaturePrefixes_.clear();
+    for (const auto& Core : cores) {
+        auto const Labels = R"({core=")" + std::to_string(Core.coreId) + R"("} )";
+        coreIds_.push_back(Core.coreId);
+        usagePrefixes_.push_back(std::string(CORE_USAGE) + Labels);
+        frequencyPrefixes_.push_back(std::string(CORE_FREQUENCY) + Labels);
+        temperaturePrefixes_.push_back(std::string(CORE_TEMPERATURE) + Labels);
+    }
+}
+
+void PrometheusRenderer::BuildPackageLayout(const std::vector<CpuPackageThermal>& packages) {
+    packageIds_.clear();
+    packageTemperaturePrefixes_.clear();
+    packageThrottlingPrefixes_.clear();
+    for (const auto& Package : packages) {
+        auto const Labels = R"({package=")" + std::to_string(Package.package) + R"("} )";
+        packageIds_.push_back(Package.package);
+        packageTemperaturePrefixes_.push_back(std::string(PACKAGE_TEMPERATURE) + Labels);
+        packageThrottlingPrefixes_.push_back(std::string(PACKAGE_THROTTLING) + Labels);
+    }
+}
+
+std::shared_ptr<const std::string> PrometheusRenderer::Render(const SystemStats& stats) {
+    static auto const RenderLatency = perf::Register("serialize.prometheus");
+    perf::ScopedTimer const Timer(RenderLatency);
+
+    const auto& Cores = stats.cpu.cores;
+    if (!std::ranges::equal(Cores, coreIds_, {}, &CPUCoreData::coreId)) {
+        BuildLayout(Cores);
+    }
+    const auto& Packages = stats.cpu.packages;
+    if (!std::ranges::equal(Packages, packageIds_, {}, &CpuPackageThermal::package)) {
+        BuildPackageLayout(Packages);
+    }
+
+    auto Text = std::make_shared<std::string>();
+    Text->reserve(lastSize_ + 256);
+    auto& Out = *Text;
+
+    AppendGauge(Out, "pc_monitor_cpu_usage_percent", "Overall CPU usage, 0-100.", stats.cpu.overall);
+    AppendGauge(Out, "pc_monitor_cpu_frequency_mhz", "Average core frequency.", stats.cpu.averageFrequency);
+    if (stats.cpu.temperature) {
+        AppendGauge(Out, "pc_monitor_cpu_temperature_celsius", "Hottest CPU package.", *stats.cpu.temperature);
+    }
+    if (!Packages.empty()) {
+        AppendGauge(Out,
+                    "pc_monitor_cpu_throttling",
+                    "1 while any package runs hot with its clocks pulled below their peak.",
+                    std::uint64_t{stats.cpu.throttling ? 1U : 0U});
+        AppendHeader(Out, PACKAGE_TEMPERATURE, "gauge", "Per-package CPU temperature.");
+        for (std::size_t I = 0; I < Packages.size(); ++I) {
+            Out += packageTemperaturePrefixes_[I];
+            AppendValue(Out, Packages[I].temperature);
+            Out += '\n';
+        }
+        AppendHeader(Out, PACKAGE_THROTTLING, "gauge", "1 while the package runs hot with its clocks pulled down.");
+        for (std::size_t I = 0; I < Packages.size(); ++I) {
+            Out += packageThrottlingPrefixes_[I];
+            AppendValue(Out, std::uint64_t{Packages[I].throttling ? 1U : 0U});
+            Out += '\n';
+        }
+    }
+
+    AppendHeader(Out, CORE_USAGE, "gauge", "Per-core CPU usage, 0-100.");
+    for (std::size_t I = 0; I < Cores.size(); ++I) {
+        Out += usagePrefixes_[I];
+        AppendValue(Out, Cores[I].usage);
+        Out += '\n';
+    }
+    AppendHeader(Out, CORE_FREQUENCY, "gauge", "Per-core frequency.");
+    for (std::size_t I = 0; I < Cores.size(); ++I) {
+        Out += frequencyPrefixes_[I];
+        AppendValue(Out, Cores[I].frequency);
+        Out += '\n';
+    }
+    if (std::ranges::any_of(Cores, [](const CPUCoreData& core) { return core.temperature.has_value(); })) {
+        AppendHeader(Out, CORE_TEMPERATURE, "gauge", "Per-core temperature of the physical core.");
+        for (std::size_t I = 0; I < Cores.size(); ++I) {
+            if (Cores[I].temperature) {
+                Out += temperaturePrefixes_[I];
+                AppendValue(Out, *Cores[I].temperature);
+                Out += '\n';
+            }
+        }
+    }
+
+    const auto& Memory = stats.memory;
+    AppendGauge(Out, "pc_monitor_memory_total_bytes", "Installed memory.", Memory.total);
+    AppendGauge(Out, "pc_monitor_memory_used_bytes", "Memory in use.", Memory.used);
+    AppendGauge(Out, "pc_monitor_memory_available_bytes", "Memory available without swapping.", Memory.available);
+    AppendGauge(Out, "pc_monitor_memory_cache_bytes", "Page cache.", Memory.cache);
+    AppendGauge(Out, "pc_monitor_memory_buffers_bytes", "Kernel buffers.", Memory.buffers);
+    AppendGauge(Out, "pc_monitor_memory_usage_percent", "Memory usage, 0-100.", Memory.usagePercent);
+    AppendGauge(Out, "pc_monitor_memory_slab_bytes", "Kernel slab.", Memory.slab);
+    AppendGauge(Out, "pc_monitor_memory_dirty_bytes", "Memory waiting to be written back.", Memory.dirty);
+    AppendGauge(Out, "pc_monitor_memory_writeback_bytes", "Memory being written back.", Memory.writeback);
+    AppendGauge(Out, "pc_monitor_memory_swap_total_bytes", "Swap space.", Memory.swapTotal);
+    AppendGauge(Out, "pc_monitor_memory_swap_used_bytes", "Swap space in use.", Memory.swapUsed);
+    AppendGauge(Out, "pc_monitor_memory_huge_pages_total_bytes", "Default-size huge page pool.", Memory.hugePagesTotal);
+    AppendGauge(Out, "pc_monitor_memory_huge_pages_free_bytes", "Unused huge pages.", Memory.hugePagesFree);
+    if (Memory.pressure) {
+        AppendPressure(Out, *Memory.pressure);
+    }
+
+    BuildDevicePrefixes(diskNames_, diskPrefixes_, stats.disks, "device", DISK_METRICS);
+    AppendDeviceGauges(Out, stats.disks, DISK_RATE_FIELDS, DISK_METRICS, diskPrefixes_);
+    BuildDevicePrefixes(interfaceNames_, interfacePrefixes_, stats.network, "interface", NETWORK_METRICS);
+    AppendDeviceGauges(Out, stats.network, NETWORK_RATE_FIELDS, NETWORK_METRICS, interfacePrefixes_);
+
+    AppendGauge(Out,
+                "pc_monitor_sample_timestamp_seconds",
+                "Collection time of this sample, in seconds since the epoch.",
+                std::chrono::duration<double>(stats.timestamp.time_since_epoch()).count());
+
+    lastSize_ = Out.size();
+    return Text;
+}
+
+}  // namespace pc_monitor
@@ -0,0 +1,429 @@
+#include "simd_kernels.hpp"
+
+#include <cstdlib>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define PC_MONITOR_SIMD_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #endif
+#else
+    #define PC_MONITOR_SIMD_X86 0
+#endif
+
+// AVX2 code is compiled for that target function by function, so the binary still runs on older CPUs; MSVC
+// accepts the intrinsics without a target switch
+#if defined(__GNUC__) || defined(__clang__)
+    #define PC_MONITOR_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define PC_MONITOR_TARGET_AVX2
+#endif
+
+namespace pc_monitor::simd {
+
+namespace {
+
+template <typename T>
+Summary SummarizeScalar(std::span<const T> values) noexcept {
+    Summary Result;
+    Result.count = values.size();
+    for (T const Value : values) {
+        auto const X = static_cast<double>(Value);
+        Result.sum += X;
+        Result.min = X < Result.min ? X : Result.min;
+        Result.max = X > Result.max ? X : Result.max;
+    }
+
+    // Second pass over the deviations; stable where sum-of-squares would cancel
+    auto const Mean = Result.Mean();
+    for (T const Value : values) {
+        auto const Deviation = static_cast<double>(Value) - Mean;
+        Result.m2 += Deviation * Deviation;
+    }
+    return Result;
+}
+
+double HistogramScale(double lower, double upper, std::size_t bucketCount) noexcept {
+    return upper > lower ? static_cast<double>(bucketCount) / (upper - lower) : 0.0;
+}
+
+template <typename T>
+void HistogramScalar(std::span<const T> values,
+                     double lower,
+                     double upper,
+                     std::span<std::uint32_t> buckets) noexcept {
+    if (buckets.empty()) {
+        return;
+    }
+
+    auto const Scale = HistogramScale(lower, upper, buckets.size());
+    auto const Last = static_cast<double>(buckets.size() - 1);
+    for (T const Value : values) {
+        auto Position = (static_cast<double>(Value) - lower) * Scale;
+        Position = Position > 0.0 ? Position : 0.0;  // also maps NaN to the first bucket
+        Position = Position < Last ? Position : Last;
+        ++buckets[static_cast<std::size_t>(Position)];
+    }
+}
+
+#if PC_MONITOR_SIMD_X86
+
+PC_MONITOR_TARGET_AVX2 double HorizontalSum(__m256d value) noexcept {
+    __m128d Pair = _mm_add_pd(_mm256_castpd256_pd128(value), _mm256_extractf128_pd(value, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(Pair, _mm_unpackhi_pd(Pair, Pair)));
+}
+
+PC_MONITOR_TARGET_AVX2 double HorizontalMin(__m256d value) noexcept {
+    __m128d Pair = _mm_min_pd(_mm256_castpd256_pd128(value), _mm256_extractf128_pd(value, 1));
+    return _mm_cvtsd_f64(_mm_min_sd(Pair, _mm_unpackhi_pd(Pair, Pair)));
+}
+
+PC_MONITOR_TARGET_AVX2 double HorizontalMax(__m256d value) noexcept {
+    __m128d Pair = _mm_max_pd(_mm256_castpd256_pd128(value), _mm256_extractf128_pd(value, 1));
+    return _mm_cvtsd_f64(_mm_max_sd(Pair, _mm_unpackhi_pd(Pair, Pair)));
+}
+
+PC_MONITOR_TARGET_AVX2 double SumAvx2(std::span<const double> values) noexcept {
+    const double* const Data = values.data();
+    auto const Size = values.size();
+
+    // Four independent accumulators hide the add latency
+    __m256d Sum0 = _mm256_setzero_pd();
+    __m256d Sum1 = _mm256_setzero_pd();
+    __m256d Sum2 = _mm256_setzero_pd();
+    __m256d Sum3 = _mm256_setzero_pd();
+    std::size_t I = 0;
+    for (; I + 16 <= Size; I += 16) {
+        Sum0 = _mm256_add_pd(Sum0, _mm256_loadu_pd(Data + I));
+        Sum1 = _mm256_add_pd(Sum1, _mm256_loadu_pd(Data + I + 4));
+        Sum2 = _mm256_add_pd(Sum2, _mm256_loadu_pd(Data + I + 8));
+        Sum3 = _mm256_add_pd(Sum3, _mm256_loadu_pd(Data + I + 12));
+    }
+    for (; I + 4 <= Size; I += 4) {
+        Sum0 = _mm256_add_pd(Sum0, _mm256_loadu_pd(Data + I));
+    }
+
+    double Total = HorizontalSum(_mm256_add_pd(_mm256_add_pd(Sum0, Sum1), _mm256_add_pd(Sum2, Sum3)));
+    for (; I < Size; ++I) {
+        Total += Data[I];
+    }
+    return Total;
+}
+
+PC_MONITOR_TARGET_AVX2 Summary SummarizeAvx2(std::span<const double> values) noexcept {
+    const double* const Data = values.data();
+    auto const Size = values.size();
+    if (Size < 4) {
+        return SummarizeScalar(values);
+    }
+
+    __m256d Sum0 = _mm256_setzero_pd();
+    __m256d Sum1 = _mm256_setzero_pd();
+    __m256d Min = _mm256_loadu_pd(Data);
+    __m256d Max = Min;
+    std::size_t I = 0;
+    for (; I + 8 <= Size; I += 8) {
+        __m256d const A = _mm256_loadu_pd(Data + I);
+        __m256d const B = _mm256_loadu_pd(Data + I + 4);
+        Sum0 = _mm256_add_pd(Sum0, A);
+        Sum1 = _mm256_add_pd(Sum1, B);
+        Min = _mm256_min_pd(Min, _mm256_min_pd(A, B));
+        Max = _mm256_max_pd(Max, _mm256_max_pd(A, B));
+    }
+
+    Summary Result;
+    Result.count = Size;
+    Result.sum = HorizontalSum(_mm256_add_pd(Sum0, Sum1));
+    Result.min = HorizontalMin(Min);
+    Result.max = HorizontalMax(Max);
+    for (std::size_t J = I; J < Size; ++J) {
+        Result.sum += Data[J];
+        Result.min = Data[J] < Result.min ? Data[J] : Result.min;
+        Result.max = Data[J] > Result.max ? Data[J] : Result.max;
+    }
+
+    __m256d const Mean = _mm256_set1_pd(Result.Mean());
+    __m256d M2 = _mm256_setzero_pd();
+    for (I = 0; I + 4 <= Size; I += 4) {
+        __m256d const Deviation = _mm256_sub_pd(_mm256_loadu_pd(Data + I), Mean);
+        M2 = _mm256_add_pd(M2, _mm256_mul_pd(Deviation, Deviation));
+    }
+    Result.m2 = HorizontalSum(M2);
+    for (; I < Size; ++I) {
+        auto const Deviation = Data[I] - Result.Mean();
+        Result.m2 += Deviation * Deviation;
+    }
+    return Result;
+}
+
+PC_MONITOR_TARGET_AVX2 Summary SummarizeAvx2(std::span<const float> values) noexcept {
+    const float* const Data = values.data();
+    auto const Size = values.size();
+    if (Size < 8) {
+        return SummarizeScalar(values);
+    }
+
+    // Extremes in single precision (exact), sums widened to double like the scalar code
+    __m256d SumLow = _mm256_setzero_pd();
+    __m256d SumHigh = _mm256_setzero_pd();
+    __m256 Min = _mm256_loadu_ps(Data);
+    __m256 Max = Min;
+    std::size_t I = 0;
+    for (; I + 8 <= Size; I += 8) {
+        __m256 const Value = _mm256_loadu_ps(Data + I);
+        SumLow = _mm256_add_pd(SumLow, _mm256_cvtps_pd(_mm256_castps256_ps128(Value)));
+        SumHigh = _mm256_add_pd(SumHigh, _mm256_cvtps_pd(_mm256_extractf128_ps(Value, 1)));
+        Min = _mm256_min_ps(Min, Value);
+        Max = _mm256_max_ps(Max, Value);
+    }
+
+    Summary Result;
+    Result.count = Size;
+    Result.sum = HorizontalSum(_mm256_add_pd(SumLow, SumHigh));
+    Result.min = HorizontalMin(_mm256_min_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(Min)),
+                                             _mm256_cvtps_pd(_mm256_extractf128_ps(Min, 1))));
+    Result.max = HorizontalMax(_mm256_max_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(Max)),
+                                             _mm256_cvtps_pd(_mm256_extractf128_ps(Max, 1))));
+    for (std::size_t J = I; J < Size; ++J) {
+        auto const X = static_cast<double>(Data[J]);
+        Result.sum += X;
+        Result.min = X < Result.min ? X : Result.min;
+        Result.max = X > Result.max ? X : Result.max;
+    }
+
+    __m256d const Mean = _mm256_set1_pd(Result.Mean());
+    __m256d M2 = _mm256_setzero_pd();
+    for (I = 0; I + 8 <= Size; I += 8) {
+        __m256 const Value = _mm256_loadu_ps(Data + I);
+        __m256d const Low = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(Value)), Mean);
+        __m256d const High = _mm256_sub_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(Value, 1)), Mean);
+        M2 = _mm256_add_pd(M2, _mm256_add_pd(_mm256_mul_pd(Low, Low), _mm256_mul_pd(High, High)));
+    }
+    Result.m2 = HorizontalSum(M2);
+    for (; I < Size; ++I) {
+        auto const Deviation = static_cast<double>(Data[I]) - Result.Mean();
+        Result.m2 += Deviation * Deviation;
+    }
+    return Result;
+}
+
+// Bucket indices are computed four at a time; AVX2 has no scatter, so the increments stay scalar
+PC_MONITOR_TARGET_AVX2 void CountBuckets(__m256d values,
+                                         __m256d lower,
+                                         __m256d scale,
+                                         __m256d last,
+                                         std::uint32_t* buckets) noexcept {
+    __m256d Position = _mm256_mul_pd(_mm256_sub_pd(values, lower), scale);
+    Position = _mm256_max_pd(Position, _mm256_setzero_pd());  // NaN takes the second operand, 0
+    Position = _mm256_min_pd(Position, last);
+
+    alignas(16) std::int32_t Index[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(Index), _mm256_cvttpd_epi32(Position));
+    ++buckets[Index[0]];
+    ++buckets[Index[1]];
+    ++buckets[Index[2]];
+    ++buckets[Index[3]];
+}
+
+PC_MONITOR_TARGET_AVX2 void HistogramAvx2(std::span<const double> values,
+                                          double lower,
+                                          double upper,
+                                          std::span<std::uint32_t> buckets) noexcept {
+    if (buckets.empty()) {
+        return;
+    }
+
+    __m256d const Lower = _mm256_set1_pd(lower);
+    __m256d const Scale = _mm256_set1_pd(HistogramScale(lower, upper, buckets.size()));
+    __m256d const Last = _mm256_set1_pd(static_cast<double>(buckets.size() - 1));
+    std::size_t I = 0;
+    for (; I + 4 <= values.size(); I += 4) {
+        CountBuckets(_mm256_loadu_pd(values.data() + I), Lower, Scale, Last, buckets.data());
+    }
+    HistogramScalar(values.subspan(I), lower, upper, buckets);
+}
+
+PC_MONITOR_TARGET_AVX2 void HistogramAvx2(std::span<const float> values,
+                                          double lower,
+                                          double upper,
+                                          std::span<std::uint32_t> buckets) noexcept {
+    if (buckets.empty()) {
+        return;
+    }
+
+    __m256d const Lower = _mm256_set1_pd(lower);
+    __m256d const Scale = _mm256_set1_pd(HistogramScale(lower, upper, buckets.size()));
+    __m256d const Last = _mm256_set1_pd(static_cast<double>(buckets.size() - 1));
+    std::size_t I = 0;
+    for (; I + 8 <= values.size(); I += 8) {
+        __m256 const Value = _mm256_loadu_ps(values.data() + I);
+        CountBuckets(_mm256_cvtps_pd(_mm256_castps256_ps128(Value)), Lower, Scale, Last, buckets.data());
+        CountBuckets(_mm256_cvtps_pd(_mm256_extractf128_ps(Value, 1)), Lower, Scale, Last, buckets.data());
+    }
+    HistogramScalar(values.subspan(I), lower, upper, buckets);
+}
+
+bool CpuSupportsAvx2() noexcept {
+    #if defined(_MSC_VER)
+    int Info[4];
+    __cpuid(Info, 0);
+    if (Info[0] < 7) {
+        return false;
+    }
+
+    // AVX state must also be enabled by the OS (OSXSAVE and XCR0 bits 1-2)
+    __cpuid(Info, 1);
+    constexpr int OSXSAVE = 1 << 27;
+    constexpr int AVX = 1 << 28;
+    if ((Info[2] & OSXSAVE) == 0 || (Info[2] & AVX) == 0 || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+
+    __cpuidex(Info, 7, 0);
+    constexpr int AVX2 = 1 << 5;
+    return (Info[1] & AVX2) != 0;
+    #else
+    return __builtin_cpu_supports("avx2") != 0;
+    #endif
+}
+
+#endif
+
+struct KernelTable {
+    std::string_view name;
+    double (*sum)(std::span<const double>) noexcept;
+    Summary (*summarizeDouble)(std::span<const double>) noexcept;
+    Summary (*summarizeFloat)(std::span<const float>) noexcept;
+    void (*histogramDouble)(std::span<const double>, double, double, std::span<std::uint32_t>) noexcept;
+    void (*histogramFloat)(std::span<const float>, double, double, std::span<std::uint32_t>) noexcept;
+};
+
+const KernelTable& SelectKernels() noexcept {
+    static constexpr KernelTable SCALAR{"scalar",
+                                        &scalar::Sum,
+                                        &scalar::Summarize,
+                                        &scalar::Summarize,
+                                        &scalar::Histogram,
+                                        &scalar::Histogram};
+
+#if PC_MONITOR_SIMD_X86
+    static constexpr KernelTable AVX2{
+        "avx2", &SumAvx2, &SummarizeAvx2, &SummarizeAvx2, &HistogramAvx2, &HistogramAvx2};
+
+    const char* const Override = std::getenv("PC_MONITOR_SIMD");
+    bool const ForceScalar = Override != nullptr && std::string_view(Override) == "scalar";
+    if (!ForceScalar && CpuSupportsAvx2()) {
+        return AVX2;
+    }
+#endif
+    return SCALAR;
+}
+
+const KernelTable& Kernels() noexcept {
+    static const KernelTable& Table = SelectKernels();
+    return Table;
+}
+
+}  // namespace
+
+Summary Summary::Merge(const Summary& a, const Summary& b) noexcept {
+    if (a.count == 0) {
+        return b;
+    }
+    if (b.count == 0) {
+        return a;
+    }
+
+    Summary Result;
+    Result.count = a.count + b.count;
+    Result.sum = a.sum + b.sum;
+    Result.min = a.min < b.min ? a.min : b.min;
+    Result.max = a.max > b.max ? a.max : b.max;
+
+    auto const Delta = b.Mean() - a.Mean();
+    auto const CountA = static_cast<double>(a.count);
+    auto const CountB = static_cast<double>(b.count);
+    Result.m2 = a.m2 + b.m2 + (Delta * Delta * CountA * CountB / static_cast<double>(Result.count));
+    return Result;
+}
+
+std::string_view ActiveKernel() noexcept {
+    return Kernels().name;
+}
+
+double Sum(std::span<const double> values) noexcept {
+    return Kernels().sum(values);
+}
+
+double Mean(std::span<const double> values) noexcept {
+    return values.empty() ? 0.0 : Sum(values) / static_cast<double>(values.size());
+}
+
+Summary Summarize(std::span<const double> values) noexcept {
+    return Kernels().summarizeDouble(values);
+}
+
+Summary Summarize(std::span<const float> values) noexcept {
+    return Kernels().summarizeFloat(values);
+}
+
+void Histogram(std::span<const double> values, double lower, double upper, std::span<std::uint32_t> buckets) noexcept {
+    Kernels().histogramDouble(values, lower, upper, buckets);
+}
+
+void Histogram(std::span<const float> values, double lower, double upper, std::span<std::uint32_t> buckets) noexcept {
+    Kernels().histogramFloat(values, lower, upper, buckets);
+}
+
+double Percentile(std::span<const std::uint32_t> buckets, double lower, double upper, double quantile) noexcept {
+    std::uint64_t Total = 0;
+    for (auto const Count : buckets) {
+        Total += Count;
+    }
+    if (Total == 0) {
+        return lower;
+    }
+
+    auto const Target = quantile * static_cast<double>(Total);
+    auto const Width = (upper - lower) / static_cast<double>(buckets.size());
+    std::uint64_t Cumulative = 0;
+    for (std::size_t I = 0; I < buckets.size(); ++I) {
+        Cumulative += buckets[I];
+        if (static_cast<double>(Cumulative) >= Target) {
+            return lower + (Width * static_cast<double>(I + 1));
+        }
+    }
+    return upper;
+}
+
+namespace scalar {
+
+double Sum(std::span<const double> values) noexcept {
+    double Total = 0.0;
+    for (double const Value : values) {
+        Total += Value;
+    }
+    return Total;
+}
+
+Summary Summarize(std::span<const double> values) noexcept {
+    return SummarizeScalar(values);
+}
+
+Summary Summarize(std::span<const float> values) noexcept {
+    return SummarizeScalar(values);
+}
+
+void Histogram(std::span<const double> values, double lower, double upper, std::span<std::uint32_t> buckets) noexcept {
+    HistogramScalar(values, lower, upper, buckets);
+}
+
+void Histogram(std::span<const float> values, double lower, double upper, std::span<std::uint32_t> buckets) noexcept {
+    HistogramScalar(values, lower, upper, buckets);
+}
+
+}  // namespace scalar
+
+}  // namespace pc_monitor::simd
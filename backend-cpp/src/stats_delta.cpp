@@ -0,0 +1,291 @@
+#include "stats_delta.hpp"
+
+#include "json_writer.hpp"
+
+#include <cmath>
+#include <optional>
+#include <string_view>
+
+namespace pc_monitor {
+
+namespace {
+
+std::int64_t ToTenths(double value) {
+    return std::llround(value * 10.0);
+}
+
+void AppendTenths(std::string& out, std::int64_t tenths) {
+    if (tenths < 0) {
+        out += '-';
+        tenths = -tenths;
+    }
+    json::AppendJson(out, tenths / 10);
+    out += '.';
+    out += static_cast<char>('0' + (tenths % 10));
+}
+
+void AppendOptionalTenths(std::string& out, std::optional<std::int64_t> tenths) {
+    if (tenths) {
+        AppendTenths(out, *tenths);
+    } else {
+        out += "null";
+    }
+}
+
+// Nested object whose `"name":{` is only written once its first member is added, so unchanged groups
+// are left out of the delta entirely
+class LazyObject {
+public:
+    LazyObject(std::string& out, std::string_view name, bool& parentEmpty)
+        : out_(out), name_(name), parentEmpty_(parentEmpty) {}
+
+    std::string& Member(std::string_view key) {
+        if (!open_) {
+            out_ += parentEmpty_ ? "\"" : ",\"";
+            parentEmpty_ = false;
+            out_.append(name_).append("\":{\"");
+            open_ = true;
+        } else {
+            out_ += ",\"";
+        }
+        out_.append(key).append("\":");
+        return out_;
+    }
+
+    void Finish() {
+        if (open_) {
+            out_ += '}';
+        }
+    }
+
+private:
+    std::string& out_;
+    std::string_view name_;
+    bool& parentEmpty_;
+    bool open_ = false;
+};
+
+// Appends "key":[[index,value],...] for the entries that differ, if any
+template <typename T, typename AppendValue>
+void AppendChangedEntries(LazyObject& object,
+                          std::string_view key,
+                          const std::vector<T>& before,
+                          const std::vector<T>& after,
+                          AppendValue&& appendValue) {
+    std::string* Out = nullptr;
+    for (std::size_t I = 0; I < after.size(); ++I) {
+        if (before[I] == after[I]) {
+            continue;
+        }
+        if (Out == nullptr) {
+            Out = &object.Member(key);
+            *Out += "[[";
+        } else {
+            *Out += ",[";
+        }
+        json::AppendJson(*Out, I);
+        *Out += ',';
+        appendValue(*Out, after[I]);
+        *Out += ']';
+    }
+    if (Out != nullptr) {
+        *Out += ']';
+    }
+}
+
+template <typename T>
+void AppendIfChanged(LazyObject& object, std::string_view key, T before, T after) {
+    if (before != after) {
+        json::AppendJson(object.Member(key), after);
+    }
+}
+
+void AppendTenthsIfChanged(LazyObject& object, std::string_view key, std::int64_t before, std::int64_t after) {
+    if (before != after) {
+        AppendTenths(object.Member(key), after);
+    }
+}
+
+// Rates of every device, field by field
+template <typename Device, std::size_t N>
+void QuantizeRates(const std::vector<Device>& devices,
+                   const std::array<RateField<Device>, N>& fields,
+                   std::vector<std::string>& names,
+                   std::array<std::vector<std::int64_t>, N>& rates) {
+    names.reserve(devices.size());
+    for (const auto& Entry : devices) {
+        names.push_back(Entry.name);
+    }
+    for (std::size_t F = 0; F < N; ++F) {
+        rates[F].reserve(devices.size());
+        for (const auto& Entry : devices) {
+            rates[F].push_back(ToTenths(Entry.*fields[F].member));
+        }
+    }
+}
+
+template <typename Device, std::size_t N>
+void AppendChangedRates(std::string& out,
+                        std::string_view name,
+                        bool& dataEmpty,
+                        const std::array<RateField<Device>, N>& fields,
+                        const std::array<std::vector<std::int64_t>, N>& before,
+                        const std::array<std::vector<std::int64_t>, N>& after) {
+    LazyObject Object(out, name, dataEmpty);
+    for (std::size_t F = 0; F < N; ++F) {
+        AppendChangedEntries(Object, fields[F].key, before[F], after[F], AppendTenths);
+    }
+    Object.Finish();
+}
+
+}  // namespace
+
+QuantizedStats QuantizedStats::From(const SystemStats& stats) {
+    QuantizedStats Quantized{.overall = ToTenths(stats.cpu.overall),
+                             .averageFrequency = stats.cpu.averageFrequency,
+                             .temperature = std::nullopt,
+                             .coreIds = {},
+                             .coreUsage = {},
+                             .coreFrequency = {},
+                             .coreTemperature = {},
+                             .packageIds = {},
+                             .packageTemperature = {},
+                             .packageThrottling = {},
+                             .throttling = stats.cpu.throttling,
+                             .memoryTotal = stats.memory.total,
+                             .memoryUsed = stats.memory.used,
+                             .memoryAvailable = stats.memory.available,
+                             .memoryCache = stats.memory.cache,
+                             .memoryBuffers = stats.memory.buffers,
+                             .memoryUsagePercent = ToTenths(stats.memory.usagePercent),
+                             .memorySlab = stats.memory.slab,
+                             .memoryDirty = stats.memory.dirty,
+                             .memoryWriteback = stats.memory.writeback,
+                             .memorySwapTotal = stats.memory.swapTotal,
+                             .memorySwapUsed = stats.memory.swapUsed,
+                             .memoryHugePagesTotal = stats.memory.hugePagesTotal,
+                             .memoryHugePagesFree = stats.memory.hugePagesFree,
+                             .pressure = stats.memory.pressure,
+                             .pressureAverages = {},
+                             .diskNames = {},
+                             .interfaceNames = {},
+                             .diskRates = {},
+                             .networkRates = {}};
+
+    if (stats.cpu.temperature) {
+        Quantized.temperature = ToTenths(*stats.cpu.temperature);
+    }
+
+    Quantized.coreIds.reserve(stats.cpu.cores.size());
+    Quantized.coreUsage.reserve(stats.cpu.cores.size());
+    Quantized.coreFrequency.reserve(stats.cpu.cores.size());
+    Quantized.coreTemperature.reserve(stats.cpu.cores.size());
+    for (const auto& Core : stats.cpu.cores) {
+        Quantized.coreIds.push_back(Core.coreId);
+        Quantized.coreUsage.push_back(ToTenths(Core.usage));
+        Quantized.coreFrequency.push_back(Core.frequency);
+        Quantized.coreTemperature.push_back(Core.temperature ? std::optional(ToTenths(*Core.temperature))
+                                                             : std::nullopt);
+    }
+    for (const auto& Package : stats.cpu.packages) {
+        Quantized.packageIds.push_back(Package.package);
+        Quantized.packageTemperature.push_back(ToTenths(Package.temperature));
+        Quantized.packageThrottling.push_back(Package.throttling);
+    }
+
+    if (const auto& Pressure = stats.memory.pressure) {
+        for (const auto* Resource : {&Pressure->cpu, &Pressure->io, &Pressure->memory}) {
+            for (const auto& Stall : {std::optional(Resource->some), Resource->full}) {
+                if (Stall) {
+                    Quantized.pressureAverages.push_back(std::llround(Stall->avg10 * 100.0));
+                    Quantized.pressureAverages.push_back(std::llround(Stall->avg60 * 100.0));
+                    Quantized.pressureAverages.push_back(std::llround(Stall->avg300 * 100.0));
+                }
+            }
+        }
+    }
+
+    QuantizeRates(stats.disks, DISK_RATE_FIELDS, Quantized.diskNames, Quantized.diskRates);
+    QuantizeRates(stats.network, NETWORK_RATE_FIELDS, Quantized.interfaceNames, Quantized.networkRates);
+
+    return Quantized;
+}
+
+namespace json {
+
+bool AppendStatsDelta(std::string& out,
+                      const QuantizedStats& before,
+                      const QuantizedStats& after,
+                      std::uint64_t sequence,
+                      std::int64_t timestampMs) {
+    // Same count is not enough: a core taken offline and another brought online keeps the size but shifts
+    // every index after it
+    if (before.coreIds != after.coreIds || before.packageIds != after.packageIds ||
+        before.diskNames != after.diskNames || before.interfaceNames != after.interfaceNames) {
+        return false;
+    }
+
+    out += R"({"type":"delta","seq":)";
+    AppendJson(out, sequence);
+    out += R"(,"timestamp":)";
+    AppendJson(out, timestampMs);
+    out += R"(,"data":{)";
+
+    bool DataEmpty = true;
+
+    LazyObject Cpu(out, "cpu", DataEmpty);
+    AppendTenthsIfChanged(Cpu, "overall", before.overall, after.overall);
+    AppendIfChanged(Cpu, "averageFrequency", before.averageFrequency, after.averageFrequency);
+    if (before.temperature != after.temperature) {
+        AppendOptionalTenths(Cpu.Member("temperature"), after.temperature);
+    }
+    AppendIfChanged(Cpu, "throttling", before.throttling, after.throttling);
+    AppendChangedEntries(Cpu, "usage", before.coreUsage, after.coreUsage, AppendTenths);
+    AppendChangedEntries(
+        Cpu, "frequency", before.coreFrequency, after.coreFrequency, [](std::string& target, std::uint64_t value) {
+            AppendJson(target, value);
+        });
+    AppendChangedEntries(Cpu, "coreTemperature", before.coreTemperature, after.coreTemperature, AppendOptionalTenths);
+    AppendChangedEntries(Cpu, "packageTemperature", before.packageTemperature, after.packageTemperature, AppendTenths);
+    AppendChangedEntries(Cpu,
+                         "packageThrottling",
+                         before.packageThrottling,
+                         after.packageThrottling,
+                         [](std::string& target, bool value) { AppendJson(target, value); });
+    Cpu.Finish();
+
+    LazyObject Memory(out, "memory", DataEmpty);
+    AppendIfChanged(Memory, "total", before.memoryTotal, after.memoryTotal);
+    AppendIfChanged(Memory, "used", before.memoryUsed, after.memoryUsed);
+    AppendIfChanged(Memory, "available", before.memoryAvailable, after.memoryAvailable);
+    AppendIfChanged(Memory, "cache", before.memoryCache, after.memoryCache);
+    AppendIfChanged(Memory, "buffers", before.memoryBuffers, after.memoryBuffers);
+    AppendTenthsIfChanged(Memory, "usagePercent", before.memoryUsagePercent, after.memoryUsagePercent);
+    AppendIfChanged(Memory, "slab", before.memorySlab, after.memorySlab);
+    AppendIfChanged(Memory, "dirty", before.memoryDirty, after.memoryDirty);
+    AppendIfChanged(Memory, "writeback", before.memoryWriteback, after.memoryWriteback);
+    AppendIfChanged(Memory, "swapTotal", before.memorySwapTotal, after.memorySwapTotal);
+    AppendIfChanged(Memory, "swapUsed", before.memorySwapUsed, after.memorySwapUsed);
+    AppendIfChanged(Memory, "hugePagesTotal", before.memoryHugePagesTotal, after.memoryHugePagesTotal);
+    AppendIfChanged(Memory, "hugePagesFree", before.memoryHugePagesFree, after.memoryHugePagesFree);
+    if (before.pressure.has_value() != after.pressure.has_value() ||
+        before.pressureAverages != after.pressureAverages) {
+        auto& Out = Memory.Member("pressure");
+        if (after.pressure) {
+            AppendJson(Out, *after.pressure);
+        } else {
+            Out += "null";
+        }
+    }
+    Memory.Finish();
+
+    AppendChangedRates(out, "disks", DataEmpty, DISK_RATE_FIELDS, before.diskRates, after.diskRates);
+    AppendChangedRates(out, "network", DataEmpty, NETWORK_RATE_FIELDS, before.networkRates, after.networkRates);
+
+    out += "}}";
+    return true;
+}
+
+}  // namespace json
+
+}  // namespace pc_monitor
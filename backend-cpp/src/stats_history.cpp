@@ -0,0 +1,651 @@
+#include "stats_history.hpp"
+
+#include "json_writer.hpp"
+#include "simd_kernels.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace pc_monitor {
+
+namespace {
+// Series order within every ring: fixed CPU/memory columns, per-core usage, per-core frequency, then the
+// rates of every disk and of every interface, device by device in key order
+enum FixedSeries : std::uint8_t {
+    CPU_OVERALL,
+    MEMORY_AVAILABLE,
+    MEMORY_BUFFERS,
+    MEMORY_CACHE,
+    MEMORY_USAGE_PERCENT,
+    MEMORY_USED,
+    FIXED_SERIES_COUNT
+};
+
+constexpr std::array<std::string_view, FIXED_SERIES_COUNT - MEMORY_AVAILABLE> MEMORY_KEYS{
+    "available", "buffers", "cache", "usagePercent", "used"};
+
+// Fixed rows ahead of the per-core rows in the narrow columns (CPU overall, memory usagePercent) and ahead of
+// the device rows in the wide ones (memory available, buffers, cache, used)
+constexpr std::size_t NARROW_FIXED_ROWS = 2;
+constexpr std::size_t WIDE_FIXED_ROWS = 4;
+
+// avg/max/min arrays plus separators for one bucket of one series
+constexpr std::size_t BYTES_PER_VALUE = 3 * 12;
+constexpr std::size_t FIXED_BYTES = 512;
+constexpr std::size_t BYTES_PER_NAME = 64;
+
+// Histogram resolution behind the summary percentiles: 1/256 of the series' range
+constexpr std::size_t SUMMARY_BUCKETS = 256;
+
+// The summary object for `values`, with extremes passed in separately; returns the summary of `values`
+template <typename T>
+simd::Summary AppendSummaryObject(std::string& out, std::span<const T> values, double min, double max) {
+    if (values.empty()) {
+        out += R"({"max":null,"mean":null,"min":null,"p50":null,"p95":null,"p99":null,"stddev":null})";
+        return {};
+    }
+
+    auto const Summary = simd::Summarize(values);
+    std::array<std::uint32_t, SUMMARY_BUCKETS> Buckets{};
+    simd::Histogram(values, Summary.min, Summary.max, Buckets);
+
+    out += R"({"max":)";
+    json::AppendJson(out, max);
+    out += R"(,"mean":)";
+    json::AppendJson(out, Summary.Mean());
+    out += R"(,"min":)";
+    json::AppendJson(out, min);
+    out += R"(,"p50":)";
+    json::AppendJson(out, simd::Percentile(Buckets, Summary.min, Summary.max, 0.50));
+    out += R"(,"p95":)";
+    json::AppendJson(out, simd::Percentile(Buckets, Summary.min, Summary.max, 0.95));
+    out += R"(,"p99":)";
+    json::AppendJson(out, simd::Percentile(Buckets, Summary.min, Summary.max, 0.99));
+    out += R"(,"stddev":)";
+    json::AppendJson(out, Summary.StdDev());
+    out += '}';
+    return Summary;
+}
+
+std::int64_t ToMilliseconds(std::chrono::system_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+template <typename Device>
+bool SameNames(const std::vector<std::string>& names, const std::vector<Device>& devices) {
+    return std::ranges::equal(names, devices, {}, {}, &Device::name);
+}
+
+template <typename Device>
+void AssignNames(std::vector<std::string>& names, const std::vector<Device>& devices) {
+    names.clear();
+    for (const auto& Entry : devices) {
+        names.push_back(Entry.name);
+    }
+}
+
+template <typename Device, std::size_t N>
+void FillRates(double* sample, const std::vector<Device>& devices, const std::array<RateField<Device>, N>& fields) {
+    for (const auto& Entry : devices) {
+        for (const auto& Field : fields) {
+            *sample++ = static_cast<double>(Entry.*Field.member);
+        }
+    }
+}
+
+// Folds one sample row into the bucket at `slot`, or starts the bucket with it
+template <typename Columns, typename T>
+void FoldRow(Columns& columns,
+             const std::vector<T>& sample,
+             std::size_t capacity,
+             std::size_t slot,
+             bool start) {
+    for (std::size_t Row = 0; Row < sample.size(); ++Row) {
+        auto const Index = (Row * capacity) + slot;
+        if (start) {
+            columns.min[Index] = sample[Row];
+            columns.max[Index] = sample[Row];
+            columns.sum[Index] = sample[Row];
+        } else {
+            columns.min[Index] = std::min(columns.min[Index], sample[Row]);
+            columns.max[Index] = std::max(columns.max[Index], sample[Row]);
+            columns.sum[Index] += sample[Row];
+        }
+    }
+}
+
+// Copies buckets first, first + 1, ... (modulo capacity) of every row of a ring column into rows of `points`
+template <typename T>
+void CopyWindow(std::vector<T>& to,
+                const std::vector<T>& from,
+                std::size_t capacity,
+                std::size_t first,
+                std::size_t points) {
+    to.clear();
+    if (points == 0) {
+        return;
+    }
+    // The window is at most two contiguous runs of each row, split where the ring wraps
+    auto const FirstRun = std::min(points, capacity - first);
+    to.reserve((from.size() / capacity) * points);
+    for (auto Row = from.begin(); Row != from.end(); Row += static_cast<std::ptrdiff_t>(capacity)) {
+        auto const First = Row + static_cast<std::ptrdiff_t>(first);
+        to.insert(to.end(), First, First + static_cast<std::ptrdiff_t>(FirstRun));
+        to.insert(to.end(), Row, Row + static_cast<std::ptrdiff_t>(points - FirstRun));
+    }
+}
+
+// Old series index of each rate series of `names`, or SIZE_MAX for a device that is new
+void MapDeviceSeries(std::vector<std::size_t>& map,
+                     const std::vector<std::string>& oldNames,
+                     std::size_t oldBase,
+                     const std::vector<std::string>& names,
+                     std::size_t fields) {
+    for (const auto& Name : names) {
+        auto const Found = std::ranges::find(oldNames, Name);
+        for (std::size_t F = 0; F < fields; ++F) {
+            map.push_back(Found == oldNames.end()
+                              ? SIZE_MAX
+                              : oldBase + (static_cast<std::size_t>(Found - oldNames.begin()) * fields) + F);
+        }
+    }
+}
+
+// [{"name":..,"<rate key>":<series>,...},...] for one device kind, keys in order
+template <typename Device, std::size_t N, typename AppendSeriesAt>
+void AppendDeviceSeries(std::string& out,
+                        const std::vector<std::string>& names,
+                        const std::array<RateField<Device>, N>& fields,
+                        std::size_t base,
+                        AppendSeriesAt appendSeries) {
+    out += '[';
+    for (std::size_t D = 0; D < names.size(); ++D) {
+        out += D == 0 ? "{" : ",{";
+        bool NameWritten = false;
+        for (std::size_t F = 0; F < N; ++F) {
+            if (!NameWritten && fields[F].key > "name") {
+                out += F == 0 ? R"("name":)" : R"(,"name":)";
+                json::AppendJson(out, names[D]);
+                NameWritten = true;
+            }
+            out += F == 0 && !NameWritten ? "\"" : ",\"";
+            out += fields[F].key;
+            out += "\":";
+            appendSeries(base + (D * N) + F);
+        }
+        if (!NameWritten) {
+            out += R"(,"name":)";
+            json::AppendJson(out, names[D]);
+        }
+        out += '}';
+    }
+    out += ']';
+}
+}  // namespace
+
+std::size_t StatsHistory::DiskSeries(const Snapshot& snapshot) noexcept {
+    return FIXED_SERIES_COUNT + (2 * snapshot.coreIds.size());
+}
+
+std::size_t StatsHistory::NetworkSeries(const Snapshot& snapshot) noexcept {
+    return DiskSeries(snapshot) + (snapshot.diskNames.size() * DISK_RATE_FIELDS.size());
+}
+
+std::size_t StatsHistory::SeriesCount(const Snapshot& snapshot) noexcept {
+    return NetworkSeries(snapshot) + (snapshot.interfaceNames.size() * NETWORK_RATE_FIELDS.size());
+}
+
+StatsHistory::Location StatsHistory::Locate(const Snapshot& snapshot, std::size_t series) noexcept {
+    switch (series) {
+        case CPU_OVERALL:
+            return {.wide = false, .row = 0};
+        case MEMORY_USAGE_PERCENT:
+            return {.wide = false, .row = 1};
+        case MEMORY_USED:
+            return {.wide = true, .row = WIDE_FIXED_ROWS - 1};
+        default:
+            break;
+    }
+    if (series < FIXED_SERIES_COUNT) {
+        return {.wide = true, .row = series - MEMORY_AVAILABLE};
+    }
+    if (series < DiskSeries(snapshot)) {
+        return {.wide = false, .row = NARROW_FIXED_ROWS + series - FIXED_SERIES_COUNT};
+    }
+    return {.wide = true, .row = WIDE_FIXED_ROWS + series - DiskSeries(snapshot)};
+}
+
+void StatsHistory::ResetLayout(const SystemStats& stats) {
+    coreIds_.clear();
+    for (const auto& Core : stats.cpu.cores) {
+        coreIds_.push_back(Core.coreId);
+    }
+    AssignNames(diskNames_, stats.disks);
+    AssignNames(interfaceNames_, stats.network);
+
+    narrowSample_.assign(NARROW_FIXED_ROWS + (2 * coreIds_.size()), 0.0F);
+    wideSample_.assign(WIDE_FIXED_ROWS + (diskNames_.size() * DISK_RATE_FIELDS.size()) +
+                           (interfaceNames_.size() * NETWORK_RATE_FIELDS.size()),
+                       0.0);
+
+    for (std::size_t I = 0; I < TIERS.size(); ++I) {
+        auto& Ring = rings_[I];
+        Ring.stepMs = std::chrono::duration_cast<std::chrono::milliseconds>(TIERS[I].step).count();
+        Ring.capacity = TIERS[I].capacity;
+        Ring.head = 0;
+        Ring.size = 0;
+        Ring.bucketStart.assign(Ring.capacity, 0);
+        Ring.count.assign(Ring.capacity, 0);
+        for (auto* Column : {&Ring.narrow.min, &Ring.narrow.max, &Ring.narrow.sum}) {
+            Column->assign(narrowSample_.size() * Ring.capacity, 0.0F);
+        }
+        for (auto* Column : {&Ring.wide.min, &Ring.wide.max, &Ring.wide.sum}) {
+            Column->assign(wideSample_.size() * Ring.capacity, 0.0);
+        }
+    }
+}
+
+void StatsHistory::RemapDevices(const SystemStats& stats) {
+    // Device rows only live in the wide columns, after the memory rows
+    std::vector<std::size_t> Map(WIDE_FIXED_ROWS);
+    std::iota(Map.begin(), Map.end(), std::size_t{0});
+    std::vector<std::string> Disks;
+    std::vector<std::string> Interfaces;
+    AssignNames(Disks, stats.disks);
+    AssignNames(Interfaces, stats.network);
+    MapDeviceSeries(Map, diskNames_, WIDE_FIXED_ROWS, Disks, DISK_RATE_FIELDS.size());
+    MapDeviceSeries(Map,
+                    interfaceNames_,
+                    WIDE_FIXED_ROWS + (diskNames_.size() * DISK_RATE_FIELDS.size()),
+                    Interfaces,
+                    NETWORK_RATE_FIELDS.size());
+    diskNames_ = std::move(Disks);
+    interfaceNames_ = std::move(Interfaces);
+    wideSample_.assign(Map.size(), 0.0);
+
+    std::vector<double> Column;
+    auto Move = [&](std::vector<double>& column, std::size_t capacity) {
+        Column.assign(Map.size() * capacity, 0.0);
+        for (std::size_t Row = 0; Row < Map.size(); ++Row) {
+            if (Map[Row] != SIZE_MAX) {
+                std::copy_n(column.begin() + static_cast<std::ptrdiff_t>(Map[Row] * capacity),
+                            capacity,
+                            Column.begin() + static_cast<std::ptrdiff_t>(Row * capacity));
+            }
+        }
+        column.swap(Column);
+    };
+    for (auto& Ring : rings_) {
+        Move(Ring.wide.min, Ring.capacity);
+        Move(Ring.wide.max, Ring.capacity);
+        Move(Ring.wide.sum, Ring.capacity);
+    }
+}
+
+void StatsHistory::Append(const SystemStats& stats) {
+    std::unique_lock<std::shared_mutex> const Lock(mutex_);
+
+    auto const& Cores = stats.cpu.cores;
+    bool const LayoutChanged =
+        coreIds_.size() != Cores.size() ||
+        !std::ranges::equal(coreIds_, Cores, {}, {}, [](const CPUCoreData& core) { return core.coreId; });
+    if (LayoutChanged) {
+        ResetLayout(stats);
+    } else if (!SameNames(diskNames_, stats.disks) || !SameNames(interfaceNames_, stats.network)) {
+        RemapDevices(stats);
+    }
+
+    narrowSample_[0] = static_cast<float>(stats.cpu.overall);
+    narrowSample_[1] = static_cast<float>(stats.memory.usagePercent);
+    for (std::size_t I = 0; I < Cores.size(); ++I) {
+        narrowSample_[NARROW_FIXED_ROWS + I] = static_cast<float>(Cores[I].usage);
+        narrowSample_[NARROW_FIXED_ROWS + Cores.size() + I] = static_cast<float>(Cores[I].frequency);
+    }
+    wideSample_[0] = static_cast<double>(stats.memory.available);
+    wideSample_[1] = static_cast<double>(stats.memory.buffers);
+    wideSample_[2] = static_cast<double>(stats.memory.cache);
+    wideSample_[3] = static_cast<double>(stats.memory.used);
+    FillRates(&wideSample_[WIDE_FIXED_ROWS], stats.disks, DISK_RATE_FIELDS);
+    FillRates(&wideSample_[WIDE_FIXED_ROWS + (stats.disks.size() * DISK_RATE_FIELDS.size())],
+              stats.network,
+              NETWORK_RATE_FIELDS);
+
+    auto const TimestampMs = ToMilliseconds(stats.timestamp);
+    for (auto& Ring : rings_) {
+        auto const Bucket = TimestampMs - (TimestampMs % Ring.stepMs);
+
+        if (Ring.size != 0 && Bucket == Ring.bucketStart[Ring.head]) {
+            // Same bucket: fold the sample into the running aggregates
+            ++Ring.count[Ring.head];
+            FoldRow(Ring.narrow, narrowSample_, Ring.capacity, Ring.head, false);
+            FoldRow(Ring.wide, wideSample_, Ring.capacity, Ring.head, false);
+            continue;
+        }
+
+        // The wall clock stepped back: older buckets would no longer be in order, so start over
+        if (Ring.size != 0 && Bucket < Ring.bucketStart[Ring.head]) {
+            Ring.size = 0;
+        }
+
+        Ring.head = Ring.size == 0 ? 0 : (Ring.head + 1) % Ring.capacity;
+        Ring.size = std::min(Ring.size + 1, Ring.capacity);
+        Ring.bucketStart[Ring.head] = Bucket;
+        Ring.count[Ring.head] = 1;
+        FoldRow(Ring.narrow, narrowSample_, Ring.capacity, Ring.head, true);
+        FoldRow(Ring.wide, wideSample_, Ring.capacity, Ring.head, true);
+    }
+}
+
+std::chrono::seconds StatsHistory::StepFor(std::chrono::seconds range) noexcept {
+    for (const auto& Tier : TIERS) {
+        if (range <= Tier.step * static_cast<std::int64_t>(Tier.capacity)) {
+            return Tier.step;
+        }
+    }
+    return TIERS.back().step;
+}
+
+void StatsHistory::AppendSeries(std::string& out, const Ring& window, Location where) {
+    auto const Base = where.row * window.capacity;
+    auto AppendColumn = [&](std::string_view key, auto value) {
+        out += key;
+        out += '[';
+        for (std::size_t I = 0; I < window.size; ++I) {
+            if (I != 0) {
+                out += ',';
+            }
+            json::AppendJson(out, value(Base + I, I));
+        }
+        out += ']';
+    };
+    auto AppendColumns = [&](const auto& columns) {
+        using Value = typename std::remove_cvref_t<decltype(columns.sum)>::value_type;
+        AppendColumn(R"({"avg":)", [&](std::size_t index, std::size_t slot) {
+            return columns.sum[index] / static_cast<Value>(window.count[slot]);
+        });
+        AppendColumn(R"(,"max":)", [&](std::size_t index, std::size_t /*slot*/) { return columns.max[index]; });
+        AppendColumn(R"(,"min":)", [&](std::size_t index, std::size_t /*slot*/) { return columns.min[index]; });
+    };
+
+    if (where.wide) {
+        AppendColumns(window.wide);
+    } else {
+        AppendColumns(window.narrow);
+    }
+    out += '}';
+}
+
+bool StatsHistory::AppendRange(std::string& out,
+                               std::chrono::seconds range,
+                               std::chrono::seconds step,
+                               WireFormat format) const {
+    auto const TierIt = std::ranges::find(TIERS, step, &Tier::step);
+    if (TierIt == TIERS.end()) {
+        return false;
+    }
+
+    Snapshot Selected;
+    {
+        std::shared_lock<std::shared_mutex> const Lock(mutex_);
+        Selected = SnapshotLocked(static_cast<std::size_t>(TierIt - TIERS.begin()), range);
+    }
+
+    if (format == WireFormat::BINARY) {
+        AppendBinaryRange(out, Selected);
+    } else {
+        AppendJsonRange(out, Selected);
+    }
+    return true;
+}
+
+StatsHistory::Window StatsHistory::WindowFor(const Ring& ring, std::chrono::seconds range) noexcept {
+    if (ring.size == 0) {
+        return {};
+    }
+
+    // Buckets whose start lies within the last `range`, counting back from the newest one
+    auto const RangeMs = std::chrono::duration_cast<std::chrono::milliseconds>(range).count();
+    auto const From = ring.bucketStart[ring.head] - RangeMs + ring.stepMs;
+    std::size_t Points = 0;
+    while (Points < ring.size && ring.bucketStart[(ring.head + ring.capacity - Points) % ring.capacity] >= From) {
+        ++Points;
+    }
+    return {.first = (ring.head + ring.capacity + 1 - Points) % ring.capacity, .points = Points};
+}
+
+StatsHistory::Snapshot StatsHistory::SnapshotLocked(std::size_t tier, std::chrono::seconds range) const {
+    const auto& Ring = rings_[tier];
+    auto const [First, Points] = WindowFor(Ring, range);
+
+    Snapshot Copy{.coreIds = coreIds_,
+                  .diskNames = diskNames_,
+                  .interfaceNames = interfaceNames_,
+                  .memoryBytes = MemoryBytesLocked()};
+    auto& Window = Copy.window;
+    // The ring's own step is unset until the first sample, so take it from the tier
+    Window.stepMs = std::chrono::duration_cast<std::chrono::milliseconds>(TIERS[tier].step).count();
+    Window.capacity = Points;
+    Window.head = Points == 0 ? 0 : Points - 1;
+    Window.size = Points;
+    CopyWindow(Window.bucketStart, Ring.bucketStart, Ring.capacity, First, Points);
+    CopyWindow(Window.count, Ring.count, Ring.capacity, First, Points);
+    for (auto [To, From] : {std::pair{&Window.narrow.min, &Ring.narrow.min},
+                            std::pair{&Window.narrow.max, &Ring.narrow.max},
+                            std::pair{&Window.narrow.sum, &Ring.narrow.sum}}) {
+        CopyWindow(*To, *From, Ring.capacity, First, Points);
+    }
+    for (auto [To, From] : {std::pair{&Window.wide.min, &Ring.wide.min},
+                            std::pair{&Window.wide.max, &Ring.wide.max},
+                            std::pair{&Window.wide.sum, &Ring.wide.sum}}) {
+        CopyWindow(*To, *From, Ring.capacity, First, Points);
+    }
+    return Copy;
+}
+
+double StatsHistory::AppendSeriesSummary(std::string& out,
+                                         const Ring& window,
+                                         Location where,
+                                         std::vector<double>& averages) {
+    auto const Base = where.row * window.capacity;
+    auto SummarizeColumns = [&](const auto& columns) {
+        using Value = typename std::remove_cvref_t<decltype(columns.sum)>::value_type;
+        auto Extremes = [&](const std::vector<Value>& column) {
+            return simd::Summarize(std::span<const Value>(column).subspan(Base, window.size));
+        };
+
+        averages.clear();
+        for (std::size_t I = 0; I < window.size; ++I) {
+            averages.push_back(columns.sum[Base + I] / static_cast<Value>(window.count[I]));
+        }
+
+        return AppendSummaryObject(
+                   out, std::span<const double>(averages), Extremes(columns.min).min, Extremes(columns.max).max)
+            .Mean();
+    };
+
+    return where.wide ? SummarizeColumns(window.wide) : SummarizeColumns(window.narrow);
+}
+
+void StatsHistory::AppendSummary(std::string& out, std::chrono::seconds range) const {
+    auto const Step = StepFor(range);
+    Snapshot Selected;
+    {
+        std::shared_lock<std::shared_mutex> const Lock(mutex_);
+        Selected = SnapshotLocked(static_cast<std::size_t>(std::ranges::find(TIERS, Step, &Tier::step) - TIERS.begin()),
+                                  range);
+    }
+    const auto& Window = Selected.window;
+    const auto& CoreIds = Selected.coreIds;
+
+    std::vector<double> Averages;
+    Averages.reserve(Window.size);
+    std::vector<float> CoreMeans;
+    CoreMeans.reserve(CoreIds.size());
+
+    out += R"({"cpu":{"cores":[)";
+    for (std::size_t I = 0; I < CoreIds.size(); ++I) {
+        out += I == 0 ? R"({"coreId":)" : R"(,{"coreId":)";
+        json::AppendJson(out, CoreIds[I]);
+        out += R"(,"frequency":)";
+        AppendSeriesSummary(out, Window, Locate(Selected, FIXED_SERIES_COUNT + CoreIds.size() + I), Averages);
+        out += R"(,"usage":)";
+        CoreMeans.push_back(
+            static_cast<float>(AppendSeriesSummary(out, Window, Locate(Selected, FIXED_SERIES_COUNT + I), Averages)));
+        out += '}';
+    }
+    out += R"(],"overall":)";
+    AppendSeriesSummary(out, Window, Locate(Selected, CPU_OVERALL), Averages);
+    out += R"(,"spread":)";
+    auto const Spread = simd::Summarize(std::span<const float>(CoreMeans));
+    AppendSummaryObject(out,
+                        Window.size == 0 ? std::span<const float>() : std::span<const float>(CoreMeans),
+                        Spread.min,
+                        Spread.max);
+
+    auto const AppendSummaryAt = [&](std::size_t series) {
+        AppendSeriesSummary(out, Window, Locate(Selected, series), Averages);
+    };
+    out += R"(},"disks":)";
+    AppendDeviceSeries(out, Selected.diskNames, DISK_RATE_FIELDS, DiskSeries(Selected), AppendSummaryAt);
+    out += R"(,"memory":{)";
+    for (std::size_t I = 0; I < MEMORY_KEYS.size(); ++I) {
+        out += I == 0 ? "\"" : ",\"";
+        out += MEMORY_KEYS[I];
+        out += "\":";
+        AppendSummaryAt(MEMORY_AVAILABLE + I);
+    }
+
+    out += R"(},"network":)";
+    AppendDeviceSeries(out, Selected.interfaceNames, NETWORK_RATE_FIELDS, NetworkSeries(Selected), AppendSummaryAt);
+    out += R"(,"points":)";
+    json::AppendJson(out, Window.size);
+    out += R"(,"step":)";
+    json::AppendJson(out, std::chrono::duration_cast<std::chrono::milliseconds>(Step).count());
+    out += '}';
+}
+
+void StatsHistory::AppendJsonRange(std::string& out, const Snapshot& snapshot) {
+    const auto& Window = snapshot.window;
+    const auto& CoreIds = snapshot.coreIds;
+    out.reserve(out.size() + FIXED_BYTES +
+                ((snapshot.diskNames.size() + snapshot.interfaceNames.size()) * BYTES_PER_NAME) +
+                (Window.size * (SeriesCount(snapshot) * BYTES_PER_VALUE + 16)));
+
+    out += R"({"cpu":{"cores":[)";
+    for (std::size_t I = 0; I < CoreIds.size(); ++I) {
+        out += I == 0 ? R"({"coreId":)" : R"(,{"coreId":)";
+        json::AppendJson(out, CoreIds[I]);
+        out += R"(,"frequency":)";
+        AppendSeries(out, Window, Locate(snapshot, FIXED_SERIES_COUNT + CoreIds.size() + I));
+        out += R"(,"usage":)";
+        AppendSeries(out, Window, Locate(snapshot, FIXED_SERIES_COUNT + I));
+        out += '}';
+    }
+    out += R"(],"overall":)";
+    AppendSeries(out, Window, Locate(snapshot, CPU_OVERALL));
+
+    auto const AppendSeriesAt = [&](std::size_t series) { AppendSeries(out, Window, Locate(snapshot, series)); };
+    out += R"(},"disks":)";
+    AppendDeviceSeries(out, snapshot.diskNames, DISK_RATE_FIELDS, DiskSeries(snapshot), AppendSeriesAt);
+    out += R"(,"memory":{)";
+    for (std::size_t I = 0; I < MEMORY_KEYS.size(); ++I) {
+        out += I == 0 ? "\"" : ",\"";
+        out += MEMORY_KEYS[I];
+        out += "\":";
+        AppendSeriesAt(MEMORY_AVAILABLE + I);
+    }
+
+    out += R"(},"memoryBytes":)";
+    json::AppendJson(out, snapshot.memoryBytes);
+    out += R"(,"network":)";
+    AppendDeviceSeries(out, snapshot.interfaceNames, NETWORK_RATE_FIELDS, NetworkSeries(snapshot), AppendSeriesAt);
+    out += R"(,"points":)";
+    json::AppendJson(out, Window.size);
+    out += R"(,"step":)";
+    json::AppendJson(out, Window.stepMs);
+    out += R"(,"timestamps":[)";
+    for (std::size_t I = 0; I < Window.size; ++I) {
+        if (I != 0) {
+            out += ',';
+        }
+        json::AppendJson(out, Window.bucketStart[I]);
+    }
+    out += "]}";
+}
+
+void StatsHistory::AppendBinaryRange(std::string& out, const Snapshot& snapshot) {
+    const auto& Window = snapshot.window;
+    binary::AppendHeader(out, binary::MessageType::HISTORY);
+
+    binary::BitWriter Writer(out);
+    Writer.WriteVarint(static_cast<std::uint64_t>(Window.stepMs));
+    Writer.WriteVarint(Window.size);
+    Writer.WriteVarint(snapshot.memoryBytes);
+    Writer.WriteVarint(snapshot.coreIds.size());
+    binary::WriteCoreIds(
+        Writer, snapshot.coreIds.size(), [&](std::size_t index) { return snapshot.coreIds[index]; });
+    binary::WriteNames(Writer, snapshot.diskNames.size(), [&](std::size_t index) -> std::string_view {
+        return snapshot.diskNames[index];
+    });
+    binary::WriteNames(Writer, snapshot.interfaceNames.size(), [&](std::size_t index) -> std::string_view {
+        return snapshot.interfaceNames[index];
+    });
+
+    binary::TimestampEncoder Timestamps(Writer);
+    for (std::size_t I = 0; I < Window.size; ++I) {
+        Timestamps.Put(Window.bucketStart[I]);
+    }
+
+    // Consecutive buckets of one series are usually close, which is what the XOR chains compress
+    auto const EncodeSeries = [&](const auto& columns, std::size_t row) {
+        using Value = typename std::remove_cvref_t<decltype(columns.sum)>::value_type;
+        auto const Base = row * Window.capacity;
+        binary::XorEncoder Avg(Writer);
+        for (std::size_t I = 0; I < Window.size; ++I) {
+            Avg.Put(columns.sum[Base + I] / static_cast<Value>(Window.count[I]));
+        }
+        binary::XorEncoder Max(Writer);
+        for (std::size_t I = 0; I < Window.size; ++I) {
+            Max.Put(columns.max[Base + I]);
+        }
+        binary::XorEncoder Min(Writer);
+        for (std::size_t I = 0; I < Window.size; ++I) {
+            Min.Put(columns.min[Base + I]);
+        }
+    };
+    for (std::size_t Series = 0; Series < SeriesCount(snapshot) && Window.size != 0; ++Series) {
+        auto const Where = Locate(snapshot, Series);
+        if (Where.wide) {
+            EncodeSeries(Window.wide, Where.row);
+        } else {
+            EncodeSeries(Window.narrow, Where.row);
+        }
+    }
+    Writer.Finish();
+}
+
+std::size_t StatsHistory::MemoryBytes() const {
+    std::shared_lock<std::shared_mutex> const Lock(mutex_);
+    return MemoryBytesLocked();
+}
+
+std::size_t StatsHistory::MemoryBytesLocked() const {
+    std::size_t Bytes = (coreIds_.capacity() * sizeof(std::uint32_t)) +
+                        (narrowSample_.capacity() * sizeof(float)) + (wideSample_.capacity() * sizeof(double)) +
+                        ((diskNames_.capacity() + interfaceNames_.capacity()) * sizeof(std::string));
+    for (const auto& Ring : rings_) {
+        Bytes += (Ring.bucketStart.capacity() * sizeof(std::int64_t)) +
+                 (Ring.count.capacity() * sizeof(std::uint32_t)) +
+                 ((Ring.narrow.min.capacity() + Ring.narrow.max.capacity() + Ring.narrow.sum.capacity()) *
+                  sizeof(float)) +
+                 ((Ring.wide.min.capacity() + Ring.wide.max.capacity() + Ring.wide.sum.capacity()) * sizeof(double));
+    }
+    return Bytes;
+}
+
+}  // namespace pc_monitor
@@ -0,0 +1,339 @@
+#include "stats_sampler.hpp"
+
+#include <algorithm>
+
+namespace pc_monitor {
+
+namespace {
+using Clock = TimerWheel::Clock;
+
+std::int64_t Microseconds(Clock::duration duration) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+}  // namespace
+
+StatsSampler::StatsSampler(std::shared_ptr<SystemMonitor> monitor, Options options)
+    : monitor_(std::move(monitor)), options_(options) {
+    // Built-in groups feeding the snapshot; scheduled by Start() once the first sample is in
+    (void)AddTaskLocked("cpu", options_.cpuInterval, true, [this]() {
+        // A failed sample keeps the previous values published
+        if (auto Cpu = monitor_->GetCpuStats()) {
+            current_.cpu = std::move(*Cpu);
+            pendingPublish_ = true;
+        }
+    });
+    (void)AddTaskLocked("memory", options_.memoryInterval, true, [this]() {
+        if (auto Memory = monitor_->GetMemoryStats()) {
+            current_.memory = *Memory;
+            pendingPublish_ = true;
+        }
+    });
+    (void)AddTaskLocked("disk", options_.diskInterval, true, [this]() {
+        if (auto Disks = monitor_->GetDiskStats()) {
+            current_.disks = std::move(*Disks);
+            pendingPublish_ = true;
+        }
+    });
+    (void)AddTaskLocked("network", options_.networkInterval, true, [this]() {
+        if (auto Network = monitor_->GetNetworkStats()) {
+            current_.network = std::move(*Network);
+            pendingPublish_ = true;
+        }
+    });
+}
+
+StatsSampler::~StatsSampler() {
+    Stop();
+}
+
+Result<void> StatsSampler::Start() {
+    if (running_.load()) {
+        return std::unexpected(SystemError::SYSTEM_ERROR);
+    }
+
+    auto Cpu = monitor_->GetCpuStats();
+    if (!Cpu) {
+        return std::unexpected(Cpu.error());
+    }
+    auto Memory = monitor_->GetMemoryStats();
+    if (!Memory) {
+        return std::unexpected(Memory.error());
+    }
+    current_.cpu = std::move(*Cpu);
+    current_.memory = *Memory;
+
+    // Disks and interfaces are optional; without them the groups keep publishing empty lists
+    if (auto Disks = monitor_->GetDiskStats()) {
+        current_.disks = std::move(*Disks);
+    }
+    if (auto Network = monitor_->GetNetworkStats()) {
+        current_.network = std::move(*Network);
+    }
+    Publish();
+
+    {
+        std::lock_guard<std::mutex> const Lock(mutex_);
+        auto const Now = Clock::now();
+        lastDemand_.store(Now.time_since_epoch().count());
+        idle_.store(false);
+        for (auto& Task : tasks_) {
+            if (Task->publishes) {
+                (void)wheel_.Cancel(Task->id, Task->deadline);
+                Task->deadline = Now + Task->interval;
+                wheel_.Schedule(Task->id, Task->deadline);
+            }
+        }
+    }
+
+    running_.store(true);
+    samplerThread_ = std::thread([this]() { Run(); });
+
+    return {};
+}
+
+void StatsSampler::Stop() {
+    if (running_.exchange(false)) {
+        {
+            std::lock_guard<std::mutex> const Lock(mutex_);
+        }
+        wake_.notify_all();
+
+        if (samplerThread_.joinable()) {
+            samplerThread_.join();
+        }
+    }
+}
+
+void StatsSampler::Publish() {
+    current_.timestamp = monitor_->Now();
+    pendingPublish_ = false;
+
+    // Readers holding the previous snapshot keep it alive until they drop their reference
+    auto Published = std::make_shared<const SystemStats>(current_);
+    latest_.store(Published, std::memory_order_release);
+    sequence_.fetch_add(1, std::memory_order_acq_rel);
+    published_.Notify();
+
+    std::lock_guard<std::mutex> const Lock(listenersMutex_);
+    for (const auto& [Id, Callback] : listeners_) {
+        Callback(Published);
+    }
+}
+
+StatsSampler::ListenerId StatsSampler::AddListener(Listener listener) {
+    std::lock_guard<std::mutex> const Lock(listenersMutex_);
+
+    if (auto Current = Latest()) {
+        listener(Current);
+    }
+
+    auto const Id = nextListenerId_++;
+    listeners_.emplace_back(Id, std::move(listener));
+    return Id;
+}
+
+void StatsSampler::RemoveListener(ListenerId id) {
+    std::lock_guard<std::mutex> const Lock(listenersMutex_);
+    std::erase_if(listeners_, [id](const auto& entry) { return entry.first == id; });
+}
+
+AsyncStream<StatsSampler::Snapshot> StatsSampler::Subscribe(EventLoop& loop, std::stop_token stop) {
+    Snapshot Last;
+    auto Seen = Sequence();
+    auto const Published = [this, &Seen]() { return Sequence() != Seen; };
+    do {
+        // The sequence is bumped after the pointer is stored, so a snapshot can show up one wake-up early
+        Seen = Sequence();
+        auto Current = Latest();
+        if (Current && Current != Last) {
+            NoteDemand();
+            Last = Current;
+            co_yield std::move(Current);
+        }
+    } while (co_await published_.Wait(loop, stop, Published));
+}
+
+StatsSampler::TaskId StatsSampler::AddTaskLocked(std::string name,
+                                                 std::chrono::milliseconds interval,
+                                                 bool publishes,
+                                                 Task task) {
+    auto Added = std::make_unique<ScheduledTask>();
+    Added->id = nextTaskId_++;
+    Added->interval = interval;
+    Added->run = std::move(task);
+    Added->publishes = publishes;
+    Added->latency = perf::Register("collect." + name);
+    Added->stats.name = std::move(name);
+    Added->stats.intervalMs = interval.count();
+    tasks_.push_back(std::move(Added));
+    return tasks_.back()->id;
+}
+
+StatsSampler::TaskId StatsSampler::AddTask(std::string name, std::chrono::milliseconds interval, Task task) {
+    std::lock_guard<std::mutex> const Lock(mutex_);
+    auto const Id = AddTaskLocked(std::move(name), interval, false, std::move(task));
+
+    auto& Added = *tasks_.back();
+    Added.deadline = Clock::now();
+    wheel_.Schedule(Id, Added.deadline);
+    rearmed_ = true;
+    wake_.notify_one();
+    return Id;
+}
+
+void StatsSampler::RemoveTask(TaskId id) {
+    std::lock_guard<std::mutex> const RunLock(runMutex_);
+    std::lock_guard<std::mutex> const Lock(mutex_);
+
+    auto const Found = std::ranges::find_if(tasks_, [id](const auto& task) { return task->id == id; });
+    if (Found != tasks_.end()) {
+        (void)wheel_.Cancel(id, (*Found)->deadline);
+        tasks_.erase(Found);
+    }
+}
+
+void StatsSampler::NoteDemand() {
+    lastDemand_.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    if (!idle_.load()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> const Lock(mutex_);
+    if (!idle_.exchange(false)) {
+        return;
+    }
+
+    // Deadlines were spaced for the idle interval; run every pending task now and resume from there
+    auto const Now = Clock::now();
+    for (auto& Task : tasks_) {
+        if (Task->deadline > Now && wheel_.Cancel(Task->id, Task->deadline)) {
+            Task->deadline = Now;
+            wheel_.Schedule(Task->id, Now);
+        }
+    }
+    rearmed_ = true;
+    wake_.notify_one();
+}
+
+std::vector<SamplingTaskStats> StatsSampler::TaskStats() const {
+    std::lock_guard<std::mutex> const Lock(mutex_);
+
+    std::vector<SamplingTaskStats> Stats;
+    Stats.reserve(tasks_.size());
+    for (const auto& Task : tasks_) {
+        Stats.push_back(Task->stats);
+        Stats.back().intervalMs = EffectiveInterval(*Task).count();
+    }
+    return Stats;
+}
+
+std::chrono::milliseconds StatsSampler::EffectiveInterval(const ScheduledTask& task) const noexcept {
+    if (task.interval.count() == 0 || !idle_.load()) {
+        return task.interval;
+    }
+    return std::max(task.interval, options_.idleInterval);
+}
+
+void StatsSampler::Reschedule(ScheduledTask& task, Clock::time_point started, Clock::time_point now) {
+    auto const Jitter = Microseconds(started - task.deadline);
+    auto& Stats = task.stats;
+    ++Stats.runs;
+    Stats.lastJitterUs = Jitter;
+    Stats.maxJitterUs = std::max(Stats.maxJitterUs, Jitter);
+    task.totalJitterUs += Jitter;
+    Stats.meanJitterUs = task.totalJitterUs / static_cast<std::int64_t>(Stats.runs);
+    Stats.lastDurationUs = Microseconds(now - started);
+
+    auto const Interval = EffectiveInterval(task);
+    if (Interval.count() == 0) {
+        return;
+    }
+
+    // The next deadline follows from the previous one, not from when this run finished, so collection time
+    // never accumulates; deadlines that already passed are skipped and counted instead of run back to back
+    auto Next = task.deadline + Interval;
+    if (Next <= now) {
+        auto const Skipped = (now - task.deadline) / Interval;
+        Stats.missed += static_cast<std::uint64_t>(Skipped);
+        Next = task.deadline + ((Skipped + 1) * Interval);
+    }
+    task.deadline = Next;
+    wheel_.Schedule(task.id, Next);
+}
+
+void StatsSampler::RunBatch(std::vector<ScheduledTask*>& batch) {
+    // Built-in groups first, so the snapshot of this tick is out before extra tasks take their time
+    std::ranges::stable_partition(batch, &ScheduledTask::publishes);
+
+    for (auto* Task : batch) {
+        if (!Task->publishes && pendingPublish_) {
+            Publish();
+        }
+
+        auto const Started = Clock::now();
+        Task->run();
+        auto const Finished = Clock::now();
+        perf::Record(Task->latency,
+                     static_cast<std::uint64_t>(
+                         std::chrono::duration_cast<std::chrono::nanoseconds>(Finished - Started).count()));
+
+        std::lock_guard<std::mutex> const Lock(mutex_);
+        Reschedule(*Task, Started, Finished);
+    }
+
+    if (pendingPublish_) {
+        Publish();
+    }
+}
+
+void StatsSampler::Run() {
+    std::vector<ScheduledTask*> Batch;
+    std::unique_lock<std::mutex> Lock(mutex_);
+
+    while (running_.load()) {
+        rearmed_ = false;
+        auto const Wake = [this]() { return !running_.load() || rearmed_; };
+        if (auto const Next = wheel_.NextDeadline()) {
+            wake_.wait_until(Lock, *Next, Wake);
+        } else {
+            wake_.wait(Lock, Wake);
+        }
+
+        if (!running_.load()) {
+            break;
+        }
+
+        auto const Now = Clock::now();
+        auto const SinceDemand = Now.time_since_epoch() - Clock::duration{lastDemand_.load()};
+        if (!idle_.load() && SinceDemand > options_.idleAfter) {
+            idle_.store(true);
+        }
+
+        due_.clear();
+        wheel_.Expire(Now, due_);
+        if (due_.empty()) {
+            continue;
+        }
+
+        // Tasks run without the wheel lock, so AddTask() and NoteDemand() never wait for a collection
+        Lock.unlock();
+        {
+            std::lock_guard<std::mutex> const RunLock(runMutex_);
+            Lock.lock();
+            Batch.clear();
+            for (const auto& Entry : due_) {
+                auto const Found =
+                    std::ranges::find_if(tasks_, [&Entry](const auto& task) { return task->id == Entry.key; });
+                if (Found != tasks_.end()) {
+                    Batch.push_back(Found->get());
+                }
+            }
+            Lock.unlock();
+
+            RunBatch(Batch);
+        }
+        Lock.lock();
+    }
+}
+
+}  // namespace pc_monitor
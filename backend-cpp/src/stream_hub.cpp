@@ -0,0 +1,119 @@
+#include "stream_hub.hpp"
+
+#include <algorithm>
+
+namespace pc_monitor {
+
+StreamHub::Frame StreamHub::Subscription::WaitNext(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> Lock(mutex_);
+    if (!ready_.wait_for(Lock, timeout, [this]() { return count_ != 0 || closed_.load(); }) || count_ == 0) {
+        return nullptr;
+    }
+
+    Frame Next = std::move(queue_[head_]);
+    head_ = (head_ + 1) % queue_.size();
+    --count_;
+    backlogDrops_ = 0;
+    return Next;
+}
+
+StreamHub::Frame StreamHub::Subscription::TryNext() {
+    std::lock_guard<std::mutex> const Lock(mutex_);
+    if (count_ == 0) {
+        return nullptr;
+    }
+
+    Frame Next = std::move(queue_[head_]);
+    head_ = (head_ + 1) % queue_.size();
+    --count_;
+    backlogDrops_ = 0;
+    return Next;
+}
+
+bool StreamHub::Subscription::Push(const Frame& frame, std::size_t maxBacklogDrops) {
+    {
+        std::lock_guard<std::mutex> const Lock(mutex_);
+        if (closed_.load()) {
+            return true;
+        }
+
+        if (count_ == queue_.size()) {
+            // Slow consumer: replace the oldest frame, newer stats supersede it anyway
+            head_ = (head_ + 1) % queue_.size();
+            --count_;
+            dropped_.fetch_add(1);
+            if (++backlogDrops_ > maxBacklogDrops) {
+                return false;
+            }
+        }
+
+        queue_[(head_ + count_) % queue_.size()] = frame;
+        ++count_;
+    }
+    ready_.notify_one();
+    if (onReady_) {
+        onReady_();
+    }
+    return true;
+}
+
+void StreamHub::Subscription::Close() {
+    {
+        std::lock_guard<std::mutex> const Lock(mutex_);
+        closed_.store(true);
+        std::fill(queue_.begin(), queue_.end(), nullptr);
+        count_ = 0;
+    }
+    ready_.notify_all();
+    if (onReady_) {
+        onReady_();
+    }
+}
+
+StreamHub::StreamHub(std::size_t queueCapacity, std::size_t maxBacklogDrops)
+    : queueCapacity_(std::max<std::size_t>(queueCapacity, 1)), maxBacklogDrops_(maxBacklogDrops) {}
+
+std::shared_ptr<StreamHub::Subscription> StreamHub::Subscribe(const Frame& initial, ReadyCallback onReady) {
+    auto Created = std::make_shared<Subscription>(queueCapacity_, std::move(onReady));
+    if (initial) {
+        Created->Push(initial, maxBacklogDrops_);
+    }
+
+    std::lock_guard<std::mutex> const Lock(subscribersMutex_);
+    subscribers_.push_back(Created);
+    return Created;
+}
+
+void StreamHub::Unsubscribe(const std::shared_ptr<Subscription>& subscription) {
+    subscription->Close();
+
+    std::lock_guard<std::mutex> const Lock(subscribersMutex_);
+    std::erase(subscribers_, subscription);
+}
+
+void StreamHub::Publish(const Frame& frame) {
+    std::lock_guard<std::mutex> const Lock(subscribersMutex_);
+    std::erase_if(subscribers_, [&](const std::shared_ptr<Subscription>& subscriber) {
+        if (subscriber->Push(frame, maxBacklogDrops_)) {
+            return false;
+        }
+        subscriber->Close();
+        slowDisconnects_.fetch_add(1);
+        return true;
+    });
+}
+
+void StreamHub::CloseAll() {
+    std::lock_guard<std::mutex> const Lock(subscribersMutex_);
+    for (const auto& Subscriber : subscribers_) {
+        Subscriber->Close();
+    }
+    subscribers_.clear();
+}
+
+std::size_t StreamHub::SubscriberCount() const {
+    std::lock_guard<std::mutex> const Lock(subscribersMutex_);
+    return subscribers_.size();
+}
+
+}  // namespace pc_monitor
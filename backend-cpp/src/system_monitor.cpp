@@ -1,33 +1,381 @@
 #include "system_monitor.hpp"
 
+#include "collector_backend.hpp"
+#include "proc_file.hpp"
+#include "simd_kernels.hpp"
+
 #include <algorithm>
+#include <charconv>
 #include <chrono>
+#include <cmath>
+#include <limits>
 #include <numeric>
+#include <optional>
+#include <string_view>
 #include <thread>
+#include <tuple>
+
+#if defined(_WIN32)
+    // winsock2.h has to precede windows.h, which the other headers pull in
+    #include <winsock2.h>
 
-#include <pdh.h>
-#include <powerbase.h>
-#include <psapi.h>
-#include <windows.h>
-#pragma comment(lib, "pdh.lib")
-#pragma comment(lib, "psapi.lib")
+    #include <iphlpapi.h>
+    #include <pdh.h>
+    #include <powerbase.h>
+    #include <psapi.h>
+    #include <windows.h>
+    #include <winioctl.h>
+    #pragma comment(lib, "iphlpapi.lib")
+    #pragma comment(lib, "pdh.lib")
+    #pragma comment(lib, "powrprof.lib")
+    #pragma comment(lib, "psapi.lib")
+#elif defined(__linux__)
+    #include <array>
+    #include <cerrno>
+    #include <optional>
+    #include <string>
+    #include <utility>
+#endif
 
 namespace pc_monitor {
 
+namespace {
+// Counts packages, physical cores and NUMA nodes of the per-cpu entries and orders the caches
+void SummarizeTopology(CpuTopology& topology) {
+    std::vector<std::uint32_t> Packages;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> Cores;
+    std::vector<std::uint32_t> Nodes;
+    for (const auto& Cpu : topology.cpus) {
+        Packages.push_back(Cpu.package);
+        Cores.emplace_back(Cpu.package, Cpu.core);
+        Nodes.push_back(Cpu.node);
+    }
+    auto const CountDistinct = [](auto& values) {
+        std::ranges::sort(values);
+        return static_cast<std::uint32_t>(std::ranges::distance(values.begin(), std::ranges::unique(values).begin()));
+    };
+    topology.packages = CountDistinct(Packages);
+    topology.physicalCores = CountDistinct(Cores);
+    topology.numaNodes = CountDistinct(Nodes);
+    topology.logicalCpus = static_cast<std::uint32_t>(topology.cpus.size());
+    std::ranges::sort(topology.caches, {}, [](const CpuCacheInfo& cache) {
+        return std::tie(cache.level, cache.type, cache.cpus);
+    });
+}
+
+// Matches `c` against the [set] opening at pattern[open]; returns the index past its ']', npos when the set is
+// not terminated (the '[' is then an ordinary character)
+std::size_t MatchSet(std::string_view pattern, std::size_t open, char c, bool& matched) noexcept {
+    auto I = open + 1;
+    bool const Negated = I < pattern.size() && (pattern[I] == '!' || pattern[I] == '^');
+    if (Negated) {
+        ++I;
+    }
+    matched = false;
+    for (auto const First = I; I < pattern.size() && (pattern[I] != ']' || I == First); ++I) {
+        if (I + 2 < pattern.size() && pattern[I + 1] == '-' && pattern[I + 2] != ']') {
+            matched = matched || (pattern[I] <= c && c <= pattern[I + 2]);
+            I += 2;
+        } else {
+            matched = matched || pattern[I] == c;
+        }
+    }
+    if (I >= pattern.size()) {
+        return std::string_view::npos;
+    }
+    matched = matched != Negated;
+    return I + 1;
+}
+
+// Shell glob over the whole name; a mismatch after a '*' retries with the star covering one more character
+bool GlobMatch(std::string_view pattern, std::string_view name) noexcept {
+    constexpr auto NONE = std::string_view::npos;
+    std::size_t P = 0;
+    std::size_t N = 0;
+    std::size_t AfterStar = NONE;
+    std::size_t StarName = 0;
+    while (N < name.size()) {
+        if (P < pattern.size() && pattern[P] == '*') {
+            AfterStar = ++P;
+            StarName = N;
+            continue;
+        }
+
+        auto Next = NONE;
+        if (P < pattern.size()) {
+            bool Matched = false;
+            auto const SetEnd = pattern[P] == '[' ? MatchSet(pattern, P, name[N], Matched) : NONE;
+            if (SetEnd != NONE) {
+                Next = Matched ? SetEnd : NONE;
+            } else if (pattern[P] == '?' || pattern[P] == name[N]) {
+                Next = P + 1;
+            }
+        }
+        if (Next != NONE) {
+            P = Next;
+            ++N;
+        } else if (AfterStar != NONE) {
+            P = AfterStar;
+            N = ++StarName;
+        } else {
+            return false;
+        }
+    }
+    while (P < pattern.size() && pattern[P] == '*') {
+        ++P;
+    }
+    return P == pattern.size();
+}
+
+// Cumulative counters of one device as the platform reports them, in common units
+struct DiskCounters {
+    std::uint64_t reads{};
+    std::uint64_t writes{};
+    std::uint64_t readBytes{};
+    std::uint64_t writeBytes{};
+    std::uint64_t busyUs{};   // time with at least one request in flight
+    std::uint64_t queueUs{};  // time summed over every request in flight, so its rate is the average queue
+};
+
+struct NetworkCounters {
+    std::uint64_t rxBytes{};
+    std::uint64_t txBytes{};
+    std::uint64_t rxPackets{};
+    std::uint64_t txPackets{};
+    std::uint64_t errors{};
+    std::uint64_t drops{};
+};
+
+// Per-second rate of a cumulative counter; keeps the previous rate when the counter went backwards (a device
+// reset, a replay wrapping around), as the cpu usage does
+void UpdateRate(double& rate, std::uint64_t before, std::uint64_t after, double seconds) noexcept {
+    if (after >= before) {
+        rate = static_cast<double>(after - before) / seconds;
+    }
+}
+
+void ApplyRates(const DiskCounters& before, const DiskCounters& after, double seconds, DiskDeviceData& disk) {
+    constexpr double MICROS_PER_SECOND = 1e6;
+    UpdateRate(disk.readsPerSec, before.reads, after.reads, seconds);
+    UpdateRate(disk.writesPerSec, before.writes, after.writes, seconds);
+    UpdateRate(disk.readBytesPerSec, before.readBytes, after.readBytes, seconds);
+    UpdateRate(disk.writeBytesPerSec, before.writeBytes, after.writeBytes, seconds);
+    UpdateRate(disk.queueDepth, before.queueUs, after.queueUs, seconds * MICROS_PER_SECOND);
+    UpdateRate(disk.utilization, before.busyUs, after.busyUs, seconds * MICROS_PER_SECOND / 100.0);
+    disk.utilization = std::min(disk.utilization, 100.0);
+}
+
+void ApplyRates(const NetworkCounters& before,
+                const NetworkCounters& after,
+                double seconds,
+                NetworkInterfaceData& nic) {
+    UpdateRate(nic.rxBytesPerSec, before.rxBytes, after.rxBytes, seconds);
+    UpdateRate(nic.txBytesPerSec, before.txBytes, after.txBytes, seconds);
+    UpdateRate(nic.rxPacketsPerSec, before.rxPackets, after.rxPackets, seconds);
+    UpdateRate(nic.txPacketsPerSec, before.txPackets, after.txPackets, seconds);
+    UpdateRate(nic.errorsPerSec, before.errors, after.errors, seconds);
+    UpdateRate(nic.dropsPerSec, before.drops, after.drops, seconds);
+}
+
+// Devices of one collector by name, with the counters of the previous sample. Sources list devices in the
+// same order every time, so the slot after the last match is tried first and only a new or vanished device
+// costs a scan. The filter runs once per name; excluded devices keep a slot so they are not filtered again.
+template <typename Counters, typename Data>
+class DeviceTable {
+public:
+    struct Slot {
+        Data data{};  // name and latest rates
+        Counters previous{};
+        bool included = false;
+        bool primed = false;     // previous holds a sample
+        std::uint64_t seen = 0;  // last sample that listed the device
+    };
+
+    // Starts a sample read at `now`; returns the seconds since the previous one, 0 for the first
+    double Begin(std::chrono::system_clock::time_point now) noexcept {
+        auto const Seconds = generation_ == 0 ? 0.0 : std::chrono::duration<double>(now - previous_).count();
+        ++generation_;
+        previous_ = now;
+        cursor_ = 0;
+        return Seconds;
+    }
+
+    // Slot of `name`, or nullptr when the filter excludes it
+    Slot* Find(std::string_view name, const DeviceFilter& filter) {
+        auto Index = cursor_;
+        if (Index >= slots_.size() || slots_[Index].data.name != name) {
+            auto const Found =
+                std::ranges::find_if(slots_, [name](const Slot& slot) { return slot.data.name == name; });
+            Index = static_cast<std::size_t>(Found - slots_.begin());
+            if (Found == slots_.end()) {
+                auto& Added = slots_.emplace_back();
+                Added.data.name = name;
+                Added.included = filter.Matches(name);
+            }
+        }
+        cursor_ = Index + 1;
+        auto& Found = slots_[Index];
+        Found.seen = generation_;
+        return Found.included ? &Found : nullptr;
+    }
+
+    static void Update(Slot& slot, const Counters& current, double seconds) {
+        if (slot.primed && seconds > 0.0) {
+            ApplyRates(slot.previous, current, seconds, slot.data);
+        }
+        slot.previous = current;
+        slot.primed = true;
+    }
+
+    // Forgets devices this sample did not list and returns the included ones in source order
+    std::vector<Data> Finish() {
+        auto const Stale = [this](const Slot& slot) { return slot.seen != generation_; };
+        if (std::ranges::any_of(slots_, Stale)) {
+            std::erase_if(slots_, Stale);
+        }
+        std::vector<Data> Devices;
+        for (const auto& Slot : slots_) {
+            if (Slot.included) {
+                Devices.push_back(Slot.data);
+            }
+        }
+        return Devices;
+    }
+
+    void Clear() noexcept {
+        slots_.clear();
+        cursor_ = 0;
+        generation_ = 0;
+    }
+
+private:
+    std::vector<Slot> slots_;
+    std::size_t cursor_ = 0;
+    std::uint64_t generation_ = 0;
+    std::chrono::system_clock::time_point previous_{};
+};
+
+using DiskTable = DeviceTable<DiskCounters, DiskDeviceData>;
+using NetworkTable = DeviceTable<NetworkCounters, NetworkInterfaceData>;
+}  // namespace
+
+// DeviceFilter implementation
+bool DeviceFilter::Matches(std::string_view name) const {
+    auto const Matching = [name](const std::string& pattern) { return GlobMatch(pattern, name); };
+    return !std::ranges::any_of(exclude, Matching) && (include.empty() || std::ranges::any_of(include, Matching));
+}
+
+DeviceFilter DeviceFilter::Parse(std::string_view spec) {
+    DeviceFilter Filter;
+    while (!spec.empty()) {
+        auto const Comma = spec.find(',');
+        auto Pattern = spec.substr(0, Comma);
+        spec.remove_prefix(Comma == std::string_view::npos ? spec.size() : Comma + 1);
+
+        auto const First = Pattern.find_first_not_of(' ');
+        Pattern = First == std::string_view::npos ? std::string_view{} : Pattern.substr(First);
+        Pattern = Pattern.substr(0, Pattern.find_last_not_of(' ') + 1);
+        if (Pattern.starts_with('!')) {
+            Filter.exclude.emplace_back(Pattern.substr(1));
+        } else if (!Pattern.empty()) {
+            Filter.include.emplace_back(Pattern);
+        }
+    }
+    return Filter;
+}
+
+DeviceFilter DeviceFilter::DefaultDisks() {
+    return DeviceFilter{.include = {},
+                        .exclude = {"loop*",
+                                    "ram*",
+                                    "zram*",
+                                    "sr*",
+                                    "fd*",
+                                    "[hsv]d*[0-9]",
+                                    "xvd*[0-9]",
+                                    "nvme*p[0-9]*",
+                                    "mmcblk*p[0-9]*"}};
+}
+
+DeviceFilter DeviceFilter::DefaultNetwork() {
+    return DeviceFilter{
+        .include = {},
+        .exclude = {"lo", "veth*", "docker*", "br-*", "virbr*", "cali*", "flannel*", "cni*", "lxc*"}};
+}
+
+#if defined(_WIN32)
+namespace {
+// Layout of CallNtPowerInformation(ProcessorInformation) entries, which the SDK headers do not declare
+struct ProcessorPowerInformation {
+    ULONG number;
+    ULONG maxMhz;
+    ULONG currentMhz;
+    ULONG mhzLimit;
+    ULONG maxIdleState;
+    ULONG currentIdleState;
+};
+
+// Logical processor ids of an affinity mask, numbered across groups of 64
+void AppendMaskCpus(const GROUP_AFFINITY& mask, std::vector<std::uint32_t>& cpus) {
+    for (std::uint32_t Bit = 0; Bit < 64; ++Bit) {
+        if ((mask.Mask >> Bit) & 1U) {
+            cpus.push_back((static_cast<std::uint32_t>(mask.Group) * 64) + Bit);
+        }
+    }
+}
+
+// UTF-8 of a wide interface alias, into a reused string
+void AssignUtf8(std::string& out, const wchar_t* value) {
+    auto const Size = WideCharToMultiByte(CP_UTF8, 0, value, -1, nullptr, 0, nullptr, nullptr);
+    out.resize(Size > 0 ? static_cast<std::size_t>(Size) : 1);
+    WideCharToMultiByte(CP_UTF8, 0, value, -1, out.data(), Size, nullptr, nullptr);
+    out.pop_back();  // the terminator
+}
+
+std::string CacheTypeName(PROCESSOR_CACHE_TYPE type) {
+    switch (type) {
+        case CacheData:
+            return "data";
+        case CacheInstruction:
+            return "instruction";
+        case CacheTrace:
+            return "trace";
+        default:
+            return "unified";
+    }
+}
+}  // namespace
+
 class SystemMonitor::Impl {
 public:
     PDH_HQUERY cpuQuery = nullptr;
     PDH_HCOUNTER cpuTotal = nullptr;
     std::vector<PDH_HCOUNTER> cpuCores;
+    std::vector<double> frequencies;               // reused scratch for the average
+    std::vector<ProcessorPowerInformation> power;  // one entry per logical processor, filled every sample
+    std::uint64_t fallbackFrequency = 2400;        // MHz, from the registry when power information fails
+    CpuTopology topology;
+    DeviceFilter diskFilter = DeviceFilter::DefaultDisks();
+    DeviceFilter networkFilter = DeviceFilter::DefaultNetwork();
+    std::vector<std::pair<std::string, HANDLE>> diskHandles;  // "PhysicalDriveN", opened once by Initialize()
+    DiskTable disks;
+    NetworkTable interfaces;
+    std::string aliasScratch;
     bool initialized = false;
+    bool hasBackend = false;
 
-    Impl() = default;
+    explicit Impl(std::unique_ptr<CollectorBackend> backend) : hasBackend(backend != nullptr) {}
 
     ~Impl() {
         Cleanup();
     }
 
     Result<void> Initialize() {
+        // Captures hold procfs text, which only the Linux collector parses
+        if (hasBackend) {
+            return std::unexpected(SystemError::INITIALIZATION_FAILED);
+        }
+
         // Initialize PDH for CPU monitoring
         if (PdhOpenQuery(nullptr, 0, &cpuQuery) != ERROR_SUCCESS) {
             return std::unexpected(SystemError::INITIALIZATION_FAILED);
@@ -54,8 +402,15 @@ public:
             }
         }
 
-        // Collect first sample (required for PDH)
+        power.resize(SysInfo.dwNumberOfProcessors);
+        fallbackFrequency = ReadRegistryFrequency();
+        topology = ReadTopology();
+        OpenDisks();
+
+        // Collect first sample (required for PDH), and the disk and interface counters to take deltas from
         PdhCollectQueryData(cpuQuery);
+        (void)GetDiskStats();
+        (void)GetNetworkStats();
         std::this_thread::sleep_for(std::chrono::milliseconds{100});
 
         initialized = true;
@@ -82,9 +437,48 @@ public:
         }
         Stats.memory = *MemResult;
 
+        if (auto Disks = GetDiskStats()) {
+            Stats.disks = std::move(*Disks);
+        }
+        if (auto Network = GetNetworkStats()) {
+            Stats.network = std::move(*Network);
+        }
+
         return Stats;
     }
 
+    [[nodiscard]] std::chrono::system_clock::time_point Now() const {
+        return std::chrono::system_clock::now();
+    }
+
+    Result<CPUUsageData> SampleCpu() {
+        if (!initialized) {
+            return std::unexpected(SystemError::INITIALIZATION_FAILED);
+        }
+        return GetCpuStats();
+    }
+
+    Result<MemoryUsageData> SampleMemory() {
+        if (!initialized) {
+            return std::unexpected(SystemError::INITIALIZATION_FAILED);
+        }
+        return GetMemoryStats();
+    }
+
+    Result<std::vector<DiskDeviceData>> SampleDisks() {
+        if (!initialized) {
+            return std::unexpected(SystemError::INITIALIZATION_FAILED);
+        }
+        return GetDiskStats();
+    }
+
+    Result<std::vector<NetworkInterfaceData>> SampleNetwork() {
+        if (!initialized) {
+            return std::unexpected(SystemError::INITIALIZATION_FAILED);
+        }
+        return GetNetworkStats();
+    }
+
 private:
     void Cleanup() {
         if (cpuQuery != nullptr) {
@@ -92,9 +486,110 @@ private:
             cpuQuery = nullptr;
         }
         cpuCores.clear();
+        topology = {};
+        for (auto& [Name, Handle] : diskHandles) {
+            CloseHandle(Handle);
+        }
+        diskHandles.clear();
+        disks.Clear();
+        interfaces.Clear();
         initialized = false;
     }
 
+    // Keeps a handle on every physical drive the filter selects; opened without read or write access, which
+    // is all the performance query needs
+    void OpenDisks() {
+        constexpr DWORD MAX_DRIVES = 64;
+        for (DWORD Drive = 0; Drive < MAX_DRIVES; ++Drive) {
+            auto Name = std::format("PhysicalDrive{}", Drive);
+            if (!diskFilter.Matches(Name)) {
+                continue;
+            }
+            auto const Path = std::format(L"\\\\.\\PhysicalDrive{}", Drive);
+            HANDLE const Handle = CreateFileW(
+                Path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, 0, nullptr);
+            if (Handle != INVALID_HANDLE_VALUE) {
+                diskHandles.emplace_back(std::move(Name), Handle);
+            }
+        }
+    }
+
+    // Times in DISK_PERFORMANCE are 100 ns units; idle time against the query clock gives the busy time
+    Result<std::vector<DiskDeviceData>> GetDiskStats() {
+        if (diskHandles.empty()) {
+            return std::unexpected(SystemError::DATA_UNAVAILABLE);
+        }
+
+        constexpr std::uint64_t TICKS_PER_MICROSECOND = 10;
+        auto const Seconds = disks.Begin(std::chrono::system_clock::now());
+        for (const auto& [Name, Handle] : diskHandles) {
+            DISK_PERFORMANCE Performance{};
+            DWORD Returned = 0;
+            if (DeviceIoControl(Handle,
+                                IOCTL_DISK_PERFORMANCE,
+                                nullptr,
+                                0,
+                                &Performance,
+                                sizeof(Performance),
+                                &Returned,
+                                nullptr) == 0) {
+                continue;
+            }
+            auto* Slot = disks.Find(Name, diskFilter);
+            if (Slot == nullptr) {
+                continue;
+            }
+            auto const Ticks = [](const LARGE_INTEGER& value) {
+                return static_cast<std::uint64_t>(std::max<LONGLONG>(value.QuadPart, 0));
+            };
+            auto const Busy = Ticks(Performance.QueryTime) - std::min(Ticks(Performance.IdleTime),
+                                                                       Ticks(Performance.QueryTime));
+            DiskTable::Update(*Slot,
+                              DiskCounters{.reads = Performance.ReadCount,
+                                           .writes = Performance.WriteCount,
+                                           .readBytes = Ticks(Performance.BytesRead),
+                                           .writeBytes = Ticks(Performance.BytesWritten),
+                                           .busyUs = Busy / TICKS_PER_MICROSECOND,
+                                           .queueUs = (Ticks(Performance.ReadTime) + Ticks(Performance.WriteTime)) /
+                                                      TICKS_PER_MICROSECOND},
+                              Seconds);
+        }
+        return disks.Finish();
+    }
+
+    // Hardware interfaces from one GetIfTable2 call, named by their alias ("Ethernet", "Wi-Fi"); filter
+    // drivers and virtual adapters show up as extra rows over the same traffic, so they are skipped
+    Result<std::vector<NetworkInterfaceData>> GetNetworkStats() {
+        PMIB_IF_TABLE2 Table = nullptr;
+        if (GetIfTable2(&Table) != NO_ERROR) {
+            return std::unexpected(SystemError::DATA_UNAVAILABLE);
+        }
+
+        auto const Seconds = interfaces.Begin(std::chrono::system_clock::now());
+        for (ULONG I = 0; I < Table->NumEntries; ++I) {
+            const auto& Row = Table->Table[I];
+            if (Row.Type == IF_TYPE_SOFTWARE_LOOPBACK || Row.InterfaceAndOperStatusFlags.FilterInterface ||
+                !Row.InterfaceAndOperStatusFlags.HardwareInterface) {
+                continue;
+            }
+            AssignUtf8(aliasScratch, Row.Alias);
+            auto* Slot = interfaces.Find(aliasScratch, networkFilter);
+            if (Slot == nullptr) {
+                continue;
+            }
+            NetworkTable::Update(*Slot,
+                                 NetworkCounters{.rxBytes = Row.InOctets,
+                                                 .txBytes = Row.OutOctets,
+                                                 .rxPackets = Row.InUcastPkts + Row.InNUcastPkts,
+                                                 .txPackets = Row.OutUcastPkts + Row.OutNUcastPkts,
+                                                 .errors = Row.InErrors + Row.OutErrors,
+                                                 .drops = Row.InDiscards + Row.OutDiscards},
+                                 Seconds);
+        }
+        FreeMibTable(Table);
+        return interfaces.Finish();
+    }
+
     Result<CPUUsageData> GetCpuStats() {
         // Collect query data
         if (PdhCollectQueryData(cpuQuery) != ERROR_SUCCESS) {
@@ -109,22 +604,28 @@ private:
             CpuData.overall = std::clamp(CounterVal.doubleValue, 0.0, 100.0);
         }
 
-        // Get individual core usage
+        // One call reports the current clock of every logical processor
+        auto const PowerBytes = static_cast<ULONG>(power.size() * sizeof(ProcessorPowerInformation));
+        bool const HasPower =
+            !power.empty() && CallNtPowerInformation(ProcessorInformation, nullptr, 0, power.data(), PowerBytes) == 0;
+
+        // Get individual core usage; frequencies are also gathered contiguously for the average
         CpuData.cores.reserve(cpuCores.size());
+        frequencies.clear();
         for (std::size_t I = 0; I < cpuCores.size(); ++I) {
             if (PdhGetFormattedCounterValue(cpuCores[I], PDH_FMT_DOUBLE, nullptr, &CounterVal) == ERROR_SUCCESS) {
                 CPUCoreData CoreData{.coreId = static_cast<std::uint32_t>(I),
                                      .usage = std::clamp(CounterVal.doubleValue, 0.0, 100.0),
-                                     .frequency = GetCoreFrequency(I)};
+                                     .frequency = HasPower && I < power.size() && power[I].currentMhz != 0
+                                                      ? std::uint64_t{power[I].currentMhz}
+                                                      : fallbackFrequency};
+                frequencies.push_back(static_cast<double>(CoreData.frequency));
                 CpuData.cores.push_back(std::move(CoreData));
             }
         }
 
         // Calculate average frequency
-        if (!CpuData.cores.empty()) {
-            auto Frequencies = CpuData.cores | std::views::transform([](const auto& core) { return core.frequency; });
-            CpuData.averageFrequency = static_cast<std::uint64_t>(utils::Average(Frequencies));
-        }
+        CpuData.averageFrequency = static_cast<std::uint64_t>(simd::Mean(frequencies));
 
         // Try to get CPU temperature (optional)
         CpuData.temperature = GetCpuTemperature();
@@ -140,25 +641,37 @@ private:
             return std::unexpected(SystemError::DATA_UNAVAILABLE);
         }
 
-        // Get more detailed memory info
-        // PROCESS_MEMORY_COUNTERS_EX pmc;  // Reserved for future use
-        // HANDLE hProcess = GetCurrentProcess();  // Reserved for future use
-
+        // dwMemoryLoad is rounded to whole percents, so the share is computed from the byte counts instead.
+        // The commit charge beyond physical memory is what the page file holds.
+        auto const Used = MemStatus.ullTotalPhys - MemStatus.ullAvailPhys;
+        auto const PageFile = MemStatus.ullTotalPageFile - std::min(MemStatus.ullTotalPageFile, MemStatus.ullTotalPhys);
+        auto const Committed = MemStatus.ullTotalPageFile - MemStatus.ullAvailPageFile;
         MemoryUsageData MemData{.total = MemStatus.ullTotalPhys,
-                                .used = MemStatus.ullTotalPhys - MemStatus.ullAvailPhys,
+                                .used = Used,
                                 .available = MemStatus.ullAvailPhys,
-                                .cache = 0,    // Windows doesn't easily expose cache info
-                                .buffers = 0,  // Windows doesn't easily expose buffer info
-                                .usagePercent = static_cast<double>(MemStatus.dwMemoryLoad)};
+                                .cache = 0,
+                                .buffers = 0,  // Windows has no separate buffer cache
+                                .usagePercent = MemStatus.ullTotalPhys == 0
+                                                    ? 0.0
+                                                    : 100.0 * static_cast<double>(Used) /
+                                                          static_cast<double>(MemStatus.ullTotalPhys),
+                                .swapTotal = PageFile,
+                                .swapUsed = std::min(PageFile, Committed - std::min(Committed, Used))};
 
-        // Try to get cache information from performance counters
-        MemData.cache = GetCacheSize();
+        // System file cache and kernel pools, in pages
+        PERFORMANCE_INFORMATION Performance{};
+        Performance.cb = sizeof(Performance);
+        if (GetPerformanceInfo(&Performance, sizeof(Performance)) != 0) {
+            MemData.cache = static_cast<std::uint64_t>(Performance.SystemCache) * Performance.PageSize;
+            MemData.slab = static_cast<std::uint64_t>(Performance.KernelPaged + Performance.KernelNonpaged) *
+                           Performance.PageSize;
+        }
 
         return MemData;
     }
 
-    static std::uint64_t GetCoreFrequency(std::size_t /* coreIndex */) {
-        // Try to get processor frequency - simplified implementation
+    // Nominal clock of the first processor, read once
+    static std::uint64_t ReadRegistryFrequency() {
         HKEY HKey = nullptr;
         if (RegOpenKeyExW(
                 HKEY_LOCAL_MACHINE, L"HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0", 0, KEY_READ, &HKey) ==
@@ -183,32 +696,906 @@ private:
         return std::nullopt;
     }
 
-    static std::uint64_t GetCacheSize() {
-        // Get cache size from system info - simplified
+    // Packages, cores, NUMA nodes and caches from one GetLogicalProcessorInformationEx call
+    static CpuTopology ReadTopology() {
         DWORD BufferSize = 0;
-        GetLogicalProcessorInformation(nullptr, &BufferSize);
+        GetLogicalProcessorInformationEx(RelationAll, nullptr, &BufferSize);
+        std::vector<std::byte> Buffer(BufferSize);
+        auto* const First = reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(Buffer.data());
+        CpuTopology Topology;
+        if (BufferSize == 0 || GetLogicalProcessorInformationEx(RelationAll, First, &BufferSize) == 0) {
+            return Topology;
+        }
 
-        if (BufferSize > 0) {
-            std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> Buffer(BufferSize /
-                                                                     sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+        struct Group {
+            std::uint32_t id;
+            std::vector<std::uint32_t> cpus;
+        };
+        std::vector<Group> Packages;
+        std::vector<Group> Cores;
+        std::vector<Group> Nodes;
+        std::vector<std::uint32_t> Cpus;
+        for (DWORD Offset = 0; Offset < BufferSize;) {
+            const auto& Info =
+                *reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(Buffer.data() + Offset);
+            Offset += Info.Size;
 
-            if (GetLogicalProcessorInformation(Buffer.data(), &BufferSize) != 0) {
-                std::uint64_t TotalCache = 0;
-                for (const auto& Info : Buffer) {
-                    if (Info.Relationship == RelationCache) {
-                        TotalCache += Info.Cache.Size;
+            Cpus.clear();
+            switch (Info.Relationship) {
+                case RelationProcessorPackage:
+                case RelationProcessorCore:
+                    for (WORD I = 0; I < Info.Processor.GroupCount; ++I) {
+                        AppendMaskCpus(Info.Processor.GroupMask[I], Cpus);
+                    }
+                    if (Info.Relationship == RelationProcessorPackage) {
+                        Packages.push_back({static_cast<std::uint32_t>(Packages.size()), Cpus});
+                    } else {
+                        Cores.push_back({static_cast<std::uint32_t>(Cores.size()), Cpus});
                     }
+                    break;
+                case RelationNumaNode:
+                    AppendMaskCpus(Info.NumaNode.GroupMask, Cpus);
+                    Nodes.push_back({Info.NumaNode.NodeNumber, Cpus});
+                    break;
+                case RelationCache:
+                    AppendMaskCpus(Info.Cache.GroupMask, Cpus);
+                    Topology.caches.push_back(CpuCacheInfo{.level = Info.Cache.Level,
+                                                           .type = CacheTypeName(Info.Cache.Type),
+                                                           .size = Info.Cache.CacheSize,
+                                                           .lineSize = Info.Cache.LineSize,
+                                                           .cpus = Cpus});
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // Core ids restart in every package, as on Linux
+        auto const Owner = [](const std::vector<Group>& groups, std::uint32_t cpu) -> const Group* {
+            auto const Found = std::ranges::find_if(
+                groups, [cpu](const Group& group) { return std::ranges::contains(group.cpus, cpu); });
+            return Found != groups.end() ? &*Found : nullptr;
+        };
+        std::vector<std::uint32_t> CoresInPackage(Packages.size(), 0);
+        for (const auto& Core : Cores) {
+            if (Core.cpus.empty()) {
+                continue;
+            }
+            const auto* Package = Owner(Packages, Core.cpus.front());
+            const auto* Node = Owner(Nodes, Core.cpus.front());
+            auto const CoreId = Package != nullptr ? CoresInPackage[Package->id]++ : Core.id;
+            for (auto const Cpu : Core.cpus) {
+                Topology.cpus.push_back(LogicalCpuInfo{.cpuId = Cpu,
+                                                       .package = Package != nullptr ? Package->id : 0,
+                                                       .core = CoreId,
+                                                       .node = Node != nullptr ? Node->id : 0,
+                                                       .siblings = Core.cpus});
+            }
+        }
+        std::ranges::sort(Topology.cpus, {}, &LogicalCpuInfo::cpuId);
+        SummarizeTopology(Topology);
+        return Topology;
+    }
+};
+
+#elif defined(__linux__)
+namespace {
+
+using procfs::NextLine;
+using procfs::NextUnsigned;
+
+struct CpuTimes {
+    std::uint64_t total{};  // jiffies
+    std::uint64_t idle{};   // idle + iowait jiffies
+};
+
+constexpr std::int64_t AGGREGATE_CPU = -1;
+
+// Parses a "cpu[N] user nice system idle iowait irq softirq steal ..." line of /proc/stat.
+// Returns the cpu id (AGGREGATE_CPU for the summary line) or nullopt when line is not a cpu line.
+std::optional<std::int64_t> ParseCpuLine(std::string_view line, CpuTimes& times) noexcept {
+    if (!line.starts_with("cpu")) {
+        return std::nullopt;
+    }
+    line.remove_prefix(3);
+
+    std::int64_t CpuId = AGGREGATE_CPU;
+    if (!line.empty() && line.front() != ' ' && !NextUnsigned(line, CpuId)) {
+        return std::nullopt;
+    }
+
+    // guest and guest_nice are already accounted in user and nice, so only the first 8 fields count
+    constexpr std::size_t FIELD_COUNT = 8;
+    constexpr std::size_t IDLE_FIELD = 3;
+    constexpr std::size_t IOWAIT_FIELD = 4;
+
+    times = {};
+    for (std::size_t Field = 0; Field < FIELD_COUNT; ++Field) {
+        std::uint64_t Value = 0;
+        if (!NextUnsigned(line, Value)) {
+            break;
+        }
+        times.total += Value;
+        if (Field == IDLE_FIELD || Field == IOWAIT_FIELD) {
+            times.idle += Value;
+        }
+    }
+    return CpuId;
+}
+
+// Next blank-separated token, advancing past it
+std::string_view NextWord(std::string_view& text) noexcept {
+    auto const Start = text.find_first_not_of(" \t");
+    text.remove_prefix(Start == std::string_view::npos ? text.size() : Start);
+    auto const End = std::min(text.find_first_of(" \t"), text.size());
+    auto const Word = text.substr(0, End);
+    text.remove_prefix(End);
+    return Word;
+}
+
+// Kernel cpu list notation, e.g. "0-3,8,10-11"
+std::vector<std::uint32_t> ParseCpuList(std::string_view text) {
+    std::vector<std::uint32_t> Cpus;
+    while (!text.empty()) {
+        auto const Comma = text.find(',');
+        auto Item = text.substr(0, Comma);
+        text.remove_prefix(Comma == std::string_view::npos ? text.size() : Comma + 1);
+
+        std::uint32_t First = 0;
+        if (!NextUnsigned(Item, First)) {
+            continue;
+        }
+        std::uint32_t Last = First;
+        if (Item.starts_with('-')) {
+            Item.remove_prefix(1);
+            NextUnsigned(Item, Last);
+        }
+        for (auto Cpu = First; Cpu <= Last; ++Cpu) {
+            Cpus.push_back(Cpu);
+        }
+    }
+    return Cpus;
+}
+
+// "cache <level> <type> <size> <line size> <cpu list>" of the CPU_TOPOLOGY text; sizes carry a K/M/G suffix
+std::optional<CpuCacheInfo> ParseCacheLine(std::string_view line) {
+    CpuCacheInfo Cache;
+    if (!NextUnsigned(line, Cache.level)) {
+        return std::nullopt;
+    }
+    for (char const Char : NextWord(line)) {
+        Cache.type += static_cast<char>(Char >= 'A' && Char <= 'Z' ? Char - 'A' + 'a' : Char);
+    }
+
+    auto Size = NextWord(line);
+    if (!NextUnsigned(Size, Cache.size)) {
+        return std::nullopt;
+    }
+    constexpr std::uint64_t KIB = 1024;
+    if (Size.starts_with('K')) {
+        Cache.size *= KIB;
+    } else if (Size.starts_with('M')) {
+        Cache.size *= KIB * KIB;
+    } else if (Size.starts_with('G')) {
+        Cache.size *= KIB * KIB * KIB;
+    }
+
+    NextUnsigned(line, Cache.lineSize);
+    Cache.cpus = ParseCpuList(NextWord(line));
+    return Cache;
+}
+
+// The /proc/meminfo fields the collector keeps
+enum MeminfoField : std::uint8_t {
+    MEMINFO_TOTAL,
+    MEMINFO_AVAILABLE,
+    MEMINFO_BUFFERS,
+    MEMINFO_CACHED,
+    MEMINFO_SLAB,
+    MEMINFO_DIRTY,
+    MEMINFO_WRITEBACK,
+    MEMINFO_SWAP_TOTAL,
+    MEMINFO_SWAP_FREE,
+    MEMINFO_HUGE_PAGES_TOTAL,
+    MEMINFO_HUGE_PAGES_FREE,
+    MEMINFO_HUGE_PAGE_SIZE,
+    MEMINFO_FIELDS
+};
+
+constexpr std::array<std::string_view, MEMINFO_FIELDS> MEMINFO_KEYS{"MemTotal",
+                                                                    "MemAvailable",
+                                                                    "Buffers",
+                                                                    "Cached",
+                                                                    "Slab",
+                                                                    "Dirty",
+                                                                    "Writeback",
+                                                                    "SwapTotal",
+                                                                    "SwapFree",
+                                                                    "HugePages_Total",
+                                                                    "HugePages_Free",
+                                                                    "Hugepagesize"};
+
+using MeminfoValues = std::array<std::uint64_t, MEMINFO_FIELDS>;
+
+// Which line of /proc/meminfo holds which field. The kernel prints a fixed list of lines, so the layout is
+// learned on the first read and later reads only skip to the wanted lines and parse their numbers. Byte
+// offsets would not do: the columns widen once a value passes eight digits.
+class MeminfoLayout {
+public:
+    // Fields missing from this kernel read as 0; false when the text has no MemTotal
+    bool Parse(std::string_view text, MeminfoValues& values) {
+        if (fieldByLine_.empty() || !ParseKnown(text, values)) {
+            Learn(text);
+            return ParseKnown(text, values);
+        }
+        return true;
+    }
+
+private:
+    // Checks every wanted line still starts with its key, which is all it takes to notice a different layout
+    // (a capture from another kernel)
+    bool ParseKnown(std::string_view text, MeminfoValues& values) const {
+        values = {};
+        for (auto const Field : fieldByLine_) {
+            auto Line = procfs::NextLine(text);
+            if (Field == MEMINFO_FIELDS) {
+                continue;
+            }
+            auto const Key = MEMINFO_KEYS[Field];
+            if (!Line.starts_with(Key) || Line.size() == Key.size() || Line[Key.size()] != ':') {
+                return false;
+            }
+            Line.remove_prefix(Key.size() + 1);
+            procfs::NextUnsigned(Line, values[Field]);
+        }
+        return !fieldByLine_.empty();
+    }
+
+    void Learn(std::string_view text) {
+        fieldByLine_.clear();
+        std::size_t LastWanted = 0;
+        while (!text.empty()) {
+            auto const Line = procfs::NextLine(text);
+            auto const Key = Line.substr(0, Line.find(':'));
+            auto const Found = std::ranges::find(MEMINFO_KEYS, Key);
+            fieldByLine_.push_back(static_cast<MeminfoField>(Found - MEMINFO_KEYS.begin()));
+            if (Found != MEMINFO_KEYS.end()) {
+                LastWanted = fieldByLine_.size();
+            }
+        }
+        fieldByLine_.resize(LastWanted);
+    }
+
+    std::vector<MeminfoField> fieldByLine_;  // MEMINFO_FIELDS for lines that are skipped
+};
+
+// "some avg10=0.12 avg60=0.05 avg300=0.01 total=123456" and the same for "full", as in /proc/pressure/*
+bool ParsePressure(std::string_view text, ResourcePressure& pressure) {
+    auto const ParseLine = [](std::string_view line, PressureStall& stall) {
+        std::array<double*, 3> const Averages{&stall.avg10, &stall.avg60, &stall.avg300};
+        for (auto* Average : Averages) {
+            auto const Equals = line.find('=');
+            if (Equals == std::string_view::npos) {
+                return false;
+            }
+            line.remove_prefix(Equals + 1);
+            auto const Parsed = std::from_chars(line.data(), line.data() + line.size(), *Average);
+            if (Parsed.ec != std::errc{}) {
+                return false;
+            }
+            line.remove_prefix(static_cast<std::size_t>(Parsed.ptr - line.data()));
+        }
+        auto const Equals = line.find('=');
+        line.remove_prefix(Equals == std::string_view::npos ? line.size() : Equals + 1);
+        return procfs::NextUnsigned(line, stall.total);
+    };
+
+    bool HasSome = false;
+    pressure.full.reset();
+    while (!text.empty()) {
+        auto Line = procfs::NextLine(text);
+        if (Line.starts_with("some ")) {
+            HasSome = ParseLine(Line, pressure.some);
+        } else if (Line.starts_with("full ")) {
+            if (PressureStall Full; ParseLine(Line, Full)) {
+                pressure.full = Full;
+            }
+        }
+    }
+    return HasSome;
+}
+
+// Busy percentage between two samples; keeps the previous value when no jiffy has elapsed
+double UsageFromDelta(const CpuTimes& previous, const CpuTimes& current, double lastUsage) noexcept {
+    if (current.total <= previous.total) {
+        return lastUsage;
+    }
+    auto const Total = static_cast<double>(current.total - previous.total);
+    auto const Idle = static_cast<double>(current.idle >= previous.idle ? current.idle - previous.idle : 0);
+    return std::clamp(100.0 * (1.0 - (Idle / Total)), 0.0, 100.0);
+}
+
+}  // namespace
+
+class SystemMonitor::Impl {
+public:
+    struct CoreSlot {
+        std::uint32_t cpuId{};
+        CpuTimes previous{};
+        double usage{};
+        std::uint64_t fallbackFrequency{};    // MHz, used when cpufreq is not exposed (VMs, containers)
+        std::int32_t temperatureSensor = -1;  // THERMAL_SENSORS line of the physical core, -1 without one
+    };
+
+    // A cpu package with at least one temperature sensor
+    struct PackageSlot {
+        std::uint32_t package{};
+        std::int32_t sensor = -1;              // package sensor, -1 when only its cores report
+        std::optional<double> critical{};      // Celsius
+        double peakFrequency{};                // highest mean MHz seen so far, the reference for throttling
+        std::vector<std::size_t> coreSlots{};  // slots of the package's logical cpus
+    };
+
+    std::unique_ptr<CollectorBackend> backend;
+    std::vector<char> statBuffer;  // sized once for the cpu lines of /proc/stat
+    CpuTimes previousTotal{};
+    double overallUsage{};
+    std::vector<CoreSlot> cores;
+    std::vector<double> frequencies;        // reused scratch for the average
+    std::vector<std::int32_t> slotByCpuId;  // -1 for cpu ids without a slot
+    CpuTopology topology;
+    std::vector<PackageSlot> packages;
+    std::vector<double> sensorTemperatures;  // Celsius per sensor, NaN when the last read failed
+    DeviceFilter diskFilter = DeviceFilter::DefaultDisks();
+    DeviceFilter networkFilter = DeviceFilter::DefaultNetwork();
+    DiskTable disks;
+    NetworkTable interfaces;
+    std::vector<char> diskBuffer;  // grown until /proc/diskstats fits, then reused
+    std::vector<char> networkBuffer;
+    MeminfoLayout meminfo;
+    bool initialized = false;
+
+    explicit Impl(std::unique_ptr<CollectorBackend> source)
+        : backend(source ? std::move(source) : std::make_unique<ProcfsBackend>()) {}
+
+    Result<void> Initialize() {
+        if (auto Opened = backend->Open(); !Opened) {
+            return Opened;
+        }
+
+        // Discover online cpus and how much of /proc/stat the cpu lines occupy
+        auto const StatContent = backend->ReadAll(CollectorSource::STAT, 0);
+        std::string_view Remaining = StatContent;
+        std::size_t CpuSectionSize = 0;
+        CpuTimes Times;
+        while (!Remaining.empty()) {
+            auto const Line = NextLine(Remaining);
+            auto const CpuId = ParseCpuLine(Line, Times);
+            if (!CpuId) {
+                break;
+            }
+            CpuSectionSize = static_cast<std::size_t>(Remaining.data() - StatContent.data());
+            if (*CpuId != AGGREGATE_CPU) {
+                CoreSlot Slot;
+                Slot.cpuId = static_cast<std::uint32_t>(*CpuId);
+                cores.push_back(std::move(Slot));
+            }
+        }
+        if (cores.empty()) {
+            Cleanup();
+            return std::unexpected(SystemError::INITIALIZATION_FAILED);
+        }
+
+        // Counters gain digits over time, so leave generous headroom beyond the current size
+        constexpr std::size_t STAT_SLACK = 4096;
+        statBuffer.resize((CpuSectionSize * 2) + STAT_SLACK);
+
+        auto const FallbackFrequencies = ReadCpuinfoFrequencies();
+        for (std::size_t I = 0; I < cores.size(); ++I) {
+            auto& Slot = cores[I];
+            Slot.fallbackFrequency =
+                Slot.cpuId < FallbackFrequencies.size() && FallbackFrequencies[Slot.cpuId] != 0
+                    ? FallbackFrequencies[Slot.cpuId]
+                    : DEFAULT_FREQUENCY_MHZ;
+
+            if (Slot.cpuId >= slotByCpuId.size()) {
+                slotByCpuId.resize(Slot.cpuId + 1, -1);
+            }
+            slotByCpuId[Slot.cpuId] = static_cast<std::int32_t>(I);
+        }
+        topology = ReadTopology();
+        ReadThermalSensors();
+
+        // Take the baseline sample so the first GetCurrentStats() has a delta to work with; disks and
+        // interfaces are optional, as older captures and some containers have neither
+        initialized = true;
+        if (!SampleCpuTimes()) {
+            Cleanup();
+            return std::unexpected(SystemError::INITIALIZATION_FAILED);
+        }
+        disks.Clear();
+        interfaces.Clear();
+        (void)GetDiskStats();
+        (void)GetNetworkStats();
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+
+        return {};
+    }
+
+    Result<SystemStats> GetCurrentStats() {
+        if (!initialized) {
+            return std::unexpected(SystemError::INITIALIZATION_FAILED);
+        }
+
+        SystemStats Stats;
+        auto CpuResult = GetCpuStats();
+        if (!CpuResult) {
+            return std::unexpected(CpuResult.error());
+        }
+        Stats.cpu = std::move(*CpuResult);
+
+        // Stamped after /proc/stat was read, which is what moves a stepped replay to its next sample
+        Stats.timestamp = backend->Now();
+
+        auto MemResult = GetMemoryStats();
+        if (!MemResult) {
+            return std::unexpected(MemResult.error());
+        }
+        Stats.memory = *MemResult;
+
+        if (auto Disks = GetDiskStats()) {
+            Stats.disks = std::move(*Disks);
+        }
+        if (auto Network = GetNetworkStats()) {
+            Stats.network = std::move(*Network);
+        }
+
+        return Stats;
+    }
+
+    [[nodiscard]] std::chrono::system_clock::time_point Now() const {
+        return backend->Now();
+    }
+
+    Result<CPUUsageData> SampleCpu() {
+        if (!initialized) {
+            return std::unexpected(SystemError::INITIALIZATION_FAILED);
+        }
+        return GetCpuStats();
+    }
+
+    Result<MemoryUsageData> SampleMemory() {
+        if (!initialized) {
+            return std::unexpected(SystemError::INITIALIZATION_FAILED);
+        }
+        return GetMemoryStats();
+    }
+
+    Result<std::vector<DiskDeviceData>> SampleDisks() {
+        if (!initialized) {
+            return std::unexpected(SystemError::INITIALIZATION_FAILED);
+        }
+        return GetDiskStats();
+    }
+
+    Result<std::vector<NetworkInterfaceData>> SampleNetwork() {
+        if (!initialized) {
+            return std::unexpected(SystemError::INITIALIZATION_FAILED);
+        }
+        return GetNetworkStats();
+    }
+
+private:
+    static constexpr std::uint64_t DEFAULT_FREQUENCY_MHZ = 2400;
+
+    // A package counts as throttling when it runs within THROTTLE_MARGIN of its critical temperature (or of
+    // DEFAULT_CRITICAL when the sensor reports none) while its cores clock below THROTTLE_RATIO of their peak
+    static constexpr double DEFAULT_CRITICAL_CELSIUS = 100.0;
+    static constexpr double THROTTLE_MARGIN_CELSIUS = 10.0;
+    static constexpr double THROTTLE_RATIO = 0.85;
+
+    void Cleanup() {
+        statBuffer.clear();
+        cores.clear();
+        slotByCpuId.clear();
+        topology = {};
+        packages.clear();
+        sensorTemperatures.clear();
+        disks.Clear();
+        interfaces.Clear();
+        diskBuffer.clear();
+        networkBuffer.clear();
+        meminfo = {};
+        initialized = false;
+    }
+
+    // Whole text of a source that grows with the device count: the buffer doubles until a read fits in it
+    std::string_view ReadGrowing(CollectorSource source, std::vector<char>& buffer) {
+        constexpr std::size_t INITIAL_BYTES = 4096;
+        if (buffer.empty()) {
+            buffer.resize(INITIAL_BYTES);
+        }
+        while (true) {
+            auto const Text = backend->Read(source, 0, buffer);
+            if (Text.size() < buffer.size()) {
+                return Text;
+            }
+            buffer.resize(buffer.size() * 2);
+        }
+    }
+
+    // "major minor name reads merged sectors ms writes merged sectors ms in-flight io-ms weighted-io-ms ..."
+    // lines of /proc/diskstats; sectors are 512 bytes whatever the device's block size
+    Result<std::vector<DiskDeviceData>> GetDiskStats() {
+        auto Remaining = ReadGrowing(CollectorSource::DISKSTATS, diskBuffer);
+        if (Remaining.empty()) {
+            return std::unexpected(SystemError::DATA_UNAVAILABLE);
+        }
+
+        constexpr std::uint64_t SECTOR_BYTES = 512;
+        constexpr std::uint64_t MICROS_PER_MS = 1000;
+        auto const Seconds = disks.Begin(backend->Now());
+        std::array<std::uint64_t, 11> Fields{};
+        while (!Remaining.empty()) {
+            auto Line = NextLine(Remaining);
+            std::uint32_t Major = 0;
+            std::uint32_t Minor = 0;
+            if (!NextUnsigned(Line, Major) || !NextUnsigned(Line, Minor)) {
+                continue;
+            }
+            auto* Slot = disks.Find(NextWord(Line), diskFilter);
+            if (Slot == nullptr) {
+                continue;
+            }
+            Fields.fill(0);
+            for (auto& Field : Fields) {
+                if (!NextUnsigned(Line, Field)) {
+                    break;
                 }
-                return TotalCache;
             }
+            DiskTable::Update(*Slot,
+                              DiskCounters{.reads = Fields[0],
+                                           .writes = Fields[4],
+                                           .readBytes = Fields[2] * SECTOR_BYTES,
+                                           .writeBytes = Fields[6] * SECTOR_BYTES,
+                                           .busyUs = Fields[9] * MICROS_PER_MS,
+                                           .queueUs = Fields[10] * MICROS_PER_MS},
+                              Seconds);
         }
+        return disks.Finish();
+    }
 
-        return 0;
+    // "name: rx bytes packets errs drop fifo frame compressed multicast tx bytes packets errs drop ..." lines of
+    // /proc/net/dev, after two header lines without a colon
+    Result<std::vector<NetworkInterfaceData>> GetNetworkStats() {
+        auto Remaining = ReadGrowing(CollectorSource::NET_DEV, networkBuffer);
+        if (Remaining.empty()) {
+            return std::unexpected(SystemError::DATA_UNAVAILABLE);
+        }
+
+        auto const Seconds = interfaces.Begin(backend->Now());
+        std::array<std::uint64_t, 12> Fields{};
+        while (!Remaining.empty()) {
+            auto Line = NextLine(Remaining);
+            auto const Colon = Line.find(':');
+            if (Colon == std::string_view::npos) {
+                continue;
+            }
+            auto Name = Line.substr(0, Colon);
+            Name.remove_prefix(std::min(Name.find_first_not_of(' '), Name.size()));
+            auto* Slot = interfaces.Find(Name, networkFilter);
+            if (Slot == nullptr) {
+                continue;
+            }
+            Line.remove_prefix(Colon + 1);
+            Fields.fill(0);
+            for (auto& Field : Fields) {
+                if (!NextUnsigned(Line, Field)) {
+                    break;
+                }
+            }
+            NetworkTable::Update(*Slot,
+                                 NetworkCounters{.rxBytes = Fields[0],
+                                                 .txBytes = Fields[8],
+                                                 .rxPackets = Fields[1],
+                                                 .txPackets = Fields[9],
+                                                 .errors = Fields[2] + Fields[10],
+                                                 .drops = Fields[3] + Fields[11]},
+                                 Seconds);
+        }
+        return interfaces.Finish();
+    }
+
+    // Layout of the online cpus; a cpu without topology data (older captures, restricted sysfs) counts as a
+    // physical core of its own in package and node 0
+    CpuTopology ReadTopology() const {
+        CpuTopology Topology;
+        Topology.cpus.reserve(cores.size());
+        for (const auto& Slot : cores) {
+            LogicalCpuInfo Cpu{.cpuId = Slot.cpuId, .core = Slot.cpuId, .siblings = {Slot.cpuId}};
+            auto const Text = backend->ReadAll(CollectorSource::CPU_TOPOLOGY, Slot.cpuId);
+            std::string_view Remaining = Text;
+            while (!Remaining.empty()) {
+                auto Line = NextLine(Remaining);
+                auto const Key = NextWord(Line);
+                if (Key == "package") {
+                    NextUnsigned(Line, Cpu.package);
+                } else if (Key == "core") {
+                    NextUnsigned(Line, Cpu.core);
+                } else if (Key == "node") {
+                    NextUnsigned(Line, Cpu.node);
+                } else if (Key == "siblings") {
+                    Cpu.siblings = ParseCpuList(NextWord(Line));
+                } else if (Key == "cache") {
+                    // Every cpu sharing a cache reports it, so keep the first copy only
+                    auto Cache = ParseCacheLine(Line);
+                    if (Cache && std::ranges::find(Topology.caches, *Cache) == Topology.caches.end()) {
+                        Topology.caches.push_back(std::move(*Cache));
+                    }
+                }
+            }
+            Topology.cpus.push_back(std::move(Cpu));
+        }
+        SummarizeTopology(Topology);
+        return Topology;
+    }
+
+    // Maps the THERMAL_SENSORS lines onto packages and core slots; a core sensor covers every SMT sibling
+    void ReadThermalSensors() {
+        auto const Text = backend->ReadAll(CollectorSource::THERMAL_SENSORS, 0);
+        auto const PackageFor = [this](std::uint32_t package) -> PackageSlot& {
+            auto It = std::ranges::find(packages, package, &PackageSlot::package);
+            if (It == packages.end()) {
+                It = packages.insert(packages.end(), PackageSlot{.package = package});
+            }
+            return *It;
+        };
+
+        std::string_view Remaining = Text;
+        std::int32_t Sensor = 0;
+        for (; !Remaining.empty(); ++Sensor) {
+            auto Line = NextLine(Remaining);
+            auto const Kind = NextWord(Line);
+            std::uint32_t Package = 0;
+            std::uint32_t Core = 0;
+            std::uint64_t Critical = 0;
+            if (!NextUnsigned(Line, Package) || (Kind == "core" && !NextUnsigned(Line, Core))) {
+                continue;
+            }
+            NextUnsigned(Line, Critical);
+
+            auto& Slot = PackageFor(Package);
+            if (Critical != 0 && (Kind == "package" || !Slot.critical)) {
+                Slot.critical = static_cast<double>(Critical) / 1000.0;
+            }
+            if (Kind == "package") {
+                Slot.sensor = Sensor;
+            } else if (Kind == "core") {
+                for (std::size_t I = 0; I < cores.size(); ++I) {
+                    if (topology.cpus[I].package == Package && topology.cpus[I].core == Core) {
+                        cores[I].temperatureSensor = Sensor;
+                    }
+                }
+            }
+        }
+        sensorTemperatures.assign(static_cast<std::size_t>(Sensor), std::numeric_limits<double>::quiet_NaN());
+
+        std::ranges::sort(packages, {}, &PackageSlot::package);
+        for (auto& Slot : packages) {
+            for (std::size_t I = 0; I < cores.size(); ++I) {
+                if (topology.cpus[I].package == Slot.package) {
+                    Slot.coreSlots.push_back(I);
+                }
+            }
+        }
+    }
+
+    // Every sensor holds a single millidegree value, negative below freezing
+    void SampleTemperatures() {
+        std::array<char, 32> Buffer;
+        for (std::size_t I = 0; I < sensorTemperatures.size(); ++I) {
+            auto Content = backend->Read(CollectorSource::TEMPERATURE, static_cast<std::uint32_t>(I), Buffer);
+            while (!Content.empty() && Content.front() == ' ') {
+                Content.remove_prefix(1);
+            }
+            std::int64_t Millidegrees = 0;
+            auto const Parsed = std::from_chars(Content.data(), Content.data() + Content.size(), Millidegrees);
+            sensorTemperatures[I] = Parsed.ec == std::errc{} ? static_cast<double>(Millidegrees) / 1000.0
+                                                             : std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+
+    [[nodiscard]] std::optional<double> SensorCelsius(std::int32_t sensor) const {
+        if (sensor < 0 || std::isnan(sensorTemperatures[static_cast<std::size_t>(sensor)])) {
+            return std::nullopt;
+        }
+        return sensorTemperatures[static_cast<std::size_t>(sensor)];
+    }
+
+    // Package temperatures (the package sensor, else the hottest core) and the throttling verdicts; expects
+    // cpu.cores to hold this sample's frequencies and core temperatures
+    void UpdatePackages(CPUUsageData& cpu) {
+        cpu.packages.reserve(packages.size());
+        for (auto& Slot : packages) {
+            auto Temperature = SensorCelsius(Slot.sensor);
+            double FrequencySum = 0.0;
+            for (auto const Index : Slot.coreSlots) {
+                const auto& Core = cpu.cores[Index];
+                FrequencySum += static_cast<double>(Core.frequency);
+                if (Slot.sensor < 0 && Core.temperature && (!Temperature || *Core.temperature > *Temperature)) {
+                    Temperature = Core.temperature;
+                }
+            }
+            auto const Frequency =
+                Slot.coreSlots.empty() ? 0.0 : FrequencySum / static_cast<double>(Slot.coreSlots.size());
+            Slot.peakFrequency = std::max(Slot.peakFrequency, Frequency);
+            if (!Temperature) {
+                continue;
+            }
+
+            auto const Hot = *Temperature >= Slot.critical.value_or(DEFAULT_CRITICAL_CELSIUS) - THROTTLE_MARGIN_CELSIUS;
+            auto const Throttling = Hot && Frequency < THROTTLE_RATIO * Slot.peakFrequency;
+            cpu.packages.push_back(CpuPackageThermal{.package = Slot.package,
+                                                     .temperature = *Temperature,
+                                                     .critical = Slot.critical,
+                                                     .throttling = Throttling});
+            cpu.temperature = std::max(cpu.temperature.value_or(*Temperature), *Temperature);
+            cpu.throttling = cpu.throttling || Throttling;
+        }
+    }
+
+    // Reads /proc/stat and updates overall and per-core usage from the jiffy deltas
+    bool SampleCpuTimes() {
+        auto Remaining = backend->Read(CollectorSource::STAT, 0, statBuffer);
+        if (Remaining.empty()) {
+            return false;
+        }
+
+        CpuTimes Times;
+        while (!Remaining.empty()) {
+            auto const CpuId = ParseCpuLine(NextLine(Remaining), Times);
+            if (!CpuId) {
+                break;
+            }
+
+            if (*CpuId == AGGREGATE_CPU) {
+                overallUsage = UsageFromDelta(previousTotal, Times, overallUsage);
+                previousTotal = Times;
+                continue;
+            }
+
+            auto const Index = static_cast<std::size_t>(*CpuId);
+            if (Index < slotByCpuId.size() && slotByCpuId[Index] >= 0) {
+                auto& Slot = cores[static_cast<std::size_t>(slotByCpuId[Index])];
+                Slot.usage = UsageFromDelta(Slot.previous, Times, Slot.usage);
+                Slot.previous = Times;
+            }
+        }
+        return true;
+    }
+
+    Result<CPUUsageData> GetCpuStats() {
+        if (!SampleCpuTimes()) {
+            return std::unexpected(SystemError::DATA_UNAVAILABLE);
+        }
+
+        CPUUsageData CpuData;
+        CpuData.overall = overallUsage;
+
+        // Frequencies are also gathered contiguously for the average
+        SampleTemperatures();
+        CpuData.cores.reserve(cores.size());
+        frequencies.clear();
+        for (const auto& Slot : cores) {
+            auto const Frequency = GetCoreFrequency(*backend, Slot);
+            frequencies.push_back(static_cast<double>(Frequency));
+            CpuData.cores.push_back(CPUCoreData{.coreId = Slot.cpuId,
+                                                .usage = Slot.usage,
+                                                .frequency = Frequency,
+                                                .temperature = SensorCelsius(Slot.temperatureSensor)});
+        }
+
+        // Calculate average frequency
+        CpuData.averageFrequency = static_cast<std::uint64_t>(simd::Mean(frequencies));
+
+        UpdatePackages(CpuData);
+
+        return CpuData;
+    }
+
+    Result<MemoryUsageData> GetMemoryStats() {
+        std::array<char, 8192> Buffer;
+        auto const Text = backend->Read(CollectorSource::MEMINFO, 0, Buffer);
+        MeminfoValues Values;
+        if (!meminfo.Parse(Text, Values) || Values[MEMINFO_TOTAL] == 0) {
+            return std::unexpected(SystemError::DATA_UNAVAILABLE);
+        }
+
+        // Values in /proc/meminfo are reported in KiB, except the huge page counts
+        constexpr std::uint64_t KIB = 1024;
+        auto const TotalKb = Values[MEMINFO_TOTAL];
+        auto const AvailableKb = std::min(Values[MEMINFO_AVAILABLE], TotalKb);
+        auto const SwapFreeKb = std::min(Values[MEMINFO_SWAP_FREE], Values[MEMINFO_SWAP_TOTAL]);
+        auto const HugePageBytes = Values[MEMINFO_HUGE_PAGE_SIZE] * KIB;
+        MemoryUsageData Memory{.total = TotalKb * KIB,
+                               .used = (TotalKb - AvailableKb) * KIB,
+                               .available = AvailableKb * KIB,
+                               .cache = Values[MEMINFO_CACHED] * KIB,
+                               .buffers = Values[MEMINFO_BUFFERS] * KIB,
+                               .usagePercent = 100.0 * static_cast<double>(TotalKb - AvailableKb) /
+                                               static_cast<double>(TotalKb),
+                               .slab = Values[MEMINFO_SLAB] * KIB,
+                               .dirty = Values[MEMINFO_DIRTY] * KIB,
+                               .writeback = Values[MEMINFO_WRITEBACK] * KIB,
+                               .swapTotal = Values[MEMINFO_SWAP_TOTAL] * KIB,
+                               .swapUsed = (Values[MEMINFO_SWAP_TOTAL] - SwapFreeKb) * KIB,
+                               .hugePagesTotal = Values[MEMINFO_HUGE_PAGES_TOTAL] * HugePageBytes,
+                               .hugePagesFree = Values[MEMINFO_HUGE_PAGES_FREE] * HugePageBytes,
+                               .pressure = std::nullopt};
+
+        // PSI is all or nothing: every resource has a file, or none has
+        SystemPressure Pressure;
+        std::array<ResourcePressure*, 3> const Resources{&Pressure.cpu, &Pressure.io, &Pressure.memory};
+        for (std::uint32_t I = 0; I < Resources.size(); ++I) {
+            std::array<char, 256> PressureBuffer;
+            if (!ParsePressure(backend->Read(CollectorSource::PRESSURE, I, PressureBuffer), *Resources[I])) {
+                return Memory;
+            }
+        }
+        Memory.pressure = Pressure;
+        return Memory;
+    }
+
+    static std::uint64_t GetCoreFrequency(CollectorBackend& source, const CoreSlot& slot) {
+        // scaling_cur_freq holds a single kHz value
+        std::array<char, 32> Buffer;
+        auto Content = source.Read(CollectorSource::CPU_FREQUENCY, slot.cpuId, Buffer);
+        std::uint64_t Khz = 0;
+        if (NextUnsigned(Content, Khz) && Khz != 0) {
+            return Khz / 1000;
+        }
+        return slot.fallbackFrequency;
+    }
+
+    // "cpu MHz" per processor from /proc/cpuinfo, read once as a fallback for hosts without cpufreq
+    std::vector<std::uint64_t> ReadCpuinfoFrequencies() const {
+        auto const Content = backend->ReadAll(CollectorSource::CPUINFO, 0);
+
+        std::vector<std::uint64_t> Frequencies;
+        std::string_view Remaining = Content;
+        std::size_t Processor = 0;
+        while (!Remaining.empty()) {
+            auto Line = NextLine(Remaining);
+            auto const Colon = Line.find(':');
+            if (Colon == std::string_view::npos) {
+                continue;
+            }
+            auto const Key = Line.substr(0, Line.find_first_of(" \t"));
+            auto Value = Line.substr(Colon + 1);
+            if (Key == "processor") {
+                NextUnsigned(Value, Processor);
+            } else if (Line.starts_with("cpu MHz")) {
+                std::uint64_t Mhz = 0;
+                if (NextUnsigned(Value, Mhz)) {
+                    if (Processor >= Frequencies.size()) {
+                        Frequencies.resize(Processor + 1, 0);
+                    }
+                    Frequencies[Processor] = Mhz;
+                }
+            }
+        }
+        return Frequencies;
     }
 };
+#else
+    #error "SystemMonitor has no collector backend for this platform"
+#endif
 
 // SystemMonitor implementation
-SystemMonitor::SystemMonitor() : pImpl_(std::make_unique<Impl>()) {}
+SystemMonitor::SystemMonitor() : pImpl_(std::make_unique<Impl>(nullptr)) {}
+
+SystemMonitor::SystemMonitor(std::unique_ptr<CollectorBackend> backend)
+    : pImpl_(std::make_unique<Impl>(std::move(backend))) {}
 
 SystemMonitor::~SystemMonitor() = default;
 
@@ -220,15 +1607,33 @@ Result<SystemStats> SystemMonitor::GetCurrentStats() {
     return pImpl_->GetCurrentStats();
 }
 
-SystemMonitor::StatsGenerator SystemMonitor::StreamStats(std::chrono::milliseconds interval) {
-    while (true) {
-        auto Stats = GetCurrentStats();
-        if (Stats) {
-            co_yield *Stats;
-        }
+Result<CPUUsageData> SystemMonitor::GetCpuStats() {
+    return pImpl_->SampleCpu();
+}
 
-        std::this_thread::sleep_for(interval);
-    }
+Result<MemoryUsageData> SystemMonitor::GetMemoryStats() {
+    return pImpl_->SampleMemory();
+}
+
+Result<std::vector<DiskDeviceData>> SystemMonitor::GetDiskStats() {
+    return pImpl_->SampleDisks();
+}
+
+Result<std::vector<NetworkInterfaceData>> SystemMonitor::GetNetworkStats() {
+    return pImpl_->SampleNetwork();
+}
+
+void SystemMonitor::SetDeviceFilters(DeviceFilter disks, DeviceFilter network) {
+    pImpl_->diskFilter = std::move(disks);
+    pImpl_->networkFilter = std::move(network);
+}
+
+std::chrono::system_clock::time_point SystemMonitor::Now() const {
+    return pImpl_->Now();
+}
+
+const CpuTopology& SystemMonitor::Topology() const noexcept {
+    return pImpl_->topology;
 }
 
 }  // namespace pc_monitor
\ No newline at end of file
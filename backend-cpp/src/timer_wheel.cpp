@@ -0,0 +1,88 @@
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+
+namespace pc_monitor {
+
+std::uint64_t TimerWheel::TickOf(Clock::time_point time) const noexcept {
+    if (time <= origin_) {
+        return 0;
+    }
+    return static_cast<std::uint64_t>((time - origin_) / TICK);
+}
+
+void TimerWheel::Schedule(Key key, Clock::time_point deadline) {
+    auto const Tick = std::max(TickOf(deadline), cursor_);
+    slots_[Tick % SLOTS].push_back(Entry{.key = key, .deadline = deadline});
+    ++size_;
+}
+
+bool TimerWheel::Cancel(Key key, Clock::time_point deadline) {
+    // Every pending entry sits in the slot of its own tick, or of the cursor when it was scheduled late
+    auto& Slot = slots_[std::max(TickOf(deadline), cursor_) % SLOTS];
+    auto const Found = std::ranges::find_if(
+        Slot, [&](const Entry& entry) { return entry.key == key && entry.deadline == deadline; });
+    if (Found == Slot.end()) {
+        return false;
+    }
+    *Found = Slot.back();
+    Slot.pop_back();
+    --size_;
+    return true;
+}
+
+std::optional<TimerWheel::Clock::time_point> TimerWheel::NextDeadline() const {
+    if (size_ == 0) {
+        return std::nullopt;
+    }
+
+    // The first slot holding an entry of its own revolution has the earliest deadline
+    for (std::uint64_t Tick = cursor_; Tick < cursor_ + SLOTS; ++Tick) {
+        std::optional<Clock::time_point> Earliest;
+        for (const auto& Entry : slots_[Tick % SLOTS]) {
+            if (TickOf(Entry.deadline) <= Tick && (!Earliest || Entry.deadline < *Earliest)) {
+                Earliest = Entry.deadline;
+            }
+        }
+        if (Earliest) {
+            return Earliest;
+        }
+    }
+
+    // Everything is at least one revolution away
+    auto Earliest = Clock::time_point::max();
+    for (const auto& Slot : slots_) {
+        for (const auto& Entry : Slot) {
+            Earliest = std::min(Earliest, Entry.deadline);
+        }
+    }
+    return Earliest;
+}
+
+void TimerWheel::Expire(Clock::time_point now, std::vector<Entry>& due) {
+    auto const First = due.size();
+    auto const NowTick = TickOf(now);
+
+    // After a long sleep one pass over the whole wheel sees every entry
+    auto const Steps = std::min<std::uint64_t>(NowTick - std::min(NowTick, cursor_), SLOTS - 1);
+    for (std::uint64_t Step = 0; Step <= Steps; ++Step) {
+        auto& Slot = slots_[(NowTick - Step) % SLOTS];
+        for (std::size_t I = 0; I < Slot.size();) {
+            if (Slot[I].deadline <= now) {
+                due.push_back(Slot[I]);
+                Slot[I] = Slot.back();
+                Slot.pop_back();
+                --size_;
+            } else {
+                ++I;
+            }
+        }
+    }
+    cursor_ = std::max(cursor_, NowTick);
+
+    std::sort(due.begin() + static_cast<std::ptrdiff_t>(First), due.end(), [](const Entry& a, const Entry& b) {
+        return a.deadline < b.deadline;
+    });
+}
+
+}  // namespace pc_monitor
@@ -1,63 +1,219 @@
 #include "web_server.hpp"
 
+#include "json_writer.hpp"
+
+#include <algorithm>
+#include <charconv>
 #include <format>
+#include <iterator>
 #include <ranges>
 
 namespace pc_monitor {
 
-WebServer::WebServer(std::shared_ptr<SystemMonitor> monitor, std::uint16_t port)
-    : monitor_(std::move(monitor)), server_(std::make_unique<httplib::Server>()), port_(port) {
+namespace {
+// httplib request pool; the event server (--io-threads) uses its own I/O threads instead
+constexpr std::size_t WORKER_THREADS = 256;
+
+// httplib parks one pool worker on each open stream while it waits for frames, so streams are capped well
+// below the pool size and answered with 503 past the cap, keeping the rest of the pool free for REST routes.
+// The event server parks no thread per stream and has no cap.
+constexpr std::size_t MAX_POOLED_STREAMS = WORKER_THREADS / 4;
+constexpr std::string_view STREAM_RETRY_AFTER_SECONDS = "5";
+
+// An SSE comment line keeps idle proxies from closing the stream and detects dead clients
+constexpr auto STREAM_HEARTBEAT_INTERVAL = std::chrono::seconds{15};
+constexpr std::string_view STREAM_HEARTBEAT = ": heartbeat\n\n";
+constexpr std::string_view BINARY_STREAM_HEARTBEAT{"\0", 1};  // zero-length message
+
+constexpr std::string_view DEFAULT_HISTORY_RANGE = "5m";
+
+constexpr std::size_t DEFAULT_PROCESS_COUNT = 20;
+constexpr auto PROCESS_SCAN_INTERVAL = std::chrono::seconds{2};
+
+constexpr std::size_t DEFAULT_CGROUP_COUNT = 20;
+constexpr auto CGROUP_SCAN_INTERVAL = std::chrono::seconds{2};
+
+// WebSocket message for one alert transition; SSE clients get the same object as a "data:" line
+std::string AlertMessage(const AlertEvent& event) {
+    std::string Message;
+    Message.reserve(256);
+    Message.append(R"({"type":"alert","timestamp":)");
+    json::AppendJson(Message, event.timestamp);
+    Message.append(R"(,"data":)");
+    json::AppendJson(Message, event);
+    Message += '}';
+    return Message;
+}
+
+// Set when routing starts and read by the logger once the response is written; both run on the worker
+// thread serving the request
+thread_local std::chrono::steady_clock::time_point RequestStarted;
+
+// Binary when asked for by ?format=binary or an Accept header naming the binary media type; ?format wins
+WireFormat NegotiateFormat(const httplib::Request& req) {
+    if (req.has_param("format")) {
+        return req.get_param_value("format") == "binary" ? WireFormat::BINARY : WireFormat::JSON;
+    }
+    return req.get_header_value("Accept").find(binary::CONTENT_TYPE) != std::string::npos ? WireFormat::BINARY
+                                                                                           : WireFormat::JSON;
+}
+}  // namespace
+
+WebServer::WebServer(std::shared_ptr<StatsSampler> sampler,
+                     std::uint16_t port,
+                     std::uint16_t wsPort,
+                     const std::shared_ptr<const MetricsStore>& store,
+                     std::vector<AlertRule> rules,
+                     std::shared_ptr<const FleetAggregator> fleet,
+                     std::size_t ioThreads)
+    : sampler_(std::move(sampler)),
+      topologyBody_(std::make_shared<const std::string>(json::ToJsonString(sampler_->Topology()))),
+      alerts_(std::move(rules)),
+      fleet_(std::move(fleet)),
+      server_(ioThreads == 0 ? std::make_unique<httplib::Server>() : nullptr),
+      eventServer_(ioThreads != 0 ? std::make_unique<EventHttpServer>(EventHttpServer::Options{.threads = ioThreads})
+                                  : nullptr),
+      port_(port),
+      wsPort_(wsPort) {
+    if (server_) {
+        server_->new_task_queue = []() { return new httplib::ThreadPool(WORKER_THREADS); };
+    }
+
     SetupCors();
     SetupRoutes();
+
+    // Replayed before the render listener is added, so history stays in time order
+    if (store) {
+        auto const Now = std::chrono::system_clock::now();
+        SystemStats Restored;
+        store->Query(Now - StatsHistory::SPAN, Now, [this, &Restored](const StoredSample& sample) {
+            sample.Decode(Restored);
+            history_.Append(Restored);
+        });
+    }
+
+    renderListener_ =
+        sampler_->AddListener([this](const StatsSampler::Snapshot& stats) { RenderSnapshot(stats); });
+
+    // Sampler tasks run after the snapshot of their tick is published, so the scan never delays a stats frame
+    if (processes_.Initialize()) {
+        processTask_ = sampler_->AddTask("processes", PROCESS_SCAN_INTERVAL, [this]() { (void)processes_.Scan(); });
+    }
+    if (cgroups_.Initialize()) {
+        cgroupTask_ = sampler_->AddTask("cgroups", CGROUP_SCAN_INTERVAL, [this]() { (void)cgroups_.Scan(); });
+    }
 }
 
 WebServer::~WebServer() {
     Stop();
+    if (processTask_ != 0) {
+        sampler_->RemoveTask(processTask_);
+    }
+    if (cgroupTask_ != 0) {
+        sampler_->RemoveTask(cgroupTask_);
+    }
+    sampler_->RemoveListener(renderListener_);
 }
 
 Result<void> WebServer::Start() {
-    if (running_.load()) {
+    if (started_) {
         return std::unexpected(SystemError::SYSTEM_ERROR);
     }
 
-    StartBroadcastThread();
+    if (eventServer_) {
+        if (auto Started = eventServer_->Start("localhost", port_); !Started) {
+            return Started;
+        }
+    }
 
-    // Start server in a separate thread
-    std::thread ServerThread([this]() {
-        running_.store(true);
-        server_->listen("localhost", port_);
-    });
+    wsListener_ = std::make_unique<WebSocketListener>(
+        "/ws/stats", [this](const std::shared_ptr<WebSocketConnection>& client) { HandleWebSocketOpen(client); });
+    auto WsResult = wsListener_->Start("localhost", wsPort_);
+    if (!WsResult) {
+        wsListener_.reset();
+        if (eventServer_) {
+            eventServer_->Stop();
+        }
+        return WsResult;
+    }
+
+    // Bound here so a taken port fails Start(); the accept loop then runs on listenThread_ and clears
+    // running_ when it returns, which ends main's IsRunning() wait
+    if (server_ && !server_->bind_to_port("localhost", port_)) {
+        wsListener_->Stop();
+        wsListener_.reset();
+        return std::unexpected(SystemError::INITIALIZATION_FAILED);
+    }
+
+    started_ = true;
+    running_.store(true);
+    StartBroadcastThread();
 
-    ServerThread.detach();
+    // The event server listens on its own I/O threads
+    if (eventServer_) {
+        return {};
+    }
 
-    // Give server time to start
-    std::this_thread::sleep_for(std::chrono::milliseconds{100});
+    listenThread_ = std::thread([this]() {
+        server_->listen_after_bind();
+        running_.store(false);
+    });
+    server_->wait_until_ready();
 
     return {};
 }
 
 void WebServer::Stop() {
-    if (running_.load()) {
+    if (started_) {
+        started_ = false;
         running_.store(false);
         shouldBroadcast_.store(false);
 
+        // Wake every parked stream so its worker can finish before the server stops
+        streamHub_.CloseAll();
+        binaryStreamHub_.CloseAll();
+
         if (server_) {
             server_->stop();
         }
+        if (listenThread_.joinable()) {
+            listenThread_.join();
+        }
+        if (eventServer_) {
+            eventServer_->Stop();
+        }
 
+        {
+            std::lock_guard<std::mutex> const Lock(broadcastMutex_);
+        }
+        broadcastWake_.notify_all();
         if (broadcastThread_.joinable()) {
             broadcastThread_.join();
         }
+
+        if (wsListener_) {
+            wsListener_->Stop();
+        }
     }
 }
 
 void WebServer::SetupCors() {
-    server_->set_pre_routing_handler([](const httplib::Request& /* req */, httplib::Response& res) {
+    auto PreRouting = [](const httplib::Request& /* req */, httplib::Response& res) {
+        if constexpr (perf::ENABLED) {
+            RequestStarted = std::chrono::steady_clock::now();
+        }
         res.set_header("Access-Control-Allow-Origin", "*");
         res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
         res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
         return httplib::Server::HandlerResponse::Unhandled;
-    });
+    };
+
+    // The event server answers preflight requests itself
+    if (eventServer_) {
+        eventServer_->SetPreRoutingHandler(PreRouting);
+        return;
+    }
+    server_->set_pre_routing_handler(PreRouting);
 
     // Handle preflight requests
     server_->Options(".*", [](const httplib::Request&, httplib::Response& res) {
@@ -68,150 +224,652 @@ void WebServer::SetupCors() {
 
 void WebServer::SetupRoutes() {
     // API routes
-    server_->Get("/api/cpu",
-                 [this](const httplib::Request& req, httplib::Response& res) { HandleCpuEndpoint(req, res); });
+    Route("/api/cpu", [this](const httplib::Request& req, httplib::Response& res) { HandleCpuEndpoint(req, res); });
 
-    server_->Get("/api/memory",
-                 [this](const httplib::Request& req, httplib::Response& res) { HandleMemoryEndpoint(req, res); });
+    Route("/api/memory",
+          [this](const httplib::Request& req, httplib::Response& res) { HandleMemoryEndpoint(req, res); });
 
-    server_->Get("/api/stats",
-                 [this](const httplib::Request& req, httplib::Response& res) { HandleStatsEndpoint(req, res); });
+    Route("/api/stats", [this](const httplib::Request& req, httplib::Response& res) { HandleStatsEndpoint(req, res); });
+
+    Route("/api/history",
+          [this](const httplib::Request& req, httplib::Response& res) { HandleHistoryEndpoint(req, res); });
+
+    Route("/api/processes",
+          [this](const httplib::Request& req, httplib::Response& res) { HandleProcessesEndpoint(req, res); });
+
+    Route("/api/cgroups",
+          [this](const httplib::Request& req, httplib::Response& res) { HandleCgroupsEndpoint(req, res); });
+
+    Route("/api/history/summary", [this](const httplib::Request& req, httplib::Response& res) {
+        HandleHistorySummaryEndpoint(req, res);
+    });
+
+    Route("/api/alerts",
+          [this](const httplib::Request& req, httplib::Response& res) { HandleAlertsEndpoint(req, res); });
+
+    // Federation: rollups and per-host rows, and each upstream's own /api/stats body as last fetched
+    Route("/api/fleet", [this](const httplib::Request& req, httplib::Response& res) { HandleFleetEndpoint(req, res); });
+    Route("/api/fleet/host",
+          [this](const httplib::Request& req, httplib::Response& res) { HandleFleetHostEndpoint(req, res); });
+
+    Route("/api/sampling",
+          [this](const httplib::Request& req, httplib::Response& res) { HandleSamplingEndpoint(req, res); });
+
+    // Discovered once at startup, so every request shares the same rendering
+    Route("/api/topology", [this](const httplib::Request& /* req */, httplib::Response& res) {
+        SetSharedContent(res, topologyBody_, "application/json");
+    });
+
+    // Prometheus text exposition of the latest sample
+    Route("/metrics",
+          [this](const httplib::Request& req, httplib::Response& res) { HandleMetricsEndpoint(req, res); });
+
+    // Self-instrumentation; reports "enabled":false when built without it
+    Route("/debug/perf", [this](const httplib::Request& req, httplib::Response& res) { HandlePerfEndpoint(req, res); });
 
     // Health check
-    server_->Get("/health", [](const httplib::Request&, httplib::Response& res) {
+    Route("/health", [](const httplib::Request&, httplib::Response& res) {
         res.set_content(R"({"status":"ok","service":"pc-monitor-cpp"})", "application/json");
     });
 
-    // WebSocket endpoint (simplified - httplib has limited WebSocket support)
-    server_->Get("/ws/stats",
-                 [this](const httplib::Request& req, httplib::Response& res) { HandleWebSocket(req, res); });
+    // Server-Sent Events stream of every published sample; its lifetime is not a latency, so it gets no
+    // histogram
+    if (eventServer_) {
+        eventServer_->Stream("/ws/stats", [this](const httplib::Request& req, httplib::Response& res) {
+            auto const Format = NegotiateFormat(req);
+            res.set_header("Content-Type",
+                           Format == WireFormat::BINARY ? binary::CONTENT_TYPE.data() : "text/event-stream");
+            return StatsStreamSource(Format, res);
+        });
+    } else {
+        server_->Get("/ws/stats",
+                     [this](const httplib::Request& req, httplib::Response& res) { HandleStatsStream(req, res); });
+    }
+
+    // Runs after the last byte of each response is written (with the event server: once it is queued).
+    // Streamed bodies are counted by their providers, so only in-memory bodies are added here.
+    if constexpr (perf::ENABLED) {
+        auto Logger = [this](const httplib::Request& req, const httplib::Response& res) {
+            perf::Add(perf::Counter::BYTES_WRITTEN, res.body.size());
+            auto const Found = routeLatency_.find(req.path);
+            if (Found != routeLatency_.end() && req.method == "GET") {
+                perf::Record(Found->second,
+                             static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                            std::chrono::steady_clock::now() - RequestStarted)
+                                                            .count()));
+            }
+        };
+        if (eventServer_) {
+            eventServer_->SetLogger(std::move(Logger));
+        } else {
+            server_->set_logger(std::move(Logger));
+        }
+    }
 }
 
-void WebServer::HandleCpuEndpoint(const httplib::Request& /*unused*/, httplib::Response& res) {
-    auto Stats = monitor_->GetCurrentStats();
-    if (!Stats) {
+void WebServer::Route(const std::string& path, httplib::Server::Handler handler) {
+    routeLatency_.emplace(path, perf::Register("request " + path));
+    if (eventServer_) {
+        eventServer_->Get(path, std::move(handler));
+    } else {
+        server_->Get(path, std::move(handler));
+    }
+}
+
+void WebServer::RenderSnapshot(const StatsSampler::Snapshot& stats) {
+    history_.Append(*stats);
+    alertEvents_.clear();
+    alerts_.Evaluate(*stats, alertEvents_);
+
+    auto Rendered = json::Render(stats);
+    rendered_.store(Rendered, std::memory_order_release);
+    metrics_.store(prometheus_.Render(*stats), std::memory_order_release);
+    streamHub_.Publish(RenderedStats::Share(Rendered, &RenderedStats::streamFrame));
+    binaryStreamHub_.Publish(RenderedStats::Share(Rendered, &RenderedStats::binaryFrame));
+
+    // Alert transitions follow the stats frame of the sample that caused them; the binary stream carries
+    // stats only
+    std::vector<std::string> Alerts;
+    if (!alertEvents_.empty()) {
+        auto Frame = std::make_shared<std::string>();
+        for (const auto& Event : alertEvents_) {
+            Alerts.push_back(AlertMessage(Event));
+            Frame->append("data: ").append(Alerts.back()).append("\n\n");
+        }
+        streamHub_.Publish(std::move(Frame));
+    }
+    {
+        std::lock_guard<std::mutex> const Lock(broadcastMutex_);
+        ++renderSequence_;
+        if (shouldBroadcast_.load()) {
+            std::ranges::move(Alerts, std::back_inserter(wsPendingAlerts_));
+        }
+    }
+    broadcastWake_.notify_one();
+}
+
+void WebServer::SendRendered(httplib::Response& res,
+                             const std::string RenderedStats::*body,
+                             std::string_view what,
+                             const char* contentType) {
+    sampler_->NoteDemand();
+    auto Rendered = rendered_.load(std::memory_order_acquire);
+    if (!Rendered) {
         res.status = 500;
-        res.set_content(json::ErrorResponse(Stats.error(), "Failed to get CPU stats").dump(), "application/json");
+        res.set_content(
+            json::ErrorResponse(SystemError::DATA_UNAVAILABLE, std::format("Failed to get {} stats", what)).dump(),
+            "application/json");
         return;
     }
 
-    res.set_content(json::ToJson(Stats->cpu).dump(), "application/json");
+    SetSharedContent(res, RenderedStats::Share(Rendered, body), contentType);
+}
+
+void WebServer::HandleCpuEndpoint(const httplib::Request& /*unused*/, httplib::Response& res) {
+    SendRendered(res, &RenderedStats::cpuBody, "CPU");
 }
 
 void WebServer::HandleMemoryEndpoint(const httplib::Request& /*unused*/, httplib::Response& res) {
-    auto Stats = monitor_->GetCurrentStats();
-    if (!Stats) {
+    SendRendered(res, &RenderedStats::memoryBody, "memory");
+}
+
+void WebServer::HandleStatsEndpoint(const httplib::Request& req, httplib::Response& res) {
+    if (NegotiateFormat(req) == WireFormat::BINARY) {
+        SendRendered(res, &RenderedStats::binaryBody, "system", binary::CONTENT_TYPE.data());
+        return;
+    }
+    SendRendered(res, &RenderedStats::statsBody, "system");
+}
+
+void WebServer::HandleHistoryEndpoint(const httplib::Request& req, httplib::Response& res) {
+    auto const Range =
+        utils::ParseDuration(req.has_param("range") ? req.get_param_value("range") : DEFAULT_HISTORY_RANGE);
+    if (!Range) {
+        res.status = 400;
+        res.set_content(json::ErrorResponse(SystemError::INVALID_REQUEST, "range must look like 90s, 5m or 1h").dump(),
+                        "application/json");
+        return;
+    }
+
+    auto const Step =
+        req.has_param("step") ? utils::ParseDuration(req.get_param_value("step")) : StatsHistory::StepFor(*Range);
+
+    auto const Format = NegotiateFormat(req);
+    static auto const SerializeLatency = perf::Register("serialize.history");
+    std::string Body;
+    bool Appended = false;
+    if (Step) {
+        perf::ScopedTimer const Timer(SerializeLatency);
+        Appended = history_.AppendRange(Body, *Range, *Step, Format);
+    }
+    if (!Appended) {
+        res.status = 400;
+        res.set_content(json::ErrorResponse(SystemError::INVALID_REQUEST, "step must be one of 1s, 10s or 1m").dump(),
+                        "application/json");
+        return;
+    }
+
+    res.set_content(std::move(Body), Format == WireFormat::BINARY ? binary::CONTENT_TYPE.data() : "application/json");
+}
+
+void WebServer::HandleHistorySummaryEndpoint(const httplib::Request& req, httplib::Response& res) {
+    auto const Range =
+        utils::ParseDuration(req.has_param("range") ? req.get_param_value("range") : DEFAULT_HISTORY_RANGE);
+    if (!Range) {
+        res.status = 400;
+        res.set_content(json::ErrorResponse(SystemError::INVALID_REQUEST, "range must look like 90s, 5m or 1h").dump(),
+                        "application/json");
+        return;
+    }
+
+    std::string Body;
+    history_.AppendSummary(Body, *Range);
+    res.set_content(std::move(Body), "application/json");
+}
+
+void WebServer::HandleProcessesEndpoint(const httplib::Request& req, httplib::Response& res) {
+    sampler_->NoteDemand();
+    auto const Table = processes_.Latest();
+    if (!Table) {
         res.status = 500;
-        res.set_content(json::ErrorResponse(Stats.error(), "Failed to get memory stats").dump(), "application/json");
+        res.set_content(json::ErrorResponse(SystemError::DATA_UNAVAILABLE, "Failed to get process stats").dump(),
+                        "application/json");
+        return;
+    }
+
+    std::size_t Count = DEFAULT_PROCESS_COUNT;
+    if (req.has_param("top")) {
+        auto const Top = req.get_param_value("top");
+        auto const [End, Ec] = std::from_chars(Top.data(), Top.data() + Top.size(), Count);
+        if (Ec != std::errc{} || End != Top.data() + Top.size()) {
+            res.status = 400;
+            res.set_content(json::ErrorResponse(SystemError::INVALID_REQUEST, "top must be a count").dump(),
+                            "application/json");
+            return;
+        }
+    }
+
+    auto const Sort = req.has_param("sort") ? req.get_param_value("sort") : "cpu";
+    if (Sort != "cpu" && Sort != "rss") {
+        res.status = 400;
+        res.set_content(json::ErrorResponse(SystemError::INVALID_REQUEST, "sort must be cpu or rss").dump(),
+                        "application/json");
         return;
     }
 
-    res.set_content(json::ToJson(Stats->memory).dump(), "application/json");
+    auto const Top = ProcessMonitor::Top(*Table, Count, Sort == "rss" ? ProcessSortKey::RSS : ProcessSortKey::CPU);
+    std::string Body;
+    Body.reserve(64 + (Top.size() * 80));
+    Body += R"({"processes":)";
+    json::AppendJson(Body, Top);
+    Body += R"(,"sort":)";
+    json::AppendJson(Body, std::string_view(Sort));
+    Body += R"(,"timestamp":)";
+    json::AppendJson(Body, Table->timestamp);
+    Body += R"(,"total":)";
+    json::AppendJson(Body, Table->processes.size());
+    Body += '}';
+    res.set_content(std::move(Body), "application/json");
 }
 
-void WebServer::HandleStatsEndpoint(const httplib::Request& /*unused*/, httplib::Response& res) {
-    auto Stats = monitor_->GetCurrentStats();
-    if (!Stats) {
+void WebServer::HandleCgroupsEndpoint(const httplib::Request& req, httplib::Response& res) {
+    sampler_->NoteDemand();
+    auto const Table = cgroups_.Latest();
+    if (!Table) {
         res.status = 500;
-        res.set_content(json::ErrorResponse(Stats.error(), "Failed to get system stats").dump(), "application/json");
+        res.set_content(json::ErrorResponse(SystemError::DATA_UNAVAILABLE, "Failed to get cgroup stats").dump(),
+                        "application/json");
+        return;
+    }
+
+    std::size_t Count = DEFAULT_CGROUP_COUNT;
+    if (req.has_param("top")) {
+        auto const Top = req.get_param_value("top");
+        auto const [End, Ec] = std::from_chars(Top.data(), Top.data() + Top.size(), Count);
+        if (Ec != std::errc{} || End != Top.data() + Top.size()) {
+            res.status = 400;
+            res.set_content(json::ErrorResponse(SystemError::INVALID_REQUEST, "top must be a count").dump(),
+                            "application/json");
+            return;
+        }
+    }
+
+    auto const Sort = req.has_param("sort") ? req.get_param_value("sort") : "cpu";
+    if (Sort != "cpu" && Sort != "memory" && Sort != "io") {
+        res.status = 400;
+        res.set_content(json::ErrorResponse(SystemError::INVALID_REQUEST, "sort must be cpu, memory or io").dump(),
+                        "application/json");
         return;
     }
+    auto const Key = Sort == "memory" ? CgroupSortKey::MEMORY : Sort == "io" ? CgroupSortKey::IO : CgroupSortKey::CPU;
+
+    // Plain string prefix of the cgroup path, e.g. /kubepods.slice
+    auto const Prefix = req.has_param("prefix") ? req.get_param_value("prefix") : "";
+    auto const Top = CgroupMonitor::Top(*Table, Count, Key, Prefix);
+    std::string Body;
+    Body.reserve(96 + Prefix.size() + (Top.size() * 192));
+    Body += R"({"cgroups":)";
+    json::AppendJson(Body, Top);
+    Body += R"(,"prefix":)";
+    json::AppendJson(Body, std::string_view(Prefix));
+    Body += R"(,"sort":)";
+    json::AppendJson(Body, std::string_view(Sort));
+    Body += R"(,"timestamp":)";
+    json::AppendJson(Body, Table->timestamp);
+    Body += R"(,"total":)";
+    json::AppendJson(Body, Table->cgroups.size());
+    Body += '}';
+    res.set_content(std::move(Body), "application/json");
+}
 
-    res.set_content(json::ToJson(*Stats).dump(), "application/json");
+void WebServer::HandleAlertsEndpoint(const httplib::Request& /*unused*/, httplib::Response& res) {
+    auto const Firing = alerts_.Firing();
+    std::string Body;
+    Body.reserve(64 + (Firing.size() * 256));
+    Body += R"({"alerts":)";
+    json::AppendJson(Body, Firing);
+    Body += R"(,"checks":)";
+    json::AppendJson(Body, alerts_.CheckCount());
+    Body += R"(,"rules":)";
+    json::AppendJson(Body, alerts_.RuleCount());
+    Body += '}';
+    res.set_content(std::move(Body), "application/json");
 }
 
-void WebServer::HandleWebSocket(const httplib::Request& /* req */, httplib::Response& res) {
-    // Simplified WebSocket handling - in a real implementation,
-    // you would use a proper WebSocket library
-    res.set_header("Content-Type", "text/event-stream");
-    res.set_header("Cache-Control", "no-cache");
-    res.set_header("Connection", "keep-alive");
+void WebServer::HandleFleetEndpoint(const httplib::Request& /*unused*/, httplib::Response& res) {
+    if (!fleet_) {
+        res.status = 500;
+        res.set_content(
+            json::ErrorResponse(SystemError::DATA_UNAVAILABLE, "Not aggregating a fleet; start with --fleet").dump(),
+            "application/json");
+        return;
+    }
+
+    auto View = fleet_->Latest();
+    SetSharedContent(res, std::shared_ptr<const std::string>(View, &View->body), "application/json");
+}
 
-    // Send stats every second
-    for (int I = 0; I < 60 && running_.load(); ++I) {
-        auto Stats = monitor_->GetCurrentStats();
-        if (Stats) {
-            auto JsonData = json::ToJson(*Stats);
-            std::string SseData = std::format("data: {}\n\n", JsonData.dump());
-            res.set_content(SseData, "text/plain");
+void WebServer::HandleFleetHostEndpoint(const httplib::Request& req, httplib::Response& res) {
+    if (auto const View = fleet_ ? fleet_->Latest() : nullptr) {
+        if (auto const Found = View->hosts.find(req.get_param_value("name")); Found != View->hosts.end()) {
+            SetSharedContent(res, Found->second, "application/json");
+            return;
         }
+    }
+    res.status = 404;
+    res.set_content(
+        json::ErrorResponse(SystemError::INVALID_REQUEST, "No stats from a fleet host of that name").dump(),
+        "application/json");
+}
 
-        std::this_thread::sleep_for(std::chrono::seconds{1});
+void WebServer::HandleSamplingEndpoint(const httplib::Request& /*unused*/, httplib::Response& res) {
+    auto const Tasks = sampler_->TaskStats();
+    std::string Body;
+    Body.reserve(64 + (Tasks.size() * 192));
+    Body += sampler_->IsIdle() ? R"({"idle":true,"tasks":)" : R"({"idle":false,"tasks":)";
+    json::AppendJson(Body, Tasks);
+    Body += '}';
+    res.set_content(std::move(Body), "application/json");
+}
+
+void WebServer::HandleMetricsEndpoint(const httplib::Request& /*unused*/, httplib::Response& res) {
+    sampler_->NoteDemand();
+    auto Text = metrics_.load(std::memory_order_acquire);
+    if (!Text) {
+        res.status = 500;
+        res.set_content(json::ErrorResponse(SystemError::DATA_UNAVAILABLE, "No sample rendered yet").dump(),
+                        "application/json");
+        return;
     }
+
+    // The sample part is shared; the server's own metrics are merged per scrape rather than per sample
+    constexpr std::size_t SERVER_METRICS_BYTES = 4096;
+    std::string Body;
+    Body.reserve(Text->size() + SERVER_METRICS_BYTES);
+    Body += *Text;
+    PrometheusRenderer::AppendServerMetrics(Body,
+                                            {.sseClients = streamHub_.SubscriberCount(),
+                                             .binaryStreamClients = binaryStreamHub_.SubscriberCount(),
+                                             .webSocketClients = wsClientCount_.load(std::memory_order_relaxed)});
+    res.set_content(std::move(Body), PrometheusRenderer::CONTENT_TYPE.data());
+}
+
+void WebServer::HandlePerfEndpoint(const httplib::Request& /*unused*/, httplib::Response& res) {
+    auto const Histograms = perf::Summaries();
+    std::string Body;
+    Body.reserve(192 + (Histograms.size() * 160));
+    Body += R"({"counters":{"bytesWritten":)";
+    json::AppendJson(Body, perf::Total(perf::Counter::BYTES_WRITTEN));
+    Body += perf::ENABLED ? R"(},"enabled":true,"gauges":{"binaryStreamClients":)"
+                          : R"(},"enabled":false,"gauges":{"binaryStreamClients":)";
+    json::AppendJson(Body, binaryStreamHub_.SubscriberCount());
+    Body += R"(,"sseClients":)";
+    json::AppendJson(Body, streamHub_.SubscriberCount());
+    Body += R"(,"webSocketClients":)";
+    json::AppendJson(Body, wsClientCount_.load(std::memory_order_relaxed));
+    Body += R"(},"histograms":)";
+    json::AppendJson(Body, Histograms);
+    Body += '}';
+    res.set_content(std::move(Body), "application/json");
+}
+
+EventHttpServer::StreamSource WebServer::StatsStreamSource(WireFormat format, httplib::Response& res) {
+    bool const Binary = format == WireFormat::BINARY;
+    StreamHub::Frame Initial;
+    if (auto Rendered = rendered_.load(std::memory_order_acquire)) {
+        Initial = RenderedStats::Share(Rendered, Binary ? &RenderedStats::binaryFrame : &RenderedStats::streamFrame);
+    }
+    sampler_->NoteDemand();
+
+    res.set_header("Cache-Control", "no-cache");
+    res.set_header("X-Accel-Buffering", "no");
+    return {.hub = Binary ? &binaryStreamHub_ : &streamHub_,
+            .initial = std::move(Initial),
+            .heartbeat = Binary ? BINARY_STREAM_HEARTBEAT : STREAM_HEARTBEAT,
+            .onFrame = [this]() { sampler_->NoteDemand(); }};
+}
+
+void WebServer::HandleStatsStream(const httplib::Request& req, httplib::Response& res) {
+    if (pooledStreams_.fetch_add(1) >= MAX_POOLED_STREAMS) {
+        pooledStreams_.fetch_sub(1);
+        res.status = 503;
+        res.set_header("Retry-After", STREAM_RETRY_AFTER_SECONDS.data());
+        res.set_content(
+            json::ErrorResponse(SystemError::DATA_UNAVAILABLE,
+                                std::format("Too many open streams (limit {}); retry later", MAX_POOLED_STREAMS))
+                .dump(),
+            "application/json");
+        return;
+    }
+
+    auto const Format = NegotiateFormat(req);
+    auto Source = StatsStreamSource(Format, res);
+    auto& Hub = *Source.hub;
+    auto Subscription = Hub.Subscribe(Source.initial);
+
+    // The provider only waits on this client's queue; frames are shared buffers rendered once per sample
+    res.set_chunked_content_provider(
+        Format == WireFormat::BINARY ? binary::CONTENT_TYPE.data() : "text/event-stream",
+        [this, Subscription, Heartbeat = Source.heartbeat](std::size_t /* offset */, httplib::DataSink& sink) {
+            auto Frame = Subscription->WaitNext(STREAM_HEARTBEAT_INTERVAL);
+            if (Subscription->IsClosed() || !running_.load()) {
+                sink.done();
+                return true;
+            }
+            sampler_->NoteDemand();
+            auto const Data = Frame ? std::string_view(*Frame) : Heartbeat;
+            if (!sink.write(Data.data(), Data.size())) {
+                return false;
+            }
+            perf::Add(perf::Counter::BYTES_WRITTEN, Data.size());
+            return true;
+        },
+        [this, &Hub, Subscription](bool /* success */) {
+            Hub.Unsubscribe(Subscription);
+            pooledStreams_.fetch_sub(1);
+        });
 }
 
 void WebServer::StartBroadcastThread() {
     shouldBroadcast_.store(true);
     broadcastThread_ = std::thread([this]() {
+        std::uint64_t Seen = 0;
+        std::vector<std::string> Alerts;
         while (shouldBroadcast_.load()) {
             BroadcastStats();
-            std::this_thread::sleep_for(std::chrono::seconds{1});
+            BroadcastAlerts(Alerts);
+            Alerts.clear();
+
+            // Woken by RenderSnapshot as soon as a new sample is rendered; a render that lands between the
+            // broadcast and the wait is caught by the sequence instead of a polling timeout
+            std::unique_lock<std::mutex> Lock(broadcastMutex_);
+            broadcastWake_.wait(Lock,
+                                [this, &Seen]() { return renderSequence_ != Seen || !shouldBroadcast_.load(); });
+            Seen = renderSequence_;
+            Alerts.swap(wsPendingAlerts_);
         }
     });
 }
 
-void WebServer::BroadcastStats() {
-    auto Stats = monitor_->GetCurrentStats();
-    if (!Stats) {
+void WebServer::HandleWebSocketOpen(const std::shared_ptr<WebSocketConnection>& client) {
+    std::lock_guard<std::mutex> const Lock(clientsMutex_);
+
+    // Full snapshot on connect; from then on the client shares the broadcast baseline
+    if (wsFullFrame_ && client->SendText(*wsFullFrame_)) {
+        perf::Add(perf::Counter::BYTES_WRITTEN, wsFullFrame_->size());
+        client->lastSequence = wsSequence_;
+    }
+    wsClients_.insert(client);
+    wsClientCount_.store(wsClients_.size(), std::memory_order_relaxed);
+    sampler_->NoteDemand();
+}
+
+void WebServer::BroadcastAlerts(const std::vector<std::string>& messages) {
+    if (messages.empty()) {
         return;
     }
 
-    auto JsonData = json::ToJson(*Stats);
-    std::string Message = JsonData.dump();
+    std::size_t Bytes = 0;
+    for (const auto& Message : messages) {
+        Bytes += Message.size();
+    }
 
-    std::lock_guard<std::mutex> const Lock(clientsMutex_);
+    std::vector<std::shared_ptr<WebSocketConnection>> Clients;
+    {
+        std::lock_guard<std::mutex> const Lock(clientsMutex_);
+        Clients = CollectClientsLocked();
+    }
 
-    // Clean up expired clients and broadcast to active ones
-    for (auto It = wsClients_.begin(); It != wsClients_.end();) {
-        if (auto client = It->lock()) {
-            // In a real WebSocket implementation, we would send the message here
-            ++It;
+    bool Dropped = false;
+    for (const auto& Client : Clients) {
+        if (std::ranges::all_of(messages, [&Client](const auto& message) { return Client->SendText(message); })) {
+            perf::Add(perf::Counter::BYTES_WRITTEN, Bytes);
         } else {
-            It = wsClients_.erase(It);
+            Dropped = true;
         }
     }
+    if (Dropped) {
+        std::lock_guard<std::mutex> const Lock(clientsMutex_);
+        CollectClientsLocked();
+    }
 }
 
-// JSON serialization implementations
-namespace json {
-nlohmann::json ToJson(const CPUCoreData& core) {
-    return nlohmann::json{{"coreId", core.coreId}, {"usage", core.usage}, {"frequency", core.frequency}};
+std::vector<std::shared_ptr<WebSocketConnection>> WebServer::CollectClientsLocked() {
+    std::vector<std::shared_ptr<WebSocketConnection>> Clients;
+    Clients.reserve(wsClients_.size());
+    for (auto It = wsClients_.begin(); It != wsClients_.end();) {
+        auto Client = It->lock();
+        if (!Client || !Client->IsOpen()) {
+            It = wsClients_.erase(It);
+            continue;
+        }
+        Clients.push_back(std::move(Client));
+        ++It;
+    }
+    wsClientCount_.store(wsClients_.size(), std::memory_order_relaxed);
+    return Clients;
 }
 
-nlohmann::json ToJson(const CPUUsageData& cpu) {
-    nlohmann::json CoresJson = nlohmann::json::array();
-
-    // Use C++23 ranges for transformation
-    auto CoreJsons = cpu.cores | std::views::transform([](const auto& core) { return ToJson(core); });
-
-    for (const auto& CoreJson : CoreJsons) {
-        CoresJson.push_back(CoreJson);
+void WebServer::BroadcastStats() {
+    auto Rendered = rendered_.load(std::memory_order_acquire);
+    if (!Rendered) {
+        return;
     }
 
-    nlohmann::json Result{
-        {"overall", cpu.overall}, {"averageFrequency", cpu.averageFrequency}, {"cores", std::move(CoresJson)}};
+    std::unique_lock<std::mutex> Lock(clientsMutex_);
+    if (Rendered->stats == wsLastBroadcast_) {
+        return;
+    }
 
-    if (cpu.temperature.has_value()) {
-        Result["temperature"] = *cpu.temperature;
+    auto Current = QuantizedStats::From(*Rendered->stats);
+    auto const TimestampMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(Rendered->stats->timestamp.time_since_epoch()).count();
+    auto const PreviousSequence = wsSequence_;
+    auto const Sequence = ++wsSequence_;
+
+    // Rendered once per sample and shared by every client: clients that hold the previous frame get the
+    // delta, everyone else (new or recovering) the full snapshot
+    static auto const SerializeLatency = perf::Register("serialize.websocket");
+    std::string Delta;
+    bool HasDelta = false;
+    {
+        perf::ScopedTimer const Timer(SerializeLatency);
+        HasDelta = PreviousSequence != 0 && json::AppendStatsDelta(Delta, wsBaseline_, Current, Sequence, TimestampMs);
+
+        auto FullFrame = std::make_shared<std::string>();
+        FullFrame->reserve(Rendered->statsBody.size() + 64);
+        FullFrame->append(R"({"type":"stats","seq":)");
+        json::AppendJson(*FullFrame, Sequence);
+        FullFrame->append(R"(,"timestamp":)");
+        json::AppendJson(*FullFrame, TimestampMs);
+        FullFrame->append(R"(,"data":)").append(Rendered->statsBody).append("}");
+        wsFullFrame_ = std::move(FullFrame);
     }
 
-    return Result;
+    auto const Clients = CollectClientsLocked();
+    auto const FullFrame = wsFullFrame_;
+    wsBaseline_ = std::move(Current);
+    wsLastBroadcast_ = Rendered->stats;
+    Lock.unlock();
+
+    // Sent outside clientsMutex_ so handshakes never wait on the broadcast. Sends don't block: a stalled client
+    // only fills its own bounded queue, and is dropped when that overflows. A client that connects meanwhile
+    // already got this frame in full from HandleWebSocketOpen.
+    bool Dropped = false;
+    for (const auto& Client : Clients) {
+        bool const SendDelta = HasDelta && Client->lastSequence == PreviousSequence;
+        auto const Message = SendDelta ? std::string_view(Delta) : std::string_view(*FullFrame);
+        if (Client->SendText(Message)) {
+            perf::Add(perf::Counter::BYTES_WRITTEN, Message.size());
+            Client->lastSequence = Sequence;
+        } else {
+            Dropped = true;
+        }
+    }
+    if (Dropped) {
+        Lock.lock();
+        CollectClientsLocked();
+    }
+    if (!Clients.empty()) {
+        sampler_->NoteDemand();
+    }
 }
 
-nlohmann::json ToJson(const MemoryUsageData& memory) {
-    return nlohmann::json{{"total", memory.total},
-                          {"used", memory.used},
-                          {"available", memory.available},
-                          {"cache", memory.cache},
-                          {"buffers", memory.buffers},
-                          {"usagePercent", memory.usagePercent}};
+void SetSharedContent(httplib::Response& res, std::shared_ptr<const std::string> body, const char* contentType) {
+    auto const Size = body->size();
+    res.set_content_provider(
+        Size,
+        contentType,
+        [Body = std::move(body)](std::size_t offset, std::size_t length, httplib::DataSink& sink) {
+            if (!sink.write(Body->data() + offset, length)) {
+                return false;
+            }
+            perf::Add(perf::Counter::BYTES_WRITTEN, length);
+            return true;
+        });
 }
 
-nlohmann::json ToJson(const SystemStats& stats) {
-    auto TimestampMs =
-        std::chrono::duration_cast<std::chrono::milliseconds>(stats.timestamp.time_since_epoch()).count();
-
-    return nlohmann::json{{"cpu", ToJson(stats.cpu)}, {"memory", ToJson(stats.memory)}, {"timestamp", TimestampMs}};
+namespace json {
+std::shared_ptr<const RenderedStats> Render(StatsSampler::Snapshot stats) {
+    static auto const RenderLatency = perf::Register("serialize.render");
+    perf::ScopedTimer const Timer(RenderLatency);
+    auto Rendered = std::make_shared<RenderedStats>();
+
+    // About 50 bytes per core (70 with a temperature) and 200 per device plus the fixed fields, most of them
+    // memory and pressure stalls; reserving up front avoids regrowth while appending
+    constexpr std::size_t BYTES_PER_CORE = 80;
+    constexpr std::size_t BYTES_PER_DEVICE = 224;
+    constexpr std::size_t FIXED_BYTES = 1024;
+    auto const Estimate = (stats->cpu.cores.size() * BYTES_PER_CORE) +
+                          ((stats->disks.size() + stats->network.size()) * BYTES_PER_DEVICE) + FIXED_BYTES;
+
+    Rendered->cpuBody.reserve(Estimate);
+    AppendJson(Rendered->cpuBody, stats->cpu);
+    AppendJson(Rendered->memoryBody, stats->memory);
+
+    // Laid out by JsonFields<SystemStats> with the bodies above copied in, so the cores are serialized once
+    Rendered->statsBody.reserve(Estimate);
+    AppendJsonReusing(Rendered->statsBody,
+                      *stats,
+                      Prerendered{&SystemStats::cpu, std::string_view(Rendered->cpuBody)},
+                      Prerendered{&SystemStats::memory, std::string_view(Rendered->memoryBody)});
+
+    // Stream frames use the frontend's WebSocketMessage envelope
+    constexpr std::string_view FRAME_PREFIX = R"(data: {"type":"stats","timestamp":)";
+    constexpr std::string_view FRAME_DATA = R"(,"data":)";
+    constexpr std::string_view FRAME_SUFFIX = "}\n\n";
+    Rendered->streamFrame.reserve(Rendered->statsBody.size() + FIXED_BYTES);
+    Rendered->streamFrame.append(FRAME_PREFIX);
+    AppendJson(Rendered->streamFrame, stats->timestamp);
+    Rendered->streamFrame.append(FRAME_DATA).append(Rendered->statsBody).append(FRAME_SUFFIX);
+
+    binary::AppendStats(Rendered->binaryBody, *stats);
+    Rendered->binaryFrame.reserve(Rendered->binaryBody.size() + 10);
+    binary::AppendVarint(Rendered->binaryFrame, Rendered->binaryBody.size());
+    Rendered->binaryFrame.append(Rendered->binaryBody);
+
+    Rendered->stats = std::move(stats);
+    return Rendered;
 }
 }  // namespace json
 
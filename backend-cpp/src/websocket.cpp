@@ -0,0 +1,651 @@
+#include "websocket.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <span>
+
+#if defined(_WIN32)
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+    #pragma comment(lib, "ws2_32.lib")
+#else
+    #include <cerrno>
+
+    #include <fcntl.h>
+    #include <netdb.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+namespace pc_monitor {
+
+namespace {
+
+#if defined(_WIN32)
+using PollDescriptor = WSAPOLLFD;
+constexpr SocketHandle INVALID_SOCKET_HANDLE = INVALID_SOCKET;
+constexpr int SEND_FLAGS = 0;
+constexpr int SEND_MORE_FLAGS = 0;
+
+int PollSockets(PollDescriptor* descriptors, std::size_t count, int timeoutMs) {
+    return WSAPoll(descriptors, static_cast<ULONG>(count), timeoutMs);
+}
+
+void CloseSocket(SocketHandle socket) {
+    closesocket(socket);
+}
+
+void ShutdownSocket(SocketHandle socket) {
+    shutdown(socket, SD_BOTH);
+}
+
+void SetNonBlocking(SocketHandle socket) {
+    u_long Enable = 1;
+    ioctlsocket(socket, FIONBIO, &Enable);
+}
+
+bool WouldBlock() {
+    return WSAGetLastError() == WSAEWOULDBLOCK;
+}
+#else
+using PollDescriptor = pollfd;
+constexpr SocketHandle INVALID_SOCKET_HANDLE = -1;
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+constexpr int SEND_MORE_FLAGS = MSG_NOSIGNAL | MSG_MORE;
+
+int PollSockets(PollDescriptor* descriptors, std::size_t count, int timeoutMs) {
+    return ::poll(descriptors, static_cast<nfds_t>(count), timeoutMs);
+}
+
+void CloseSocket(SocketHandle socket) {
+    ::close(socket);
+}
+
+void ShutdownSocket(SocketHandle socket) {
+    ::shutdown(socket, SHUT_RDWR);
+}
+
+void SetNonBlocking(SocketHandle socket) {
+    ::fcntl(socket, F_SETFL, ::fcntl(socket, F_GETFL) | O_NONBLOCK);
+}
+
+bool WouldBlock() {
+    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+}
+#endif
+
+constexpr std::uint8_t OPCODE_CONTINUATION = 0x0;
+constexpr std::uint8_t OPCODE_TEXT = 0x1;
+constexpr std::uint8_t OPCODE_BINARY = 0x2;
+constexpr std::uint8_t OPCODE_CLOSE = 0x8;
+constexpr std::uint8_t OPCODE_PING = 0x9;
+constexpr std::uint8_t OPCODE_PONG = 0xA;
+
+constexpr std::uint16_t CLOSE_PROTOCOL_ERROR = 1002;
+constexpr std::uint16_t CLOSE_TOO_BIG = 1009;
+
+// Clients only send control frames and small messages to this server
+constexpr std::size_t MAX_CLIENT_FRAME = 64 * 1024;
+constexpr std::size_t MAX_HANDSHAKE_SIZE = 8 * 1024;
+constexpr auto HANDSHAKE_TIMEOUT = std::chrono::seconds{10};
+
+// After accept() fails (e.g. out of descriptors) the still-readable listener is left out of poll() this long,
+// or until a connection closes, instead of spinning on it
+constexpr auto ACCEPT_BACKOFF = std::chrono::milliseconds{100};
+
+// Frames a client has not taken yet; one that falls further behind is disconnected, as StreamHub does
+constexpr std::size_t MAX_PENDING_OUTPUT = 1024 * 1024;
+constexpr int POLL_INTERVAL_MS = 200;
+
+constexpr std::string_view HANDSHAKE_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+bool SendAll(SocketHandle socket, std::string_view data, int flags) {
+    while (!data.empty()) {
+        auto const Sent = ::send(socket, data.data(), static_cast<int>(data.size()), flags);
+        if (Sent <= 0) {
+            return false;
+        }
+        data.remove_prefix(static_cast<std::size_t>(Sent));
+    }
+    return true;
+}
+
+// Bytes written before the non-blocking socket would block, or -1 once the connection failed
+std::ptrdiff_t SendSome(SocketHandle socket, std::string_view data, int flags) {
+    std::size_t Total = 0;
+    while (Total < data.size()) {
+        auto const Sent = ::send(socket, data.data() + Total, static_cast<int>(data.size() - Total), flags);
+        if (Sent < 0 && WouldBlock()) {
+            break;
+        }
+        if (Sent <= 0) {
+            return -1;
+        }
+        Total += static_cast<std::size_t>(Sent);
+    }
+    return static_cast<std::ptrdiff_t>(Total);
+}
+
+std::uint32_t RotateLeft(std::uint32_t value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+}
+
+// SHA-1 as required by the Sec-WebSocket-Accept computation
+std::array<std::uint8_t, 20> Sha1(std::string_view data) {
+    std::array<std::uint32_t, 5> State = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+
+    std::string Message(data);
+    Message += static_cast<char>(0x80);
+    while (Message.size() % 64 != 56) {
+        Message += '\0';
+    }
+    auto const BitLength = static_cast<std::uint64_t>(data.size()) * 8;
+    for (int Shift = 56; Shift >= 0; Shift -= 8) {
+        Message += static_cast<char>((BitLength >> Shift) & 0xFF);
+    }
+
+    for (std::size_t Chunk = 0; Chunk < Message.size(); Chunk += 64) {
+        std::array<std::uint32_t, 80> Words{};
+        for (std::size_t I = 0; I < 16; ++I) {
+            for (std::size_t Byte = 0; Byte < 4; ++Byte) {
+                Words[I] = (Words[I] << 8) | static_cast<std::uint8_t>(Message[Chunk + (I * 4) + Byte]);
+            }
+        }
+        for (std::size_t I = 16; I < 80; ++I) {
+            Words[I] = RotateLeft(Words[I - 3] ^ Words[I - 8] ^ Words[I - 14] ^ Words[I - 16], 1);
+        }
+
+        auto [A, B, C, D, E] = State;
+        for (std::size_t I = 0; I < 80; ++I) {
+            std::uint32_t F = 0;
+            std::uint32_t K = 0;
+            if (I < 20) {
+                F = (B & C) | (~B & D);
+                K = 0x5A827999;
+            } else if (I < 40) {
+                F = B ^ C ^ D;
+                K = 0x6ED9EBA1;
+            } else if (I < 60) {
+                F = (B & C) | (B & D) | (C & D);
+                K = 0x8F1BBCDC;
+            } else {
+                F = B ^ C ^ D;
+                K = 0xCA62C1D6;
+            }
+            auto const Temp = RotateLeft(A, 5) + F + E + K + Words[I];
+            E = D;
+            D = C;
+            C = RotateLeft(B, 30);
+            B = A;
+            A = Temp;
+        }
+        State[0] += A;
+        State[1] += B;
+        State[2] += C;
+        State[3] += D;
+        State[4] += E;
+    }
+
+    std::array<std::uint8_t, 20> Digest{};
+    for (std::size_t I = 0; I < Digest.size(); ++I) {
+        Digest[I] = static_cast<std::uint8_t>(State[I / 4] >> (24 - ((I % 4) * 8)));
+    }
+    return Digest;
+}
+
+std::string Base64(std::span<const std::uint8_t> data) {
+    constexpr std::string_view ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    std::string Encoded;
+    Encoded.reserve(((data.size() + 2) / 3) * 4);
+    for (std::size_t I = 0; I < data.size(); I += 3) {
+        std::uint32_t Group = static_cast<std::uint32_t>(data[I]) << 16;
+        if (I + 1 < data.size()) {
+            Group |= static_cast<std::uint32_t>(data[I + 1]) << 8;
+        }
+        if (I + 2 < data.size()) {
+            Group |= data[I + 2];
+        }
+        Encoded += ALPHABET[(Group >> 18) & 0x3F];
+        Encoded += ALPHABET[(Group >> 12) & 0x3F];
+        Encoded += I + 1 < data.size() ? ALPHABET[(Group >> 6) & 0x3F] : '=';
+        Encoded += I + 2 < data.size() ? ALPHABET[Group & 0x3F] : '=';
+    }
+    return Encoded;
+}
+
+bool EqualsIgnoreCase(std::string_view left, std::string_view right) {
+    return std::ranges::equal(left, right, [](char L, char R) {
+        return std::tolower(static_cast<unsigned char>(L)) == std::tolower(static_cast<unsigned char>(R));
+    });
+}
+
+bool ContainsIgnoreCase(std::string_view text, std::string_view token) {
+    return std::ranges::search(text, token, [](char L, char R) {
+               return std::tolower(static_cast<unsigned char>(L)) == std::tolower(static_cast<unsigned char>(R));
+           }).begin() != text.end();
+}
+
+std::string_view Trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+}  // namespace
+
+// WebSocketConnection implementation
+WebSocketConnection::WebSocketConnection(SocketHandle socket) : socket_(socket) {
+    int const NoDelay = 1;
+    setsockopt(socket_, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&NoDelay), sizeof(NoDelay));
+    SetNonBlocking(socket_);
+}
+
+WebSocketConnection::~WebSocketConnection() {
+    CloseSocket(socket_);
+}
+
+bool WebSocketConnection::SendText(std::string_view payload) {
+    return SendFrame(OPCODE_TEXT, payload);
+}
+
+bool WebSocketConnection::SendFrame(std::uint8_t opcode, std::string_view payload) {
+    // Server frames are never masked: FIN + opcode, then a 7, 16 or 64 bit length
+    std::array<char, 10> Header{};
+    std::size_t HeaderSize = 2;
+    Header[0] = static_cast<char>(0x80 | opcode);
+    if (payload.size() < 126) {
+        Header[1] = static_cast<char>(payload.size());
+    } else if (payload.size() <= 0xFFFF) {
+        Header[1] = 126;
+        Header[2] = static_cast<char>((payload.size() >> 8) & 0xFF);
+        Header[3] = static_cast<char>(payload.size() & 0xFF);
+        HeaderSize = 4;
+    } else {
+        Header[1] = 127;
+        for (std::size_t I = 0; I < 8; ++I) {
+            Header[2 + I] = static_cast<char>((static_cast<std::uint64_t>(payload.size()) >> (56 - (I * 8))) & 0xFF);
+        }
+        HeaderSize = 10;
+    }
+
+    std::string_view const Head(Header.data(), HeaderSize);
+    std::lock_guard<std::mutex> const Lock(sendMutex_);
+    if (!open_.load()) {
+        return false;
+    }
+
+    // Written straight to the socket while nothing is queued; whatever it does not take waits for the
+    // listener thread, which flushes on POLLOUT
+    std::ptrdiff_t HeadSent = 0;
+    std::ptrdiff_t PayloadSent = 0;
+    if (pendingOutput_.empty()) {
+        HeadSent = SendSome(socket_, Head, payload.empty() ? SEND_FLAGS : SEND_MORE_FLAGS);
+        if (HeadSent == static_cast<std::ptrdiff_t>(Head.size())) {
+            PayloadSent = SendSome(socket_, payload, SEND_FLAGS);
+        }
+    }
+    auto const Unsent = (Head.size() - static_cast<std::size_t>(std::max<std::ptrdiff_t>(HeadSent, 0))) +
+                        (payload.size() - static_cast<std::size_t>(std::max<std::ptrdiff_t>(PayloadSent, 0)));
+    if (HeadSent < 0 || PayloadSent < 0 || pendingOutput_.size() + Unsent > MAX_PENDING_OUTPUT) {
+        ShutdownLocked();
+        return false;
+    }
+    pendingOutput_.append(Head.substr(static_cast<std::size_t>(HeadSent)));
+    pendingOutput_.append(payload.substr(static_cast<std::size_t>(PayloadSent)));
+    return true;
+}
+
+bool WebSocketConnection::HasPendingOutput() {
+    std::lock_guard<std::mutex> const Lock(sendMutex_);
+    return !pendingOutput_.empty();
+}
+
+bool WebSocketConnection::FlushPending() {
+    std::lock_guard<std::mutex> const Lock(sendMutex_);
+    if (!open_.load()) {
+        return false;
+    }
+    auto const Sent = SendSome(socket_, pendingOutput_, SEND_FLAGS);
+    if (Sent < 0) {
+        ShutdownLocked();
+        return false;
+    }
+    pendingOutput_.erase(0, static_cast<std::size_t>(Sent));
+    return true;
+}
+
+void WebSocketConnection::Close(std::uint16_t code) {
+    std::array<char, 2> const Payload = {static_cast<char>(code >> 8), static_cast<char>(code & 0xFF)};
+    SendFrame(OPCODE_CLOSE, {Payload.data(), Payload.size()});
+
+    std::lock_guard<std::mutex> const Lock(sendMutex_);
+    ShutdownLocked();
+}
+
+void WebSocketConnection::ShutdownLocked() {
+    // The descriptor itself stays valid until the last owner releases the connection
+    if (open_.exchange(false)) {
+        ShutdownSocket(socket_);
+        pendingOutput_.clear();
+    }
+}
+
+// WebSocketListener implementation
+WebSocketListener::WebSocketListener(std::string path, OpenHandler onOpen)
+    : path_(std::move(path)), onOpen_(std::move(onOpen)), listenSocket_(INVALID_SOCKET_HANDLE) {}
+
+WebSocketListener::~WebSocketListener() {
+    Stop();
+}
+
+Result<void> WebSocketListener::Start(const std::string& host, std::uint16_t port) {
+    if (running_.load()) {
+        return std::unexpected(SystemError::SYSTEM_ERROR);
+    }
+
+    addrinfo Hints{};
+    Hints.ai_family = AF_UNSPEC;
+    Hints.ai_socktype = SOCK_STREAM;
+    Hints.ai_flags = AI_PASSIVE;
+
+    addrinfo* Addresses = nullptr;
+    auto const Service = std::to_string(port);
+    if (getaddrinfo(host.c_str(), Service.c_str(), &Hints, &Addresses) != 0 || Addresses == nullptr) {
+        return std::unexpected(SystemError::INITIALIZATION_FAILED);
+    }
+
+    for (auto* Address = Addresses; Address != nullptr; Address = Address->ai_next) {
+        auto const Socket = ::socket(Address->ai_family, Address->ai_socktype, Address->ai_protocol);
+        if (Socket == INVALID_SOCKET_HANDLE) {
+            continue;
+        }
+
+        int const Reuse = 1;
+        setsockopt(Socket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&Reuse), sizeof(Reuse));
+
+        if (::bind(Socket, Address->ai_addr, static_cast<int>(Address->ai_addrlen)) == 0 &&
+            ::listen(Socket, SOMAXCONN) == 0) {
+            listenSocket_ = Socket;
+            break;
+        }
+        CloseSocket(Socket);
+    }
+    freeaddrinfo(Addresses);
+
+    if (listenSocket_ == INVALID_SOCKET_HANDLE) {
+        return std::unexpected(SystemError::INITIALIZATION_FAILED);
+    }
+
+    running_.store(true);
+    ioThread_ = std::thread([this]() { Run(); });
+    return {};
+}
+
+void WebSocketListener::Stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    if (ioThread_.joinable()) {
+        ioThread_.join();
+    }
+
+    for (auto& Pending : pending_) {
+        CloseSocket(Pending.socket);
+    }
+    pending_.clear();
+
+    for (const auto& Connection : connections_) {
+        Connection->Close(1001);
+    }
+    connections_.clear();
+    connectionCount_.store(0);
+
+    CloseSocket(listenSocket_);
+    listenSocket_ = INVALID_SOCKET_HANDLE;
+}
+
+void WebSocketListener::Run() {
+    std::vector<PollDescriptor> Descriptors;
+
+    while (running_.load()) {
+        // Layout: listening socket, then pending handshakes, then open connections
+        Descriptors.clear();
+        short const ListenEvents = std::chrono::steady_clock::now() >= acceptResume_ ? POLLIN : 0;
+        Descriptors.push_back(PollDescriptor{.fd = listenSocket_, .events = ListenEvents, .revents = 0});
+        for (const auto& Pending : pending_) {
+            Descriptors.push_back(PollDescriptor{.fd = Pending.socket, .events = POLLIN, .revents = 0});
+        }
+        for (const auto& Connection : connections_) {
+            short const Events = Connection->HasPendingOutput() ? POLLIN | POLLOUT : POLLIN;
+            Descriptors.push_back(PollDescriptor{.fd = Connection->socket_, .events = Events, .revents = 0});
+        }
+
+        if (PollSockets(Descriptors.data(), Descriptors.size(), POLL_INTERVAL_MS) < 0) {
+            continue;
+        }
+
+        // Connections first: completing a handshake below appends to connections_
+        auto const Open = connections_.size() + pending_.size();
+        std::size_t Index = 1 + pending_.size();
+        std::erase_if(connections_, [&](const std::shared_ptr<WebSocketConnection>& connection) {
+            auto const Events = Descriptors[Index++].revents;
+            if (!connection->IsOpen()) {
+                return true;
+            }
+            if ((Events & POLLOUT) != 0 && !connection->FlushPending()) {
+                return true;
+            }
+            if ((Events & (POLLIN | POLLERR | POLLHUP)) != 0 && !ReadFrames(*connection)) {
+                connection->Close();
+                return true;
+            }
+            return false;
+        });
+
+        auto const Now = std::chrono::steady_clock::now();
+        Index = 1;
+        std::erase_if(pending_, [&](PendingHandshake& pending) {
+            auto const Events = Descriptors[Index++].revents;
+            if ((Events & (POLLIN | POLLERR | POLLHUP)) != 0) {
+                return !ReadHandshake(pending);
+            }
+            if (Now - pending.accepted > HANDSHAKE_TIMEOUT) {
+                CloseSocket(pending.socket);
+                return true;
+            }
+            return false;
+        });
+
+        // A closed socket frees a descriptor, so a paused accept is retried right away
+        if (connections_.size() + pending_.size() < Open) {
+            acceptResume_ = {};
+        }
+        if ((Descriptors[0].revents & POLLIN) != 0) {
+            AcceptPending();
+        }
+
+        connectionCount_.store(connections_.size());
+    }
+}
+
+void WebSocketListener::AcceptPending() {
+    auto const Socket = ::accept(listenSocket_, nullptr, nullptr);
+    if (Socket == INVALID_SOCKET_HANDLE) {
+        acceptResume_ = std::chrono::steady_clock::now() + ACCEPT_BACKOFF;
+        return;
+    }
+    pending_.push_back(PendingHandshake{.socket = Socket, .request = {}, .accepted = std::chrono::steady_clock::now()});
+}
+
+bool WebSocketListener::ReadHandshake(PendingHandshake& pending) {
+    std::array<char, 2048> Buffer;
+    auto const Received = ::recv(pending.socket, Buffer.data(), static_cast<int>(Buffer.size()), 0);
+    if (Received <= 0) {
+        CloseSocket(pending.socket);
+        return false;
+    }
+    pending.request.append(Buffer.data(), static_cast<std::size_t>(Received));
+
+    auto const HeaderEnd = pending.request.find("\r\n\r\n");
+    if (HeaderEnd == std::string::npos) {
+        if (pending.request.size() > MAX_HANDSHAKE_SIZE) {
+            SendAll(pending.socket, "HTTP/1.1 431 Request Header Fields Too Large\r\n\r\n", SEND_FLAGS);
+            CloseSocket(pending.socket);
+            return false;
+        }
+        return true;
+    }
+
+    std::string_view Remaining(pending.request.data(), HeaderEnd + 2);
+    auto const RequestLine = Remaining.substr(0, Remaining.find("\r\n"));
+    Remaining.remove_prefix(RequestLine.size() + 2);
+
+    // "GET <path>[?query] HTTP/1.1"
+    auto const Target = RequestLine.substr(RequestLine.find(' ') + 1);
+    auto const Path = Target.substr(0, Target.find_first_of(" ?"));
+
+    std::string_view Key;
+    bool Upgrade = false;
+    while (!Remaining.empty()) {
+        auto const Line = Remaining.substr(0, Remaining.find("\r\n"));
+        Remaining.remove_prefix(std::min(Remaining.size(), Line.size() + 2));
+
+        auto const Colon = Line.find(':');
+        if (Colon == std::string_view::npos) {
+            continue;
+        }
+        auto const Name = Trim(Line.substr(0, Colon));
+        auto const Value = Trim(Line.substr(Colon + 1));
+        if (EqualsIgnoreCase(Name, "Sec-WebSocket-Key")) {
+            Key = Value;
+        } else if (EqualsIgnoreCase(Name, "Upgrade")) {
+            Upgrade = ContainsIgnoreCase(Value, "websocket");
+        }
+    }
+
+    if (!RequestLine.starts_with("GET ") || Path != path_) {
+        SendAll(pending.socket, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n", SEND_FLAGS);
+        CloseSocket(pending.socket);
+        return false;
+    }
+    if (!Upgrade || Key.empty()) {
+        SendAll(pending.socket, "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n", SEND_FLAGS);
+        CloseSocket(pending.socket);
+        return false;
+    }
+
+    std::string KeyWithGuid(Key);
+    KeyWithGuid += HANDSHAKE_GUID;
+    auto const Digest = Sha1(KeyWithGuid);
+
+    std::string Response =
+        "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\nSec-WebSocket-Accept: ";
+    Response += Base64(Digest);
+    Response += "\r\n\r\n";
+    if (!SendAll(pending.socket, Response, SEND_FLAGS)) {
+        CloseSocket(pending.socket);
+        return false;
+    }
+
+    auto Connection = std::make_shared<WebSocketConnection>(pending.socket);
+    // Anything the client pipelined after the handshake is its first frame data
+    Connection->readBuffer_ = pending.request.substr(HeaderEnd + 4);
+    connections_.push_back(Connection);
+    onOpen_(Connection);
+    return false;
+}
+
+bool WebSocketListener::ReadFrames(WebSocketConnection& connection) {
+    std::array<char, 4096> Buffer;
+    auto const Received = ::recv(connection.socket_, Buffer.data(), static_cast<int>(Buffer.size()), 0);
+    if (Received < 0 && WouldBlock()) {
+        return true;
+    }
+    if (Received <= 0) {
+        return false;
+    }
+
+    auto& Pending = connection.readBuffer_;
+    Pending.append(Buffer.data(), static_cast<std::size_t>(Received));
+
+    while (Pending.size() >= 2) {
+        auto const First = static_cast<std::uint8_t>(Pending[0]);
+        auto const Second = static_cast<std::uint8_t>(Pending[1]);
+        auto const Opcode = static_cast<std::uint8_t>(First & 0x0F);
+        bool const Masked = (Second & 0x80) != 0;
+
+        std::uint64_t Length = Second & 0x7F;
+        std::size_t Offset = 2;
+        if (Length == 126) {
+            if (Pending.size() < 4) {
+                return true;
+            }
+            Length = (static_cast<std::uint64_t>(static_cast<std::uint8_t>(Pending[2])) << 8) |
+                     static_cast<std::uint8_t>(Pending[3]);
+            Offset = 4;
+        } else if (Length == 127) {
+            if (Pending.size() < 10) {
+                return true;
+            }
+            Length = 0;
+            for (std::size_t I = 2; I < 10; ++I) {
+                Length = (Length << 8) | static_cast<std::uint8_t>(Pending[I]);
+            }
+            Offset = 10;
+        }
+
+        // RFC 6455 5.1: a server must close the connection on unmasked client frames
+        if (!Masked) {
+            connection.Close(CLOSE_PROTOCOL_ERROR);
+            return false;
+        }
+        if (Length > MAX_CLIENT_FRAME) {
+            connection.Close(CLOSE_TOO_BIG);
+            return false;
+        }
+
+        auto const FrameSize = Offset + 4 + static_cast<std::size_t>(Length);
+        if (Pending.size() < FrameSize) {
+            return true;
+        }
+
+        std::string Payload = Pending.substr(Offset + 4, static_cast<std::size_t>(Length));
+        for (std::size_t I = 0; I < Payload.size(); ++I) {
+            Payload[I] = static_cast<char>(Payload[I] ^ Pending[Offset + (I % 4)]);
+        }
+        Pending.erase(0, FrameSize);
+
+        switch (Opcode) {
+            case OPCODE_CLOSE:
+                connection.Close();
+                return false;
+            case OPCODE_PING:
+                connection.SendFrame(OPCODE_PONG, Payload);
+                break;
+            case OPCODE_PONG:
+            case OPCODE_TEXT:
+            case OPCODE_BINARY:
+            case OPCODE_CONTINUATION:
+                // The stream is server-to-client only; client messages carry nothing to act on
+                break;
+            default:
+                connection.Close(CLOSE_PROTOCOL_ERROR);
+                return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace pc_monitor
@@ -1,37 +1,195 @@
 export interface SystemStats {
   cpu: CPUUsageData;
+  disks: DiskDeviceData[];
   memory: MemoryUsageData;
+  network: NetworkInterfaceData[];
   timestamp: number;
 }
 
 export interface CPUUsageData {
   overall: number;        // 0-100%
-  temperature?: number;   // Celsius
+  temperature?: number;   // Celsius, the hottest package
   averageFrequency: number; // MHz
   cores: CPUCoreData[];
+  packages: CpuPackageThermal[];
+  throttling: boolean;    // any package throttling
   timestamp?: number;     // Unix timestamp
 }
 
+// A package is throttling while it runs within 10 C of critical with its clocks below 85% of their peak
+export interface CpuPackageThermal {
+  critical?: number;      // Celsius
+  package: number;
+  temperature: number;    // Celsius
+  throttling: boolean;
+}
+
 export interface MemoryUsageData {
   total: number;          // bytes
   used: number;           // bytes
   available: number;      // bytes
-  cache: number;          // bytes
+  cache: number;          // bytes, page cache
   buffers: number;        // bytes
   usagePercent: number;   // calculated 0-100%
+  slab: number;           // bytes
+  dirty: number;          // bytes
+  writeback: number;      // bytes
+  swapTotal: number;      // bytes
+  swapUsed: number;       // bytes
+  hugePagesTotal: number; // bytes
+  hugePagesFree: number;  // bytes
+  pressure?: SystemPressure; // absent without PSI
   timestamp?: number;     // Unix timestamp
 }
 
+// One /proc/pressure line: % of wall time with tasks stalled, over 10 s, 60 s and 300 s
+export interface PressureStall {
+  avg10: number;
+  avg60: number;
+  avg300: number;
+  total: number;          // microseconds stalled since boot
+}
+
+export interface ResourcePressure {
+  some: PressureStall;    // at least one task stalled
+  full?: PressureStall;   // every non-idle task stalled
+}
+
+export interface SystemPressure {
+  cpu: ResourcePressure;
+  io: ResourcePressure;
+  memory: ResourcePressure;
+}
+
 export interface CPUCoreData {
   coreId: number;
   usage: number;          // 0-100%
   frequency: number;      // MHz
+  temperature?: number;   // Celsius, of the physical core
 }
 
+// Rates between the last two samples of the device's cumulative counters
+export interface DiskDeviceData {
+  name: string;             // kernel name, e.g. "nvme0n1"
+  queueDepth: number;       // average requests in flight
+  readBytesPerSec: number;
+  readsPerSec: number;
+  utilization: number;      // 0-100% of the time with a request in flight
+  writeBytesPerSec: number;
+  writesPerSec: number;
+}
+
+export interface NetworkInterfaceData {
+  dropsPerSec: number;
+  errorsPerSec: number;
+  name: string;
+  rxBytesPerSec: number;
+  rxPacketsPerSec: number;
+  txBytesPerSec: number;
+  txPacketsPerSec: number;
+}
+
+export type DiskRateKey = Exclude<keyof DiskDeviceData, 'name'>;
+export type NetworkRateKey = Exclude<keyof NetworkInterfaceData, 'name'>;
+
+// Rate keys in wire order (binary messages, history series)
+export const DISK_RATE_KEYS: readonly DiskRateKey[] = [
+  'queueDepth', 'readBytesPerSec', 'readsPerSec', 'utilization', 'writeBytesPerSec', 'writesPerSec',
+];
+export const NETWORK_RATE_KEYS: readonly NetworkRateKey[] = [
+  'dropsPerSec', 'errorsPerSec', 'rxBytesPerSec', 'rxPacketsPerSec', 'txBytesPerSec', 'txPacketsPerSec',
+];
+
 export interface WebSocketMessage {
-  type: 'stats' | 'error' | 'heartbeat';
+  type: 'stats' | 'delta' | 'alert' | 'error' | 'heartbeat';
+  seq?: number;           // stats/delta sequence on the WebSocket stream
   timestamp: number;
-  data: SystemStats | ErrorData | null;
+  data: SystemStats | StatsDelta | AlertData | ErrorData | null;
+}
+
+// An alert rule instance that started or stopped firing; also the entries of /api/alerts
+export interface AlertData {
+  instance: string;       // core id, package id or device name; empty for host-wide metrics
+  metric: string;         // e.g. "cpu.core.usage", "disk.utilization"
+  rule: string;
+  severity: 'warning' | 'critical';
+  since: number;          // Unix ms, when the condition started to hold
+  state: 'firing' | 'resolved';
+  threshold: number;
+  timestamp: number;
+  value: number | null;   // null when the core or device went away
+}
+
+export interface AlertsResponse {
+  alerts: AlertData[];    // firing now
+  checks: number;         // rule instances evaluated per sample
+  rules: number;
+}
+
+// One upstream of a federating instance; /api/fleet/host?name= serves its last full SystemStats
+export interface FleetHost {
+  address: string;        // host:port
+  cores: number;
+  cpu: number;
+  diskReadBytesPerSec: number;
+  diskWriteBytesPerSec: number;
+  error?: string;         // why the last fetch failed, while down
+  failures: number;       // consecutive failed fetches
+  lastSeen?: number;      // Unix ms of the last good fetch
+  latencyMs: number;
+  memoryTotal: number;
+  memoryUsagePercent: number;
+  memoryUsed: number;
+  name: string;
+  networkRxBytesPerSec: number;
+  networkTxBytesPerSec: number;
+  temperature?: number;
+  throttling: boolean;
+  up: boolean;
+}
+
+// Totals over the hosts that are up
+export interface FleetRollup {
+  busiest?: string;
+  cores: number;
+  cpuMax: number;
+  cpuMean: number;        // weighted by core count
+  diskReadBytesPerSec: number;
+  diskWriteBytesPerSec: number;
+  hosts: number;
+  memoryTotal: number;
+  memoryUsagePercent: number;
+  memoryUsed: number;
+  networkRxBytesPerSec: number;
+  networkTxBytesPerSec: number;
+  temperatureMax?: number;
+  throttling: number;     // hosts with a throttling package
+  up: number;
+}
+
+export interface FleetResponse {
+  hosts: FleetHost[];
+  rollup: FleetRollup;
+  timestamp: number;
+}
+
+// Changed fields since frame seq - 1; per-core, per-package and per-device entries are [index, value] pairs.
+// The package and device lists never change in a delta: the server sends a full snapshot instead.
+export interface StatsDelta {
+  cpu?: {
+    overall?: number;
+    averageFrequency?: number;
+    temperature?: number | null;
+    throttling?: boolean;
+    usage?: [number, number][];
+    frequency?: [number, number][];
+    coreTemperature?: [number, number | null][];
+    packageTemperature?: [number, number][];
+    packageThrottling?: [number, boolean][];
+  };
+  disks?: Partial<Record<DiskRateKey, [number, number][]>>;
+  memory?: Partial<Omit<MemoryUsageData, 'timestamp' | 'pressure'>> & { pressure?: SystemPressure | null };
+  network?: Partial<Record<NetworkRateKey, [number, number][]>>;
 }
 
 export interface ErrorData {
@@ -40,6 +198,131 @@ export interface ErrorData {
   retry: boolean | (() => void);
 }
 
+// /api/history: one bucket per timestamp, every series column-aligned with `timestamps`
+export interface HistorySeries {
+  avg: number[];
+  max: number[];
+  min: number[];
+}
+
+export type DiskHistory = { name: string } & Record<DiskRateKey, HistorySeries>;
+export type NetworkHistory = { name: string } & Record<NetworkRateKey, HistorySeries>;
+
+export interface HistoryResponse {
+  cpu: {
+    cores: { coreId: number; frequency: HistorySeries; usage: HistorySeries }[];
+    overall: HistorySeries;
+  };
+  disks: DiskHistory[];
+  memory: Record<'available' | 'buffers' | 'cache' | 'usagePercent' | 'used', HistorySeries>;
+  memoryBytes: number;    // history buffer footprint on the server
+  network: NetworkHistory[];
+  points: number;
+  step: number;           // ms
+  timestamps: number[];   // bucket start, Unix ms
+}
+
+// /api/history/summary: null fields when the range holds no samples
+export interface SeriesSummary {
+  max: number | null;
+  mean: number | null;
+  min: number | null;
+  p50: number | null;
+  p95: number | null;
+  p99: number | null;
+  stddev: number | null;
+}
+
+export interface HistorySummaryResponse {
+  cpu: {
+    cores: { coreId: number; frequency: SeriesSummary; usage: SeriesSummary }[];
+    overall: SeriesSummary;
+    spread: SeriesSummary;  // per-core mean usage across cores
+  };
+  disks: ({ name: string } & Record<DiskRateKey, SeriesSummary>)[];
+  memory: Record<'available' | 'buffers' | 'cache' | 'usagePercent' | 'used', SeriesSummary>;
+  network: ({ name: string } & Record<NetworkRateKey, SeriesSummary>)[];
+  points: number;
+  step: number;           // ms
+}
+
+// /api/processes?top=N&sort=cpu|rss, largest first
+export interface ProcessInfo {
+  cpu: number;   // % of one core since the previous scan
+  name: string;
+  pid: number;
+  rss: number;   // bytes
+}
+
+export interface ProcessesResponse {
+  processes: ProcessInfo[];
+  sort: 'cpu' | 'rss';
+  timestamp: number;
+  total: number;  // processes in the scan
+}
+
+// /api/cgroups?top=N&sort=cpu|memory|io&prefix=/path, largest first; 500 on hosts without cgroup v2
+export interface CgroupInfo {
+  anon: number;              // bytes
+  cpu: number;               // % of one core since the previous scan, descendants included
+  file: number;              // page cache, bytes
+  memory: number;            // memory.current, bytes
+  path: string;              // e.g. /system.slice/docker-1f.scope
+  readBytesPerSec: number;
+  writeBytesPerSec: number;
+}
+
+export interface CgroupsResponse {
+  cgroups: CgroupInfo[];
+  prefix: string;
+  sort: 'cpu' | 'memory' | 'io';
+  timestamp: number;
+  total: number;  // cgroups in the scan
+}
+
+// /api/sampling; jitter is how late a run started after its deadline
+export interface SamplingTaskStats {
+  intervalMs: number;      // current interval, stretched while idle; 0 for one-shot tasks
+  lastDurationUs: number;
+  lastJitterUs: number;
+  maxJitterUs: number;
+  meanJitterUs: number;
+  missed: number;          // deadlines skipped after a late run
+  name: string;
+  runs: number;
+}
+
+export interface SamplingResponse {
+  idle: boolean;
+  tasks: SamplingTaskStats[];
+}
+
+// /api/topology; discovered once when the server starts
+export interface CpuCacheInfo {
+  cpus: number[];          // logical cpus sharing this cache
+  level: number;
+  lineSize: number;        // bytes
+  size: number;            // bytes
+  type: 'data' | 'instruction' | 'unified' | 'trace';
+}
+
+export interface LogicalCpuInfo {
+  core: number;            // physical core id within the package
+  cpuId: number;           // matches CPUCoreData.coreId
+  node: number;            // NUMA node
+  package: number;
+  siblings: number[];      // logical cpus of the same physical core, including this one
+}
+
+export interface CpuTopology {
+  caches: CpuCacheInfo[];
+  cpus: LogicalCpuInfo[];
+  logicalCpus: number;
+  numaNodes: number;
+  packages: number;
+  physicalCores: number;
+}
+
 export interface ChartDataPoint {
   timestamp: number;
   value: number;
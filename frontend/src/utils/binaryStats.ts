@@ -0,0 +1,380 @@
+import { DISK_RATE_KEYS, NETWORK_RATE_KEYS } from '../types';
+import type {
+  CPUCoreData,
+  CpuPackageThermal,
+  DiskDeviceData,
+  HistoryResponse,
+  HistorySeries,
+  MemoryUsageData,
+  NetworkInterfaceData,
+  PressureStall,
+  ResourcePressure,
+  SystemPressure,
+  SystemStats,
+} from '../types';
+
+// Decoder for the backend's binary wire format (requested with `Accept: application/x-pc-monitor` or
+// `?format=binary`). The layout is documented in backend-cpp/include/binary_codec.hpp.
+
+export const BINARY_CONTENT_TYPE = 'application/x-pc-monitor';
+
+const MAGIC = 'PCMB';
+const MESSAGE_STATS = 1;
+const MESSAGE_HISTORY = 2;
+const HEADER_BYTES = 5;
+
+class BitReader {
+  private byteOffset: number;
+  private bitOffset = 0;
+
+  constructor(private readonly bytes: Uint8Array, offset: number) {
+    this.byteOffset = offset;
+  }
+
+  // Up to 32 bits, most significant first
+  readBits(count: number): number {
+    let value = 0;
+    while (count > 0) {
+      if (this.byteOffset >= this.bytes.length) {
+        throw new Error('Truncated binary message');
+      }
+      const available = 8 - this.bitOffset;
+      const take = Math.min(available, count);
+      const chunk = (this.bytes[this.byteOffset] >> (available - take)) & ((1 << take) - 1);
+      value = value * (1 << take) + chunk;
+      this.bitOffset += take;
+      count -= take;
+      if (this.bitOffset === 8) {
+        this.bitOffset = 0;
+        this.byteOffset += 1;
+      }
+    }
+    return value;
+  }
+
+  readBigBits(count: number): bigint {
+    const high = count > 32 ? this.readBits(count - 32) : 0;
+    const low = this.readBits(Math.min(count, 32));
+    return (BigInt(high) << 32n) | BigInt(low);
+  }
+
+  readBit(): boolean {
+    return this.readBits(1) === 1;
+  }
+
+  // Exact up to 2^53, which covers byte counts and millisecond timestamps
+  readVarint(): number {
+    let value = 0;
+    let scale = 1;
+    for (;;) {
+      const group = this.readBits(8);
+      value += (group & 0x7f) * scale;
+      if ((group & 0x80) === 0) {
+        return value;
+      }
+      scale *= 128;
+    }
+  }
+
+  readString(): string {
+    const bytes = Uint8Array.from({ length: this.readVarint() }, () => this.readBits(8));
+    return new TextDecoder().decode(bytes);
+  }
+
+  readSigned(): number {
+    const zigzag = this.readVarint();
+    return zigzag % 2 === 0 ? zigzag / 2 : -(zigzag + 1) / 2;
+  }
+}
+
+class XorDecoder {
+  private previous = 0n;
+  private leading = 0;
+  private trailing = 0;
+  private first = true;
+  private readonly view = new DataView(new ArrayBuffer(8));
+
+  constructor(private readonly reader: BitReader) {}
+
+  next(): number {
+    if (this.first) {
+      this.first = false;
+      this.previous = this.reader.readBigBits(64);
+    } else if (this.reader.readBit()) {
+      if (this.reader.readBit()) {
+        this.leading = this.reader.readBits(5);
+        const meaningful = this.reader.readBits(6) || 64;
+        this.trailing = 64 - this.leading - meaningful;
+      }
+      const meaningful = 64 - this.leading - this.trailing;
+      this.previous ^= this.reader.readBigBits(meaningful) << BigInt(this.trailing);
+    }
+    this.view.setBigUint64(0, this.previous);
+    return this.view.getFloat64(0);
+  }
+}
+
+class TimestampDecoder {
+  private previous = 0;
+  private previousDelta = 0;
+  private count = 0;
+
+  constructor(private readonly reader: BitReader) {}
+
+  next(): number {
+    this.count += 1;
+    if (this.count === 1) {
+      this.previous = this.reader.readVarint();
+      return this.previous;
+    }
+    if (this.count === 2) {
+      this.previousDelta = this.reader.readSigned();
+    } else {
+      this.previousDelta += this.readDeltaOfDelta();
+    }
+    this.previous += this.previousDelta;
+    return this.previous;
+  }
+
+  private readDeltaOfDelta(): number {
+    let zigzag: number;
+    if (!this.reader.readBit()) {
+      return 0;
+    } else if (!this.reader.readBit()) {
+      zigzag = this.reader.readBits(7);
+    } else if (!this.reader.readBit()) {
+      zigzag = this.reader.readBits(9);
+    } else if (!this.reader.readBit()) {
+      zigzag = this.reader.readBits(12);
+    } else {
+      zigzag = this.reader.readVarint();
+    }
+    return zigzag % 2 === 0 ? zigzag / 2 : -(zigzag + 1) / 2;
+  }
+}
+
+const readCoreIds = (reader: BitReader, count: number): number[] => {
+  if (!reader.readBit()) {
+    return Array.from({ length: count }, (_, index) => index);
+  }
+  const ids: number[] = [];
+  let previous = -1;
+  for (let i = 0; i < count; i += 1) {
+    previous += reader.readSigned();
+    ids.push(previous);
+  }
+  return ids;
+};
+
+const readNames = (reader: BitReader): string[] =>
+  Array.from({ length: reader.readVarint() }, () => reader.readString());
+
+// One device per name, its rates (values or history series) read in key order through `next`
+const readDevices = <K extends string, V>(
+  names: string[],
+  keys: readonly K[],
+  next: () => V,
+): ({ name: string } & Record<K, V>)[] =>
+  names.map((name) => {
+    const rates = {} as Record<K, V>;
+    keys.forEach((key) => { rates[key] = next(); });
+    return { name, ...rates };
+  });
+
+// Presence bits of the full lines, one chain of every line's averages, then every line's total
+const readPressure = (reader: BitReader): SystemPressure => {
+  const hasFull = [reader.readBit(), reader.readBit(), reader.readBit()];
+  const averages = new XorDecoder(reader);
+  const readLine = (): PressureStall => ({
+    avg10: averages.next(), avg60: averages.next(), avg300: averages.next(), total: 0,
+  });
+  const [cpu, io, memory]: ResourcePressure[] = hasFull.map((full) => ({
+    some: readLine(),
+    full: full ? readLine() : undefined,
+  }));
+  [cpu, io, memory].forEach((resource) => {
+    resource.some.total = reader.readVarint();
+    if (resource.full) {
+      resource.full.total = reader.readVarint();
+    }
+  });
+  return { cpu, io, memory };
+};
+
+const openMessage = (buffer: ArrayBuffer | Uint8Array, expectedType: number): BitReader => {
+  const bytes = buffer instanceof Uint8Array ? buffer : new Uint8Array(buffer);
+  const magic = String.fromCharCode(...bytes.subarray(0, MAGIC.length));
+  if (magic !== MAGIC || bytes[MAGIC.length] !== expectedType) {
+    throw new Error('Not a pc-monitor binary message of the expected type');
+  }
+  return new BitReader(bytes, HEADER_BYTES);
+};
+
+export const decodeStats = (buffer: ArrayBuffer | Uint8Array): SystemStats => {
+  const reader = openMessage(buffer, MESSAGE_STATS);
+  const timestamp = reader.readVarint();
+  const coreCount = reader.readVarint();
+  const coreIds = readCoreIds(reader, coreCount);
+  const hasTemperature = reader.readBit();
+
+  const values = new XorDecoder(reader);
+  const overall = values.next();
+  const temperature = hasTemperature ? values.next() : undefined;
+  const usagePercent = values.next();
+  const usages = coreIds.map(() => values.next());
+
+  const averageFrequency = reader.readVarint();
+  let frequency = 0;
+  const cores: CPUCoreData[] = coreIds.map((coreId, index) => {
+    frequency = index === 0 ? reader.readVarint() : frequency + reader.readSigned();
+    return { coreId, usage: usages[index], frequency };
+  });
+
+  const memoryTotals = {
+    total: reader.readVarint(),
+    used: reader.readVarint(),
+    available: reader.readVarint(),
+    cache: reader.readVarint(),
+    buffers: reader.readVarint(),
+    usagePercent,
+  };
+
+  const diskNames = readNames(reader);
+  const interfaceNames = readNames(reader);
+  const rates = new XorDecoder(reader);
+  const next = () => rates.next();
+  const disks: DiskDeviceData[] = readDevices(diskNames, DISK_RATE_KEYS, next);
+  const network: NetworkInterfaceData[] = readDevices(interfaceNames, NETWORK_RATE_KEYS, next);
+
+  const packageFlags = Array.from({ length: reader.readVarint() }, () => ({
+    package: reader.readVarint(),
+    hasCritical: reader.readBit(),
+    throttling: reader.readBit(),
+  }));
+  const anyCoreTemperature = reader.readBit();
+  const coreHasTemperature = coreIds.map(() => anyCoreTemperature && reader.readBit());
+  const temperatures = new XorDecoder(reader);
+  const packageTemperatures = packageFlags.map(() => temperatures.next());
+  const packages: CpuPackageThermal[] = packageFlags.map(({ package: id, hasCritical, throttling }, index) => ({
+    critical: hasCritical ? temperatures.next() : undefined,
+    package: id,
+    temperature: packageTemperatures[index],
+    throttling,
+  }));
+  coreHasTemperature.forEach((present, index) => {
+    if (present) {
+      cores[index].temperature = temperatures.next();
+    }
+  });
+  const throttling = packages.some((entry) => entry.throttling);
+
+  const memory: MemoryUsageData = {
+    ...memoryTotals,
+    slab: reader.readVarint(),
+    dirty: reader.readVarint(),
+    writeback: reader.readVarint(),
+    swapTotal: reader.readVarint(),
+    swapUsed: reader.readVarint(),
+    hugePagesTotal: reader.readVarint(),
+    hugePagesFree: reader.readVarint(),
+  };
+  if (reader.readBit()) {
+    memory.pressure = readPressure(reader);
+  }
+
+  return {
+    cpu: { overall, temperature, averageFrequency, cores, packages, throttling },
+    disks,
+    memory,
+    network,
+    timestamp,
+  };
+};
+
+export const decodeHistory = (buffer: ArrayBuffer | Uint8Array): HistoryResponse => {
+  const reader = openMessage(buffer, MESSAGE_HISTORY);
+  const step = reader.readVarint();
+  const points = reader.readVarint();
+  const memoryBytes = reader.readVarint();
+  const coreCount = reader.readVarint();
+  const coreIds = readCoreIds(reader, coreCount);
+  const diskNames = readNames(reader);
+  const interfaceNames = readNames(reader);
+
+  const timestampDecoder = new TimestampDecoder(reader);
+  const timestamps = Array.from({ length: points }, () => timestampDecoder.next());
+
+  const readChain = (): number[] => {
+    const decoder = new XorDecoder(reader);
+    return Array.from({ length: points }, () => decoder.next());
+  };
+  const readSeries = (): HistorySeries =>
+    points === 0 ? { avg: [], max: [], min: [] } : { avg: readChain(), max: readChain(), min: readChain() };
+
+  const overall = readSeries();
+  const memory = {
+    available: readSeries(),
+    buffers: readSeries(),
+    cache: readSeries(),
+    usagePercent: readSeries(),
+    used: readSeries(),
+  };
+  const usage = coreIds.map(() => readSeries());
+  const frequency = coreIds.map(() => readSeries());
+  const disks = readDevices(diskNames, DISK_RATE_KEYS, readSeries);
+  const network = readDevices(interfaceNames, NETWORK_RATE_KEYS, readSeries);
+
+  return {
+    cpu: {
+      cores: coreIds.map((coreId, index) => ({ coreId, frequency: frequency[index], usage: usage[index] })),
+      overall,
+    },
+    disks,
+    memory,
+    memoryBytes,
+    network,
+    points,
+    step,
+    timestamps,
+  };
+};
+
+// Splits the binary /ws/stats byte stream into messages; feed it every received chunk
+export class BinaryStreamReader {
+  private pending = new Uint8Array(0);
+
+  push(chunk: Uint8Array): SystemStats[] {
+    const combined = new Uint8Array(this.pending.length + chunk.length);
+    combined.set(this.pending);
+    combined.set(chunk, this.pending.length);
+
+    const messages: SystemStats[] = [];
+    let offset = 0;
+    for (;;) {
+      // Varint length prefix; a zero length is a heartbeat
+      let length = 0;
+      let scale = 1;
+      let cursor = offset;
+      let complete = false;
+      while (cursor < combined.length) {
+        const group = combined[cursor++];
+        length += (group & 0x7f) * scale;
+        scale *= 128;
+        if ((group & 0x80) === 0) {
+          complete = true;
+          break;
+        }
+      }
+      if (!complete || cursor + length > combined.length) {
+        break;
+      }
+      if (length > 0) {
+        messages.push(decodeStats(combined.subarray(cursor, cursor + length)));
+      }
+      offset = cursor + length;
+    }
+
+    this.pending = combined.slice(offset);
+    return messages;
+  }
+}
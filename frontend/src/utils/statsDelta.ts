@@ -0,0 +1,59 @@
+import type { MemoryUsageData, StatsDelta, SystemStats } from '../types';
+
+// Copies `devices` and sets every [index, value] entry of each changed rate key
+const applyRates = <D extends object>(
+  devices: D[],
+  changes: Partial<Record<keyof D & string, [number, number][]>> | undefined,
+): D[] => {
+  if (!changes) {
+    return devices;
+  }
+  const updated = devices.map((device) => ({ ...device }));
+  for (const [key, entries] of Object.entries(changes) as [keyof D & string, [number, number][]][]) {
+    entries.forEach(([index, value]) => { (updated[index] as Record<string, unknown>)[key] = value; });
+  }
+  return updated;
+};
+
+// Pressure comes whole, or null once PSI disappears (a replay of another host)
+const applyMemory = (previous: MemoryUsageData, changes: NonNullable<StatsDelta['memory']>): MemoryUsageData => {
+  const { pressure, ...scalars } = changes;
+  const memory = { ...previous, ...scalars };
+  if (pressure !== undefined) {
+    memory.pressure = pressure ?? undefined;
+  }
+  return memory;
+};
+
+// Applies a delta frame to the previous snapshot. Returns a new object; the previous one is left untouched.
+export const applyStatsDelta = (previous: SystemStats, delta: StatsDelta, timestamp: number): SystemStats => {
+  const cpu = { ...previous.cpu, cores: previous.cpu.cores, packages: previous.cpu.packages };
+  if (delta.cpu) {
+    const {
+      usage, frequency, temperature, coreTemperature, packageTemperature, packageThrottling, ...scalars
+    } = delta.cpu;
+    Object.assign(cpu, scalars);
+    if (temperature !== undefined) {
+      cpu.temperature = temperature ?? undefined;
+    }
+    if (usage || frequency || coreTemperature) {
+      cpu.cores = previous.cpu.cores.map((core) => ({ ...core }));
+      usage?.forEach(([index, value]) => { cpu.cores[index].usage = value; });
+      frequency?.forEach(([index, value]) => { cpu.cores[index].frequency = value; });
+      coreTemperature?.forEach(([index, value]) => { cpu.cores[index].temperature = value ?? undefined; });
+    }
+    if (packageTemperature || packageThrottling) {
+      cpu.packages = previous.cpu.packages.map((entry) => ({ ...entry }));
+      packageTemperature?.forEach(([index, value]) => { cpu.packages[index].temperature = value; });
+      packageThrottling?.forEach(([index, value]) => { cpu.packages[index].throttling = value; });
+    }
+  }
+
+  return {
+    cpu,
+    disks: applyRates(previous.disks, delta.disks),
+    memory: delta.memory ? applyMemory(previous.memory, delta.memory) : previous.memory,
+    network: applyRates(previous.network, delta.network),
+    timestamp,
+  };
+};